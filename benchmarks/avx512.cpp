@@ -0,0 +1,93 @@
+#include <cmath>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// The same kernels at the widest Vec of the build, built once for the host
+// and once with -mno-avx512f so the AVX-512 and AVX2 paths compare
+// directly. Array lengths are odd on purpose, the tails are masked zmm
+// packets in one build and a ymm, xmm and scalar cascade in the other
+
+using VecW = Vec<float, native_width<float>>;
+
+static std::vector<float> make_array(const std::size_t n, const float offset) {
+    std::vector<float> a(n);
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] = 1.5f + std::sin(i * 0.01f + offset);
+    return a;
+}
+
+static void BM_VecRsqrt(benchmark::State& state) {
+    std::vector<VecW> v(state.range(0)), out(v.size());
+    for (std::size_t i = 0; i < v.size(); ++i)
+        for (uint32_t l = 0; l < VecW::Size; ++l)
+            v[i][l] = 1.5f + std::sin((i * VecW::Size + l) * 0.01f);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < v.size(); ++i)
+            out[i] = v[i].rsqrt() * v[i] + v[i].rcp();
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * v.size() * VecW::Size);
+}
+
+BENCHMARK(BM_VecRsqrt)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+static void BM_Mat4fMul(benchmark::State& state) {
+    std::vector<Mat4f> a(state.range(0)), b(a.size()), out(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        for (uint32_t e = 0; e < 16; ++e) {
+            a[i].data()[e] = std::sin(i * 0.1f + e * 0.3f);
+            b[i].data()[e] = std::cos(i * 0.1f + e * 0.3f);
+        }
+    }
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = a[i] * b[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_Mat4fMul)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+static void BM_Mat4fMulVec(benchmark::State& state) {
+    std::vector<Mat4f> a(state.range(0));
+    std::vector<Vec4f> v(a.size()), out(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        for (uint32_t e = 0; e < 16; ++e)
+            a[i].data()[e] = std::sin(i * 0.1f + e * 0.3f);
+        v[i] = Vec4f(1.f, i * 0.01f, -2.f, 1.f);
+    }
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = a[i] * v[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_Mat4fMulVec)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+static void BM_ExprTail(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+    auto a = make_array(n, 0.f), b = make_array(n, 1.f), c = make_array(n, 2.f);
+    std::vector<float> out(n);
+    for (auto _ : state) {
+        assign(out, lazy(a) * lazy(b) + lazy(c));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_ExprTail)->Arg(15)->Arg(31)->Arg(1023)->Arg((1 << 16) - 1);
+
+BENCHMARK_MAIN();
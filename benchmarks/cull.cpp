@@ -0,0 +1,106 @@
+#include <array>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Frustum culling of bounding spheres, the indices of the spheres inside
+// or crossing all six planes of a frustum. Centers and radii are SoA
+// streams and about half of the spheres survive, the worst case for the
+// branches of the scalar loop. The packet variants test W spheres against
+// every plane with lane compares and compress the survivors' indices
+
+static constexpr std::size_t sphere_count = 1 << 16;
+
+struct Plane {
+    float nx, ny, nz, d;
+};
+
+struct Spheres {
+    std::vector<float> x, y, z, r;
+};
+
+static Spheres make_spheres() {
+    pcg32 rng(4);
+    Spheres s;
+    for (std::size_t i = 0; i < sphere_count; ++i) {
+        s.x.push_back(rng.next_float() * 20.f - 10.f);
+        s.y.push_back(rng.next_float() * 20.f - 10.f);
+        s.z.push_back(rng.next_float() * 20.f);
+        s.r.push_back(rng.next_float() * 0.9f + 0.1f);
+    }
+    return s;
+}
+
+// A 90 degree frustum looking down +z from the origin, near 1 and far 16
+static std::array<Plane, 6> make_frustum() {
+    const float h = 0.70710678f;
+    return { {
+        { h, 0.f, h, 0.f }, { -h, 0.f, h, 0.f },
+        { 0.f, h, h, 0.f }, { 0.f, -h, h, 0.f },
+        { 0.f, 0.f, 1.f, -1.f }, { 0.f, 0.f, -1.f, 16.f }
+    } };
+}
+
+static void set_counters(benchmark::State& state, const std::size_t kept) {
+    state.counters["kept"] = static_cast<double>(kept) / sphere_count;
+    state.SetItemsProcessed(state.iterations() * sphere_count);
+}
+
+static void BM_CullLoop(benchmark::State& state) {
+    const auto s = make_spheres();
+    const auto planes = make_frustum();
+    std::vector<uint32_t> out(sphere_count);
+    std::size_t kept = 0;
+    for (auto _ : state) {
+        uint32_t k = 0;
+        for (uint32_t i = 0; i < sphere_count; ++i) {
+            bool inside = true;
+            for (const auto& p : planes) {
+                if (p.nx * s.x[i] + p.ny * s.y[i] + p.nz * s.z[i] + p.d < -s.r[i]) {
+                    inside = false;
+                    break;
+                }
+            }
+            if (inside)
+                out[k++] = i;
+        }
+        benchmark::DoNotOptimize(out.data());
+        kept = k;
+    }
+    set_counters(state, kept);
+}
+
+BENCHMARK(BM_CullLoop);
+
+template <uint32_t W>
+static void BM_CullPacket(benchmark::State& state) {
+    using V = Vec<float, W>;
+    const auto s = make_spheres();
+    const auto planes = make_frustum();
+    std::vector<uint32_t> out(sphere_count);
+    std::size_t kept = 0;
+    for (auto _ : state) {
+        uint32_t k = 0;
+        for (uint32_t i = 0; i < sphere_count; i += W) {
+            const V x = load_packet<V>(&s.x[i]), y = load_packet<V>(&s.y[i]),
+                z = load_packet<V>(&s.z[i]), nr = V(0.f) - load_packet<V>(&s.r[i]);
+            Mask<float, W> keep(true);
+            for (const auto& p : planes)
+                keep &= x * p.nx + y * p.ny + z * p.nz + V(p.d) >= nr;
+            k += compress_indices(out.data() + k, i, keep);
+        }
+        benchmark::DoNotOptimize(out.data());
+        kept = k;
+    }
+    set_counters(state, kept);
+}
+
+BENCHMARK_TEMPLATE(BM_CullPacket, 4);
+BENCHMARK_TEMPLATE(BM_CullPacket, 8);
+BENCHMARK_TEMPLATE(BM_CullPacket, 16);
+
+BENCHMARK_MAIN();
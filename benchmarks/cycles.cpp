@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <yavl/yavl.h>
+
+#include "utils.h"
+
+using namespace yavl;
+
+// Latency and reciprocal throughput of single primitives, the numbers the
+// google benchmark suites can't give.
+//
+// Latency is the time per op of a chain where every op takes the result of
+// the previous one, reciprocal throughput the time per op of Chains
+// independent chains interleaved. Both are the best of a number of samples
+// minus the same loop with an empty step. Times are in counter ticks, tsc
+// ticks on x86 run at the nominal frequency and not the core clock, the
+// perf counters give core cycles, instructions and any raw events asked
+// for(uops, port dispatch counts) per op of the throughput loop:
+//
+//   cycles [--cpu N] [--filter substr] [--event name=0xcode ...]
+//
+// e.g. --event uops=0x10e --event port0=0x1a1 --event port1=0x2a1 for
+// UOPS_ISSUED.ANY and UOPS_DISPATCHED.PORT_0/1 on recent Intel cores. The
+// raw codes are cpu specific, see the vendor's event lists.
+
+static constexpr uint32_t iterations = 1000;
+static constexpr uint32_t samples = 64;
+
+// Keeps the compiler from folding a step into the next one or dropping it,
+// register backed values stay in their registers
+template <typename R>
+static inline void opaque_reg(R& r) {
+#if defined(__x86_64__) || defined(__i386__)
+    __asm__ __volatile__ ("" : "+x"(r));
+#elif defined(__aarch64__)
+    __asm__ __volatile__ ("" : "+w"(r));
+#else
+    __asm__ __volatile__ ("" : : "r"(&r) : "memory");
+#endif
+}
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+template <typename T>
+static inline void opaque(T& v) {
+    if constexpr (requires { v.m; } && Vec<float, 4>::vectorized) {
+        if constexpr (std::is_array_v<decltype(v.m)>) {
+            for (auto& r : v.m)
+                opaque_reg(r);
+        }
+        else {
+            opaque_reg(v.m);
+        }
+    }
+    else if constexpr (std::is_floating_point_v<T>) {
+        opaque_reg(v);
+    }
+    else {
+        __asm__ __volatile__ ("" : : "r"(&v) : "memory");
+    }
+}
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+// x = op(x) as a step
+template <typename Op>
+static auto chain(const Op& op) {
+    return [=](auto& x) {
+        x = op(x);
+        opaque(x);
+    };
+}
+
+#if defined(__linux__)
+
+// One group of counters read together, cycles and instructions first then
+// the raw events. Opening fails in most containers and with a strict
+// perf_event_paranoid, the harness goes on with the tick counts only. An
+// event the cpu or kernel rejects after the cycles leader is left out of
+// the group with a warning
+struct perf_group {
+    struct event {
+        std::string name;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    std::vector<event> events;
+    std::vector<int> fds;
+
+    bool open(const std::vector<event>& evs) {
+        for (const auto& e : evs) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = e.type;
+            attr.config = e.config;
+            attr.disabled = fds.empty();
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int fd = syscall(SYS_perf_event_open, &attr, 0, -1,
+                fds.empty() ? -1 : fds[0], 0);
+            if (fd < 0) {
+                if (fds.empty())
+                    return false;
+                std::fprintf(stderr, "perf event %s unavailable, skipped\n", e.name.c_str());
+                continue;
+            }
+            fds.push_back(fd);
+            events.push_back(e);
+        }
+        return true;
+    }
+
+    void close() {
+        for (auto fd : fds)
+            ::close(fd);
+        fds.clear();
+    }
+
+    bool enabled() const {
+        return !fds.empty();
+    }
+
+    void start() {
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    std::vector<uint64_t> stop() {
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        std::vector<uint64_t> buf(fds.size() + 1, 0);
+        if (read(fds[0], buf.data(), buf.size() * sizeof(uint64_t)) < 0)
+            return std::vector<uint64_t>(fds.size(), 0);
+        return std::vector<uint64_t>(buf.begin() + 1, buf.end());
+    }
+};
+
+#else
+
+struct perf_group {
+    struct event {
+        std::string name;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    std::vector<event> events;
+
+    bool open(const std::vector<event>&) { return false; }
+    bool enabled() const { return false; }
+    void start() {}
+    std::vector<uint64_t> stop() { return {}; }
+};
+
+#endif
+
+static perf_group perf;
+
+struct result {
+    double latency;
+    double rthroughput;
+    std::vector<double> counters;
+};
+
+// Best of the samples, the loop the counters see is the last one
+template <uint32_t Chains, typename T, typename Step>
+static double run(const T& init, const Step& step, std::vector<uint64_t>* counts) {
+    unsigned long long best = ~0ull;
+    std::array<T, Chains> s;
+    for (uint32_t k = 0; k < Chains; ++k)
+        s[k] = init;
+    for (uint32_t n = 0; n < samples; ++n) {
+        const bool last = counts && n == samples - 1;
+        if (last)
+            perf.start();
+        auto t0 = tick_begin();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            static_for<Chains>([&](const auto k) {
+                step(s[k]);
+            });
+        }
+        auto t1 = tick_end();
+        if (last)
+            *counts = perf.stop();
+        best = std::min(best, t1 - t0);
+    }
+    __asm__ __volatile__ ("" : : "r"(s.data()) : "memory");
+    return static_cast<double>(best) / (static_cast<double>(iterations) * Chains);
+}
+
+template <uint32_t Chains, typename T, typename Step>
+static result measure(const T& init, const Step& step) {
+    auto empty = [](T&) {};
+    result r;
+    r.latency = run<1>(init, step, nullptr) - run<1>(init, empty, nullptr);
+
+    std::vector<uint64_t> counts, base;
+    auto* pc = perf.enabled() ? &counts : nullptr;
+    auto* pb = perf.enabled() ? &base : nullptr;
+    r.rthroughput = run<Chains>(init, step, pc) - run<Chains>(init, empty, pb);
+    for (std::size_t e = 0; e < counts.size(); ++e) {
+        double d = static_cast<double>(counts[e]) - static_cast<double>(base[e]);
+        r.counters.push_back(d / (static_cast<double>(iterations) * Chains));
+    }
+    return r;
+}
+
+static const char* filter = nullptr;
+
+template <uint32_t Chains = 8, typename T, typename Step>
+static void report(const char* name, const T& init, const Step& step) {
+    if (filter && !std::strstr(name, filter))
+        return;
+    auto r = measure<Chains>(init, step);
+    std::printf("%-28s %10.2f %10.2f", name, r.latency, r.rthroughput);
+    for (auto c : r.counters)
+        std::printf(" %10.2f", c);
+    std::printf("\n");
+}
+
+// Columns times lane broadcasts, the other Mat4f * Vec4f choice next to the
+// library one
+static Vec4f mul_vec_broadcast(const Vec4f (&c)[4], const Vec4f& v) {
+    auto t0 = c[0] * v.template shuffle<0, 0, 0, 0>() + c[1] * v.template shuffle<1, 1, 1, 1>();
+    auto t1 = c[2] * v.template shuffle<2, 2, 2, 2>() + c[3] * v.template shuffle<3, 3, 3, 3>();
+    return t0 + t1;
+}
+
+static void run_vec() {
+    const Vec4f a4{ 1.1f, 0.9f, 1.3f, 0.7f }, b4{ 0.99f, 1.01f, 0.98f, 1.02f };
+    const Vec3f a3{ 1.1f, 0.9f, 1.3f }, b3{ 0.99f, 1.01f, 0.98f };
+
+    report("vec4f.add", a4, chain([=](const Vec4f& x) { return x + b4; }));
+    report("vec4f.mul", a4, chain([=](const Vec4f& x) { return x * b4; }));
+    report("vec4f.div", a4, chain([=](const Vec4f& x) { return x / b4; }));
+    report("vec4f.sqrt", a4, chain([](const Vec4f& x) { return x.sqrt(); }));
+    report("vec4f.rsqrt", a4, chain([](const Vec4f& x) { return x.rsqrt(); }));
+    report("vec4f.rcp", a4, chain([](const Vec4f& x) { return x.rcp(); }));
+    report("vec4f.shuffle", a4, chain([](const Vec4f& x) { return x.template shuffle<3, 2, 1, 0>(); }));
+    // The scalar result is broadcast back to keep the chain
+    report("vec4f.dot", a4, chain([=](const Vec4f& x) { return Vec4f(x.dot(b4)); }));
+    report("vec4f.normalize", a4, chain([](const Vec4f& x) { return x.normalized(); }));
+
+    report("vec3f.add", a3, chain([=](const Vec3f& x) { return x + b3; }));
+    report("vec3f.cross", a3, chain([=](const Vec3f& x) { return x.cross(b3); }));
+    report("vec3f.dot", a3, chain([=](const Vec3f& x) { return Vec3f(x.dot(b3)); }));
+    report("vec3f.normalize", a3, chain([](const Vec3f& x) { return x.normalized(); }));
+
+    const Vec<float, 8> a8(1.1f), b8(0.99f);
+    report("vec8f.add", a8, chain([=](const Vec<float, 8>& x) { return x + b8; }));
+    report("vec8f.mul", a8, chain([=](const Vec<float, 8>& x) { return x * b8; }));
+    report("vec8f.sqrt", a8, chain([](const Vec<float, 8>& x) { return x.sqrt(); }));
+}
+
+static void run_mat() {
+    const Mat4f m4{
+        0.8f, 0.3f, -0.2f, 0.f,
+        -0.4f, 1.5f, 0.6f, 0.f,
+        0.1f, -0.7f, 2.f, 0.f,
+        3.f, -2.f, 1.f, 1.f
+    };
+    const Mat3f m3{ 0.8f, 0.3f, -0.2f, -0.4f, 1.5f, 0.6f, 0.1f, -0.7f, 2.f };
+    const Vec4f v4{ 1.f, 2.f, 3.f, 1.f };
+    const Vec3f v3{ 1.f, 2.f, 3.f };
+
+    report("mat4f.mul_vec", v4, chain([=](const Vec4f& x) { return m4 * x; }));
+    Vec4f cols[4];
+    for (uint32_t i = 0; i < 4; ++i)
+        std::memcpy(cols[i].data(), m4.data() + i * 4, sizeof(float) * 4);
+    report("mat4f.mul_vec_broadcast", v4, chain([=](const Vec4f& x) { return mul_vec_broadcast(cols, x); }));
+    report<4>("mat4f.mul_mat", m4, chain([=](const Mat4f& x) { return x * m4; }));
+    report<4>("mat4f.transpose", m4, chain([](const Mat4f& x) { return x.transpose(); }));
+    report<4>("mat4f.inverse", m4, chain([](const Mat4f& x) { return x.inverse().second; }));
+    report<4>("mat4f.determinant", m4, chain([](const Mat4f& x) { return Mat4f(x.determinant()); }));
+    report("mat3f.mul_vec", v3, chain([=](const Vec3f& x) { return m3 * x; }));
+    report<4>("mat3f.mul_mat", m3, chain([=](const Mat3f& x) { return x * m3; }));
+}
+
+// The generator state is the chain, outputs go to memory like they do in
+// the bulk fills
+template <typename R, typename Out, typename F>
+static auto draw(const F& f) {
+    return [=](R& rng) {
+        Out out;
+        f(rng, out);
+        opaque(out);
+    };
+}
+
+static void run_rng() {
+    using u8 = std::array<uint32_t, 8>;
+    using f8 = std::array<float, 8>;
+    using u16 = std::array<uint32_t, 16>;
+
+    report("pcg32.next_uint", pcg32{}, [](pcg32& rng) {
+        auto r = rng.next_uint();
+        __asm__ __volatile__ ("" : "+r"(r));
+    });
+    report("pcg32.next_float", pcg32{}, [](pcg32& rng) {
+        auto r = rng.next_float();
+        opaque(r);
+    });
+    report<4>("pcg32x8.next_uints", pcg32x<8>{},
+        draw<pcg32x<8>, u8>([](auto& rng, auto& out) { rng.next_uints(out); }));
+    report<4>("pcg32x8.next_floats", pcg32x<8>{},
+        draw<pcg32x<8>, f8>([](auto& rng, auto& out) { rng.next_floats(out); }));
+    report<4>("pcg32x16.next_uints", pcg32x<16>{},
+        draw<pcg32x<16>, u16>([](auto& rng, auto& out) { rng.next_uints(out); }));
+}
+
+int main(int argc, char** argv) {
+    int cpu = -1;
+    std::vector<perf_group::event> events;
+#if defined(__linux__)
+    events.push_back({ "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES });
+    events.push_back({ "instrs", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS });
+#endif
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--cpu" && i + 1 < argc) {
+            cpu = std::atoi(argv[++i]);
+        }
+        else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (arg == "--event" && i + 1 < argc) {
+            std::string ev = argv[++i];
+            auto eq = ev.find('=');
+            if (eq == std::string::npos) {
+                std::fprintf(stderr, "--event expects name=0xcode\n");
+                return 1;
+            }
+#if defined(__linux__)
+            events.push_back({ ev.substr(0, eq), PERF_TYPE_RAW,
+                std::strtoull(ev.c_str() + eq + 1, nullptr, 0) });
+#endif
+        }
+        else {
+            std::fprintf(stderr, "usage: %s [--cpu N] [--filter substr] "
+                "[--event name=0xcode ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (!pin_to_cpu(cpu))
+        std::fprintf(stderr, "could not pin to a cpu, results may be noisy\n");
+    if (!perf.open(events))
+        std::fprintf(stderr, "perf counters unavailable, reporting ticks only\n");
+
+    std::printf("%-28s %10s %10s", "primitive", "latency", "rthru");
+    if (perf.enabled()) {
+        for (const auto& e : perf.events)
+            std::printf(" %10s", e.name.c_str());
+    }
+    std::printf("\n%-28s %10s %10s\n", "", YAVL_TICK_UNIT "/op", YAVL_TICK_UNIT "/op");
+
+    run_vec();
+    run_mat();
+    run_rng();
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Ray-box and ray-triangle tests on synthetic scenes, random boxes and a
+// triangle soup in a cube with rays from around it aimed inside. Every ray
+// is tested against every primitive, rays/s is rays through the whole
+// scene and items/s single tests. The _loop variants are the scalar tests
+// a ray at a time
+
+static constexpr std::size_t ray_count = 1024;
+static constexpr std::size_t box_count = 256;
+static constexpr std::size_t triangle_count = 256;
+
+static Vec3f random_vec(pcg32& rng, const float scale) {
+    return Vec3f(rng.next_float() * 2.f - 1.f, rng.next_float() * 2.f - 1.f,
+        rng.next_float() * 2.f - 1.f) * scale;
+}
+
+static std::vector<Ray> make_rays() {
+    pcg32 rng(1);
+    std::vector<Ray> rays(ray_count);
+    for (auto& r : rays) {
+        const Vec3f o = random_vec(rng, 8.f);
+        r = Ray(o, (random_vec(rng, 2.f) - o).normalized());
+    }
+    return rays;
+}
+
+static std::vector<std::pair<Vec3f, Vec3f>> make_boxes() {
+    pcg32 rng(2);
+    std::vector<std::pair<Vec3f, Vec3f>> boxes(box_count);
+    for (auto& b : boxes) {
+        const Vec3f c = random_vec(rng, 4.f), e = random_vec(rng, 0.5f).abs();
+        b = { c - e, c + e };
+    }
+    return boxes;
+}
+
+static std::vector<std::array<Vec3f, 3>> make_triangles() {
+    pcg32 rng(3);
+    std::vector<std::array<Vec3f, 3>> tris(triangle_count);
+    for (auto& t : tris) {
+        const Vec3f c = random_vec(rng, 4.f);
+        t = { c + random_vec(rng, 1.f), c + random_vec(rng, 1.f), c + random_vec(rng, 1.f) };
+    }
+    return tris;
+}
+
+static void set_counters(benchmark::State& state, const std::size_t primitives) {
+    state.counters["rays/s"] = benchmark::Counter(static_cast<double>(ray_count),
+        benchmark::Counter::kIsIterationInvariantRate);
+    state.SetItemsProcessed(state.iterations() * ray_count * primitives);
+}
+
+template <uint32_t W>
+static std::vector<RaySoA<W>> make_ray_packets(const std::vector<Ray>& rays) {
+    std::vector<RaySoA<W>> packets(rays.size() / W);
+    for (std::size_t p = 0; p < packets.size(); ++p)
+        packets[p] = RaySoA<W>::load(rays.data() + p * W);
+    return packets;
+}
+
+// Boxes
+
+static void BM_RayBoxLoop(benchmark::State& state) {
+    const auto rays = make_rays();
+    const auto boxes = make_boxes();
+    for (auto _ : state) {
+        uint32_t hits = 0;
+        for (const auto& r : rays) {
+            for (const auto& [lo, hi] : boxes) {
+                float t0 = r.tmin, t1 = r.tmax;
+                for (uint32_t a = 0; a < 3; ++a) {
+                    float n = (lo[a] - r.org[a]) * r.inv_dir[a];
+                    float f = (hi[a] - r.org[a]) * r.inv_dir[a];
+                    if (n > f)
+                        std::swap(n, f);
+                    t0 = std::max(t0, n);
+                    t1 = std::min(t1, f);
+                }
+                hits += t0 <= t1;
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    set_counters(state, box_count);
+}
+
+BENCHMARK(BM_RayBoxLoop);
+
+// W rays against one box at a time
+template <uint32_t W>
+static void BM_RayPacketBox(benchmark::State& state) {
+    const auto packets = make_ray_packets<W>(make_rays());
+    const auto boxes = make_boxes();
+    for (auto _ : state) {
+        uint32_t hits = 0;
+        for (const auto& p : packets)
+            for (const auto& [lo, hi] : boxes)
+                hits += std::popcount(intersect_box(p, lo, hi).mask);
+        benchmark::DoNotOptimize(hits);
+    }
+    set_counters(state, box_count);
+}
+
+BENCHMARK_TEMPLATE(BM_RayPacketBox, 4);
+BENCHMARK_TEMPLATE(BM_RayPacketBox, 8);
+BENCHMARK_TEMPLATE(BM_RayPacketBox, 16);
+
+// One ray against W boxes at a time, BVH node style
+template <uint32_t W>
+static void BM_RayBoxPacket(benchmark::State& state) {
+    const auto rays = make_rays();
+    const auto boxes = make_boxes();
+    std::vector<BoxSoA<W>> nodes(box_count / W);
+    for (std::size_t i = 0; i < box_count; ++i)
+        nodes[i / W].set(i % W, boxes[i].first, boxes[i].second);
+    for (auto _ : state) {
+        uint32_t hits = 0;
+        for (const auto& r : rays)
+            for (const auto& n : nodes)
+                hits += std::popcount(intersect_box(r, n).mask);
+        benchmark::DoNotOptimize(hits);
+    }
+    set_counters(state, box_count);
+}
+
+BENCHMARK_TEMPLATE(BM_RayBoxPacket, 4);
+BENCHMARK_TEMPLATE(BM_RayBoxPacket, 8);
+BENCHMARK_TEMPLATE(BM_RayBoxPacket, 16);
+
+// Triangles, closest hit of every ray
+
+static void BM_RayTriangleLoop(benchmark::State& state) {
+    const auto rays = make_rays();
+    const auto tris = make_triangles();
+    for (auto _ : state) {
+        float sum = 0.f;
+        for (const auto& r : rays) {
+            float tmax = r.tmax;
+            for (const auto& [v0, v1, v2] : tris) {
+                const Vec3f e1 = v1 - v0, e2 = v2 - v0;
+                const Vec3f p = r.dir.cross(e2);
+                const float inv_det = 1.f / e1.dot(p);
+                const Vec3f s = r.org - v0;
+                const float u = s.dot(p) * inv_det;
+                const Vec3f q = s.cross(e1);
+                const float v = r.dir.dot(q) * inv_det;
+                const float t = e2.dot(q) * inv_det;
+                if (u >= 0.f && v >= 0.f && u + v <= 1.f && t >= r.tmin && t <= tmax)
+                    tmax = t;
+            }
+            sum += std::isinf(tmax) ? 0.f : tmax;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    set_counters(state, triangle_count);
+}
+
+BENCHMARK(BM_RayTriangleLoop);
+
+template <uint32_t W>
+static void BM_RayPacketTriangle(benchmark::State& state) {
+    const auto packets = make_ray_packets<W>(make_rays());
+    const auto tris = make_triangles();
+    for (auto _ : state) {
+        float sum = 0.f;
+        for (auto p : packets) {
+            for (const auto& [v0, v1, v2] : tris)
+                p.tmax = intersect_triangle(p, v0, v1, v2).t;
+            for (uint32_t l = 0; l < W; ++l)
+                sum += std::isinf(p.tmax[l]) ? 0.f : p.tmax[l];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    set_counters(state, triangle_count);
+}
+
+BENCHMARK_TEMPLATE(BM_RayPacketTriangle, 4);
+BENCHMARK_TEMPLATE(BM_RayPacketTriangle, 8);
+BENCHMARK_TEMPLATE(BM_RayPacketTriangle, 16);
+
+template <uint32_t W>
+static void BM_RayTrianglePacket(benchmark::State& state) {
+    const auto rays = make_rays();
+    const auto tris = make_triangles();
+    std::vector<TriangleSoA<W>> leaves(triangle_count / W);
+    for (std::size_t i = 0; i < triangle_count; ++i)
+        leaves[i / W].set(i % W, tris[i][0], tris[i][1], tris[i][2]);
+    for (auto _ : state) {
+        float sum = 0.f;
+        for (auto r : rays) {
+            for (const auto& leaf : leaves) {
+                const auto hits = intersect_triangle(r, leaf);
+                if (hits.mask)
+                    r.tmax = hits.t[hits.closest()];
+            }
+            sum += std::isinf(r.tmax) ? 0.f : r.tmax;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    set_counters(state, triangle_count);
+}
+
+BENCHMARK_TEMPLATE(BM_RayTrianglePacket, 4);
+BENCHMARK_TEMPLATE(BM_RayTrianglePacket, 8);
+BENCHMARK_TEMPLATE(BM_RayTrianglePacket, 16);
+
+BENCHMARK_MAIN();
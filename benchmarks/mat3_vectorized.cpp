@@ -30,4 +30,40 @@ static void BM_Mat3fMulMat(benchmark::State& state) {
 
 BENCHMARK(BM_Mat3fMulMat);
 
+static void BM_Mat3fTranspose(benchmark::State& state) {
+    Mat3f a{
+        2.f, 1.f, 0.5f,
+        -1.f, 3.f, 0.2f,
+        0.3f, -0.7f, 1.5f
+    };
+    Mat3f c;
+    for (auto _ : state) {
+        static_for<1000>([&](const auto i) {
+            benchmark::DoNotOptimize(a);
+            c = a.transpose();
+            benchmark::DoNotOptimize(c);
+        });
+    }
+}
+
+BENCHMARK(BM_Mat3fTranspose);
+
+static void BM_Mat3fInverse(benchmark::State& state) {
+    Mat3f a{
+        2.f, 1.f, 0.5f,
+        -1.f, 3.f, 0.2f,
+        0.3f, -0.7f, 1.5f
+    };
+    Mat3f c;
+    for (auto _ : state) {
+        static_for<1000>([&](const auto i) {
+            benchmark::DoNotOptimize(a);
+            c = a.inverse().second;
+            benchmark::DoNotOptimize(c);
+        });
+    }
+}
+
+BENCHMARK(BM_Mat3fInverse);
+
 BENCHMARK_MAIN();
\ No newline at end of file
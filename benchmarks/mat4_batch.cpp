@@ -0,0 +1,84 @@
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Parent by child Mat4f products of an animation frame, one independent
+// product per pair, in AoS and in Mat4x8f packs of 8
+
+static std::vector<Mat4f> make_mats(const std::size_t n, const float offset) {
+    std::vector<Mat4f> m(n);
+    for (std::size_t i = 0; i < n; ++i)
+        for (uint32_t e = 0; e < 16; ++e)
+            m[i].data()[e] = std::sin(i * 0.1f + e * 0.3f + offset);
+    return m;
+}
+
+static void BM_Mat4fMulLoop(benchmark::State& state) {
+    auto a = make_mats(state.range(0), 0.f), b = make_mats(state.range(0), 1.f);
+    std::vector<Mat4f> out(a.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = a[i] * b[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_Mat4fMulLoop)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_Mat4fMultiply(benchmark::State& state) {
+    auto a = make_mats(state.range(0), 0.f), b = make_mats(state.range(0), 1.f);
+    std::vector<Mat4f> out(a.size());
+    for (auto _ : state) {
+        multiply(a, b, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_Mat4fMultiply)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// Both operands kept in packs
+static void BM_Mat4x8fMul(benchmark::State& state) {
+    auto a = make_mats(state.range(0), 0.f), b = make_mats(state.range(0), 1.f);
+    std::vector<Mat4x8f> pa(a.size() / 8), pb(a.size() / 8), out(a.size() / 8);
+    for (std::size_t i = 0; i < pa.size(); ++i) {
+        pa[i] = Mat4x8f::load(a.data() + i * 8);
+        pb[i] = Mat4x8f::load(b.data() + i * 8);
+    }
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < pa.size(); ++i)
+            out[i] = pa[i] * pb[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_Mat4x8fMul)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// AoS in and out, converted to packs and back around every product
+static void BM_Mat4x8fMulConvert(benchmark::State& state) {
+    auto a = make_mats(state.range(0), 0.f), b = make_mats(state.range(0), 1.f);
+    std::vector<Mat4f> out(a.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < a.size(); i += 8) {
+            auto p = Mat4x8f::load(a.data() + i) * Mat4x8f::load(b.data() + i);
+            p.store(out.data() + i);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK(BM_Mat4x8fMulConvert)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -30,4 +30,23 @@ static void BM_Mat4fMulMat(benchmark::State& state) {
 
 BENCHMARK(BM_Mat4fMulMat);
 
+static void BM_Mat4fInverse(benchmark::State& state) {
+    Mat4f a{
+        0.8f, 0.3f, -0.2f, 0.f,
+        -0.4f, 1.5f, 0.6f, 0.f,
+        0.1f, -0.7f, 2.f, 0.f,
+        3.f, -2.f, 1.f, 1.f
+    };
+    Mat4f c;
+    for (auto _ : state) {
+        static_for<1000>([&](const auto i) {
+            benchmark::DoNotOptimize(a);
+            c = a.inverse().second;
+            benchmark::DoNotOptimize(c);
+        });
+    }
+}
+
+BENCHMARK(BM_Mat4fInverse);
+
 BENCHMARK_MAIN();
\ No newline at end of file
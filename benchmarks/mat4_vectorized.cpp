@@ -1,3 +1,6 @@
+#include <span>
+#include <vector>
+
 #include <benchmark/benchmark.h>
 
 //#define YAVL_FORCE_SSE_MAT
@@ -30,4 +33,82 @@ static void BM_Mat4fMulMat(benchmark::State& state) {
 
 BENCHMARK(BM_Mat4fMulMat);
 
+static const Mat4f affine{
+    0.8f, 0.3f, -0.2f, 0.f,
+    -0.4f, 1.5f, 0.6f, 0.f,
+    0.1f, -0.7f, 2.f, 0.f,
+    3.f, -2.f, 1.f, 1.f
+};
+
+static void BM_Mat4fInverse(benchmark::State& state) {
+    Mat4f a = affine, c;
+    for (auto _ : state) {
+        static_for<1000>([&](const auto i) {
+            benchmark::DoNotOptimize(a);
+            c = a.inverse().second;
+            benchmark::DoNotOptimize(c);
+        });
+    }
+}
+
+BENCHMARK(BM_Mat4fInverse);
+
+static void BM_Mat4fAffineInverse(benchmark::State& state) {
+    Mat4f a = affine, c;
+    for (auto _ : state) {
+        static_for<1000>([&](const auto i) {
+            benchmark::DoNotOptimize(a);
+            c = a.affine_inverse().second;
+            benchmark::DoNotOptimize(c);
+        });
+    }
+}
+
+BENCHMARK(BM_Mat4fAffineInverse);
+
+static void BM_Mat4fDeterminant(benchmark::State& state) {
+    Mat4f a = affine;
+    float c;
+    for (auto _ : state) {
+        static_for<1000>([&](const auto i) {
+            benchmark::DoNotOptimize(a);
+            c = a.determinant();
+            benchmark::DoNotOptimize(c);
+        });
+    }
+}
+
+BENCHMARK(BM_Mat4fDeterminant);
+
+static void BM_Mat4dInverse(benchmark::State& state) {
+    Mat4d a{
+        0.8, 0.3, -0.2, 0.,
+        -0.4, 1.5, 0.6, 0.,
+        0.1, -0.7, 2., 0.,
+        3., -2., 1., 1.
+    };
+    Mat4d c;
+    for (auto _ : state) {
+        static_for<1000>([&](const auto i) {
+            benchmark::DoNotOptimize(a);
+            c = a.inverse().second;
+            benchmark::DoNotOptimize(c);
+        });
+    }
+}
+
+BENCHMARK(BM_Mat4dInverse);
+
+static void BM_Mat4fInverseBatch(benchmark::State& state) {
+    std::vector<Mat4f> in(state.range(0), affine), out(in.size());
+    for (auto _ : state) {
+        inverse(std::span<const Mat4f>{ in }, std::span<Mat4f>{ out });
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_Mat4fInverseBatch)->RangeMultiplier(16)->Range(1 << 6, 1 << 16);
+
 BENCHMARK_MAIN();
\ No newline at end of file
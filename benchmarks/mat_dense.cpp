@@ -0,0 +1,132 @@
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Multiply, LU and Cholesky of the generic Mat over N, reported in FLOP/s.
+// 2 N^3 flops for a multiply, 2/3 N^3 for LU and 1/3 N^3 for Cholesky
+
+template <typename T, uint32_t N>
+static Mat<T, N> make_mat(const double offset) {
+    Mat<T, N> m;
+    for (uint32_t i = 0; i < N * N; ++i)
+        m.arr[i] = static_cast<T>(std::sin(i * 0.37 + offset));
+    for (uint32_t i = 0; i < N; ++i)
+        m.arr[i * N + i] += N;
+    return m;
+}
+
+static void set_flops(benchmark::State& state, const double flops) {
+    state.counters["FLOPS"] = benchmark::Counter(flops * state.iterations(),
+        benchmark::Counter::kIsRate);
+}
+
+// The multiply Mat used to have at every size, fully unrolled
+template <typename T, uint32_t N>
+static void BM_MatMulUnrolled(benchmark::State& state) {
+    auto a = make_mat<T, N>(0), b = make_mat<T, N>(1);
+    benchmark::DoNotOptimize(a.arr.data());
+    benchmark::DoNotOptimize(b.arr.data());
+    for (auto _ : state) {
+        Mat<T, N> c;
+        static_for<N>([&](const auto i) {
+            static_for<N>([&](const auto j) {
+                static_for<N>([&](const auto k) {
+                    c.arr[i * N + j] += a.arr[k * N + j] * b.arr[i * N + k];
+                });
+            });
+        });
+        benchmark::DoNotOptimize(c.arr.data());
+        benchmark::ClobberMemory();
+    }
+    set_flops(state, 2. * N * N * N);
+}
+
+BENCHMARK_TEMPLATE(BM_MatMulUnrolled, float, 6);
+BENCHMARK_TEMPLATE(BM_MatMulUnrolled, float, 8);
+BENCHMARK_TEMPLATE(BM_MatMulUnrolled, float, 16);
+BENCHMARK_TEMPLATE(BM_MatMulUnrolled, double, 6);
+
+// Plain loops left to the auto-vectorizer
+template <typename T, uint32_t N>
+static void BM_MatMulLoop(benchmark::State& state) {
+    auto a = make_mat<T, N>(0), b = make_mat<T, N>(1);
+    benchmark::DoNotOptimize(a.arr.data());
+    benchmark::DoNotOptimize(b.arr.data());
+    for (auto _ : state) {
+        Mat<T, N> c;
+        for (uint32_t j = 0; j < N; ++j)
+            for (uint32_t k = 0; k < N; ++k)
+                for (uint32_t i = 0; i < N; ++i)
+                    c.arr[j * N + i] += a.arr[k * N + i] * b.arr[j * N + k];
+        benchmark::DoNotOptimize(c.arr.data());
+        benchmark::ClobberMemory();
+    }
+    set_flops(state, 2. * N * N * N);
+}
+
+template <typename T, uint32_t N>
+static void BM_MatMul(benchmark::State& state) {
+    auto a = make_mat<T, N>(0), b = make_mat<T, N>(1);
+    benchmark::DoNotOptimize(a.arr.data());
+    benchmark::DoNotOptimize(b.arr.data());
+    for (auto _ : state) {
+        auto c = a * b;
+        benchmark::DoNotOptimize(c.arr.data());
+        benchmark::ClobberMemory();
+    }
+    set_flops(state, 2. * N * N * N);
+}
+
+template <typename T, uint32_t N>
+static void BM_LU(benchmark::State& state) {
+    auto a = make_mat<T, N>(0);
+    benchmark::DoNotOptimize(a.arr.data());
+    for (auto _ : state) {
+        LU<T, N> lu(a);
+        benchmark::DoNotOptimize(lu.lu.data());
+        benchmark::ClobberMemory();
+    }
+    set_flops(state, 2. / 3. * N * N * N);
+}
+
+template <typename T, uint32_t N>
+static void BM_Cholesky(benchmark::State& state) {
+    auto a = make_mat<T, N>(0);
+    a = a * a.transpose();
+    benchmark::DoNotOptimize(a.arr.data());
+    for (auto _ : state) {
+        Cholesky<T, N> ch(a);
+        benchmark::DoNotOptimize(ch.l.data());
+        benchmark::ClobberMemory();
+    }
+    set_flops(state, 1. / 3. * N * N * N);
+}
+
+#define YAVL_DENSE_BENCHMARKS(T)                                        \
+    BENCHMARK_TEMPLATE(BM_MatMulLoop, T, 6);                            \
+    BENCHMARK_TEMPLATE(BM_MatMulLoop, T, 8);                            \
+    BENCHMARK_TEMPLATE(BM_MatMulLoop, T, 16);                           \
+    BENCHMARK_TEMPLATE(BM_MatMulLoop, T, 32);                           \
+    BENCHMARK_TEMPLATE(BM_MatMul, T, 6);                                \
+    BENCHMARK_TEMPLATE(BM_MatMul, T, 8);                                \
+    BENCHMARK_TEMPLATE(BM_MatMul, T, 12);                               \
+    BENCHMARK_TEMPLATE(BM_MatMul, T, 16);                               \
+    BENCHMARK_TEMPLATE(BM_MatMul, T, 24);                               \
+    BENCHMARK_TEMPLATE(BM_MatMul, T, 32);                               \
+    BENCHMARK_TEMPLATE(BM_LU, T, 6);                                    \
+    BENCHMARK_TEMPLATE(BM_LU, T, 8);                                    \
+    BENCHMARK_TEMPLATE(BM_LU, T, 16);                                   \
+    BENCHMARK_TEMPLATE(BM_LU, T, 32);                                   \
+    BENCHMARK_TEMPLATE(BM_Cholesky, T, 6);                              \
+    BENCHMARK_TEMPLATE(BM_Cholesky, T, 8);                              \
+    BENCHMARK_TEMPLATE(BM_Cholesky, T, 16);                             \
+    BENCHMARK_TEMPLATE(BM_Cholesky, T, 32);
+
+YAVL_DENSE_BENCHMARKS(float)
+YAVL_DENSE_BENCHMARKS(double)
+
+BENCHMARK_MAIN();
@@ -0,0 +1,126 @@
+#include <cmath>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Strong scaling of the parallel bulk functions, a fixed working set well
+// past the last level cache split over 1 to N threads. Wall clock time, the
+// speedup of a row is its items/s over the threads:1 one of the same name
+
+static const Mat4f xform{
+    0.8f, 0.3f, -0.2f, 0.f,
+    -0.4f, 1.5f, 0.6f, 0.f,
+    0.1f, -0.7f, 2.f, 0.f,
+    3.f, -2.f, 1.f, 1.f
+};
+
+static constexpr std::size_t count = 1 << 22;
+
+// One pool per thread count, kept alive across benchmarks so worker start
+// up isn't timed
+static thread_pool& pool_of(const int threads) {
+    static std::map<int, std::unique_ptr<thread_pool>> pools;
+    auto& p = pools[threads];
+    if (!p)
+        p = std::make_unique<thread_pool>(threads);
+    return *p;
+}
+
+// 1, 2, 4... and the cpu count
+static void thread_counts(benchmark::internal::Benchmark* b) {
+    const int cpus = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    for (int t = 1; t < cpus; t *= 2)
+        b->Arg(t);
+    b->Arg(cpus);
+    b->ArgName("threads")->UseRealTime();
+}
+
+static void BM_TransformPoints(benchmark::State& state) {
+    auto& pool = pool_of(state.range(0));
+    std::vector<Vec3f, aligned_allocator<Vec3f>> in(count), out(count);
+    for (std::size_t i = 0; i < count; ++i)
+        in[i] = Vec3f{ i * 0.5f, i * 0.25f, i * 0.125f };
+    for (auto _ : state) {
+        parallel_transform_points(xform, in, out, store_policy::automatic, pool);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_TransformPoints)->Apply(thread_counts);
+
+static void BM_TransformPointsView(benchmark::State& state) {
+    auto& pool = pool_of(state.range(0));
+    std::vector<float, aligned_allocator<float>> buf(count * 3);
+    for (std::size_t i = 0; i < buf.size(); ++i)
+        buf[i] = i * 0.25f;
+    const Vec3fView v(buf.data(), count);
+    for (auto _ : state) {
+        parallel_transform_points(xform, v, v, pool);
+        benchmark::DoNotOptimize(buf.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_TransformPointsView)->Apply(thread_counts);
+
+static void BM_Normalize(benchmark::State& state) {
+    auto& pool = pool_of(state.range(0));
+    VecArray<float, 3> a(count);
+    for (std::size_t i = 0; i < count; ++i)
+        a.set(i, Vec3f{ i + 1.f, 2.f, 3.f });
+    for (auto _ : state) {
+        parallel_normalize(a, pool);
+        benchmark::DoNotOptimize(a.stream(0));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_Normalize)->Apply(thread_counts);
+
+static void BM_FillUniformFloat(benchmark::State& state) {
+    auto& pool = pool_of(state.range(0));
+    pcg32x<8> rng;
+    std::vector<float, aligned_allocator<float>> out(count * 4);
+    for (auto _ : state) {
+        parallel_fill_uniform_float(rng, std::span(out), store_policy::automatic, pool);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+BENCHMARK(BM_FillUniformFloat)->Apply(thread_counts);
+
+static void BM_ReduceSum(benchmark::State& state) {
+    auto& pool = pool_of(state.range(0));
+    std::vector<float, aligned_allocator<float>> v(count * 4);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = std::sin(i * 0.001f);
+    for (auto _ : state) {
+        float s = parallel_reduce(v.size(), 1 << 16, 0.f,
+            [&](const std::size_t b, const std::size_t e) {
+                float acc = 0.f;
+                for (std::size_t i = b; i < e; ++i)
+                    acc += v[i];
+                return acc;
+            },
+            [](const float a, const float b) { return a + b; }, pool);
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+
+BENCHMARK(BM_ReduceSum)->Apply(thread_counts);
+
+BENCHMARK_MAIN();
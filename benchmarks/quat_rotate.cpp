@@ -0,0 +1,154 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Quaternion rotations against the Mat4f path at skinning sized workloads,
+// a few thousand vertices with one bone rotation each, and composition of
+// rotations against Mat4f products
+
+static std::vector<Vec3f> make_vectors(const std::size_t n) {
+    std::vector<Vec3f> v(n);
+    for (std::size_t i = 0; i < n; ++i)
+        v[i] = Vec3f{ i * 0.5f, i * 0.25f, i * 0.125f };
+    return v;
+}
+
+static std::vector<Quatf> make_rotations(const std::size_t n) {
+    std::vector<Quatf> q(n);
+    for (std::size_t i = 0; i < n; ++i)
+        q[i] = Quatf::axis_angle(Vec3f{ 1.f, i * 0.1f, -0.5f }.normalized(), i * 0.37f);
+    return q;
+}
+
+// Orientations converted to matrices every time, as with Vec4f storage
+static void BM_SkinningQuatToMat4Loop(benchmark::State& state) {
+    auto in = make_vectors(state.range(0));
+    auto q = make_rotations(in.size());
+    std::vector<Vec3f> out(in.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            auto r = q[i].to_mat4() * Vec4f{ in[i].x, in[i].y, in[i].z, 0.f };
+            out[i] = Vec3f{ r.x, r.y, r.z };
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_SkinningQuatToMat4Loop)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+
+// Matrices computed beforehand, 64 bytes per vertex instead of 16
+static void BM_SkinningMat4Loop(benchmark::State& state) {
+    auto in = make_vectors(state.range(0));
+    auto q = make_rotations(in.size());
+    std::vector<Mat4f> m(in.size());
+    for (std::size_t i = 0; i < in.size(); ++i)
+        m[i] = q[i].to_mat4();
+    std::vector<Vec3f> out(in.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            auto r = m[i] * Vec4f{ in[i].x, in[i].y, in[i].z, 0.f };
+            out[i] = Vec3f{ r.x, r.y, r.z };
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_SkinningMat4Loop)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+
+static void BM_SkinningQuatLoop(benchmark::State& state) {
+    auto in = make_vectors(state.range(0));
+    auto q = make_rotations(in.size());
+    std::vector<Vec3f> out(in.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = q[i].rotate(in[i]);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_SkinningQuatLoop)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+
+static void BM_SkinningRotateVectors(benchmark::State& state) {
+    auto in = make_vectors(state.range(0));
+    auto q = make_rotations(in.size());
+    std::vector<Vec3f> out(in.size());
+    for (auto _ : state) {
+        rotate_vectors(q, in, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_SkinningRotateVectors)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+
+// One rotation for every vector
+static void BM_TransformDirections(benchmark::State& state) {
+    auto in = make_vectors(state.range(0));
+    auto m = make_rotations(1)[0].to_mat4();
+    std::vector<Vec3f> out(in.size());
+    for (auto _ : state) {
+        transform_directions(m, in, out, store_policy::cached);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_TransformDirections)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+
+static void BM_RotateVectors(benchmark::State& state) {
+    auto in = make_vectors(state.range(0));
+    auto q = make_rotations(1)[0];
+    std::vector<Vec3f> out(in.size());
+    for (auto _ : state) {
+        rotate_vectors(q, in, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_RotateVectors)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+
+// Composing bone rotations down a chain
+static void BM_ComposeMat4(benchmark::State& state) {
+    auto q = make_rotations(1024);
+    std::vector<Mat4f> m(q.size());
+    for (std::size_t i = 0; i < q.size(); ++i)
+        m[i] = q[i].to_mat4();
+    for (auto _ : state) {
+        for (std::size_t i = 1; i < m.size(); ++i)
+            m[i] = m[i - 1] * m[i];
+        benchmark::DoNotOptimize(m.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * (m.size() - 1));
+}
+
+BENCHMARK(BM_ComposeMat4);
+
+static void BM_ComposeQuat(benchmark::State& state) {
+    auto q = make_rotations(1024);
+    for (auto _ : state) {
+        for (std::size_t i = 1; i < q.size(); ++i)
+            q[i] = q[i - 1] * q[i];
+        benchmark::DoNotOptimize(q.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * (q.size() - 1));
+}
+
+BENCHMARK(BM_ComposeQuat);
+
+BENCHMARK_MAIN();
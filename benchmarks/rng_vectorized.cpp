@@ -1,3 +1,8 @@
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <vector>
+
 #include <benchmark/benchmark.h>
 
 #include <yavl/yavl.h>
@@ -17,4 +22,232 @@ static void BM_Pcg32Generate8(benchmark::State& state) {
 
 BENCHMARK(BM_Pcg32Generate8);
 
+// Bytes per second of the bulk fills against next_floats in a loop, over
+// sizes from in cache to well past it
+
+static void BM_NextFloatsLoop(benchmark::State& state) {
+    pcg32x<8> rng;
+    std::vector<float> out(state.range(0));
+    std::array<float, 8> result;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < out.size(); i += 8) {
+            rng.next_floats(result);
+            std::copy(result.begin(), result.end(), out.begin() + i);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * out.size() * sizeof(float));
+}
+
+BENCHMARK(BM_NextFloatsLoop)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+template <typename T, typename F>
+static void fill_benchmark(benchmark::State& state, const F& fill) {
+    pcg32x<8> rng;
+    std::vector<T, aligned_allocator<T>> out(state.range(0));
+    for (auto _ : state) {
+        fill(rng, std::span<T>(out));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * out.size() * sizeof(T));
+}
+
+static void BM_FillUniformFloat(benchmark::State& state, const store_policy policy) {
+    fill_benchmark<float>(state, [&](auto& rng, auto out) {
+        rng.fill_uniform_float(out, policy);
+    });
+}
+
+BENCHMARK_CAPTURE(BM_FillUniformFloat, cached, store_policy::cached)
+    ->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK_CAPTURE(BM_FillUniformFloat, streaming, store_policy::streaming)
+    ->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+static void BM_FillUniformDouble(benchmark::State& state) {
+    fill_benchmark<double>(state, [](auto& rng, auto out) {
+        rng.fill_uniform_double(out);
+    });
+}
+
+BENCHMARK(BM_FillUniformDouble)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+static void BM_FillUint32(benchmark::State& state) {
+    fill_benchmark<uint32_t>(state, [](auto& rng, auto out) {
+        rng.fill_uint32(out);
+    });
+}
+
+BENCHMARK(BM_FillUint32)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+static void BM_FillUint32Bounded(benchmark::State& state) {
+    fill_benchmark<uint32_t>(state, [](auto& rng, auto out) {
+        rng.fill_uint32_bounded(out, 1000u);
+    });
+}
+
+BENCHMARK(BM_FillUint32Bounded)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// Bounded draws and shuffles against the modulo based scalar ones
+
+static void BM_Pcg32NextUintBounded(benchmark::State& state) {
+    pcg32 rng;
+    for (auto _ : state) {
+        static_for<1000>([&](const auto i) {
+            benchmark::DoNotOptimize(rng.next_uint(1000u));
+        });
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+BENCHMARK(BM_Pcg32NextUintBounded);
+
+template <uint32_t N>
+static void BM_Pcg32xNextUintsBounded(benchmark::State& state) {
+    pcg32x<N> rng;
+    std::array<uint32_t, N> result;
+    for (auto _ : state) {
+        static_for<1000 / N>([&](const auto i) {
+            rng.next_uints(result, 1000u);
+            benchmark::DoNotOptimize(result);
+        });
+    }
+    state.SetItemsProcessed(state.iterations() * (1000 / N) * N);
+}
+
+BENCHMARK_TEMPLATE(BM_Pcg32xNextUintsBounded, 8);
+BENCHMARK_TEMPLATE(BM_Pcg32xNextUintsBounded, 16);
+
+static void BM_Pcg32Shuffle(benchmark::State& state) {
+    pcg32 rng;
+    std::vector<uint32_t> values(state.range(0));
+    std::iota(values.begin(), values.end(), 0u);
+    for (auto _ : state) {
+        rng.shuffle(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(BM_Pcg32Shuffle)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+template <uint32_t N>
+static void BM_Pcg32xShuffle(benchmark::State& state) {
+    pcg32x<N> rng;
+    std::vector<uint32_t> values(state.range(0));
+    std::iota(values.begin(), values.end(), 0u);
+    for (auto _ : state) {
+        rng.shuffle(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK_TEMPLATE(BM_Pcg32xShuffle, 8)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Pcg32xShuffle, 16)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// Samplers against scalar Box-Muller and sphere sampling on pcg32
+
+template <typename T, typename F>
+static void sample_benchmark(benchmark::State& state, const F& sample) {
+    pcg32x<8> rng;
+    std::vector<T> out(state.range(0));
+    for (auto _ : state) {
+        sample(rng, std::span<T>(out));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+static void BM_Pcg32Normal(benchmark::State& state) {
+    pcg32 rng;
+    std::vector<float> out(state.range(0));
+    for (auto _ : state) {
+        for (std::size_t i = 0; i + 1 < out.size(); i += 2) {
+            float r = std::sqrt(-2.f * std::log(1.f - rng.next_float()));
+            float phi = 2.f * std::numbers::pi_v<float> * rng.next_float();
+            out[i] = r * std::cos(phi);
+            out[i + 1] = r * std::sin(phi);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+BENCHMARK(BM_Pcg32Normal)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_FillNormal(benchmark::State& state) {
+    sample_benchmark<float>(state, [](auto& rng, auto out) { fill_normal(rng, out); });
+}
+
+BENCHMARK(BM_FillNormal)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_FillExponential(benchmark::State& state) {
+    sample_benchmark<float>(state, [](auto& rng, auto out) { fill_exponential(rng, out); });
+}
+
+BENCHMARK(BM_FillExponential)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_Pcg32Sphere(benchmark::State& state) {
+    pcg32 rng;
+    std::vector<Vec3f> out(state.range(0));
+    for (auto _ : state) {
+        for (auto& d : out) {
+            float z = 1.f - 2.f * rng.next_float();
+            float r = std::sqrt(std::max(0.f, 1.f - z * z));
+            float phi = 2.f * std::numbers::pi_v<float> * rng.next_float();
+            d = Vec3f{ r * std::cos(phi), r * std::sin(phi), z };
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+BENCHMARK(BM_Pcg32Sphere)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_SampleSphere(benchmark::State& state) {
+    sample_benchmark<Vec3f>(state, [](auto& rng, auto out) { sample_sphere(rng, out); });
+}
+
+BENCHMARK(BM_SampleSphere)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_SampleSphereSoA(benchmark::State& state) {
+    pcg32x<8> rng;
+    std::vector<float> x(state.range(0)), y(x.size()), z(x.size());
+    for (auto _ : state) {
+        sample_sphere(rng, { std::span<float>(x), std::span<float>(y), std::span<float>(z) });
+        benchmark::DoNotOptimize(x.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+BENCHMARK(BM_SampleSphereSoA)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_SampleHemisphere(benchmark::State& state) {
+    sample_benchmark<Vec3f>(state, [](auto& rng, auto out) { sample_hemisphere(rng, out); });
+}
+
+BENCHMARK(BM_SampleHemisphere)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_SampleCosineHemisphere(benchmark::State& state) {
+    sample_benchmark<Vec3f>(state, [](auto& rng, auto out) {
+        sample_cosine_hemisphere(rng, out);
+    });
+}
+
+BENCHMARK(BM_SampleCosineHemisphere)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_SampleDisk(benchmark::State& state) {
+    sample_benchmark<Vec2f>(state, [](auto& rng, auto out) { sample_disk(rng, out); });
+}
+
+BENCHMARK(BM_SampleDisk)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,573 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Throughput of the vec/mat/rng ops, reductions and 16 bit storage over
+// arrays. Every benchmark streams through a working set sized for one
+// level of the memory hierarchy, so the numbers are elements per second
+// of a production loop rather than the latency of one op on values held
+// in registers.
+//
+// Names are <group>.<op>/<layout>/<level>, elements/s and bytes/s are the
+// counters benchmarks/throughput.py compares and turns into the README
+// table:
+//
+//   throughput --benchmark_out=new.json --benchmark_out_format=json
+//   python3 benchmarks/throughput.py compare old.json new.json
+//   python3 benchmarks/throughput.py table new.json --readme README.md
+
+struct working_set {
+    const char* name;
+    std::size_t bytes;
+};
+
+// Half of each cache level leaves room for everything else touching it,
+// the DRAM set is well past the last level. Sizes are the ones the
+// benchmark library reports, with common values when it doesn't know
+static std::vector<working_set> working_sets() {
+    std::size_t cache[3] = { 32 << 10, 1 << 20, 32 << 20 };
+    for (const auto& c : benchmark::CPUInfo::Get().caches) {
+        if (c.type != "Instruction" && c.level >= 1 && c.level <= 3)
+            cache[c.level - 1] = c.size;
+    }
+    return {
+        { "L1", cache[0] / 2 },
+        { "L2", cache[1] / 2 },
+        { "L3", cache[2] / 2 },
+        { "DRAM", std::max<std::size_t>(cache[2] * 4, 256 << 20) }
+    };
+}
+
+static void set_counters(benchmark::State& state, const std::size_t n,
+    const std::size_t element_bytes)
+{
+    using benchmark::Counter;
+    state.counters["elements/s"] = Counter(static_cast<double>(n),
+        Counter::kIsIterationInvariantRate);
+    state.counters["bytes/s"] = Counter(static_cast<double>(n * element_bytes),
+        Counter::kIsIterationInvariantRate, Counter::OneK::kIs1024);
+    state.counters["working_set"] = static_cast<double>(n * element_bytes);
+}
+
+// Positive, non trivial values so sqrt, rsqrt and division stay on the
+// fast path
+static float value(const std::size_t i, const uint32_t c, const float seed) {
+    return std::sin(i * 0.37f + c * 1.3f + seed) + 1.5f;
+}
+
+// Data layouts, map() applies f to the elements of a and b and writes
+// out, reduce() writes a float per element
+
+template <typename V>
+struct aos {
+    using Data = std::vector<V>;
+    static constexpr std::size_t element_bytes = sizeof(V);
+
+    static Data make(const std::size_t n, const float seed) {
+        Data d(n);
+        for (std::size_t i = 0; i < n; ++i)
+            for (uint32_t c = 0; c < V::Size; ++c)
+                d[i][c] = value(i, c, seed);
+        return d;
+    }
+
+    template <typename F>
+    static void map(const Data& a, const Data& b, Data& out, const F& f) {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = f(a[i], b[i]);
+    }
+
+    template <typename F>
+    static void reduce(const Data& a, const Data& b, float* out, const F& f) {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = f(a[i], b[i]);
+    }
+};
+
+// One stream per component walked a native packet at a time
+template <uint32_t N>
+struct soa {
+    using Data = VecArray<float, N>;
+    static constexpr std::size_t element_bytes = N * sizeof(float);
+    static constexpr uint32_t W = native_width<float>;
+
+    static Data make(const std::size_t n, const float seed) {
+        Data d(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            Vec<float, N> v;
+            for (uint32_t c = 0; c < N; ++c)
+                v[c] = value(i, c, seed);
+            d.set(i, v);
+        }
+        return d;
+    }
+
+    template <typename F>
+    static void map(const Data& a, const Data& b, Data& out, const F& f) {
+        for (std::size_t i = 0; i < a.size(); i += W)
+            out.template store<W>(i, f(a.template load<W>(i), b.template load<W>(i)));
+    }
+
+    template <typename F>
+    static void reduce(const Data& a, const Data& b, float* out, const F& f) {
+        for (std::size_t i = 0; i < a.size(); i += W)
+            store_packet(out + i, f(a.template load<W>(i), b.template load<W>(i)));
+    }
+};
+
+// Records of N floats back to back as read from a file, seen through a
+// VecView. Only the transforms use it
+template <uint32_t N>
+struct packed {
+    using Data = std::vector<float>;
+    static constexpr std::size_t element_bytes = N * sizeof(float);
+
+    static Data make(const std::size_t n, const float seed) {
+        Data d(n * N);
+        for (std::size_t i = 0; i < n; ++i)
+            for (uint32_t c = 0; c < N; ++c)
+                d[i * N + c] = value(i, c, seed);
+        return d;
+    }
+};
+
+// Vec ops, b is read by the binary ops and the reductions only
+
+template <typename L, typename F>
+static void bm_vec_binary(benchmark::State& state, const std::size_t bytes, const F& f) {
+    const auto n = bytes / (3 * L::element_bytes);
+    auto a = L::make(n, 0.f), b = L::make(n, 1.f), out = L::make(n, 2.f);
+    for (auto _ : state) {
+        L::map(a, b, out, f);
+        benchmark::DoNotOptimize(out);
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, 3 * L::element_bytes);
+}
+
+template <typename L, typename F>
+static void bm_vec_unary(benchmark::State& state, const std::size_t bytes, const F& f) {
+    const auto n = bytes / (2 * L::element_bytes);
+    auto a = L::make(n, 0.f), out = L::make(n, 2.f);
+    for (auto _ : state) {
+        L::map(a, a, out, [&](const auto& x, const auto&) { return f(x); });
+        benchmark::DoNotOptimize(out);
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, 2 * L::element_bytes);
+}
+
+template <typename L, typename F>
+static void bm_vec_reduce(benchmark::State& state, const std::size_t bytes, const F& f) {
+    const auto element_bytes = 2 * L::element_bytes + sizeof(float);
+    const auto n = bytes / element_bytes;
+    auto a = L::make(n, 0.f), b = L::make(n, 1.f);
+    // Packet stores at the tail may run past n
+    std::vector<float> out(n + 64);
+    for (auto _ : state) {
+        L::reduce(a, b, out.data(), f);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, element_bytes);
+}
+
+template <typename Fn>
+static void add(const std::string& name, const working_set& ws, const Fn& fn) {
+    benchmark::RegisterBenchmark((name + "/" + ws.name).c_str(),
+        [=](benchmark::State& state) { fn(state, ws.bytes); });
+}
+
+template <typename L, bool HasCross>
+static void register_vec(const std::string& layout, const working_set& ws) {
+    auto binary = [&](const char* op, auto f) {
+        add(std::string("vec.") + op + "/" + layout, ws,
+            [=](auto& state, auto bytes) { bm_vec_binary<L>(state, bytes, f); });
+    };
+    auto unary = [&](const char* op, auto f) {
+        add(std::string("vec.") + op + "/" + layout, ws,
+            [=](auto& state, auto bytes) { bm_vec_unary<L>(state, bytes, f); });
+    };
+    auto reduce = [&](const char* op, auto f) {
+        add(std::string("vec.") + op + "/" + layout, ws,
+            [=](auto& state, auto bytes) { bm_vec_reduce<L>(state, bytes, f); });
+    };
+
+    binary("add", [](const auto& a, const auto& b) { return a + b; });
+    binary("sub", [](const auto& a, const auto& b) { return a - b; });
+    binary("mul", [](const auto& a, const auto& b) { return a * b; });
+    binary("div", [](const auto& a, const auto& b) { return a / b; });
+    binary("lerp", [](const auto& a, const auto& b) { return a.lerp(b, 0.25f); });
+    if constexpr (HasCross)
+        binary("cross", [](const auto& a, const auto& b) { return a.cross(b); });
+    unary("abs", [](const auto& a) { return a.abs(); });
+    unary("sqrt", [](const auto& a) { return a.sqrt(); });
+    unary("rsqrt", [](const auto& a) { return a.rsqrt(); });
+    unary("rcp", [](const auto& a) { return a.rcp(); });
+    unary("normalize", [](const auto& a) { return a.normalized(); });
+    reduce("dot", [](const auto& a, const auto& b) { return a.dot(b); });
+    reduce("length", [](const auto& a, const auto&) { return a.length(); });
+
+    // The other precisions of the ops above, which run with the default
+    // one(standard for rcp, rsqrt and VecSoA normalize, exact for the rest)
+    binary("div_fast",
+        [](const auto& a, const auto& b) { return a.template div<precision::fast>(b); });
+    binary("div_standard",
+        [](const auto& a, const auto& b) { return a.template div<precision::standard>(b); });
+    unary("rsqrt_fast", [](const auto& a) { return a.template rsqrt<precision::fast>(); });
+    unary("rsqrt_exact", [](const auto& a) { return a.template rsqrt<precision::exact>(); });
+    unary("rcp_fast", [](const auto& a) { return a.template rcp<precision::fast>(); });
+    unary("rcp_exact", [](const auto& a) { return a.template rcp<precision::exact>(); });
+    unary("normalize_fast",
+        [](const auto& a) { return a.template normalized<precision::fast>(); });
+    unary("normalize_standard",
+        [](const auto& a) { return a.template normalized<precision::standard>(); });
+    reduce("length_fast",
+        [](const auto& a, const auto&) { return a.template length<precision::fast>(); });
+    reduce("length_standard",
+        [](const auto& a, const auto&) { return a.template length<precision::standard>(); });
+}
+
+// Mat ops, a constant matrix against an array of vectors or an array of
+// matrices against another
+
+static const Mat4f xform{
+    0.8f, 0.3f, -0.2f, 0.f,
+    -0.4f, 1.5f, 0.6f, 0.f,
+    0.1f, -0.7f, 2.f, 0.f,
+    3.f, -2.f, 1.f, 1.f
+};
+
+template <typename M>
+static std::vector<M> make_mats(const std::size_t n, const float seed) {
+    std::vector<M> m(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (uint32_t e = 0; e < M::Size2; ++e)
+            m[i].data()[e] = value(i, e, seed) - 1.5f;
+        // Keep them invertible
+        for (uint32_t d = 0; d < M::Size; ++d)
+            m[i].data()[d * M::Size + d] += 4.f;
+    }
+    return m;
+}
+
+// out[i] = f(a[i], b[i]) over matrices, Out is Mat or float
+template <typename M, typename Out, typename F>
+static void bm_mat_map(benchmark::State& state, const std::size_t bytes, const F& f) {
+    const auto element_bytes = 2 * sizeof(M) + sizeof(Out);
+    const auto n = bytes / element_bytes;
+    auto a = make_mats<M>(n, 0.f), b = make_mats<M>(n, 1.f);
+    std::vector<Out> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = f(a[i], b[i]);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, element_bytes);
+}
+
+// f(a, b, out) over whole arrays, for the batch apis
+template <typename M, typename F>
+static void bm_mat_batch(benchmark::State& state, const std::size_t bytes, const F& f) {
+    const auto element_bytes = 3 * sizeof(M);
+    const auto n = bytes / element_bytes;
+    auto a = make_mats<M>(n, 0.f), b = make_mats<M>(n, 1.f);
+    std::vector<M> out(n);
+    for (auto _ : state) {
+        f(std::span<const M>(a), std::span<const M>(b), std::span<M>(out));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, element_bytes);
+}
+
+// Packs of native_width matrices, converted once outside of the loop
+static void bm_mat4_soa_mul(benchmark::State& state, const std::size_t bytes) {
+    constexpr uint32_t W = native_width<float>;
+    const auto n = bytes / (3 * sizeof(Mat4f)) / W * W;
+    auto a = make_mats<Mat4f>(n, 0.f), b = make_mats<Mat4f>(n, 1.f);
+    std::vector<Mat4fSoA> pa(n / W), pb(n / W), out(n / W);
+    for (std::size_t i = 0; i < pa.size(); ++i) {
+        pa[i] = Mat4fSoA::load(a.data() + i * W);
+        pb[i] = Mat4fSoA::load(b.data() + i * W);
+    }
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < pa.size(); ++i)
+            out[i] = pa[i] * pb[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, 3 * sizeof(Mat4f));
+}
+
+template <typename L, typename F>
+static void bm_mat_transform(benchmark::State& state, const std::size_t bytes, const F& f) {
+    const auto n = bytes / (2 * L::element_bytes);
+    auto in = L::make(n, 0.f), out = L::make(n, 2.f);
+    for (auto _ : state) {
+        f(in, out);
+        benchmark::DoNotOptimize(out);
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, 2 * L::element_bytes);
+}
+
+static void register_mat(const working_set& ws) {
+    using namespace std::string_literals;
+
+    auto transform = [&](const std::string& name, auto layout, auto f) {
+        using L = decltype(layout);
+        add(name, ws, [=](auto& state, auto bytes) { bm_mat_transform<L>(state, bytes, f); });
+    };
+    transform("mat4.mul_vec/aos4", aos<Vec4f>{}, [](const auto& in, auto& out) {
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = xform * in[i];
+    });
+    transform("mat4.mul_vec/soa4", soa<4>{}, [](const auto& in, auto& out) {
+        constexpr uint32_t W = native_width<float>;
+        const Mat4fSoA m(xform);
+        for (std::size_t i = 0; i < in.size(); i += W)
+            out.template store<W>(i, m * in.template load<W>(i));
+    });
+    transform("mat4.transform_points/aos3", aos<Vec3f>{}, [](const auto& in, auto& out) {
+        transform_points(xform, std::span<const Vec3f>(in), std::span<Vec3f>(out));
+    });
+    transform("mat4.transform_points/packed3", packed<3>{}, [](const auto& in, auto& out) {
+        const std::size_t n = in.size() / 3;
+        transform_points(xform, Vec3fView(in.data(), n), Vec3fView(out.data(), n));
+    });
+    transform("mat4.transform_points/aos4", aos<Vec4f>{}, [](const auto& in, auto& out) {
+        transform_points(xform, std::span<const Vec4f>(in), std::span<Vec4f>(out));
+    });
+    transform("mat3.mul_vec/aos3", aos<Vec3f>{}, [](const auto& in, auto& out) {
+        const Mat3f m{ 0.8f, 0.3f, -0.2f, -0.4f, 1.5f, 0.6f, 0.1f, -0.7f, 2.f };
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = m * in[i];
+    });
+
+    auto map = [&](const std::string& name, auto mat, auto out, auto f) {
+        using M = decltype(mat);
+        using Out = decltype(out);
+        add(name, ws, [=](auto& state, auto bytes) { bm_mat_map<M, Out>(state, bytes, f); });
+    };
+    map("mat4.mul_mat/aos", Mat4f{}, Mat4f{}, [](const auto& a, const auto& b) { return a * b; });
+    map("mat4.transpose/aos", Mat4f{}, Mat4f{}, [](const auto& a, const auto&) { return a.transpose(); });
+    map("mat4.inverse/aos", Mat4f{}, Mat4f{}, [](const auto& a, const auto&) { return a.inverse().second; });
+    map("mat4.inverse_fast/aos", Mat4f{}, Mat4f{}, [](const auto& a, const auto&) {
+        return a.template inverse<precision::fast>().second;
+    });
+    map("mat4.inverse_standard/aos", Mat4f{}, Mat4f{}, [](const auto& a, const auto&) {
+        return a.template inverse<precision::standard>().second;
+    });
+    map("mat4.determinant/aos", Mat4f{}, 0.f, [](const auto& a, const auto&) { return a.determinant(); });
+    map("mat3.mul_mat/aos", Mat3f{}, Mat3f{}, [](const auto& a, const auto& b) { return a * b; });
+    map("mat3.transpose/aos", Mat3f{}, Mat3f{}, [](const auto& a, const auto&) { return a.transpose(); });
+
+    add("mat4.multiply/aos"s, ws, [](auto& state, auto bytes) {
+        bm_mat_batch<Mat4f>(state, bytes, [](auto a, auto b, auto out) { multiply(a, b, out); });
+    });
+    add("mat4.inverse_batch/aos"s, ws, [](auto& state, auto bytes) {
+        bm_mat_batch<Mat4f>(state, bytes, [](auto a, auto, auto out) { inverse(a, out); });
+    });
+    add("mat4.mul_mat/soa"s, ws, bm_mat4_soa_mul);
+}
+
+// Rng fills, the output array is the whole working set
+
+template <typename T, typename F>
+static void bm_rng_fill(benchmark::State& state, const std::size_t bytes, const F& f) {
+    const auto n = bytes / sizeof(T) / 64 * 64;
+    std::vector<T> out(n);
+    pcg32x<8> rng;
+    for (auto _ : state) {
+        f(rng, std::span<T>(out));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, sizeof(T));
+}
+
+static void bm_rng_scalar(benchmark::State& state, const std::size_t bytes) {
+    const auto n = bytes / sizeof(float);
+    std::vector<float> out(n);
+    pcg32 rng;
+    for (auto _ : state) {
+        for (auto& r : out)
+            r = rng.next_float();
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, sizeof(float));
+}
+
+static void bm_rng_sphere_soa(benchmark::State& state, const std::size_t bytes) {
+    const auto n = bytes / (3 * sizeof(float)) / 64 * 64;
+    std::vector<float> x(n), y(n), z(n);
+    pcg32x<8> rng;
+    for (auto _ : state) {
+        sample_sphere(rng, std::array<std::span<float>, 3>{ x, y, z });
+        benchmark::DoNotOptimize(x.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, 3 * sizeof(float));
+}
+
+static void register_rng(const working_set& ws) {
+    auto fill = [&](const std::string& name, auto t, auto f) {
+        using T = decltype(t);
+        add(name, ws, [=](auto& state, auto bytes) { bm_rng_fill<T>(state, bytes, f); });
+    };
+    add("rng.next_float/pcg32", ws, bm_rng_scalar);
+    fill("rng.uniform_float/pcg32x8", 0.f, [](auto& rng, auto out) { rng.fill_uniform_float(out); });
+    fill("rng.uniform_double/pcg32x8", 0., [](auto& rng, auto out) { rng.fill_uniform_double(out); });
+    fill("rng.uint32/pcg32x8", 0u, [](auto& rng, auto out) { rng.fill_uint32(out); });
+    fill("rng.uint32_bounded/pcg32x8", 0u, [](auto& rng, auto out) { rng.fill_uint32_bounded(out, 1000u); });
+    fill("rng.normal/pcg32x8", 0.f, [](auto& rng, auto out) { fill_normal(rng, out); });
+    fill("rng.exponential/pcg32x8", 0.f, [](auto& rng, auto out) { fill_exponential(rng, out); });
+    fill("rng.sphere/aos3", Vec3f{}, [](auto& rng, auto out) { sample_sphere(rng, out); });
+    add("rng.sphere/soa3", ws, bm_rng_sphere_soa);
+}
+
+// Array reductions, the input is the whole working set and the _loop
+// variants are the one accumulator loops the compiler makes of them
+
+template <typename T, typename F>
+static void bm_reduce(benchmark::State& state, const std::size_t bytes, const F& f) {
+    const auto n = bytes / sizeof(T);
+    std::vector<T> a(n);
+    for (std::size_t i = 0; i < n; ++i)
+        for (uint32_t c = 0; c < sizeof(T) / sizeof(float); ++c)
+            reinterpret_cast<float*>(&a[i])[c] = value(i, c, 0.f);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f(std::span<const T>(a)));
+    set_counters(state, n, sizeof(T));
+}
+
+static void register_reduce(const working_set& ws) {
+    auto reduce = [&](const std::string& name, auto t, auto f) {
+        using T = decltype(t);
+        add(name, ws, [=](auto& state, auto bytes) { bm_reduce<T>(state, bytes, f); });
+    };
+    reduce("reduce.sum/float", 0.f, [](auto a) { return sum(a); });
+    reduce("reduce.sum_kahan/float", 0.f, [](auto a) { return sum<summation::kahan>(a); });
+    reduce("reduce.sum_loop/float", 0.f, [](auto a) {
+        return std::accumulate(a.begin(), a.end(), 0.f);
+    });
+    reduce("reduce.min/float", 0.f, [](auto a) { return min(a); });
+    reduce("reduce.argmin/float", 0.f, [](auto a) { return argmin(a); });
+    reduce("reduce.dot/float", 0.f, [](auto a) { return dot(a, a); });
+    reduce("reduce.sum/aos3", Vec3f{}, [](auto a) { return sum(a); });
+    reduce("reduce.bounds/aos3", Vec3f{}, [](auto a) { return bounds(a); });
+    reduce("reduce.bounds_loop/aos3", Vec3f{}, [](auto a) {
+        float lo[3] = { INFINITY, INFINITY, INFINITY }, hi[3] = { -INFINITY, -INFINITY, -INFINITY };
+        for (const auto& v : a) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                lo[c] = std::min(lo[c], v[c]);
+                hi[c] = std::max(hi[c], v[c]);
+            }
+        }
+        return lo[0] + lo[1] + lo[2] + hi[0] + hi[1] + hi[2];
+    });
+    reduce("reduce.covariance/aos3", Vec3f{}, [](auto a) { return covariance(a); });
+}
+
+// 16 bit storage. Conversions between whole arrays, and reduce.sum and
+// mat4.mul_vec of the groups above reading and writing half instead of
+// float while computing in float. bytes/s is the memory traffic, the
+// savings show in elements/s once the set is out of the caches
+
+template <typename From, typename To>
+static void bm_convert(benchmark::State& state, const std::size_t bytes) {
+    const auto element_bytes = sizeof(From) + sizeof(To);
+    const auto n = bytes / element_bytes;
+    std::vector<float> values(n);
+    for (std::size_t i = 0; i < n; ++i)
+        values[i] = value(i, 0, 0.f);
+    std::vector<From> in(n);
+    std::vector<To> out(n);
+    if constexpr (std::is_same_v<From, float>)
+        in = values;
+    else
+        convert(values, in);
+    for (auto _ : state) {
+        if constexpr (std::is_same_v<From, To>)
+            std::copy(in.begin(), in.end(), out.begin());
+        else
+            convert(std::span<const From>(in), std::span<To>(out));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, element_bytes);
+}
+
+// Widened a block at a time into a buffer that stays in L1
+static void bm_sum_half(benchmark::State& state, const std::size_t bytes) {
+    const auto n = bytes / sizeof(half);
+    std::vector<half> a(n);
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] = half(value(i, 0, 0.f));
+    for (auto _ : state) {
+        float block[1024], total = 0.f;
+        for (std::size_t i = 0; i < n; i += 1024) {
+            const auto m = std::min<std::size_t>(1024, n - i);
+            convert(std::span<const half>(a.data() + i, m), std::span<float>(block, m));
+            total += sum(std::span<const float>(block, m));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_counters(state, n, sizeof(half));
+}
+
+static void bm_mul_vec_half(benchmark::State& state, const std::size_t bytes) {
+    const auto n = bytes / (2 * sizeof(Vec4h));
+    std::vector<Vec4h> in(n), out(n);
+    for (std::size_t i = 0; i < n; ++i)
+        in[i] = Vec4h(value(i, 0, 0.f), value(i, 1, 0.f), value(i, 2, 0.f), 1.f);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = narrow<half>(xform * widen(in[i]));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, n, 2 * sizeof(Vec4h));
+}
+
+static void register_half(const working_set& ws) {
+    add("half.copy/float", ws, bm_convert<float, float>);
+    add("half.widen/half", ws, bm_convert<half, float>);
+    add("half.narrow/half", ws, bm_convert<float, half>);
+    add("half.widen/bfloat16", ws, bm_convert<bfloat16, float>);
+    add("half.narrow/bfloat16", ws, bm_convert<float, bfloat16>);
+    add("reduce.sum/half", ws, bm_sum_half);
+    add("mat4.mul_vec/aos4h", ws, bm_mul_vec_half);
+}
+
+int main(int argc, char** argv) {
+    for (const auto& ws : working_sets()) {
+        register_vec<aos<Vec3f>, true>("aos3", ws);
+        register_vec<aos<Vec4f>, false>("aos4", ws);
+        register_vec<soa<3>, true>("soa3", ws);
+        register_mat(ws);
+        register_rng(ws);
+        register_reduce(ws);
+        register_half(ws);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
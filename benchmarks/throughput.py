@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Regression comparison and README tables for the throughput benchmarks.
+
+Both commands read the google benchmark JSON written by
+
+    throughput --benchmark_out=run.json --benchmark_out_format=json
+
+compare  prints the elements/s ratio of every benchmark found in both runs
+         and exits with 1 when one got slower than the threshold allows.
+table    prints one markdown table per group(vec, mat, rng, reduce, half) in million
+         elements/s, with --readme the tables replace the block between
+         the throughput markers of that file instead.
+"""
+
+import argparse
+import json
+import re
+import sys
+from collections import OrderedDict
+
+LEVELS = ["L1", "L2", "L3", "DRAM"]
+BEGIN = "<!-- throughput:begin -->"
+END = "<!-- throughput:end -->"
+
+
+def load(path):
+    """name -> elements/s, the median of repeated runs when present."""
+    with open(path) as f:
+        data = json.load(f)
+    rates, medians = {}, {}
+    for b in data["benchmarks"]:
+        if "elements/s" not in b:
+            continue
+        name = b.get("run_name", b["name"])
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[name] = b["elements/s"]
+        else:
+            rates.setdefault(name, b["elements/s"])
+    rates.update(medians)
+    return data.get("context", {}), rates
+
+
+def compare(args):
+    _, base = load(args.baseline)
+    _, new = load(args.contender)
+    names = [n for n in base if n in new]
+    if not names:
+        print("no common benchmarks", file=sys.stderr)
+        return 1
+
+    width = max(len(n) for n in names)
+    regressions = 0
+    print(f"{'benchmark':<{width}}  {'baseline':>12}  {'contender':>12}  ratio")
+    for n in names:
+        ratio = new[n] / base[n]
+        flag = ""
+        if ratio < 1.0 - args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif ratio > 1.0 + args.threshold:
+            flag = "  improved"
+        print(f"{n:<{width}}  {base[n] / 1e6:>10.1f}M  {new[n] / 1e6:>10.1f}M  "
+              f"{ratio:5.2f}{flag}")
+
+    missing = sorted(set(base) ^ set(new))
+    if missing:
+        print(f"\n{len(missing)} benchmarks are only in one of the runs")
+    print(f"\n{regressions} of {len(names)} slower by more than "
+          f"{args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+def tables(rates, context):
+    """Markdown tables keyed by group, rows op/layout and columns levels."""
+    groups = OrderedDict()
+    pattern = re.compile(r"^(\w+)\.(\w+)/(\w+)/(\w+)$")
+    for name, rate in rates.items():
+        m = pattern.match(name)
+        if not m:
+            continue
+        group, op, layout, level = m.groups()
+        row = groups.setdefault(group, OrderedDict()).setdefault(f"{op} {layout}", {})
+        row[level] = rate
+
+    lines = []
+    cpu = f"{context.get('num_cpus', '?')} x {context.get('mhz_per_cpu', '?')} MHz"
+    caches = ", ".join(
+        f"L{c['level']} {c['type'].lower()} {c['size'] // 1024} KiB"
+        for c in context.get("caches", []) if c["type"] != "Instruction")
+    lines.append(f"Million elements per second, {cpu}({caches}), "
+                 f"{context.get('library_build_type', 'unknown')} benchmark library.")
+    for group, rows in groups.items():
+        lines.append("")
+        lines.append(f"#### {group}")
+        lines.append("")
+        lines.append("| Op | " + " | ".join(LEVELS) + " |")
+        lines.append("|:---|" + "|".join("-----:" for _ in LEVELS) + "|")
+        for row, values in rows.items():
+            cells = [f"{values[l] / 1e6:.0f}" if l in values else "" for l in LEVELS]
+            lines.append(f"| {row} | " + " | ".join(cells) + " |")
+    return "\n".join(lines)
+
+
+def table(args):
+    context, rates = load(args.results)
+    text = tables(rates, context)
+    if not args.readme:
+        print(text)
+        return 0
+
+    with open(args.readme) as f:
+        readme = f.read()
+    begin, end = readme.find(BEGIN), readme.find(END)
+    if begin < 0 or end < begin:
+        print(f"{args.readme} has no {BEGIN} ... {END} block", file=sys.stderr)
+        return 1
+    readme = readme[:begin + len(BEGIN)] + "\n" + text + "\n" + readme[end:]
+    with open(args.readme, "w") as f:
+        f.write(readme)
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("compare", help="compare two runs")
+    p.add_argument("baseline")
+    p.add_argument("contender")
+    p.add_argument("--threshold", type=float, default=0.05,
+                   help="relative slowdown treated as a regression")
+    p.set_defaults(func=compare)
+
+    p = sub.add_parser("table", help="markdown tables of one run")
+    p.add_argument("results")
+    p.add_argument("--readme", help="file whose throughput block is replaced")
+    p.set_defaults(func=table)
+
+    args = parser.parse_args()
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
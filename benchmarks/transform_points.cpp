@@ -0,0 +1,72 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Points per second of transform_points against a Mat4f * Vec4f loop, over
+// sizes from in cache to well past it
+
+static const Mat4f xform{
+    0.8f, 0.3f, -0.2f, 0.f,
+    -0.4f, 1.5f, 0.6f, 0.f,
+    0.1f, -0.7f, 2.f, 0.f,
+    3.f, -2.f, 1.f, 1.f
+};
+
+static std::vector<Vec3f> make_points(const std::size_t n) {
+    std::vector<Vec3f> pts(n);
+    for (std::size_t i = 0; i < n; ++i)
+        pts[i] = Vec3f{ i * 0.5f, i * 0.25f, i * 0.125f };
+    return pts;
+}
+
+static void BM_TransformPointsLoop(benchmark::State& state) {
+    auto in = make_points(state.range(0));
+    std::vector<Vec3f> out(in.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            auto r = xform * Vec4f{ in[i].x, in[i].y, in[i].z, 1.f };
+            out[i] = Vec3f{ r.x, r.y, r.z };
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_TransformPointsLoop)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+static void BM_TransformPoints(benchmark::State& state, const store_policy policy) {
+    auto in = make_points(state.range(0));
+    std::vector<Vec3f> out(in.size());
+    for (auto _ : state) {
+        transform_points(xform, in, out, policy);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK_CAPTURE(BM_TransformPoints, cached, store_policy::cached)
+    ->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_CAPTURE(BM_TransformPoints, streaming, store_policy::streaming)
+    ->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+static void BM_TransformPoints4(benchmark::State& state) {
+    std::vector<Vec4f> in(state.range(0)), out(in.size());
+    for (std::size_t i = 0; i < in.size(); ++i)
+        in[i] = Vec4f{ i * 0.5f, i * 0.25f, i * 0.125f, 1.f };
+    for (auto _ : state) {
+        transform_points(xform, in, out, store_policy::cached);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+
+BENCHMARK(BM_TransformPoints4)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+BENCHMARK_MAIN();
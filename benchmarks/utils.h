@@ -19,4 +19,75 @@
       return ( (unsigned long long)lo)|( ((unsigned long long)hi)<<32 );
   }
   #endif
-#endif
\ No newline at end of file
+#endif
+
+// Serialized timestamps for the cycle harness(cycles.cpp). The lfence
+// before the first read keeps earlier instructions from leaking into the
+// measured region, rdtscp waits for the measured instructions to retire
+// and the lfence after each read keeps later ones from starting early.
+// Other archs read the virtual counter behind an isb, or the steady clock
+// in nanoseconds
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif
+  #define YAVL_TICK_UNIT "tsc"
+  static inline unsigned long long tick_begin() {
+      _mm_lfence();
+      unsigned long long t = __rdtsc();
+      _mm_lfence();
+      return t;
+  }
+
+  static inline unsigned long long tick_end() {
+      unsigned aux;
+      unsigned long long t = __rdtscp(&aux);
+      _mm_lfence();
+      return t;
+  }
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+  #define YAVL_TICK_UNIT "cntvct"
+  static inline unsigned long long tick_begin() {
+      unsigned long long t;
+      __asm__ __volatile__ ("isb\n\tmrs %0, cntvct_el0" : "=r"(t) : : "memory");
+      return t;
+  }
+
+  static inline unsigned long long tick_end() {
+      return tick_begin();
+  }
+#else
+  #include <chrono>
+  #define YAVL_TICK_UNIT "ns"
+  static inline unsigned long long tick_begin() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static inline unsigned long long tick_end() {
+      return tick_begin();
+  }
+#endif
+
+// Pins the calling thread to one cpu so the counters and the caches stay
+// put, cpu < 0 keeps the one it is running on. False when the os doesn't
+// support it
+#if defined(__linux__)
+  #include <sched.h>
+  static inline bool pin_to_cpu(int cpu) {
+      if (cpu < 0)
+          cpu = sched_getcpu();
+      if (cpu < 0)
+          return false;
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      return sched_setaffinity(0, sizeof(set), &set) == 0;
+  }
+#else
+  static inline bool pin_to_cpu(int) {
+      return false;
+  }
+#endif
@@ -0,0 +1,128 @@
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// a * b + c * d - e over arrays and the fallback Vec, evaluated one
+// operator at a time into temporaries and as a single lazy expression.
+// Per element the eager version does 8 loads and 4 stores, the lazy one
+// 5 loads and 1 store, bytes processed only count the latter so the rates
+// compare directly
+
+static std::vector<float> make_array(const std::size_t n, const float offset) {
+    std::vector<float> a(n);
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] = i * 0.001f + offset;
+    return a;
+}
+
+struct arrays {
+    std::vector<float> a, b, c, d, e, out;
+
+    arrays(const std::size_t n) : a(make_array(n, 1.f)), b(make_array(n, 2.f)),
+        c(make_array(n, 3.f)), d(make_array(n, 4.f)), e(make_array(n, 5.f)), out(n) {}
+};
+
+// One pass per operator, as array types without expression templates do
+template <typename F>
+static std::vector<float> eager(const std::vector<float>& x, const std::vector<float>& y,
+    const F& f)
+{
+    std::vector<float> r(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i)
+        r[i] = f(x[i], y[i]);
+    return r;
+}
+
+static void BM_EagerArrays(benchmark::State& state) {
+    arrays v(state.range(0));
+    auto mul = [](float x, float y) { return x * y; };
+    for (auto _ : state) {
+        auto ab = eager(v.a, v.b, mul);
+        auto cd = eager(v.c, v.d, mul);
+        auto sum = eager(ab, cd, [](float x, float y) { return x + y; });
+        v.out = eager(sum, v.e, [](float x, float y) { return x - y; });
+        benchmark::DoNotOptimize(v.out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * v.out.size() * 6 * sizeof(float));
+}
+
+BENCHMARK(BM_EagerArrays)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// Written out by hand and left to the auto-vectorizer, the lower bound
+static void BM_FusedLoop(benchmark::State& state) {
+    arrays v(state.range(0));
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < v.out.size(); ++i)
+            v.out[i] = v.a[i] * v.b[i] + v.c[i] * v.d[i] - v.e[i];
+        benchmark::DoNotOptimize(v.out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * v.out.size() * 6 * sizeof(float));
+}
+
+BENCHMARK(BM_FusedLoop)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+static void BM_LazyArrays(benchmark::State& state) {
+    arrays v(state.range(0));
+    for (auto _ : state) {
+        assign(v.out, lazy(v.a) * lazy(v.b) + lazy(v.c) * lazy(v.d) - lazy(v.e));
+        benchmark::DoNotOptimize(v.out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * v.out.size() * 6 * sizeof(float));
+}
+
+BENCHMARK(BM_LazyArrays)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// The fallback Vec, every operator returns a std::array temporary
+template <uint32_t N>
+struct vecs {
+    using V = Vec<float, N>;
+    V a, b, c, d, e, out;
+
+    vecs() {
+        for (uint32_t i = 0; i < N; ++i) {
+            a[i] = i * 0.001f + 1.f;
+            b[i] = i * 0.001f + 2.f;
+            c[i] = i * 0.001f + 3.f;
+            d[i] = i * 0.001f + 4.f;
+            e[i] = i * 0.001f + 5.f;
+        }
+    }
+};
+
+template <uint32_t N>
+static void BM_EagerVec(benchmark::State& state) {
+    auto v = std::make_unique<vecs<N>>();
+    for (auto _ : state) {
+        v->out = v->a * v->b + v->c * v->d - v->e;
+        benchmark::DoNotOptimize(v->out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * N * 6 * sizeof(float));
+}
+
+BENCHMARK_TEMPLATE(BM_EagerVec, 7);
+BENCHMARK_TEMPLATE(BM_EagerVec, 1024);
+
+template <uint32_t N>
+static void BM_LazyVec(benchmark::State& state) {
+    auto v = std::make_unique<vecs<N>>();
+    for (auto _ : state) {
+        v->out = eval(lazy(v->a) * lazy(v->b) + lazy(v->c) * lazy(v->d) - lazy(v->e));
+        benchmark::DoNotOptimize(v->out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * N * 6 * sizeof(float));
+}
+
+BENCHMARK_TEMPLATE(BM_LazyVec, 7);
+BENCHMARK_TEMPLATE(BM_LazyVec, 1024);
+
+BENCHMARK_MAIN();
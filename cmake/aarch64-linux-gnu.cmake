@@ -0,0 +1,22 @@
+# Cross build for aarch64 Linux with the GNU toolchain, the tests run under
+# qemu-user when it is installed
+#
+#   cmake -S . -B build-arm64 -DCMAKE_TOOLCHAIN_FILE=cmake/aarch64-linux-gnu.cmake
+#   cmake --build build-arm64 && ctest --test-dir build-arm64
+
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR aarch64)
+
+set(CMAKE_C_COMPILER aarch64-linux-gnu-gcc)
+set(CMAKE_CXX_COMPILER aarch64-linux-gnu-g++)
+
+set(CMAKE_FIND_ROOT_PATH /usr/aarch64-linux-gnu)
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_PACKAGE ONLY)
+
+find_program(YAVL_QEMU_AARCH64 NAMES qemu-aarch64 qemu-aarch64-static)
+if (YAVL_QEMU_AARCH64)
+    set(CMAKE_CROSSCOMPILING_EMULATOR ${YAVL_QEMU_AARCH64} -L /usr/aarch64-linux-gnu)
+endif()
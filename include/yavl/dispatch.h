@@ -0,0 +1,84 @@
+#pragma once
+
+// Runtime dispatched batch kernels, needs linking against yavl_dispatch.
+//
+// The rest of the library picks its simd path at compile time from the isa
+// macros, which bakes the build machine's instruction set into the binary.
+// The kernels here are compiled once per isa level in separate translation
+// units and the best level the running cpu supports is picked on first use,
+// so one binary runs on everything from SSE4.2 machines to AVX-512 ones.
+//
+// Kernels take plain buffers instead of Vec/Mat objects since the register
+// layout of those types depends on the isa a translation unit is built for.
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace yavl
+{
+
+enum class isa_level : uint32_t {
+    scalar = 0,
+    sse42,
+    avx2,       // AVX2 + FMA
+    avx512,     // AVX512F + VL + DQ + BW
+    count
+};
+
+// Raw state of 8 interleaved pcg32 generators, lane i matches
+// pcg32(initstate[i], initseq[i])
+struct pcg32x8_state {
+    alignas(64) uint64_t state[8];
+    alignas(64) uint64_t inc[8];
+
+    pcg32x8_state();
+    pcg32x8_state(const uint64_t* initstate, const uint64_t* initseq);
+
+    void seed(const uint64_t* initstate, const uint64_t* initseq);
+};
+
+struct kernel_table {
+    isa_level level;
+
+    // Normalize n vectors stored as three component streams(the VecArray
+    // layout), streams don't need padding
+    void (*normalize3f)(float* x, float* y, float* z, std::size_t n);
+
+    // out[i] = mat * in[i], mat is a column major 4x4 matrix and in/out are
+    // packed 4 component vectors
+    void (*transform4f)(const float* mat, const float* in, float* out,
+        std::size_t n);
+
+    // Fill out with the interleaved output of the 8 generators, out[8k + i]
+    // comes from lane i. A tail shorter than 8 still advances every lane
+    void (*fill_uniform_float)(pcg32x8_state& rng, float* out, std::size_t n);
+    void (*fill_uint32)(pcg32x8_state& rng, uint32_t* out, std::size_t n);
+};
+
+// Highest level the running cpu supports
+isa_level detect_isa_level();
+
+// Whether the level is compiled in and the running cpu supports it
+bool isa_level_supported(const isa_level level);
+
+const char* isa_level_name(const isa_level level);
+
+// Use the given level instead of the detected one, mostly for testing the
+// lower paths on a capable machine. Returns false and leaves the active
+// table untouched if the level isn't supported. The YAVL_ISA_LEVEL
+// environment variable(scalar, sse42, avx2 or avx512) does the same for the
+// initial selection.
+bool force_isa_level(const isa_level level);
+
+// Go back to the detected level
+void reset_isa_level();
+
+isa_level active_isa_level();
+
+// Table of the active level
+const kernel_table& kernels();
+
+// Table of a specific level, nullptr if it isn't compiled in
+const kernel_table* kernels_for(const isa_level level);
+
+} // namespace yavl
@@ -0,0 +1,402 @@
+#pragma once
+
+// Ray-box slab tests and Moller-Trumbore ray-triangle tests on packets, the
+// kernels under BVH traversal and leaf intersection.
+//
+// Packets come in two shapes. W coherent rays, camera or shadow rays, go
+// against one primitive in a RaySoA. One ray goes against W primitives in
+// a BoxSoA or TriangleSoA, the children of a W wide BVH node or a leaf of
+// W triangles. Both run in the widest registers of the build, W = 16 on an
+// AVX2 build is two __m256 per component.
+//
+// Inverse directions are Vec::rcp(), rcp_ps_impl refined once, which gives
+// an axis parallel ray an infinite inverse of the sign of its zero. Its
+// slab distances are then -inf or +inf, or 0 * inf = NaN with the origin on
+// a plane. min/max return their second operand for a NaN on every backend,
+// so with the running entry/exit distances second a NaN drops its plane,
+// and the ray is inside a slab exactly when its origin is, boundary
+// included. The near plane goes by the sign of the inverse, so empty
+// boxes(lo > hi) miss.
+//
+// The triangle test decides hits with compares false on NaN instead, the
+// triangles a ray is parallel to and degenerate ones miss. Lanes with
+// tmax < tmin miss in both tests, NaN coordinates give unspecified results.
+//
+// Hits come back as a lane mask in an uint32_t, bit l for lane l, and the
+// distances of the hit lanes.
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_soa.h>
+#include <yavl/vec/vec_math.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace intersect_impl
+{
+
+// Lanes [i, i + width of R) of a per lane Vec, or a float on every lane
+template <typename R, uint32_t W>
+static inline R lanes(const Vec<float, W>& v, const uint32_t i) {
+    return math_impl::packet_ops<R>::loadu(v.arr.data() + i);
+}
+
+template <typename R>
+static inline R lanes(const float s, const uint32_t) {
+    return math_impl::packet_ops<R>::set1(s);
+}
+
+template <typename R, typename A>
+static inline void lanes3(R (&r)[3], const A& a, const uint32_t i) {
+    static_for<3>([&](const int c) {
+        r[c] = lanes<R>(a[c], i);
+    });
+}
+
+// Entry and exit distances over the three slabs, near/far are the planes
+// each lane enters and leaves by
+template <typename R>
+static inline void slabs(const R (&org)[3], const R (&inv)[3],
+    const R (&near)[3], const R (&far)[3], R& t0, R& t1)
+{
+    using O = math_impl::packet_ops<R>;
+    // (b - o) * inv rather than an fma with o * inv, which is inf - inf
+    // for an infinite inverse. The accumulators go second so NaNs drop out
+    static_for<3>([&](const int a) {
+        t0 = O::max(O::mul(O::sub(near[a], org[a]), inv[a]), t0);
+        t1 = O::min(O::mul(O::sub(far[a], org[a]), inv[a]), t1);
+    });
+}
+
+template <typename R>
+static inline R dot(const R (&a)[3], const R (&b)[3]) {
+    using O = math_impl::packet_ops<R>;
+    return O::fmadd(a[2], b[2], O::fmadd(a[1], b[1], O::mul(a[0], b[0])));
+}
+
+template <typename R>
+static inline void cross(const R (&a)[3], const R (&b)[3], R (&c)[3]) {
+    using O = math_impl::packet_ops<R>;
+    c[0] = O::fmsub(a[1], b[2], O::mul(a[2], b[1]));
+    c[1] = O::fmsub(a[2], b[0], O::mul(a[0], b[2]));
+    c[2] = O::fmsub(a[0], b[1], O::mul(a[1], b[0]));
+}
+
+// Moller-Trumbore, t/u/v are the distance and barycentrics of v1 and v2.
+// A ray parallel to the triangle, or a degenerate triangle, has det = 0
+// and the 0 * inf or inf - inf it leads to fails the compares
+template <precision P, typename R>
+static inline auto moller_trumbore(const R (&org)[3], const R (&dir)[3],
+    const R (&v0)[3], const R (&e1)[3], const R (&e2)[3], const R tmin,
+    const R tmax, R& t, R& u, R& v)
+{
+    using O = math_impl::packet_ops<R>;
+    R p[3], s[3], q[3];
+    cross(dir, e2, p);
+    const R inv_det = O::template rcp<P>(dot(e1, p));
+    static_for<3>([&](const int a) {
+        s[a] = O::sub(org[a], v0[a]);
+    });
+    cross(s, e1, q);
+    u = O::mul(dot(s, p), inv_det);
+    v = O::mul(dot(dir, q), inv_det);
+    t = O::mul(dot(e2, q), inv_det);
+
+    const R zero = O::set1(0.f);
+    auto hit = O::mand(O::ge(u, zero), O::ge(v, zero));
+    hit = O::mand(hit, O::le(O::add(u, v), O::set1(1.f)));
+    return O::mand(hit, O::mand(O::ge(t, tmin), O::le(t, tmax)));
+}
+
+} // namespace intersect_impl
+
+// One ray, the inverse direction is kept for the slab tests
+struct Ray {
+    Vec3f org, dir, inv_dir;
+    float tmin = 0.f;
+    float tmax = std::numeric_limits<float>::infinity();
+
+    Ray() = default;
+
+    Ray(const Vec3f& o, const Vec3f& d, const float t0 = 0.f,
+        const float t1 = std::numeric_limits<float>::infinity())
+        : org(o)
+        , dir(d)
+        , inv_dir(d.template rcp<precision::standard>())
+        , tmin(t0)
+        , tmax(t1)
+    {}
+};
+
+// W rays in SoA layout, a ray packet. Lanes with tmax < tmin are inactive
+// and miss everything, a default constructed packet is all inactive
+template <uint32_t W = native_width<float>>
+struct RaySoA {
+    static_assert(W <= 32, "hit masks are 32 bits");
+    static constexpr uint32_t Width = W;
+
+    using Packet = Vec<float, Width>;
+    using VecPack = Vec3SoA<float, Width>;
+
+    VecPack org, dir, inv_dir;
+    Packet tmin = Packet(0.f);
+    Packet tmax = Packet(-std::numeric_limits<float>::infinity());
+
+    // Ctors
+    RaySoA() = default;
+
+    RaySoA(const VecPack& o, const VecPack& d, const Packet& t0 = Packet(0.f),
+        const Packet& t1 = Packet(std::numeric_limits<float>::infinity()))
+        : org(o)
+        , dir(d)
+        , tmin(t0)
+        , tmax(t1)
+    {
+        static_for<3>([&](const int a) {
+            inv_dir[a] = dir[a].template rcp<precision::standard>();
+        });
+    }
+
+    // Load from Width consecutive rays
+    static RaySoA load(const Ray* src) {
+        RaySoA tmp;
+        for (uint32_t l = 0; l < Width; ++l)
+            tmp.set(l, src[l]);
+        return tmp;
+    }
+
+    // Lane access
+    Ray get(const uint32_t lane) const {
+        assert(lane < Width);
+        Ray r;
+        r.org = org.get(lane);
+        r.dir = dir.get(lane);
+        r.inv_dir = inv_dir.get(lane);
+        r.tmin = tmin[lane];
+        r.tmax = tmax[lane];
+        return r;
+    }
+
+    void set(const uint32_t lane, const Ray& r) {
+        assert(lane < Width);
+        org.set(lane, r.org);
+        dir.set(lane, r.dir);
+        inv_dir.set(lane, r.inv_dir);
+        tmin[lane] = r.tmin;
+        tmax[lane] = r.tmax;
+    }
+};
+
+// W axis aligned boxes in SoA layout, e.g. the children of a W wide BVH
+// node. Empty lanes(lo > hi) never hit, a default constructed pack is all
+// empty
+template <uint32_t W = native_width<float>>
+struct BoxSoA {
+    static_assert(W <= 32, "hit masks are 32 bits");
+    static constexpr uint32_t Width = W;
+
+    using VecPack = Vec3SoA<float, Width>;
+
+    VecPack lo = VecPack(std::numeric_limits<float>::infinity());
+    VecPack hi = VecPack(-std::numeric_limits<float>::infinity());
+
+    // Ctors
+    BoxSoA() = default;
+
+    BoxSoA(const VecPack& l, const VecPack& h) : lo(l), hi(h) {}
+
+    // Lane access
+    std::pair<Vec3f, Vec3f> get(const uint32_t lane) const {
+        return { lo.get(lane), hi.get(lane) };
+    }
+
+    void set(const uint32_t lane, const Vec3f& l, const Vec3f& h) {
+        lo.set(lane, l);
+        hi.set(lane, h);
+    }
+};
+
+// W triangles in SoA layout as a vertex and the two edges from it, what
+// Moller-Trumbore reads. A default constructed pack is all degenerate
+// triangles, which never hit
+template <uint32_t W = native_width<float>>
+struct TriangleSoA {
+    static_assert(W <= 32, "hit masks are 32 bits");
+    static constexpr uint32_t Width = W;
+
+    using VecPack = Vec3SoA<float, Width>;
+
+    VecPack v0, e1, e2;
+
+    // Lane access
+    void set(const uint32_t lane, const Vec3f& a, const Vec3f& b, const Vec3f& c) {
+        v0.set(lane, a);
+        e1.set(lane, b - a);
+        e2.set(lane, c - a);
+    }
+};
+
+// Entry distances of the hit lanes, clamped to the rays' tmin, infinity on
+// the others
+template <uint32_t W>
+struct BoxHits {
+    uint32_t mask = 0;
+    Vec<float, W> tnear;
+};
+
+// Distance and barycentrics(of v1 and v2) of the hit lanes. t is the
+// rays' tmax on the other lanes, so assigning it to a RaySoA's tmax keeps
+// the closest hit so far
+template <uint32_t W>
+struct TriangleHits {
+    uint32_t mask = 0;
+    Vec<float, W> t, u, v;
+
+    // Hit lane with the smallest t, the lowest of equal ones, W if none
+    uint32_t closest() const {
+        uint32_t best = W;
+        for (uint32_t m = mask; m; m &= m - 1) {
+            const uint32_t l = std::countr_zero(m);
+            if (best == W || t[l] < t[best])
+                best = l;
+        }
+        return best;
+    }
+};
+
+// W rays against one box
+template <uint32_t W>
+inline BoxHits<W> intersect_box(const RaySoA<W>& r, const Vec3f& lo, const Vec3f& hi) {
+    BoxHits<W> hits;
+    math_impl::for_each_packet<float>(W, [&]<typename R>(const uint32_t i) {
+        using O = math_impl::packet_ops<R>;
+        R org[3], inv[3], near[3], far[3];
+        intersect_impl::lanes3(org, r.org, i);
+        intersect_impl::lanes3(inv, r.inv_dir, i);
+        static_for<3>([&](const int a) {
+            // Lanes going down the axis enter by hi
+            near[a] = O::select_sign(inv[a], O::set1(hi[a]), O::set1(lo[a]));
+            far[a] = O::select_sign(inv[a], O::set1(lo[a]), O::set1(hi[a]));
+        });
+        R t0 = intersect_impl::lanes<R>(r.tmin, i);
+        R t1 = intersect_impl::lanes<R>(r.tmax, i);
+        intersect_impl::slabs(org, inv, near, far, t0, t1);
+
+        const auto hit = O::le(t0, t1);
+        hits.mask |= O::bits(hit) << i;
+        O::storeu(hits.tnear.arr.data() + i,
+            O::select(hit, t0, O::set1(std::numeric_limits<float>::infinity())));
+    });
+    return hits;
+}
+
+// One ray against W boxes
+template <uint32_t W>
+inline BoxHits<W> intersect_box(const Ray& r, const BoxSoA<W>& b) {
+    // The ray's signs pick the near planes of all lanes at once
+    const Vec<float, W>* near[3];
+    const Vec<float, W>* far[3];
+    for (uint32_t a = 0; a < 3; ++a) {
+        const bool down = std::signbit(r.inv_dir[a]);
+        near[a] = down ? &b.hi[a] : &b.lo[a];
+        far[a] = down ? &b.lo[a] : &b.hi[a];
+    }
+
+    BoxHits<W> hits;
+    math_impl::for_each_packet<float>(W, [&]<typename R>(const uint32_t i) {
+        using O = math_impl::packet_ops<R>;
+        R org[3], inv[3], n[3], f[3];
+        intersect_impl::lanes3(org, r.org, i);
+        intersect_impl::lanes3(inv, r.inv_dir, i);
+        static_for<3>([&](const int a) {
+            n[a] = intersect_impl::lanes<R>(*near[a], i);
+            f[a] = intersect_impl::lanes<R>(*far[a], i);
+        });
+        R t0 = O::set1(r.tmin), t1 = O::set1(r.tmax);
+        intersect_impl::slabs(org, inv, n, f, t0, t1);
+
+        const auto hit = O::le(t0, t1);
+        hits.mask |= O::bits(hit) << i;
+        O::storeu(hits.tnear.arr.data() + i,
+            O::select(hit, t0, O::set1(std::numeric_limits<float>::infinity())));
+    });
+    return hits;
+}
+
+// W rays against one triangle
+template <precision P = precision::standard, uint32_t W>
+inline TriangleHits<W> intersect_triangle(const RaySoA<W>& r, const Vec3f& v0,
+    const Vec3f& v1, const Vec3f& v2)
+{
+    const Vec3f e1 = v1 - v0, e2 = v2 - v0;
+    TriangleHits<W> hits;
+    math_impl::for_each_packet<float>(W, [&]<typename R>(const uint32_t i) {
+        using O = math_impl::packet_ops<R>;
+        R org[3], dir[3], p0[3], p1[3], p2[3], t, u, v;
+        intersect_impl::lanes3(org, r.org, i);
+        intersect_impl::lanes3(dir, r.dir, i);
+        intersect_impl::lanes3(p0, v0, i);
+        intersect_impl::lanes3(p1, e1, i);
+        intersect_impl::lanes3(p2, e2, i);
+        const R tmax = intersect_impl::lanes<R>(r.tmax, i);
+        const auto hit = intersect_impl::moller_trumbore<P>(org, dir, p0, p1, p2,
+            intersect_impl::lanes<R>(r.tmin, i), tmax, t, u, v);
+
+        hits.mask |= O::bits(hit) << i;
+        O::storeu(hits.t.arr.data() + i, O::select(hit, t, tmax));
+        O::storeu(hits.u.arr.data() + i, O::select(hit, u, O::set1(0.f)));
+        O::storeu(hits.v.arr.data() + i, O::select(hit, v, O::set1(0.f)));
+    });
+    return hits;
+}
+
+// One ray against W triangles
+template <precision P = precision::standard, uint32_t W>
+inline TriangleHits<W> intersect_triangle(const Ray& r, const TriangleSoA<W>& tri) {
+    TriangleHits<W> hits;
+    math_impl::for_each_packet<float>(W, [&]<typename R>(const uint32_t i) {
+        using O = math_impl::packet_ops<R>;
+        R org[3], dir[3], p0[3], p1[3], p2[3], t, u, v;
+        intersect_impl::lanes3(org, r.org, i);
+        intersect_impl::lanes3(dir, r.dir, i);
+        intersect_impl::lanes3(p0, tri.v0, i);
+        intersect_impl::lanes3(p1, tri.e1, i);
+        intersect_impl::lanes3(p2, tri.e2, i);
+        const R tmax = O::set1(r.tmax);
+        const auto hit = intersect_impl::moller_trumbore<P>(org, dir, p0, p1, p2,
+            O::set1(r.tmin), tmax, t, u, v);
+
+        hits.mask |= O::bits(hit) << i;
+        O::storeu(hits.t.arr.data() + i, O::select(hit, t, tmax));
+        O::storeu(hits.u.arr.data() + i, O::select(hit, u, O::set1(0.f)));
+        O::storeu(hits.v.arr.data() + i, O::select(hit, v, O::set1(0.f)));
+    });
+    return hits;
+}
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
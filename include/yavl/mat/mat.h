@@ -6,9 +6,11 @@
 #include <concepts>
 #include <stdint.h>
 #include <type_traits>
+#include <utility>
 
 #include <yavl/utils.h>
 #include <yavl/vec/vec.h>
+#include <yavl/mat/mat_dense.h>
 
 namespace yavl
 {
@@ -247,7 +249,7 @@ struct Mat {
     #define MAT_MUL_SCALAR_EXPRS(BITS, IT, MUL)                         \
     {                                                                   \
         Mat tmp;                                                        \
-        static_for<Size2>([&](const auto i) {                           \
+        bounded_static_for<Size2>([&](const auto i) {                   \
             tmp.arr[i] = arr[i] * s;                                    \
         });                                                             \
         return tmp;                                                     \
@@ -255,7 +257,7 @@ struct Mat {
 
     #define MAT_MUL_ASSIGN_SCALAR_EXPRS(BITS, IT, MUL)                  \
     {                                                                   \
-        static_for<Size2>([&](const auto i) {                           \
+        bounded_static_for<Size2>([&](const auto i) {                   \
             arr[i] *= s;                                                \
         });                                                             \
         return *this;                                                   \
@@ -277,9 +279,16 @@ struct Mat {
     #define MAT_MUL_VEC_EXPRS                                           \
     {                                                                   \
         Vec<Scalar, Size> tmp;                                          \
-        for(int i = 0; i < Size; ++i) {                                 \
-            for(int j = 0; j < Size; ++j) {                             \
-                tmp[i] += arr[j * Size + i] * v[j];                     \
+        if constexpr (Size > dense_impl::unroll_limit &&                \
+            std::is_floating_point_v<Scalar>)                           \
+        {                                                               \
+            dense_impl::gemv<Scalar, Size>(arr.data(), v.data(), tmp.data()); \
+        }                                                               \
+        else {                                                          \
+            for(int i = 0; i < Size; ++i) {                             \
+                for(int j = 0; j < Size; ++j) {                         \
+                    tmp[i] += arr[j * Size + i] * v[j];                 \
+                }                                                       \
             }                                                           \
         }                                                               \
         return tmp;                                                     \
@@ -290,13 +299,19 @@ struct Mat {
     #define MAT_MUL_MAT_EXPRS                                           \
     {                                                                   \
         Mat tmp;                                                        \
-        static_for<Size>([&](const auto i) {                            \
-            static_for<Size>([&](const auto j) {                        \
-                static_for<Size>([&](const auto k) {                    \
-                    tmp[i][j] += arr[k * Size + j] * mat[i][k];         \
+        if constexpr (Size > dense_impl::unroll_limit) {                \
+            dense_impl::gemm<Scalar, Size>(arr.data(), mat.arr.data(),  \
+                tmp.arr.data());                                        \
+        }                                                               \
+        else {                                                          \
+            static_for<Size>([&](const auto i) {                        \
+                static_for<Size>([&](const auto j) {                    \
+                    static_for<Size>([&](const auto k) {                \
+                        tmp[i][j] += arr[k * Size + j] * mat[i][k];     \
+                    });                                                 \
                 });                                                     \
             });                                                         \
-        });                                                             \
+        }                                                               \
         return tmp;                                                     \
     }
 
@@ -315,17 +330,59 @@ struct Mat {
     // Matrix manipulation methods
     auto transpose() const {
         Mat tmp;
-        for (int i = 0; i < Size; ++i)
-            for (int j = 0; j < Size; ++j)
-                tmp[i][j] = arr[j * Size + i];
+        if constexpr (Size > dense_impl::unroll_limit) {
+            dense_impl::transpose<Scalar, Size>(arr.data(), tmp.arr.data());
+        }
+        else {
+            for (int i = 0; i < Size; ++i)
+                for (int j = 0; j < Size; ++j)
+                    tmp[i][j] = arr[j * Size + i];
+        }
         return tmp;
     }
     
+    Scalar determinant() const {
+        if constexpr (Size == 2) {
+            return arr[0] * arr[3] - arr[1] * arr[2];
+        }
+        else if constexpr (Size == 3) {
+            return arr[0] * (arr[4] * arr[8] - arr[7] * arr[5])
+                + arr[3] * (arr[7] * arr[2] - arr[1] * arr[8])
+                + arr[6] * (arr[1] * arr[5] - arr[4] * arr[2]);
+        }
+        else if constexpr (Size > 4) {
+            static_assert(std::is_floating_point_v<Scalar>,
+                "determinant() past 4x4 needs a floating point Scalar");
+            // Product of the diagonal of U
+            auto lu = arr;
+            std::array<uint32_t, Size> perm;
+            Scalar det = dense_impl::lu_factor<Scalar, Size>(lu.data(), perm.data());
+            for (uint32_t i = 0; i < Size; ++i)
+                det *= lu[i * Size + i];
+            return det;
+        }
+        else {
+            // Laplace expansion along the first two columns, products of
+            // 2x2 minors of columns 0, 1 and their complements in 2, 3
+            auto minor2 = [&](const uint32_t c, const uint32_t i, const uint32_t j) {
+                return arr[c * Size + i] * arr[(c + 1) * Size + j] -
+                    arr[c * Size + j] * arr[(c + 1) * Size + i];
+            };
+            return minor2(0, 0, 1) * minor2(2, 2, 3) - minor2(0, 0, 2) * minor2(2, 1, 3)
+                + minor2(0, 0, 3) * minor2(2, 1, 2) + minor2(0, 1, 2) * minor2(2, 0, 3)
+                - minor2(0, 1, 3) * minor2(2, 0, 2) + minor2(0, 2, 3) * minor2(2, 0, 1);
+        }
+    }
+
+    // P only matters to the vectorized impls, the scalar ones divide
+    template <precision P = precision::exact>
     std::pair<bool, Mat> inverse() const {
         if constexpr (Size == 2) {
-            T det = static_cast<T>(1) / (arr[0] * arr[3] - arr[1] * arr[2]);
+            T det = determinant();
+            if (det == static_cast<Scalar>(0))
+                return std::make_pair(false, Mat{0});
             Mat ret{arr[3], -arr[1], -arr[2], arr[0]};
-            return ret * det;
+            return std::make_pair(true, ret * (static_cast<T>(1) / det));
         }
         else if constexpr (Size == 3) {
             Scalar A = arr[4] * arr[8] - arr[7] * arr[5];
@@ -335,12 +392,32 @@ struct Mat {
             Scalar E = arr[0] * arr[8] - arr[6] * arr[2];
             Scalar F = arr[3] * arr[2] - arr[0] * arr[5];
             Scalar G = arr[3] * arr[7] - arr[6] * arr[4];
-            Scalar H = arr[6] * arr[4] - arr[0] * arr[7];
+            Scalar H = arr[6] * arr[1] - arr[0] * arr[7];
             Scalar I = arr[0] * arr[4] - arr[3] * arr[1];
 
             Scalar det = arr[0] * A + arr[3] * B + arr[6] * C;
+            if (det == static_cast<Scalar>(0))
+                return std::make_pair(false, Mat{0});
             Mat ret{A, B, C, D, E, F, G, H, I};
-            return ret * det;
+            return std::make_pair(true, ret * (static_cast<T>(1) / det));
+        }
+        else if constexpr (Size > 4) {
+            static_assert(std::is_floating_point_v<Scalar>,
+                "inverse() past 4x4 needs a floating point Scalar");
+            auto lu = arr;
+            std::array<uint32_t, Size> perm;
+            if (dense_impl::lu_factor<Scalar, Size>(lu.data(), perm.data()) == 0)
+                return std::make_pair(false, Mat{0});
+            // Column by column from the columns of the identity
+            Mat ret;
+            std::array<Scalar, Size> e{};
+            for (uint32_t c = 0; c < Size; ++c) {
+                e[c] = static_cast<Scalar>(1);
+                dense_impl::lu_solve<Scalar, Size>(lu.data(), perm.data(), e.data(),
+                    ret.arr.data() + c * Size);
+                e[c] = static_cast<Scalar>(0);
+            }
+            return std::make_pair(true, ret);
         }
         else {
             // Copied from pbrt-v3
@@ -409,6 +486,38 @@ struct Mat {
             return std::make_pair(true, minv);
         }
     }
+
+    // Inverse of [A t; 0 1], only for 4x4 matrices with a last row of
+    // (0, 0, 0, 1). Only A is inverted, the result is [inverse(A) -inverse(A) t; 0 1]
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> affine_inverse() const requires (Size == 4) {
+        // Row i of inverse(A) is the cross product of the other two
+        // columns over det(A)
+        T b[3][3];
+        for (int i = 0; i < 3; ++i) {
+            const T* u = arr.data() + ((i + 1) % 3) * Size;
+            const T* v = arr.data() + ((i + 2) % 3) * Size;
+            b[i][0] = u[1] * v[2] - u[2] * v[1];
+            b[i][1] = u[2] * v[0] - u[0] * v[2];
+            b[i][2] = u[0] * v[1] - u[1] * v[0];
+        }
+        T det = arr[0] * b[0][0] + arr[1] * b[0][1] + arr[2] * b[0][2];
+        if (det == static_cast<Scalar>(0))
+            return std::make_pair(false, Mat{0});
+
+        T rdet = static_cast<T>(1) / det;
+        Mat ret;
+        for (int i = 0; i < 3; ++i) {
+            T t = static_cast<Scalar>(0);
+            for (int j = 0; j < 3; ++j) {
+                ret.arr[j * Size + i] = b[i][j] * rdet;
+                t -= ret.arr[j * Size + i] * arr[12 + j];
+            }
+            ret.arr[12 + i] = t;
+        }
+        ret.arr[15] = static_cast<Scalar>(1);
+        return std::make_pair(true, ret);
+    }
 };
 
 // Mat type aliasing
@@ -436,4 +545,91 @@ using Mat4d = Mat4<double>;
 using Mat4i = Mat4<int>;
 using Mat4u = Mat4<uint32_t>;
 
+// P A = L U with partial pivoting, for solving several right hand sides
+// against the same A. Works with every Mat, the factors are kept column
+// major without padding
+template <typename T, uint32_t N>
+    requires std::is_floating_point_v<T>
+struct LU {
+    // L below the diagonal with an implicit unit diagonal, U on and above
+    std::array<T, N * N> lu;
+    // Row i of P A is row perm[i] of A
+    std::array<uint32_t, N> perm;
+    // Sign of the permutation, 0 if A is singular
+    T sign;
+
+    LU(const Mat<T, N>& m) {
+        for (uint32_t c = 0; c < N; ++c)
+            for (uint32_t r = 0; r < N; ++r)
+                lu[c * N + r] = m[c][r];
+        sign = dense_impl::lu_factor<T, N>(lu.data(), perm.data());
+    }
+
+    bool singular() const {
+        return sign == static_cast<T>(0);
+    }
+
+    T determinant() const {
+        T det = sign;
+        for (uint32_t i = 0; i < N; ++i)
+            det *= lu[i * N + i];
+        return det;
+    }
+
+    // x with A x = b, A must not be singular
+    Vec<T, N> solve(const Vec<T, N>& b) const {
+        assert(!singular());
+        std::array<T, N> bs, xs;
+        for (uint32_t i = 0; i < N; ++i)
+            bs[i] = b[i];
+        dense_impl::lu_solve<T, N>(lu.data(), perm.data(), bs.data(), xs.data());
+        Vec<T, N> x;
+        for (uint32_t i = 0; i < N; ++i)
+            x[i] = xs[i];
+        return x;
+    }
+};
+
+// A = L L^T of a symmetric positive definite A, only the lower triangle of
+// A is read
+template <typename T, uint32_t N>
+    requires std::is_floating_point_v<T>
+struct Cholesky {
+    std::array<T, N * N> l;
+    // L^T, the back substitution walks its columns
+    std::array<T, N * N> lt;
+    // False if A is not positive definite
+    bool ok;
+
+    Cholesky(const Mat<T, N>& m) {
+        for (uint32_t c = 0; c < N; ++c)
+            for (uint32_t r = 0; r < N; ++r)
+                l[c * N + r] = m[c][r];
+        ok = dense_impl::cholesky_factor<T, N>(l.data());
+        dense_impl::transpose<T, N>(l.data(), lt.data());
+    }
+
+    Mat<T, N> lower() const {
+        Mat<T, N> ret;
+        for (uint32_t c = 0; c < N; ++c)
+            for (uint32_t r = c; r < N; ++r)
+                ret[c][r] = l[c * N + r];
+        return ret;
+    }
+
+    // x with A x = b, A must be positive definite
+    Vec<T, N> solve(const Vec<T, N>& b) const {
+        assert(ok);
+        std::array<T, N> xs;
+        for (uint32_t i = 0; i < N; ++i)
+            xs[i] = b[i];
+        dense_impl::lower_solve<false, T, N>(l.data(), xs.data());
+        dense_impl::upper_solve<T, N>(lt.data(), xs.data());
+        Vec<T, N> x;
+        for (uint32_t i = 0; i < N; ++i)
+            x[i] = xs[i];
+        return x;
+    }
+};
+
 } // namespace yavl
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+namespace yavl
+{
+
+// Mat<float, 3> as three 16 byte aligned columns with a zero padding lane,
+// shared by the sse4.2, avx and avx512 cascades. The avx layout of a
+// __m256 holding the first two columns and a __m128 for the third needed
+// lane extracts and broadcasts in every product and benchmarked slower
+// than the scalar Mat, with separate columns a product is 3 shuffles and
+// 3 multiply-adds
+
+// m * v for a column register v, the padding lane of v is never read
+#define MAT3_MUL_COLUMN_EXPRS(V)                                        \
+    MULADD(, ps, m[2], _mm_shuffle_ps(V, V, _MM_SHUFFLE(2, 2, 2, 2)),   \
+        MULADD(, ps, m[1], _mm_shuffle_ps(V, V, _MM_SHUFFLE(1, 1, 1, 1)), \
+            _mm_mul_ps(m[0], _mm_shuffle_ps(V, V, _MM_SHUFFLE(0, 0, 0, 0)))))
+
+#define MAT_MUL_VEC_EXPRS                                               \
+{                                                                       \
+    return Vec<Scalar, Size>(MAT3_MUL_COLUMN_EXPRS(v.m));               \
+}
+
+#define MAT_MUL_COL_EXPRS                                               \
+{                                                                       \
+    return Vec<Scalar, Size>(MAT3_MUL_COLUMN_EXPRS(v.m));               \
+}
+
+#define MAT_MUL_MAT_EXPRS                                               \
+{                                                                       \
+    Mat tmp;                                                            \
+    static_for<Size>([&](const auto i) {                                \
+        tmp.m[i] = MAT3_MUL_COLUMN_EXPRS(mat.m[i]);                     \
+    });                                                                 \
+    return tmp;                                                         \
+}
+
+template <>
+struct alignas(16) Mat<float, 3> {
+    YAVL_MAT_ALIAS_VECTORIZED(float, 3, 4, 3)
+
+    YAVL_DEFINE_MAT_UNION(__m128)
+
+    // Ctors
+    YAVL_MAT_VECTORIZED_CTOR(, ps, __m128)
+    YAVL_MAT_CTOR_BY3(, ps)
+
+    // Operators
+    YAVL_DEFINE_MAT3_INDEX_OP
+    YAVL_DEFINE_MAT_MUL_OP(, ps, mul)
+
+    // Misc funcs
+    YAVL_DEFINE_DATA_METHOD
+
+    // Matrix manipulation methods
+    auto transpose() const {
+        __m128 t[4] = { m[0], m[1], m[2], _mm_setzero_ps() };
+        _MM_TRANSPOSE4_PS(t[0], t[1], t[2], t[3]);
+        Mat tmp;
+        tmp.m[0] = t[0];
+        tmp.m[1] = t[1];
+        tmp.m[2] = t[2];
+        return tmp;
+    }
+
+    Scalar determinant() const {
+        return _mm_cvtss_f32(detail::mat3_determinant(m));
+    }
+
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> inverse() const {
+        Mat tmp;
+        if (_mm_cvtss_f32(detail::mat3_inverse<P>(m, tmp.m)) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, tmp);
+    }
+};
+
+#undef MAT3_MUL_COLUMN_EXPRS
+#undef MAT_MUL_VEC_EXPRS
+#undef MAT_MUL_COL_EXPRS
+#undef MAT_MUL_MAT_EXPRS
+
+} // namespace yavl
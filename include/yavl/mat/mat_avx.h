@@ -29,6 +29,8 @@ do {                                                                    \
         return detail::avx_mat_mul_vec_impl(*this, Vec<Scalar, Size>(v.m)); \
 }
 
+#if !defined(YAVL_AVX512_MAT4F)
+
 #define MAT_MUL_MAT_EXPRS                                               \
 {                                                                       \
     Mat tmp;                                                            \
@@ -80,10 +82,53 @@ struct alignas(32) Mat<float, 4> {
         tmp.m[1] = _mm256_permutevar8x32_ps(tmp1, mask);
         return tmp;
     }
+
+    // The 4x4 inverse shuffles within columns, it runs on the 128 bit halves
+    Scalar determinant() const {
+        __m128 col[4];
+        split_columns(col);
+        return _mm_cvtss_f32(detail::mat4_determinant(col));
+    }
+
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> inverse() const {
+        __m128 col[4], inv[4];
+        split_columns(col);
+        if (_mm_cvtss_f32(detail::mat4_inverse<P>(col, inv)) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, merge_columns(inv));
+    }
+
+    // Only for matrices with a last row of (0, 0, 0, 1)
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> affine_inverse() const {
+        __m128 col[4], inv[4];
+        split_columns(col);
+        if (_mm_cvtss_f32(detail::mat4_affine_inverse<P>(col, inv)) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, merge_columns(inv));
+    }
+
+private:
+    void split_columns(__m128 (&col)[4]) const {
+        col[0] = _mm256_castps256_ps128(m[0]);
+        col[1] = _mm256_extractf128_ps(m[0], 1);
+        col[2] = _mm256_castps256_ps128(m[1]);
+        col[3] = _mm256_extractf128_ps(m[1], 1);
+    }
+
+    static Mat merge_columns(const __m128 (&col)[4]) {
+        Mat tmp;
+        tmp.m[0] = _mm256_insertf128_ps(_mm256_castps128_ps256(col[0]), col[1], 1);
+        tmp.m[1] = _mm256_insertf128_ps(_mm256_castps128_ps256(col[2]), col[3], 1);
+        return tmp;
+    }
 };
 
 #undef MAT_MUL_MAT_EXPRS
 
+#endif
+
 // Code here is just same as code for Mat<float, 4> sse impl
 #define MAT_MUL_MAT_EXPRS                                               \
 {                                                                       \
@@ -123,6 +168,27 @@ struct alignas(32) Mat<double, 4> {
         _MM_TRANSPOSE4_PD(tmp.m[0], tmp.m[1], tmp.m[2], tmp.m[3]);
         return tmp;
     }
+
+    Scalar determinant() const {
+        return _mm256_cvtsd_f64(detail::mat4_determinant(m));
+    }
+
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> inverse() const {
+        Mat tmp;
+        if (_mm256_cvtsd_f64(detail::mat4_inverse<P>(m, tmp.m)) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, tmp);
+    }
+
+    // Only for matrices with a last row of (0, 0, 0, 1)
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> affine_inverse() const {
+        Mat tmp;
+        if (_mm256_cvtsd_f64(detail::mat4_affine_inverse<P>(m, tmp.m)) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, tmp);
+    }
 };
 
 template <>
@@ -155,6 +221,18 @@ struct alignas(32) Mat<double, 3> {
         tmp.m[2] = tmp4.m[2];
         return tmp;
     }
+
+    Scalar determinant() const {
+        return _mm256_cvtsd_f64(detail::mat3_determinant(m));
+    }
+
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> inverse() const {
+        Mat tmp;
+        if (_mm256_cvtsd_f64(detail::mat3_inverse<P>(m, tmp.m)) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, tmp);
+    }
 };
 
 #undef MAT_MUL_VEC_EXPRS
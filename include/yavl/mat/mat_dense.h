@@ -0,0 +1,290 @@
+#pragma once
+
+// Kernels of the generic Mat<T, N> past 4x4, on column major N x N arrays.
+//
+// Fully unrolling the multiply with static_for grows as N^3 and stops
+// paying off after 4x4, larger matrices loop over register tiles instead.
+// A tile of c is kept in 2 packets of rows(1 with AVX-512) by gemm_cols
+// columns of accumulators, every step of k loads 2 packets of a and
+// broadcasts gemm_cols elements of b into 2 * gemm_cols fmas. Rows that
+// don't fill the widest packet go through the narrower ones and a scalar
+// tail. k is blocked so a panel of a stays in L1, up to N = 128 for float
+// that is the whole matrix.
+//
+// LU with partial pivoting and Cholesky are right looking, every step
+// updates the trailing columns with packets of fnmadd.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec_math.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace dense_impl
+{
+
+// Mat sizes up to this are fully unrolled
+static constexpr uint32_t unroll_limit = 4;
+
+// Columns of a multiply tile, 2 * 4 accumulators leave room for the a
+// packets and the broadcast in 16 registers
+static constexpr uint32_t gemm_cols = 4;
+
+// Bytes of a kept in L1 while a block of k is multiplied
+static constexpr uint32_t gemm_panel_bytes = 16384;
+
+// Tile of c = a * b over [k0, k1) of R packets of rows by C columns, a and c
+// point at the first row of the tile and b and c at its first column
+template <typename P, uint32_t R, uint32_t C, uint32_t N, typename T>
+static inline void gemm_tile(const T* a, const T* b, T* c, const uint32_t k0,
+    const uint32_t k1)
+{
+    using O = math_impl::packet_ops<P>;
+    constexpr uint32_t W = O::Width;
+
+    P acc[R][C];
+    static_for<C>([&](const auto j) {
+        static_for<R>([&](const auto r) {
+            acc[r][j] = k0 == 0 ? O::set1(static_cast<T>(0)) : O::loadu(c + j * N + r * W);
+        });
+    });
+
+    for (uint32_t k = k0; k < k1; ++k) {
+        P ak[R];
+        static_for<R>([&](const auto r) {
+            ak[r] = O::loadu(a + k * N + r * W);
+        });
+        static_for<C>([&](const auto j) {
+            const P bkj = O::set1(b[j * N + k]);
+            static_for<R>([&](const auto r) {
+                acc[r][j] = O::fmadd(ak[r], bkj, acc[r][j]);
+            });
+        });
+    }
+
+    static_for<C>([&](const auto j) {
+        static_for<R>([&](const auto r) {
+            O::storeu(c + j * N + r * W, acc[r][j]);
+        });
+    });
+}
+
+// All rows of C columns from column j, widest packets first
+template <uint32_t C, uint32_t N, typename T>
+static inline void gemm_cols_block(const T* a, const T* b, T* c, const uint32_t j,
+    const uint32_t k0, const uint32_t k1)
+{
+    uint32_t i = 0;
+    auto run = [&]<typename P, uint32_t R>() {
+        constexpr uint32_t H = math_impl::packet_ops<P>::Width * R;
+        for (; i + H <= N; i += H)
+            gemm_tile<P, R, C, N>(a + i, b + j * N, c + j * N + i, k0, k1);
+    };
+
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+#if defined(YAVL_X86_AVX512F)
+    // Two zmm packets of rows measured slower, GCC spills the tile
+    run.template operator()<math_impl::packet512_t<T>, 1>();
+#endif
+#if defined(YAVL_X86_AVX2)
+    run.template operator()<math_impl::packet256_t<T>, 2>();
+    run.template operator()<math_impl::packet256_t<T>, 1>();
+#endif
+#if defined(YAVL_X86_SSE42) || defined(YAVL_ARM_NEON)
+    run.template operator()<math_impl::packet128_t<T>, 2>();
+    run.template operator()<math_impl::packet128_t<T>, 1>();
+#endif
+#endif
+    run.template operator()<T, 1>();
+}
+
+// c = a * b, c must not alias a or b
+template <typename T, uint32_t N>
+static inline void gemm(const T* a, const T* b, T* c) {
+    if constexpr (!std::is_floating_point_v<T>) {
+        for (uint32_t j = 0; j < N; ++j) {
+            for (uint32_t i = 0; i < N; ++i)
+                c[j * N + i] = static_cast<T>(0);
+            for (uint32_t k = 0; k < N; ++k)
+                for (uint32_t i = 0; i < N; ++i)
+                    c[j * N + i] += a[k * N + i] * b[j * N + k];
+        }
+    }
+    else {
+        constexpr uint32_t KC = std::max<uint32_t>(1, gemm_panel_bytes / (N * sizeof(T)));
+        for (uint32_t k0 = 0; k0 < N; k0 += KC) {
+            const uint32_t k1 = std::min(N, k0 + KC);
+            uint32_t j = 0;
+            for (; j + gemm_cols <= N; j += gemm_cols)
+                gemm_cols_block<gemm_cols, N>(a, b, c, j, k0, k1);
+            for (; j < N; ++j)
+                gemm_cols_block<1, N>(a, b, c, j, k0, k1);
+        }
+    }
+}
+
+// y = a * x as a sum of the columns of a
+template <typename T, uint32_t N>
+static inline void gemv(const T* a, const T* x, T* y) {
+    math_impl::for_each_packet<T>(N, [&]<typename P>(const uint32_t i) {
+        using O = math_impl::packet_ops<P>;
+        P acc = O::set1(static_cast<T>(0));
+        for (uint32_t k = 0; k < N; ++k)
+            acc = O::fmadd(O::loadu(a + k * N + i), O::set1(x[k]), acc);
+        O::storeu(y + i, acc);
+    });
+}
+
+template <typename T, uint32_t N>
+static inline void transpose(const T* a, T* t) {
+    uint32_t B = 0;
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_SSE42)
+    // 4x4 blocks through registers
+    if constexpr (std::is_same_v<T, float>) {
+        B = N / 4 * 4;
+        for (uint32_t j = 0; j < B; j += 4) {
+            for (uint32_t i = 0; i < B; i += 4) {
+                __m128 c0 = _mm_loadu_ps(a + j * N + i);
+                __m128 c1 = _mm_loadu_ps(a + (j + 1) * N + i);
+                __m128 c2 = _mm_loadu_ps(a + (j + 2) * N + i);
+                __m128 c3 = _mm_loadu_ps(a + (j + 3) * N + i);
+                _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+                _mm_storeu_ps(t + i * N + j, c0);
+                _mm_storeu_ps(t + (i + 1) * N + j, c1);
+                _mm_storeu_ps(t + (i + 2) * N + j, c2);
+                _mm_storeu_ps(t + (i + 3) * N + j, c3);
+            }
+        }
+    }
+#endif
+    // Whatever the blocks left, the last rows and columns
+    for (uint32_t j = 0; j < N; ++j)
+        for (uint32_t i = j < B ? B : 0; i < N; ++i)
+            t[i * N + j] = a[j * N + i];
+}
+
+// y[i] -= x[i] * s for i < n
+template <typename T>
+static inline void sub_scaled(T* y, const T* x, const T s, const uint32_t n) {
+    math_impl::for_each_packet<T>(n, [&]<typename P>(const uint32_t i) {
+        using O = math_impl::packet_ops<P>;
+        O::storeu(y + i, O::fnmadd(O::loadu(x + i), O::set1(s), O::loadu(y + i)));
+    });
+}
+
+// y[i] *= s for i < n
+template <typename T>
+static inline void scale(T* y, const T s, const uint32_t n) {
+    math_impl::for_each_packet<T>(n, [&]<typename P>(const uint32_t i) {
+        using O = math_impl::packet_ops<P>;
+        O::storeu(y + i, O::mul(O::loadu(y + i), O::set1(s)));
+    });
+}
+
+// In place P a = L U, L below the diagonal with an implicit unit diagonal
+// and U on and above it. Row i of P a is row perm[i] of a. Returns the
+// sign of the permutation, or 0 if a is singular
+template <typename T, uint32_t N>
+static inline T lu_factor(T* a, uint32_t* perm) {
+    T sign = static_cast<T>(1);
+    for (uint32_t i = 0; i < N; ++i)
+        perm[i] = i;
+
+    for (uint32_t k = 0; k < N; ++k) {
+        T* ck = a + k * N;
+        uint32_t p = k;
+        for (uint32_t i = k + 1; i < N; ++i)
+            if (std::abs(ck[i]) > std::abs(ck[p]))
+                p = i;
+        if (ck[p] == static_cast<T>(0))
+            return static_cast<T>(0);
+
+        if (p != k) {
+            for (uint32_t j = 0; j < N; ++j)
+                std::swap(a[j * N + k], a[j * N + p]);
+            std::swap(perm[k], perm[p]);
+            sign = -sign;
+        }
+
+        // Column k of L, then the rank 1 update of the trailing columns
+        scale(ck + k + 1, static_cast<T>(1) / ck[k], N - k - 1);
+        for (uint32_t j = k + 1; j < N; ++j)
+            sub_scaled(a + j * N + k + 1, ck + k + 1, a[j * N + k], N - k - 1);
+    }
+    return sign;
+}
+
+// In place a = L L^T of a symmetric positive definite a, only the lower
+// triangle is read and the upper one is zeroed. Returns false if a is not
+// positive definite
+template <typename T, uint32_t N>
+static inline bool cholesky_factor(T* a) {
+    for (uint32_t k = 0; k < N; ++k) {
+        T* ck = a + k * N;
+        if (!(ck[k] > static_cast<T>(0)))
+            return false;
+        ck[k] = std::sqrt(ck[k]);
+        scale(ck + k + 1, static_cast<T>(1) / ck[k], N - k - 1);
+        // Only the lower triangle of the trailing columns
+        for (uint32_t j = k + 1; j < N; ++j)
+            sub_scaled(a + j * N + j, ck + j, ck[j], N - j);
+    }
+    for (uint32_t j = 1; j < N; ++j)
+        for (uint32_t i = 0; i < j; ++i)
+            a[j * N + i] = static_cast<T>(0);
+    return true;
+}
+
+// In place x = inverse(L) x for lower triangular L, column by column
+template <bool UnitDiagonal, typename T, uint32_t N>
+static inline void lower_solve(const T* l, T* x) {
+    for (uint32_t k = 0; k < N; ++k) {
+        if constexpr (!UnitDiagonal)
+            x[k] /= l[k * N + k];
+        sub_scaled(x + k + 1, l + k * N + k + 1, x[k], N - k - 1);
+    }
+}
+
+// In place x = inverse(U) x for upper triangular U, column by column
+template <typename T, uint32_t N>
+static inline void upper_solve(const T* u, T* x) {
+    for (uint32_t k = N; k-- > 0;) {
+        x[k] /= u[k * N + k];
+        sub_scaled(x, u + k * N, x[k], k);
+    }
+}
+
+// x = inverse(a) b with the factors of lu_factor
+template <typename T, uint32_t N>
+static inline void lu_solve(const T* lu, const uint32_t* perm, const T* b, T* x) {
+    for (uint32_t i = 0; i < N; ++i)
+        x[i] = b[perm[i]];
+    lower_solve<true, T, N>(lu, x);
+    upper_solve<T, N>(lu, x);
+}
+
+} // namespace dense_impl
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
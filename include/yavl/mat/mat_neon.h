@@ -0,0 +1,146 @@
+#pragma once
+
+namespace yavl
+{
+
+// aarch64 NEON impl of Mat<float, 4>, one q register per column. The
+// other matrix types use the generic impl.
+//
+// vfmaq_laneq multiplies a column by a lane of the other operand without
+// a separate broadcast, a Mat * Vec is 4 multiply-adds and a Mat * Mat 16.
+
+#undef YAVL_MAT_VECTORIZED_CTOR
+#undef YAVL_MAT_CTOR_BY4
+#undef MAT_MUL_SCALAR_EXPRS
+#undef MAT_MUL_ASSIGN_SCALAR_EXPRS
+
+#define YAVL_MAT_VECTORIZED_CTOR(BITS, IT, REGI_TYPE)                   \
+    Mat() {                                                             \
+        static_for<MSize>([&](const auto i) {                           \
+            m[i] = vdupq_n_##IT(static_cast<Scalar>(0));                \
+        });                                                             \
+    }                                                                   \
+    template <typename V>                                               \
+        requires std::default_initializable<V> && std::convertible_to<V, Scalar> \
+    Mat(V v) {                                                          \
+        static_for<MSize>([&](const auto i) {                           \
+            m[i] = vdupq_n_##IT(static_cast<Scalar>(v));                \
+        });                                                             \
+    }
+
+#define YAVL_MAT_CTOR_BY4(BITS, IT)                                     \
+    template <typename... Ts>                                           \
+        requires (std::default_initializable<Ts> && ...)                \
+    constexpr Mat(Ts... args) {                                         \
+        static_assert(sizeof...(args) == Size2);                        \
+        auto setf = [&](const uint32_t i, const auto t0, const auto t1, \
+            const auto t2, const auto t3)                               \
+        {                                                               \
+            const Scalar lanes[4] = { static_cast<Scalar>(t0),          \
+                static_cast<Scalar>(t1), static_cast<Scalar>(t2),       \
+                static_cast<Scalar>(t3) };                              \
+            m[i] = vld1q_##IT(lanes);                                   \
+        };                                                              \
+        apply_by4(0, setf, args...);                                    \
+    }
+
+#define MAT_MUL_SCALAR_EXPRS(BITS, IT, MUL)                             \
+{                                                                       \
+    Mat tmp;                                                            \
+    static_for<MSize>([&](const auto i) {                               \
+        tmp.m[i] = v##MUL##q_n_##IT(m[i], s);                           \
+    });                                                                 \
+    return tmp;                                                         \
+}
+
+#define MAT_MUL_ASSIGN_SCALAR_EXPRS(BITS, IT, MUL)                      \
+{                                                                       \
+    static_for<MSize>([&](const auto i) {                               \
+        m[i] = v##MUL##q_n_##IT(m[i], s);                               \
+    });                                                                 \
+    return *this;                                                       \
+}
+
+#define MAT_MUL_VEC_EXPRS                                               \
+{                                                                       \
+    return Vec<Scalar, Size>(mul_vec_impl(v.m));                        \
+}
+
+#define MAT_MUL_COL_EXPRS                                               \
+{                                                                       \
+    return Vec<Scalar, Size>(mul_vec_impl(vld1q_f32(v.data())));        \
+}
+
+#define MAT_MUL_MAT_EXPRS                                               \
+{                                                                       \
+    Mat tmp;                                                            \
+    static_for<Size>([&](const auto i) {                                \
+        tmp.m[i] = mul_vec_impl(mat.m[i]);                              \
+    });                                                                 \
+    return tmp;                                                         \
+}
+
+template <>
+struct alignas(16) Mat<float, 4> {
+    YAVL_MAT_ALIAS_VECTORIZED(float, 4, 4, 4)
+
+    YAVL_DEFINE_MAT_UNION(float32x4_t)
+
+    // Ctors
+    YAVL_MAT_VECTORIZED_CTOR(, f32, float32x4_t)
+    YAVL_MAT_CTOR_BY4(, f32)
+
+    // Operators
+    YAVL_DEFINE_MAT_OP(, f32, mul)
+
+    // Misc funcs
+    YAVL_DEFINE_DATA_METHOD
+
+    // Matrix manipulation methods
+    auto transpose() const {
+        Mat tmp;
+        static_for<Size>([&](const auto i) {
+            tmp.m[i] = m[i];
+        });
+        detail::transpose4(tmp.m);
+        return tmp;
+    }
+
+    Scalar determinant() const {
+        return vgetq_lane_f32(detail::mat4_determinant(m), 0);
+    }
+
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> inverse() const {
+        Mat tmp;
+        if (vgetq_lane_f32(detail::mat4_inverse<P>(m, tmp.m), 0) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, tmp);
+    }
+
+    // Only for matrices with a last row of (0, 0, 0, 1)
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> affine_inverse() const {
+        Mat tmp;
+        if (vgetq_lane_f32(detail::mat4_affine_inverse<P>(m, tmp.m), 0) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, tmp);
+    }
+
+private:
+    // Sum of the columns scaled by the lanes of v, two accumulators halve
+    // the fma chain. Lane indices have to be literals
+    float32x4_t mul_vec_impl(const float32x4_t v) const {
+        auto acc0 = vmulq_laneq_f32(m[0], v, 0);
+        auto acc1 = vmulq_laneq_f32(m[1], v, 1);
+        acc0 = vfmaq_laneq_f32(acc0, m[2], v, 2);
+        acc1 = vfmaq_laneq_f32(acc1, m[3], v, 3);
+        return vaddq_f32(acc0, acc1);
+    }
+};
+
+#undef MAT_MUL_VEC_EXPRS
+#undef MAT_MUL_COL_EXPRS
+#undef MAT_MUL_MAT_EXPRS
+
+} // namespace yavl
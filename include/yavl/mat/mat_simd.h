@@ -264,6 +264,10 @@ static inline yavl::Vec<T, 2> mat2_mul_vec_i64(const yavl::Mat<T, 2>& mat,
     return Vec<T, 2>(vm[0] + vm[1], vm[2] + vm[3]);
 }
 
+// The column broadcast impls name x86 types outside of any template
+// parameter, other archs have their own Mat * Vec
+#if defined(ARCH_X86_64) || defined(ARCH_X86_32)
+
 template <typename T, uint32_t N>
 static inline yavl::Vec<T, N> sse42_mat_mul_vec_impl(const yavl::Mat<T, N>& mat,
     const yavl::Vec<T, N>& vec)
@@ -356,6 +360,291 @@ static inline yavl::Vec<T, N> avx_mat_mul_vec_impl(const yavl::Mat<T, N>& mat,
     return tmp;
 }
 
+#endif
+
+// 4x4 inverse and determinant by 2x2 sub-determinants. A register holds a
+// 2x2 block as (m00, m01, m10, m11), the 4x4 matrix is split into blocks
+// [A B; C D] and the inverse is built from adjugates of the blocks, see
+// https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+// The functions work on rows, columns can be passed in as well since
+// inverse(transpose(M)) = transpose(inverse(M)) and the determinant doesn't
+// change
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+#if defined(YAVL_X86_SSE42)
+
+template <int X, int Y, int Z, int W>
+static inline __m128 swizzle4(const __m128 a) {
+    return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+// (a[X], a[Y], b[Z], b[W])
+template <int X, int Y, int Z, int W>
+static inline __m128 shuffle4(const __m128 a, const __m128 b) {
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+static inline __m128 setr4(const float a, const float b, const float c, const float d) {
+    return _mm_setr_ps(a, b, c, d);
+}
+
+// Sum of all lanes in every lane
+static inline __m128 hsum4(const __m128 a) {
+    auto t = _mm_add_ps(a, swizzle4<2, 3, 0, 1>(a));
+    return _mm_add_ps(t, swizzle4<1, 0, 3, 2>(t));
+}
+
+static inline void transpose4(__m128 (&a)[4]) {
+    _MM_TRANSPOSE4_PS(a[0], a[1], a[2], a[3]);
+}
+
+#endif
+
+#if defined(YAVL_X86_AVX2)
+
+template <int X, int Y, int Z, int W>
+static inline __m256d swizzle4(const __m256d a) {
+    return _mm256_permute4x64_pd(a, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+template <int X, int Y, int Z, int W>
+static inline __m256d shuffle4(const __m256d a, const __m256d b) {
+    auto lo = swizzle4<X, Y, X, Y>(a);
+    auto hi = swizzle4<Z, W, Z, W>(b);
+    return _mm256_blend_pd(lo, hi, 0b1100);
+}
+
+static inline __m256d setr4(const double a, const double b, const double c, const double d) {
+    return _mm256_setr_pd(a, b, c, d);
+}
+
+static inline __m256d hsum4(const __m256d a) {
+    auto t = _mm256_add_pd(a, _mm256_permute2f128_pd(a, a, 1));
+    return _mm256_add_pd(t, _mm256_permute_pd(t, 0b0101));
+}
+
+static inline void transpose4(__m256d (&a)[4]) {
+    auto t0 = _mm256_unpacklo_pd(a[0], a[1]);
+    auto t1 = _mm256_unpackhi_pd(a[0], a[1]);
+    auto t2 = _mm256_unpacklo_pd(a[2], a[3]);
+    auto t3 = _mm256_unpackhi_pd(a[2], a[3]);
+    a[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+    a[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+    a[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+    a[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+#endif
+
+#if defined(YAVL_ARM_NEON)
+
+template <int X, int Y, int Z, int W>
+static inline float32x4_t swizzle4(const float32x4_t a) {
+    return yavl::permute_f32<X, Y, Z, W>(a);
+}
+
+template <int X, int Y, int Z, int W>
+static inline float32x4_t shuffle4(const float32x4_t a, const float32x4_t b) {
+    return vcombine_f32(vget_low_f32(swizzle4<X, Y, X, Y>(a)),
+        vget_low_f32(swizzle4<Z, W, Z, W>(b)));
+}
+
+static inline float32x4_t setr4(const float a, const float b, const float c, const float d) {
+    const float lanes[4] = { a, b, c, d };
+    return vld1q_f32(lanes);
+}
+
+static inline float32x4_t hsum4(const float32x4_t a) {
+    return vdupq_n_f32(vaddvq_f32(a));
+}
+
+static inline void transpose4(float32x4_t (&a)[4]) {
+    auto t01 = vtrnq_f32(a[0], a[1]);
+    auto t23 = vtrnq_f32(a[2], a[3]);
+    a[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    a[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    a[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    a[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+#endif
+
+#if defined(YAVL_X86_SSE42) || defined(YAVL_X86_AVX2) || defined(YAVL_ARM_NEON)
+
+// a * b
+template <typename P>
+static inline P mat2_mul(const P a, const P b) {
+    using O = yavl::math_impl::packet_ops<P>;
+    return O::fmadd(a, swizzle4<0, 3, 0, 3>(b),
+        O::mul(swizzle4<1, 0, 3, 2>(a), swizzle4<2, 1, 2, 1>(b)));
+}
+
+// adj(a) * b
+template <typename P>
+static inline P mat2_adj_mul(const P a, const P b) {
+    using O = yavl::math_impl::packet_ops<P>;
+    return O::fnmadd(swizzle4<1, 1, 2, 2>(a), swizzle4<2, 3, 0, 1>(b),
+        O::mul(swizzle4<3, 3, 0, 0>(a), b));
+}
+
+// a * adj(b)
+template <typename P>
+static inline P mat2_mul_adj(const P a, const P b) {
+    using O = yavl::math_impl::packet_ops<P>;
+    return O::fnmadd(swizzle4<1, 0, 3, 2>(a), swizzle4<2, 1, 2, 1>(b),
+        O::mul(a, swizzle4<3, 0, 3, 0>(b)));
+}
+
+// Blocks of the rows and their determinants (det A, det B, det C, det D)
+template <typename P>
+static inline void mat4_blocks(const P (&r)[4], P& a, P& b, P& c, P& d, P& det_sub) {
+    using O = yavl::math_impl::packet_ops<P>;
+    a = shuffle4<0, 1, 0, 1>(r[0], r[1]);
+    b = shuffle4<2, 3, 2, 3>(r[0], r[1]);
+    c = shuffle4<0, 1, 0, 1>(r[2], r[3]);
+    d = shuffle4<2, 3, 2, 3>(r[2], r[3]);
+    det_sub = O::sub(
+        O::mul(shuffle4<0, 2, 0, 2>(r[0], r[2]), shuffle4<1, 3, 1, 3>(r[1], r[3])),
+        O::mul(shuffle4<1, 3, 1, 3>(r[0], r[2]), shuffle4<0, 2, 0, 2>(r[1], r[3])));
+}
+
+// det(M) = det(A) det(D) + det(B) det(C) - tr(adj(A) B adj(D) C)
+template <typename P>
+static inline P mat4_det(const P det_sub, const P a_b, const P d_c) {
+    using O = yavl::math_impl::packet_ops<P>;
+    auto det = O::fmadd(swizzle4<0, 0, 0, 0>(det_sub), swizzle4<3, 3, 3, 3>(det_sub),
+        O::mul(swizzle4<1, 1, 1, 1>(det_sub), swizzle4<2, 2, 2, 2>(det_sub)));
+    return O::sub(det, hsum4(O::mul(a_b, swizzle4<0, 2, 1, 3>(d_c))));
+}
+
+// Determinant in every lane
+template <typename P>
+static inline P mat4_determinant(const P (&r)[4]) {
+    P a, b, c, d, det_sub;
+    mat4_blocks(r, a, b, c, d, det_sub);
+    return mat4_det(det_sub, mat2_adj_mul(a, b), mat2_adj_mul(d, c));
+}
+
+// Writes the inverse to out and returns the determinant in every lane, out
+// isn't meaningful when it's 0. Prec picks how 1 / det is taken
+template <yavl::precision Prec = yavl::precision::exact, typename P>
+static inline P mat4_inverse(const P (&r)[4], P (&out)[4]) {
+    using O = yavl::math_impl::packet_ops<P>;
+    P a, b, c, d, det_sub;
+    mat4_blocks(r, a, b, c, d, det_sub);
+    auto det_a = swizzle4<0, 0, 0, 0>(det_sub);
+    auto det_b = swizzle4<1, 1, 1, 1>(det_sub);
+    auto det_c = swizzle4<2, 2, 2, 2>(det_sub);
+    auto det_d = swizzle4<3, 3, 3, 3>(det_sub);
+
+    auto d_c = mat2_adj_mul(d, c);
+    auto a_b = mat2_adj_mul(a, b);
+    auto det = mat4_det(det_sub, a_b, d_c);
+
+    // Blocks of the inverse times det, before the adjugate
+    auto x = O::sub(O::mul(det_d, a), mat2_mul(b, d_c));
+    auto w = O::sub(O::mul(det_a, d), mat2_mul(c, a_b));
+    auto y = O::sub(O::mul(det_b, c), mat2_mul_adj(d, a_b));
+    auto z = O::sub(O::mul(det_c, b), mat2_mul_adj(a, d_c));
+
+    using T = typename O::Scalar;
+    auto sign = setr4(T(1), T(-1), T(-1), T(1));
+    P rdet;
+    if constexpr (Prec == yavl::precision::exact)
+        rdet = O::div(sign, det);
+    else
+        rdet = O::mul(sign, O::template rcp<Prec>(det));
+    x = O::mul(x, rdet);
+    y = O::mul(y, rdet);
+    z = O::mul(z, rdet);
+    w = O::mul(w, rdet);
+
+    out[0] = shuffle4<3, 1, 3, 1>(x, y);
+    out[1] = shuffle4<2, 0, 2, 0>(x, y);
+    out[2] = shuffle4<3, 1, 3, 1>(z, w);
+    out[3] = shuffle4<2, 0, 2, 0>(z, w);
+    return det;
+}
+
+template <typename P>
+static inline P cross3(const P a, const P b) {
+    using O = yavl::math_impl::packet_ops<P>;
+    return O::fnmadd(swizzle4<2, 0, 1, 3>(a), swizzle4<1, 2, 0, 3>(b),
+        O::mul(swizzle4<1, 2, 0, 3>(a), swizzle4<2, 0, 1, 3>(b)));
+}
+
+// 3x3 determinant of padded columns in every lane
+template <typename P>
+static inline P mat3_determinant(const P (&col)[3]) {
+    using O = yavl::math_impl::packet_ops<P>;
+    return hsum4(O::mul(col[0], cross3(col[1], col[2])));
+}
+
+// Inverse of a 3x3 matrix of padded columns, the last components must be
+// 0. Rows of the inverse are the cross products of the columns over the
+// determinant, which is returned in every lane
+template <yavl::precision Prec = yavl::precision::exact, typename P>
+static inline P mat3_inverse(const P (&col)[3], P (&out)[3]) {
+    using O = yavl::math_impl::packet_ops<P>;
+    P r[4] = {
+        cross3(col[1], col[2]),
+        cross3(col[2], col[0]),
+        cross3(col[0], col[1]),
+        O::set1(0)
+    };
+    auto det = hsum4(O::mul(col[0], r[0]));
+    P rdet;
+    if constexpr (Prec == yavl::precision::exact)
+        rdet = O::div(O::set1(1), det);
+    else
+        rdet = O::template rcp<Prec>(det);
+    yavl::static_for<3>([&](const auto i) {
+        r[i] = O::mul(r[i], rdet);
+    });
+    transpose4(r);
+    yavl::static_for<3>([&](const auto i) {
+        out[i] = r[i];
+    });
+    return det;
+}
+
+// Inverse of an affine matrix [A t; 0 1] given by columns, the last
+// component of the first three columns must be 0. The inverse is
+// [inverse(A) -inverse(A) t; 0 1], returns det(A) in every lane
+template <yavl::precision Prec = yavl::precision::exact, typename P>
+static inline P mat4_affine_inverse(const P (&col)[4], P (&out)[4]) {
+    using O = yavl::math_impl::packet_ops<P>;
+    using T = typename O::Scalar;
+    P a[3] = { col[0], col[1], col[2] };
+    P inv[3];
+    auto det = mat3_inverse<Prec>(a, inv);
+
+    auto t = col[3];
+    out[3] = O::fnmadd(inv[2], swizzle4<2, 2, 2, 2>(t), setr4(T(0), T(0), T(0), T(1)));
+    out[3] = O::fnmadd(inv[1], swizzle4<1, 1, 1, 1>(t), out[3]);
+    out[3] = O::fnmadd(inv[0], swizzle4<0, 0, 0, 0>(t), out[3]);
+    yavl::static_for<3>([&](const auto i) {
+        out[i] = inv[i];
+    });
+    return det;
+}
+
+#endif
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
+
 } // namespace detail
 
 #if defined(YAVL_X86_SSE42) || defined(YAVL_X86_AVX) || defined(YAVL_X86_AVX512ER)
@@ -405,6 +694,16 @@ struct Col<float, 3> {
     YAVL_DEFINE_COL_BASIC_FP_OP(, ps, ps)
 };
 
+} // namespace yavl
+
+#endif
+
+// Double precision columns live in ymm registers
+#if defined(YAVL_X86_AVX) || defined(YAVL_X86_AVX512ER)
+
+namespace yavl
+{
+
 template <>
 struct Col<double, 4> {
     YAVL_TYPE_ALIAS(double, 4, 4)
@@ -460,18 +759,22 @@ struct Col<double, 3> {
     #include <yavl/mat/mat2_avx.h>
 #endif
 
-// Cascaded including, using max bits intrinsic set available
-#if defined(YAVL_X86_AVX512ER) && !defined(YAVL_FORCE_SSE_MAT) && !defined(YAVL_FORCE_AVX_MAT)
-    #include <yavl/mat/mat_avx512.h>
-    #include <yavl/mat/mat3_avx.h>
-    #include <yavl/mat/mat3_avx2.h>
-#elif defined(YAVL_X86_AVX) && defined(YAVL_X86_AVX2) && !defined(YAVL_FORCE_SSE_MAT)
+// Cascaded including, using max bits intrinsic set available. The AVX-512
+// header only provides Mat<float, 4>, the AVX ones fill in the other types
+#if defined(YAVL_X86_AVX) && defined(YAVL_X86_AVX2) && !defined(YAVL_FORCE_SSE_MAT)
+    #if defined(YAVL_X86_AVX512F) && !defined(YAVL_FORCE_AVX_MAT)
+        #define YAVL_AVX512_MAT4F 1
+        #include <yavl/mat/mat_avx512.h>
+    #endif
     #include <yavl/mat/mat_avx.h>
     #include <yavl/mat/mat_avx2.h>
-    #include <yavl/mat/mat3_avx.h>
+    #include <yavl/mat/mat3_sse42.h>
     #include <yavl/mat/mat3_avx2.h>
 #elif defined(YAVL_X86_SSE42)
     #include <yavl/mat/mat_sse42.h>
+    #include <yavl/mat/mat3_sse42.h>
+#elif defined(YAVL_ARM_NEON)
+    #include <yavl/mat/mat_neon.h>
 #endif
 
 #undef MAT_MUL_SCAlAR_EXPRS
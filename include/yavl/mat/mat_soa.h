@@ -0,0 +1,293 @@
+#pragma once
+
+// Width matrices in SoA layout, the matrix counterpart of VecSoA.
+//
+// Element (c, r) of all Width matrices shares one packet, so a product of
+// two packs is N^3 vertical fmas with no shuffles or broadcasts, 64 for a
+// Mat4x8f computing 8 products. Converting from and to Width consecutive
+// Mats costs two 8x8 transposes per direction for Mat4x8f, keeping
+// hierarchies in this layout across frames avoids it.
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_soa.h>
+#include <yavl/vec/vec_math.h>
+#include <yavl/mat/mat.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace soa_impl
+{
+
+// Register holding a whole packet of Bytes, T if there is none
+template <typename T, std::size_t Bytes>
+struct packet_for {
+    using type = T;
+};
+
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+#if defined(YAVL_X86_SSE42) || defined(YAVL_ARM_NEON)
+template <typename T>
+struct packet_for<T, 16> {
+    using type = math_impl::packet128_t<T>;
+};
+#endif
+#if defined(YAVL_X86_AVX2)
+template <typename T>
+struct packet_for<T, 32> {
+    using type = math_impl::packet256_t<T>;
+};
+#endif
+#if defined(YAVL_X86_AVX512F)
+template <typename T>
+struct packet_for<T, 64> {
+    using type = math_impl::packet512_t<T>;
+};
+#endif
+#endif
+
+// a * b + c on every lane
+template <typename V>
+static inline V fmadd(const V& a, const V& b, const V& c) {
+    using T = typename V::Scalar;
+    using P = typename packet_for<T, sizeof(T) * V::Size>::type;
+    using O = math_impl::packet_ops<P>;
+    V r;
+    for (uint32_t i = 0; i < V::Size; i += O::Width)
+        O::storeu(r.arr.data() + i, O::fmadd(O::loadu(a.arr.data() + i),
+            O::loadu(b.arr.data() + i), O::loadu(c.arr.data() + i)));
+    return r;
+}
+
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_AVX)
+
+// Rows become columns, the same sequence goes both ways. Written out, GCC
+// neither unrolls the loops nor inlines nested static_for lambdas this large
+static inline void transpose8(__m256 (&r)[8]) {
+    const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// Row i of the 8x8 block at src goes to column i at dst, rows are
+// separated by the strides in floats
+static inline void transpose8(const float* src, const std::size_t src_stride,
+    float* dst, const std::size_t dst_stride)
+{
+    __m256 r[8] = {
+        _mm256_loadu_ps(src), _mm256_loadu_ps(src + src_stride),
+        _mm256_loadu_ps(src + src_stride * 2), _mm256_loadu_ps(src + src_stride * 3),
+        _mm256_loadu_ps(src + src_stride * 4), _mm256_loadu_ps(src + src_stride * 5),
+        _mm256_loadu_ps(src + src_stride * 6), _mm256_loadu_ps(src + src_stride * 7) };
+    transpose8(r);
+    _mm256_storeu_ps(dst, r[0]);
+    _mm256_storeu_ps(dst + dst_stride, r[1]);
+    _mm256_storeu_ps(dst + dst_stride * 2, r[2]);
+    _mm256_storeu_ps(dst + dst_stride * 3, r[3]);
+    _mm256_storeu_ps(dst + dst_stride * 4, r[4]);
+    _mm256_storeu_ps(dst + dst_stride * 5, r[5]);
+    _mm256_storeu_ps(dst + dst_stride * 6, r[6]);
+    _mm256_storeu_ps(dst + dst_stride * 7, r[7]);
+}
+
+#endif
+
+} // namespace soa_impl
+
+// Width N x N matrices in SoA layout. arr[c * Size + r] holds element
+// (c, r), column c and row r, of every matrix, the column major order of
+// Mat
+template <typename T, uint32_t N, uint32_t W = native_width<T>>
+struct MatSoA {
+    YAVL_MAT_ALIAS(T, N, W)
+    static constexpr uint32_t Width = W;
+    static constexpr bool vectorized = Vec<T, W>::vectorized;
+
+    using Packet = Vec<Scalar, Width>;
+    using Element = Mat<Scalar, Size>;
+    using VecPack = VecSoA<Scalar, Size, Width>;
+
+    std::array<Packet, Size2> arr;
+
+    // Ctors
+    MatSoA() = default;
+
+    MatSoA(const Scalar s) {
+        arr.fill(Packet(s));
+    }
+
+    // Broadcast a single matrix to all lanes
+    MatSoA(const Element& m) {
+        static_for<Size>([&](const auto c) {
+            static_for<Size>([&](const auto r) {
+                arr[c * Size + r] = Packet(m[c][r]);
+            });
+        });
+    }
+
+    // Load/store from Width consecutive AoS matrices
+    static MatSoA load(const Element* src) {
+        MatSoA tmp;
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_AVX)
+        if constexpr (std::is_same_v<Scalar, float> && Size == 4 && Width == 8) {
+            // Two 8x8 blocks, matrices by elements 0-7 and 8-15
+            static_assert(sizeof(Element) == sizeof(float) * 16 && sizeof(Packet) == sizeof(__m256));
+            const float* in = src[0].data();
+            soa_impl::transpose8(in, 16, tmp.arr[0].arr.data(), 8);
+            soa_impl::transpose8(in + 8, 16, tmp.arr[8].arr.data(), 8);
+            return tmp;
+        }
+#endif
+        for (uint32_t l = 0; l < Width; ++l)
+            tmp.set(l, src[l]);
+        return tmp;
+    }
+
+    void store(Element* dst) const {
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_AVX)
+        if constexpr (std::is_same_v<Scalar, float> && Size == 4 && Width == 8) {
+            float* out = dst[0].data();
+            soa_impl::transpose8(arr[0].arr.data(), 8, out, 16);
+            soa_impl::transpose8(arr[8].arr.data(), 8, out + 8, 16);
+            return;
+        }
+#endif
+        for (uint32_t l = 0; l < Width; ++l)
+            dst[l] = get(l);
+    }
+
+    // Lane access
+    Element get(const uint32_t lane) const {
+        assert(lane < Width);
+        Element tmp;
+        static_for<Size>([&](const auto c) {
+            static_for<Size>([&](const auto r) {
+                tmp[c][r] = arr[c * Size + r][lane];
+            });
+        });
+        return tmp;
+    }
+
+    void set(const uint32_t lane, const Element& m) {
+        assert(lane < Width);
+        static_for<Size>([&](const auto c) {
+            static_for<Size>([&](const auto r) {
+                arr[c * Size + r][lane] = m[c][r];
+            });
+        });
+    }
+
+    // Operators
+    Packet& operator [](const uint32_t i) {
+        assert(i < Size2);
+        return arr[i];
+    }
+
+    const Packet& operator [](const uint32_t i) const {
+        assert(i < Size2);
+        return arr[i];
+    }
+
+    MatSoA operator *(const MatSoA& b) const {
+        MatSoA tmp;
+        static_for<Size>([&](const auto c) {
+            static_for<Size>([&](const auto r) {
+                Packet acc = arr[r] * b.arr[c * Size];
+                static_for<Size - 1>([&](const auto k) {
+                    acc = soa_impl::fmadd(arr[(k + 1) * Size + r],
+                        b.arr[c * Size + k + 1], acc);
+                });
+                tmp.arr[c * Size + r] = acc;
+            });
+        });
+        return tmp;
+    }
+
+    MatSoA& operator *=(const MatSoA& b) {
+        *this = *this * b;
+        return *this;
+    }
+
+    VecPack operator *(const VecPack& v) const {
+        VecPack tmp;
+        static_for<Size>([&](const auto r) {
+            Packet acc = arr[r] * v.arr[0];
+            static_for<Size - 1>([&](const auto k) {
+                acc = soa_impl::fmadd(arr[(k + 1) * Size + r], v.arr[k + 1], acc);
+            });
+            tmp.arr[r] = acc;
+        });
+        return tmp;
+    }
+
+    // Matrix manipulation methods
+    MatSoA transpose() const {
+        MatSoA tmp;
+        static_for<Size>([&](const auto c) {
+            static_for<Size>([&](const auto r) {
+                tmp.arr[r * Size + c] = arr[c * Size + r];
+            });
+        });
+        return tmp;
+    }
+};
+
+// SoA type aliasing
+template <typename T, uint32_t W = native_width<T>>
+using Mat3SoA = MatSoA<T, 3, W>;
+
+template <typename T, uint32_t W = native_width<T>>
+using Mat4SoA = MatSoA<T, 4, W>;
+
+using Mat3fSoA = Mat3SoA<float>;
+using Mat3dSoA = Mat3SoA<double>;
+using Mat4fSoA = Mat4SoA<float>;
+using Mat4dSoA = Mat4SoA<double>;
+
+// Eight Mat4f in one __m256 per element
+using Mat4x8f = MatSoA<float, 4, 8>;
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
@@ -22,7 +22,7 @@ namespace yavl
     static_for<Size>([&](const auto i) {                                \
         static_for<Size>([&](const auto j) {                            \
             auto bij = _mm_set1_ps(mat[i][j]);                          \
-            tmp.m[i] = _mm_fmadd_ps(m[j], bij, tmp.m[i]);               \
+            tmp.m[i] = MULADD(, ps, m[j], bij, tmp.m[i]);               \
         });                                                             \
     });                                                                 \
     return tmp;                                                         \
@@ -54,37 +54,26 @@ struct alignas(16) Mat<float, 4> {
         _MM_TRANSPOSE4_PS(tmp.m[0], tmp.m[1], tmp.m[2], tmp.m[3]);
         return tmp;
     }
-};
-
-template <>
-struct alignas(16) Mat<float, 3> {
-    YAVL_MAT_ALIAS_VECTORIZED(float, 3, 4, 3)
-
-    YAVL_DEFINE_MAT_UNION(__m128)
-    
-    // Ctors
-    YAVL_MAT_VECTORIZED_CTOR(, ps, __m128)
-    YAVL_MAT_CTOR_BY3(, ps)
 
-    // Operators
-    YAVL_DEFINE_MAT3_INDEX_OP
-    YAVL_DEFINE_MAT_MUL_OP(, ps, mul)
+    Scalar determinant() const {
+        return _mm_cvtss_f32(detail::mat4_determinant(m));
+    }
 
-    // Misc funcs
-    YAVL_DEFINE_DATA_METHOD
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> inverse() const {
+        Mat tmp;
+        if (_mm_cvtss_f32(detail::mat4_inverse<P>(m, tmp.m)) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, tmp);
+    }
 
-    // Matrix manipulation methods
-    auto transpose() const {
-        Mat<Scalar, 4> tmp4;
-        tmp4.m[0] = m[0];
-        tmp4.m[1] = m[1];
-        tmp4.m[2] = m[2];
-        _MM_TRANSPOSE4_PS(tmp4.m[0], tmp4.m[1], tmp4.m[2], tmp4.m[3]);
+    // Only for matrices with a last row of (0, 0, 0, 1)
+    template <precision P = precision::exact>
+    std::pair<bool, Mat> affine_inverse() const {
         Mat tmp;
-        tmp.m[0] = tmp4.m[0];
-        tmp.m[1] = tmp4.m[1];
-        tmp.m[2] = tmp4.m[2];
-        return tmp;
+        if (_mm_cvtss_f32(detail::mat4_affine_inverse<P>(m, tmp.m)) == 0)
+            return std::make_pair(false, Mat{0});
+        return std::make_pair(true, tmp);
     }
 };
 
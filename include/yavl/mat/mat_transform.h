@@ -0,0 +1,391 @@
+#pragma once
+
+// Bulk transforms of point, direction and normal arrays by a Mat4f, and
+// batched Mat4 products and inverses.
+//
+// Looping over Mat4f * Vec4f reloads the matrix columns for every point.
+// Here the 16 matrix elements are broadcast into registers once, and a
+// batch of records(8 with SSE4.2 and AVX2, 16 with AVX-512) is transposed
+// from xyzw records into x, y, z and w registers inside each 128 bit lane,
+// transformed with 3 to 4 fmas per output component, and transposed back.
+//
+// Outputs past streaming_store_threshold bytes are written with
+// non-temporal stores by default, so a large point cloud doesn't evict the
+// working set from the cache. in and out may be the same array.
+//
+// Batched products fill a whole register with W / 4 columns of the result:
+// column k of a broadcast to every 128 bit lane times element k of each
+// result column splatted within its lane, 16 / W times 4 fmas per product
+// and no scalar inserts.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_math.h>
+#include <yavl/vec/vec_view.h>
+#include <yavl/mat/mat.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace transform_impl
+{
+
+enum class kind {
+    point,      // w = 1, w of the result dropped
+    direction,  // w = 0, w of the result dropped
+    vec4        // w from the input
+};
+
+template <kind K>
+static inline Vec4f apply(const Mat4f& m, const float* p) {
+    if constexpr (K == kind::point)
+        return m * Vec4f{ p[0], p[1], p[2], 1.f };
+    else if constexpr (K == kind::direction)
+        return m * Vec4f{ p[0], p[1], p[2], 0.f };
+    else
+        return m * Vec4f{ p[0], p[1], p[2], p[3] };
+}
+
+template <kind K, typename VO>
+static inline void transform_scalar(const Mat4f& m, const float* in, VO* out,
+    const std::size_t n, const std::size_t stride)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        auto r = apply<K>(m, in + i * stride);
+        if constexpr (VO::Size == 3)
+            out[i] = VO{ r.x, r.y, r.z };
+        else
+            out[i] = r;
+    }
+}
+
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+
+#if defined(YAVL_X86_SSE42)
+// transpose4 is the lane local one of the views
+using view_impl::transpose4;
+#endif
+
+#define YAVL_DEFINE_LANE_FUNCS(BITS, PT)                                \
+    static inline void stream(float* p, const PT a) {                   \
+        _mm##BITS##_stream_ps(p, a);                                    \
+    }                                                                   \
+    template <int K>                                                    \
+    static inline PT splat_in_lanes(const PT a) {                       \
+        return _mm##BITS##_shuffle_ps(a, a, _MM_SHUFFLE(K, K, K, K));   \
+    }
+
+#if defined(YAVL_X86_SSE42)
+YAVL_DEFINE_LANE_FUNCS(, __m128)
+
+static inline __m128 broadcast_col(const float* p, __m128) {
+    return _mm_loadu_ps(p);
+}
+#endif
+
+#if defined(YAVL_X86_AVX2)
+YAVL_DEFINE_LANE_FUNCS(256, __m256)
+
+static inline __m256 broadcast_col(const float* p, __m256) {
+    return _mm256_broadcast_ps(reinterpret_cast<const __m128*>(p));
+}
+#endif
+
+#if defined(YAVL_X86_AVX512F)
+YAVL_DEFINE_LANE_FUNCS(512, __m512)
+
+static inline __m512 broadcast_col(const float* p, __m512) {
+    return _mm512_broadcast_f32x4(_mm_loadu_ps(p));
+}
+#endif
+
+#undef YAVL_DEFINE_LANE_FUNCS
+
+// Transform W records of 4 floats, W being the floats in a register. Each
+// register holds W / 4 records, after the transpose lane l of register c
+// is component c of record l % 4 * W / 4 + l / 4, the order doesn't matter
+// since the transpose back restores it
+template <typename P, kind K, bool Stream>
+static inline void transform_block(const P (&c)[16], const float* in, float* out) {
+    using O = math_impl::packet_ops<P>;
+    constexpr uint32_t W = O::Width;
+
+    P a[4];
+    static_for<4>([&](const auto i) {
+        a[i] = O::loadu(in + i * W);
+    });
+    transpose4(a[0], a[1], a[2], a[3]);
+
+    P r[4];
+    constexpr uint32_t rows = K == kind::vec4 ? 4 : 3;
+    static_for<rows>([&](const auto i) {
+        P acc;
+        if constexpr (K == kind::point)
+            acc = O::fmadd(c[8 + i], a[2], c[12 + i]);
+        else if constexpr (K == kind::direction)
+            acc = O::mul(c[8 + i], a[2]);
+        else
+            acc = O::fmadd(c[8 + i], a[2], O::mul(c[12 + i], a[3]));
+        acc = O::fmadd(c[4 + i], a[1], acc);
+        r[i] = O::fmadd(c[i], a[0], acc);
+    });
+    // Padding lane of Vec3f
+    if constexpr (rows == 3)
+        r[3] = O::set1(0.f);
+    transpose4(r[0], r[1], r[2], r[3]);
+
+    static_for<4>([&](const auto i) {
+        if constexpr (Stream)
+            stream(out + i * W, r[i]);
+        else
+            O::storeu(out + i * W, r[i]);
+    });
+}
+
+// Process as many whole batches as fit in n, returns the records done
+template <typename P, uint32_t Unroll, kind K, bool Stream>
+static inline std::size_t transform_batches(const Mat4f& m, const float* in,
+    float* out, const std::size_t n)
+{
+    using O = math_impl::packet_ops<P>;
+    constexpr uint32_t W = O::Width;
+    constexpr std::size_t batch = W * Unroll;
+
+    P c[16];
+    static_for<16>([&](const auto i) {
+        c[i] = O::set1(m.data()[i]);
+    });
+
+    std::size_t i = 0;
+    for (; i + batch <= n; i += batch) {
+        static_for<Unroll>([&](const auto u) {
+            const std::size_t offset = (i + u * W) * 4;
+            transform_block<P, K, Stream>(c, in + offset, out + offset);
+        });
+    }
+    return i;
+}
+
+template <kind K, bool Stream>
+static inline std::size_t transform_widest(const Mat4f& m, const float* in,
+    float* out, const std::size_t n)
+{
+#if defined(YAVL_X86_AVX512F)
+    return transform_batches<__m512, 1, K, Stream>(m, in, out, n);
+#elif defined(YAVL_X86_AVX2)
+    return transform_batches<__m256, 1, K, Stream>(m, in, out, n);
+#elif defined(YAVL_X86_SSE42)
+    return transform_batches<__m128, 2, K, Stream>(m, in, out, n);
+#else
+    return 0;
+#endif
+}
+
+// out = a * b for one product, out may be a or b
+template <typename P>
+static inline void multiply_block(const float* a, const float* b, float* out) {
+    using O = math_impl::packet_ops<P>;
+    constexpr uint32_t W = O::Width;
+
+    P r[16 / W];
+    static_for<16 / W>([&](const auto h) {
+        const P bh = O::loadu(b + h * W);
+        P acc = O::mul(broadcast_col(a, P{}), splat_in_lanes<0>(bh));
+        acc = O::fmadd(broadcast_col(a + 4, P{}), splat_in_lanes<1>(bh), acc);
+        acc = O::fmadd(broadcast_col(a + 8, P{}), splat_in_lanes<2>(bh), acc);
+        r[h] = O::fmadd(broadcast_col(a + 12, P{}), splat_in_lanes<3>(bh), acc);
+    });
+    static_for<16 / W>([&](const auto h) {
+        O::storeu(out + h * W, r[h]);
+    });
+}
+
+#if defined(YAVL_X86_AVX512F)
+static constexpr std::size_t stream_alignment = 64;
+#elif defined(YAVL_X86_AVX2)
+static constexpr std::size_t stream_alignment = 32;
+#else
+static constexpr std::size_t stream_alignment = 16;
+#endif
+
+#endif // YAVL_DISABLE_VECTORIZATION
+
+template <kind K, typename VI, typename VO>
+static inline void transform_array(const Mat4f& m, std::span<const VI> in,
+    std::span<VO> out, const store_policy policy)
+{
+    assert(out.size() >= in.size());
+    const std::size_t n = in.size();
+    const float* src = reinterpret_cast<const float*>(in.data());
+    float* dst = reinterpret_cast<float*>(out.data());
+    constexpr std::size_t stride = sizeof(VI) / sizeof(float);
+
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_SSE42)
+    static_assert(sizeof(VI) == 16 && sizeof(VO) == 16);
+
+    const bool stream = use_streaming_stores(policy, n * sizeof(VO));
+
+    std::size_t done = 0;
+    if (stream) {
+        // Non-temporal stores need aligned addresses, VO is 16 byte
+        // aligned so only whole records are needed to get there
+        const auto misalign = reinterpret_cast<uintptr_t>(dst) % stream_alignment;
+        std::size_t head = misalign ? (stream_alignment - misalign) / sizeof(VO) : 0;
+        head = std::min(head, n);
+        transform_scalar<K>(m, src, out.data(), head, stride);
+        done = head + transform_widest<K, true>(m, src + head * stride,
+            dst + head * stride, n - head);
+        _mm_sfence();
+    }
+    else {
+        done = transform_widest<K, false>(m, src, dst, n);
+    }
+
+    transform_scalar<K>(m, src + done * stride, out.data() + done, n - done, stride);
+#else
+    (void)policy;
+    (void)dst;
+    transform_scalar<K>(m, src, out.data(), n, stride);
+#endif
+}
+
+// out = a * b on column major floats, out may be a or b
+static inline void multiply_one(const float* a, const float* b, float* out) {
+#if defined(YAVL_X86_AVX512F)
+    multiply_block<__m512>(a, b, out);
+#elif defined(YAVL_X86_AVX2)
+    multiply_block<__m256>(a, b, out);
+#elif defined(YAVL_X86_SSE42)
+    multiply_block<__m128>(a, b, out);
+#else
+    Mat4f ma, mb;
+    std::memcpy(ma.data(), a, sizeof(float) * 16);
+    std::memcpy(mb.data(), b, sizeof(float) * 16);
+    const Mat4f r = ma * mb;
+    std::memcpy(out, r.data(), sizeof(float) * 16);
+#endif
+}
+
+static inline void multiply_array(std::span<const Mat4f> a, std::span<const Mat4f> b,
+    std::span<Mat4f> out)
+{
+    assert(a.size() == b.size() && out.size() >= a.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+        multiply_one(a[i].data(), b[i].data(), out[i].data());
+}
+
+template <precision P, typename M>
+static inline bool inverse_array(std::span<const M> in, std::span<M> out) {
+    assert(out.size() >= in.size());
+    bool all_invertible = true;
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        auto [invertible, inv] = in[i].template inverse<P>();
+        out[i] = inv;
+        all_invertible &= invertible;
+    }
+    return all_invertible;
+}
+
+// Inverse transpose of the upper 3x3 of m, which must be invertible
+static inline Mat4f normal_matrix(const Mat4f& m) {
+    // With columns c0, c1, c2 the inverse transpose is
+    // [c1 x c2, c2 x c0, c0 x c1] / det
+    const float* a = m.data();
+    auto cross = [&](const uint32_t i, const uint32_t j, float* r) {
+        const float* u = a + i * 4;
+        const float* v = a + j * 4;
+        r[0] = u[1] * v[2] - u[2] * v[1];
+        r[1] = u[2] * v[0] - u[0] * v[2];
+        r[2] = u[0] * v[1] - u[1] * v[0];
+    };
+    float b[3][3];
+    cross(1, 2, b[0]);
+    cross(2, 0, b[1]);
+    cross(0, 1, b[2]);
+    const float inv_det = 1.f / (a[0] * b[0][0] + a[1] * b[0][1] + a[2] * b[0][2]);
+
+    return Mat4f{
+        b[0][0] * inv_det, b[0][1] * inv_det, b[0][2] * inv_det, 0.f,
+        b[1][0] * inv_det, b[1][1] * inv_det, b[1][2] * inv_det, 0.f,
+        b[2][0] * inv_det, b[2][1] * inv_det, b[2][2] * inv_det, 0.f,
+        0.f, 0.f, 0.f, 1.f
+    };
+}
+
+} // namespace transform_impl
+
+// out[i] = m * (in[i], 1), the w of the result is dropped so projective
+// matrices need the Vec4f overload and a divide
+inline void transform_points(const Mat4f& m, std::span<const Vec3f> in,
+    std::span<Vec3f> out, const store_policy policy = store_policy::automatic)
+{
+    transform_impl::transform_array<transform_impl::kind::point>(m, in, out, policy);
+}
+
+// out[i] = m * in[i]
+inline void transform_points(const Mat4f& m, std::span<const Vec4f> in,
+    std::span<Vec4f> out, const store_policy policy = store_policy::automatic)
+{
+    transform_impl::transform_array<transform_impl::kind::vec4>(m, in, out, policy);
+}
+
+// out[i] = m * (in[i], 0), translation doesn't apply
+inline void transform_directions(const Mat4f& m, std::span<const Vec3f> in,
+    std::span<Vec3f> out, const store_policy policy = store_policy::automatic)
+{
+    transform_impl::transform_array<transform_impl::kind::direction>(m, in, out, policy);
+}
+
+// Normals go through the inverse transpose of the upper 3x3 of m so they
+// stay perpendicular to transformed surfaces, which must be invertible.
+// Results aren't renormalized
+inline void transform_normals(const Mat4f& m, std::span<const Vec3f> in,
+    std::span<Vec3f> out, const store_policy policy = store_policy::automatic)
+{
+    const Mat4f nm = transform_impl::normal_matrix(m);
+    transform_impl::transform_array<transform_impl::kind::direction>(nm, in, out, policy);
+}
+
+// out[i] = a[i] * b[i], out may be a or b
+inline void multiply(std::span<const Mat4f> a, std::span<const Mat4f> b,
+    std::span<Mat4f> out)
+{
+    transform_impl::multiply_array(a, b, out);
+}
+
+// out[i] = inverse of in[i], singular matrices come out as zero matrices
+// and make the result false. in and out may be the same array
+template <precision P = precision::exact>
+inline bool inverse(std::span<const Mat4f> in, std::span<Mat4f> out) {
+    return transform_impl::inverse_array<P>(in, out);
+}
+
+template <precision P = precision::exact>
+inline bool inverse(std::span<const Mat4d> in, std::span<Mat4d> out) {
+    return transform_impl::inverse_array<P>(in, out);
+}
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
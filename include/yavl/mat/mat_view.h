@@ -0,0 +1,250 @@
+#pragma once
+
+// Matrix counterpart of VecView, and the bulk functions of mat_transform.h
+// running directly on viewed memory.
+//
+// A MatView reads column major records of N * N scalars, packed, a run time
+// stride apart or in the layout of Mat<T, N>. Transforms over VecViews keep
+// the matrix broadcast into a MatSoA and work on whole VecSoA packets, so a
+// packed xyz buffer costs the same shuffles as a view load and store plus 9
+// fmas per packet of points.
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_soa.h>
+#include <yavl/vec/vec_view.h>
+#include <yavl/mat/mat.h>
+#include <yavl/mat/mat_soa.h>
+#include <yavl/mat/mat_transform.h>
+
+namespace yavl
+{
+
+template <typename T, uint32_t N, view_layout L = view_layout::packed>
+struct MatView {
+    YAVL_TYPE_ALIAS(T, N, N)
+    static constexpr uint32_t Size2 = N * N;
+    static constexpr view_layout Layout = L;
+
+    using Element = Mat<Scalar, Size>;
+
+    // Columns of an aligned Mat3f are padded like Vec3f
+    static constexpr std::size_t ColStride = L == view_layout::aligned ?
+        sizeof(Element) / sizeof(Scalar) / N : N;
+    static constexpr std::size_t FixedStride = L == view_layout::strided ? 0 :
+        ColStride * N;
+
+    Scalar* arr = nullptr;
+    std::size_t count = 0;
+    std::size_t stride = FixedStride;
+
+    // Ctors
+    MatView() = default;
+
+    MatView(const Scalar* d, const std::size_t n) requires (L != view_layout::strided)
+        : arr(const_cast<Scalar*>(d)), count(n)
+    {
+        if constexpr (L == view_layout::aligned)
+            assert(reinterpret_cast<uintptr_t>(d) % alignof(Element) == 0);
+    }
+
+    // s is in scalars, from the start of one record to the next
+    MatView(const Scalar* d, const std::size_t n, const std::size_t s)
+        requires (L == view_layout::strided)
+        : arr(const_cast<Scalar*>(d)), count(n), stride(s)
+    {
+        assert(s >= Size2);
+    }
+
+    explicit MatView(std::span<const Element> s) requires (L == view_layout::aligned)
+        : MatView(reinterpret_cast<const Scalar*>(s.data()), s.size()) {}
+
+    // Capacity
+    inline std::size_t size() const {
+        return count;
+    }
+
+    inline bool empty() const {
+        return count == 0;
+    }
+
+    inline Scalar* data() const {
+        return arr;
+    }
+
+    inline Scalar* record(const std::size_t i) const {
+        return arr + i * (FixedStride ? FixedStride : stride);
+    }
+
+    inline std::span<Element> span() const requires (L == view_layout::aligned) {
+        return std::span<Element>(reinterpret_cast<Element*>(arr), count);
+    }
+
+    // Element access
+    inline Element get(const std::size_t i) const {
+        assert(i < count);
+        const Scalar* p = record(i);
+        Element tmp;
+        static_for<Size>([&](const auto c) {
+            static_for<Size>([&](const auto r) {
+                tmp[c][r] = p[c * ColStride + r];
+            });
+        });
+        return tmp;
+    }
+
+    inline void set(const std::size_t i, const Element& m) const {
+        assert(i < count);
+        Scalar* p = record(i);
+        static_for<Size>([&](const auto c) {
+            static_for<Size>([&](const auto r) {
+                p[c * ColStride + r] = m[c][r];
+            });
+        });
+    }
+
+    inline Element operator [](const std::size_t i) const {
+        return get(i);
+    }
+
+    // Packet access, records i to i + W - 1 must be in the view
+    template <uint32_t W = native_width<T>>
+    inline MatSoA<T, N, W> load(const std::size_t i) const {
+        assert(i + W <= count);
+        MatSoA<T, N, W> tmp;
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_AVX)
+        if constexpr (std::is_same_v<Scalar, float> && Size == 4 && W == 8) {
+            // Same two 8x8 blocks as MatSoA::load, a record stride apart
+            const float* in = record(i);
+            soa_impl::transpose8(in, stride, tmp.arr[0].arr.data(), 8);
+            soa_impl::transpose8(in + 8, stride, tmp.arr[8].arr.data(), 8);
+            return tmp;
+        }
+#endif
+        for (uint32_t l = 0; l < W; ++l)
+            tmp.set(l, get(i + l));
+        return tmp;
+    }
+
+    template <uint32_t W>
+    inline void store(const std::size_t i, const MatSoA<T, N, W>& m) const {
+        assert(i + W <= count);
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_AVX)
+        if constexpr (std::is_same_v<Scalar, float> && Size == 4 && W == 8) {
+            float* out = record(i);
+            soa_impl::transpose8(m.arr[0].arr.data(), 8, out, stride);
+            soa_impl::transpose8(m.arr[8].arr.data(), 8, out + 8, stride);
+            return;
+        }
+#endif
+        for (uint32_t l = 0; l < W; ++l)
+            set(i + l, m.get(l));
+    }
+};
+
+// View type aliasing
+using Mat4fView = MatView<float, 4, view_layout::packed>;
+
+namespace view_impl
+{
+
+// W records of in through the broadcast matrix c, the kind as in
+// transform_impl
+template <transform_impl::kind K, uint32_t NI, uint32_t NO, uint32_t W>
+static inline VecSoA<float, NO, W> transform_packet(const MatSoA<float, 4, W>& c,
+    const VecSoA<float, NI, W>& v)
+{
+    using Packet = typename VecSoA<float, NO, W>::Packet;
+    VecSoA<float, NO, W> r;
+    static_for<NO>([&](const auto i) {
+        Packet acc;
+        if constexpr (K == transform_impl::kind::point)
+            acc = soa_impl::fmadd(c[8 + i], v.arr[2], c[12 + i]);
+        else if constexpr (K == transform_impl::kind::direction)
+            acc = c[8 + i] * v.arr[2];
+        else
+            acc = soa_impl::fmadd(c[8 + i], v.arr[2], c[12 + i] * v.arr[3]);
+        acc = soa_impl::fmadd(c[4 + i], v.arr[1], acc);
+        r.arr[i] = soa_impl::fmadd(c[i], v.arr[0], acc);
+    });
+    return r;
+}
+
+template <transform_impl::kind K, typename VI, typename VO>
+static inline void transform_view(const Mat4f& m, const VI& in, const VO& out) {
+    assert(out.size() >= in.size());
+    constexpr uint32_t W = native_width<float>;
+    const MatSoA<float, 4, W> c(m);
+
+    const std::size_t n = in.size();
+    std::size_t i = 0;
+    for (; i + W <= n; i += W)
+        out.store(i, transform_packet<K, VI::Size, VO::Size>(c, in.template load<W>(i)));
+    if (i < n)
+        out.store_partial(i, transform_packet<K, VI::Size, VO::Size>(c,
+            in.template load_partial<W>(i, n - i)), n - i);
+}
+
+} // namespace view_impl
+
+// Span overloads of mat_transform.h over views, in and out may be the same
+// view. Results are stored with regular stores
+template <view_layout LI, view_layout LO>
+inline void transform_points(const Mat4f& m, const VecView<float, 3, LI>& in,
+    const VecView<float, 3, LO>& out)
+{
+    view_impl::transform_view<transform_impl::kind::point>(m, in, out);
+}
+
+template <view_layout LI, view_layout LO>
+inline void transform_points(const Mat4f& m, const VecView<float, 4, LI>& in,
+    const VecView<float, 4, LO>& out)
+{
+    view_impl::transform_view<transform_impl::kind::vec4>(m, in, out);
+}
+
+template <view_layout LI, view_layout LO>
+inline void transform_directions(const Mat4f& m, const VecView<float, 3, LI>& in,
+    const VecView<float, 3, LO>& out)
+{
+    view_impl::transform_view<transform_impl::kind::direction>(m, in, out);
+}
+
+template <view_layout LI, view_layout LO>
+inline void transform_normals(const Mat4f& m, const VecView<float, 3, LI>& in,
+    const VecView<float, 3, LO>& out)
+{
+    view_impl::transform_view<transform_impl::kind::direction>(
+        transform_impl::normal_matrix(m), in, out);
+}
+
+// out[i] = a[i] * b[i], out may be a or b
+template <view_layout LA, view_layout LB, view_layout LO>
+inline void multiply(const MatView<float, 4, LA>& a, const MatView<float, 4, LB>& b,
+    const MatView<float, 4, LO>& out)
+{
+    assert(a.size() == b.size() && out.size() >= a.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+        transform_impl::multiply_one(a.record(i), b.record(i), out.record(i));
+}
+
+// out[i] = inverse of in[i], as the span overloads
+template <precision P = precision::exact, typename T, view_layout LI, view_layout LO>
+inline bool inverse(const MatView<T, 4, LI>& in, const MatView<T, 4, LO>& out) {
+    assert(out.size() >= in.size());
+    bool all_invertible = true;
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        auto [invertible, inv] = in.get(i).template inverse<P>();
+        out.set(i, inv);
+        all_invertible &= invertible;
+    }
+    return all_invertible;
+}
+
+} // namespace yavl
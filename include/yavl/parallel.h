@@ -0,0 +1,509 @@
+#pragma once
+
+// Multi-threaded versions of the bulk functions, header only on top of
+// std::thread.
+//
+// A thread_pool runs a job of numbered chunks. Every participant, the
+// calling thread included, owns a contiguous share of the chunks and takes
+// them from the front, a participant that runs out steals single chunks
+// from the back of the others' shares. Without stealing the same thread
+// gets the same part of an array on every call, which together with first
+// touch page placement and pinned workers keeps a thread on its own NUMA
+// node's memory. Chunk sizes are multiples of a cache line of output so
+// two threads never write to the same line of an aligned buffer.
+//
+// The random number fills jump each chunk's copy of the generator to the
+// chunk's first draw with advance(), the output and the final state match
+// the serial fill bit for bit whatever the thread count.
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_soa.h>
+#include <yavl/vec/vec_view.h>
+#include <yavl/mat/mat.h>
+#include <yavl/mat/mat_transform.h>
+#include <yavl/mat/mat_view.h>
+#include <yavl/rng/pcg.h>
+
+namespace yavl
+{
+
+static constexpr std::size_t cache_line_size = 64;
+
+class thread_pool {
+public:
+    // threads counts the calling thread, 0 is one per cpu the process may
+    // run on. pin binds worker i to the i-th of those cpus, Linux only
+    explicit thread_pool(unsigned threads = 0, const bool pin = false) {
+        if (threads == 0)
+            threads = available_cpus();
+        shares = std::make_unique<share[]>(threads);
+        workers.reserve(threads - 1);
+        for (unsigned p = 1; p < threads; ++p) {
+            workers.emplace_back([this, p] { worker_main(p); });
+            if (pin)
+                pin_thread(workers.back(), p);
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator =(const thread_pool&) = delete;
+
+    ~thread_pool() {
+        stop.store(true, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+        generation.notify_all();
+        for (auto& w : workers)
+            w.join();
+    }
+
+    // Participants of a job, workers plus the calling thread
+    inline unsigned size() const {
+        return static_cast<unsigned>(workers.size()) + 1;
+    }
+
+    // Calls f(c) for c in [0, chunks) and returns when all calls are done.
+    // Concurrent runs are serialized and runs from inside a chunk execute
+    // serially on the calling thread. The first exception thrown by f is
+    // rethrown here, chunks not started by then are skipped
+    template <typename F>
+    void run(const std::size_t chunks, const F& f) {
+        if (chunks == 0)
+            return;
+        if (workers.empty() || chunks == 1 || inside_job()) {
+            for (std::size_t c = 0; c < chunks; ++c)
+                f(c);
+            return;
+        }
+        assert(chunks <= UINT32_MAX);
+
+        std::lock_guard<std::mutex> lock(run_mutex);
+        job_fn = [](const void* ctx, const std::size_t c) {
+            (*static_cast<const F*>(ctx))(c);
+        };
+        job_ctx = &f;
+        error = nullptr;
+        failed.store(false, std::memory_order_relaxed);
+
+        const std::size_t n = size();
+        for (std::size_t p = 0; p < n; ++p)
+            shares[p].range.store(pack(chunks * p / n, chunks * (p + 1) / n),
+                std::memory_order_relaxed);
+        busy.store(static_cast<unsigned>(workers.size()), std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+        generation.notify_all();
+
+        inside_job() = true;
+        drain(0);
+        inside_job() = false;
+
+        // Workers check out after their last chunk, nothing of this job is
+        // touched once busy is zero
+        for (unsigned b; (b = busy.load(std::memory_order_acquire)) != 0;)
+            busy.wait(b, std::memory_order_acquire);
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    // [front, back) of the chunks a participant still owns, front in the
+    // low half. Owner and thieves both move it with a CAS
+    struct alignas(cache_line_size) share {
+        std::atomic<uint64_t> range{0};
+    };
+
+    static constexpr uint64_t pack(const std::size_t front, const std::size_t back) {
+        return static_cast<uint64_t>(front) | static_cast<uint64_t>(back) << 32;
+    }
+
+    static bool pop_front(share& s, std::size_t& c) {
+        uint64_t r = s.range.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint64_t front = r & 0xffffffffu, back = r >> 32;
+            if (front >= back)
+                return false;
+            if (s.range.compare_exchange_weak(r, pack(front + 1, back),
+                std::memory_order_relaxed))
+            {
+                c = front;
+                return true;
+            }
+        }
+    }
+
+    static bool steal_back(share& s, std::size_t& c) {
+        uint64_t r = s.range.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint64_t front = r & 0xffffffffu, back = r >> 32;
+            if (front >= back)
+                return false;
+            if (s.range.compare_exchange_weak(r, pack(front, back - 1),
+                std::memory_order_relaxed))
+            {
+                c = back - 1;
+                return true;
+            }
+        }
+    }
+
+    // Own chunks first, then the neighbours' in order. Shares only shrink
+    // so one pass empties all of them
+    void drain(const unsigned p) {
+        const unsigned n = size();
+        std::size_t c;
+        while (pop_front(shares[p], c))
+            execute(c);
+        for (unsigned i = 1; i < n; ++i) {
+            share& victim = shares[(p + i) % n];
+            while (steal_back(victim, c))
+                execute(c);
+        }
+    }
+
+    void execute(const std::size_t c) {
+        if (failed.load(std::memory_order_relaxed))
+            return;
+        try {
+            job_fn(job_ctx, c);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void worker_main(const unsigned p) {
+        inside_job() = true;
+        uint64_t seen = 0;
+        for (;;) {
+            generation.wait(seen, std::memory_order_acquire);
+            seen = generation.load(std::memory_order_acquire);
+            if (stop.load(std::memory_order_relaxed))
+                return;
+            drain(p);
+            if (busy.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                busy.notify_all();
+        }
+    }
+
+    static bool& inside_job() {
+        thread_local bool inside = false;
+        return inside;
+    }
+
+    static unsigned available_cpus() {
+#if defined(__linux__)
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            return std::max(CPU_COUNT(&set), 1);
+#endif
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    static void pin_thread(std::thread& t, const unsigned i) {
+#if defined(__linux__)
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+            return;
+        const int count = CPU_COUNT(&allowed);
+        if (count == 0)
+            return;
+        int skip = static_cast<int>(i % count);
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (!CPU_ISSET(cpu, &allowed) || skip-- > 0)
+                continue;
+            cpu_set_t one;
+            CPU_ZERO(&one);
+            CPU_SET(cpu, &one);
+            pthread_setaffinity_np(t.native_handle(), sizeof(one), &one);
+            return;
+        }
+#else
+        (void)t;
+        (void)i;
+#endif
+    }
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<share[]> shares;
+
+    std::mutex run_mutex;
+    void (*job_fn)(const void*, std::size_t) = nullptr;
+    const void* job_ctx = nullptr;
+
+    alignas(cache_line_size) std::atomic<uint64_t> generation{0};
+    alignas(cache_line_size) std::atomic<unsigned> busy{0};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> failed{false};
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+// Pool used when none is given, YAVL_NUM_THREADS overrides the size
+inline thread_pool& default_thread_pool() {
+    static thread_pool pool([] {
+        if (const char* env = std::getenv("YAVL_NUM_THREADS"))
+            return static_cast<unsigned>(std::strtoul(env, nullptr, 10));
+        return 0u;
+    }());
+    return pool;
+}
+
+// f(begin, end) over [0, n) in chunks of grain elements, the last one
+// shorter
+template <typename F>
+inline void parallel_for(const std::size_t n, std::size_t grain, const F& f,
+    thread_pool& pool = default_thread_pool())
+{
+    grain = std::max<std::size_t>(grain, 1);
+    pool.run((n + grain - 1) / grain, [&](const std::size_t c) {
+        const std::size_t begin = c * grain;
+        f(begin, std::min(begin + grain, n));
+    });
+}
+
+// combine(...combine(combine(init, map(c0)), map(c1))...) over the same
+// chunks as parallel_for. Chunk results are combined in order on the
+// calling thread, so the result only depends on n and grain
+template <typename R, typename Map, typename Combine>
+inline R parallel_reduce(const std::size_t n, std::size_t grain, R init,
+    const Map& map, const Combine& combine, thread_pool& pool = default_thread_pool())
+{
+    struct alignas(cache_line_size) slot {
+        R value;
+    };
+
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t chunks = (n + grain - 1) / grain;
+    std::vector<slot, aligned_allocator<slot, alignof(slot)>> partial(chunks, slot{init});
+    pool.run(chunks, [&](const std::size_t c) {
+        const std::size_t begin = c * grain;
+        partial[c].value = map(begin, std::min(begin + grain, n));
+    });
+    for (const auto& p : partial)
+        init = combine(init, p.value);
+    return init;
+}
+
+namespace parallel_impl
+{
+
+// Chunks are kept over min_chunk_bytes so the scheduling cost stays small
+// next to the kernel, and below a chunks_per_thread share of the array so
+// stealing has something to balance
+static constexpr std::size_t min_chunk_bytes = 32u << 10;
+static constexpr std::size_t chunks_per_thread = 8;
+
+// Records of the given size in a whole number of cache lines
+static constexpr std::size_t line_records(const std::size_t bytes) {
+    return std::lcm(bytes, cache_line_size) / bytes;
+}
+
+// Records per chunk, a multiple of align
+static inline std::size_t chunk_grain(const std::size_t n, const std::size_t bytes,
+    const std::size_t align, const thread_pool& pool)
+{
+    const std::size_t share = n / (pool.size() * chunks_per_thread);
+    const std::size_t grain = std::max(share, min_chunk_bytes / bytes);
+    return (grain + align - 1) / align * align;
+}
+
+// Records in the widest batch of transform_impl. Chunks of whole batches
+// leave the scalar tail where the serial transform has it, so results on a
+// cache line aligned output match it exactly
+static constexpr std::size_t transform_batch = 16;
+
+// Streaming is decided by the size of the whole output, not of a chunk
+static inline store_policy resolve(const store_policy policy, const std::size_t bytes) {
+    return use_streaming_stores(policy, bytes) ? store_policy::streaming :
+        store_policy::cached;
+}
+
+template <typename VI, typename VO, typename F>
+static inline void for_span_chunks(std::span<const VI> in, std::span<VO> out,
+    const store_policy policy, thread_pool& pool, const F& f)
+{
+    assert(out.size() >= in.size());
+    const std::size_t n = in.size();
+    const store_policy resolved = resolve(policy, n * sizeof(VO));
+    const std::size_t align = std::lcm(line_records(sizeof(VO)), transform_batch);
+    parallel_for(n, chunk_grain(n, sizeof(VO), align, pool),
+        [&](const std::size_t begin, const std::size_t end) {
+            f(in.subspan(begin, end - begin), out.subspan(begin, end - begin), resolved);
+        }, pool);
+}
+
+template <typename VI, typename VO, typename F>
+static inline void for_view_chunks(const VI& in, const VO& out, thread_pool& pool,
+    const F& f)
+{
+    assert(out.size() >= in.size());
+    constexpr std::size_t bytes = VO::Size * sizeof(typename VO::Scalar);
+    const std::size_t n = in.size();
+    const std::size_t align = std::lcm(line_records(bytes),
+        std::size_t(native_width<typename VO::Scalar>));
+    parallel_for(n, chunk_grain(n, bytes, align, pool),
+        [&](const std::size_t begin, const std::size_t end) {
+            f(in.subview(begin, end - begin), out.subview(begin, end - begin));
+        }, pool);
+}
+
+template <uint32_t N, typename T, typename Fill>
+static inline void fill(pcg32x<N>& rng, std::span<T> out, const store_policy policy,
+    thread_pool& pool, const Fill& fill_chunk)
+{
+    const std::size_t n = out.size();
+    const store_policy resolved = resolve(policy, n * sizeof(T));
+    // Chunks start on whole blocks of N draws
+    const std::size_t align = std::lcm(line_records(sizeof(T)), std::size_t(N));
+    parallel_for(n, chunk_grain(n, sizeof(T), align, pool),
+        [&](const std::size_t begin, const std::size_t end) {
+            pcg32x<N> g = rng;
+            g.advance(static_cast<int64_t>(begin / N));
+            fill_chunk(g, out.subspan(begin, end - begin), resolved);
+        }, pool);
+    rng.advance(static_cast<int64_t>((n + N - 1) / N));
+}
+
+} // namespace parallel_impl
+
+// Bulk transforms of mat_transform.h and mat_view.h split across a pool
+inline void parallel_transform_points(const Mat4f& m, std::span<const Vec3f> in,
+    std::span<Vec3f> out, const store_policy policy = store_policy::automatic,
+    thread_pool& pool = default_thread_pool())
+{
+    parallel_impl::for_span_chunks(in, out, policy, pool,
+        [&](auto i, auto o, const store_policy p) { transform_points(m, i, o, p); });
+}
+
+inline void parallel_transform_points(const Mat4f& m, std::span<const Vec4f> in,
+    std::span<Vec4f> out, const store_policy policy = store_policy::automatic,
+    thread_pool& pool = default_thread_pool())
+{
+    parallel_impl::for_span_chunks(in, out, policy, pool,
+        [&](auto i, auto o, const store_policy p) { transform_points(m, i, o, p); });
+}
+
+inline void parallel_transform_directions(const Mat4f& m, std::span<const Vec3f> in,
+    std::span<Vec3f> out, const store_policy policy = store_policy::automatic,
+    thread_pool& pool = default_thread_pool())
+{
+    parallel_impl::for_span_chunks(in, out, policy, pool,
+        [&](auto i, auto o, const store_policy p) { transform_directions(m, i, o, p); });
+}
+
+// The normal matrix is computed once, chunks transform directions with it
+inline void parallel_transform_normals(const Mat4f& m, std::span<const Vec3f> in,
+    std::span<Vec3f> out, const store_policy policy = store_policy::automatic,
+    thread_pool& pool = default_thread_pool())
+{
+    const Mat4f nm = transform_impl::normal_matrix(m);
+    parallel_transform_directions(nm, in, out, policy, pool);
+}
+
+template <uint32_t N, view_layout LI, view_layout LO>
+inline void parallel_transform_points(const Mat4f& m, const VecView<float, N, LI>& in,
+    const VecView<float, N, LO>& out, thread_pool& pool = default_thread_pool())
+{
+    parallel_impl::for_view_chunks(in, out, pool,
+        [&](const auto& i, const auto& o) { transform_points(m, i, o); });
+}
+
+template <view_layout LI, view_layout LO>
+inline void parallel_transform_directions(const Mat4f& m, const VecView<float, 3, LI>& in,
+    const VecView<float, 3, LO>& out, thread_pool& pool = default_thread_pool())
+{
+    parallel_impl::for_view_chunks(in, out, pool,
+        [&](const auto& i, const auto& o) { transform_directions(m, i, o); });
+}
+
+template <view_layout LI, view_layout LO>
+inline void parallel_transform_normals(const Mat4f& m, const VecView<float, 3, LI>& in,
+    const VecView<float, 3, LO>& out, thread_pool& pool = default_thread_pool())
+{
+    parallel_transform_directions(transform_impl::normal_matrix(m), in, out, pool);
+}
+
+// VecArray::normalize and VecView::normalize split across a pool
+template <uint32_t W = 0, precision P = precision::standard, typename T, uint32_t N>
+inline void parallel_normalize(VecArray<T, N>& a, thread_pool& pool = default_thread_pool()) {
+    constexpr uint32_t Width = W ? W : native_width<T>;
+    // Streams are cache line aligned, so are chunks of MaxWidth records
+    constexpr std::size_t align = VecArray<T, N>::MaxWidth;
+    const std::size_t n = a.size();
+    parallel_for(n, parallel_impl::chunk_grain(n, N * sizeof(T), align, pool),
+        [&](const std::size_t begin, const std::size_t end) {
+            a.template normalize<Width, P>(begin, end);
+        }, pool);
+}
+
+template <uint32_t W = 0, precision P = precision::standard, typename T, uint32_t N,
+    view_layout L>
+inline void parallel_normalize(const VecView<T, N, L>& v,
+    thread_pool& pool = default_thread_pool())
+{
+    constexpr uint32_t Width = W ? W : native_width<T>;
+    parallel_impl::for_view_chunks(v, v, pool,
+        [](const auto& i, const auto&) { i.template normalize<Width, P>(); });
+}
+
+// pcg32x fills split across a pool, same output and final state as the
+// member functions. fill_uint32_bounded has no parallel version, the
+// draws its rejections consume aren't known before they are made
+template <uint32_t N>
+inline void parallel_fill_uint32(pcg32x<N>& rng, std::span<uint32_t> out,
+    const store_policy policy = store_policy::automatic,
+    thread_pool& pool = default_thread_pool())
+{
+    parallel_impl::fill(rng, out, policy, pool,
+        [](pcg32x<N>& g, std::span<uint32_t> o, const store_policy p) {
+            g.fill_uint32(o, p);
+        });
+}
+
+template <uint32_t N>
+inline void parallel_fill_uniform_float(pcg32x<N>& rng, std::span<float> out,
+    const store_policy policy = store_policy::automatic,
+    thread_pool& pool = default_thread_pool())
+{
+    parallel_impl::fill(rng, out, policy, pool,
+        [](pcg32x<N>& g, std::span<float> o, const store_policy p) {
+            g.fill_uniform_float(o, p);
+        });
+}
+
+template <uint32_t N>
+inline void parallel_fill_uniform_double(pcg32x<N>& rng, std::span<double> out,
+    const store_policy policy = store_policy::automatic,
+    thread_pool& pool = default_thread_pool())
+{
+    parallel_impl::fill(rng, out, policy, pool,
+        [](pcg32x<N>& g, std::span<double> o, const store_policy p) {
+            g.fill_uniform_double(o, p);
+        });
+}
+
+} // namespace yavl
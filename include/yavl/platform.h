@@ -50,6 +50,9 @@
 #   if defined(__AVX512VPOPCNTDQ__)
 #       define YAVL_X86_AVX512VPOPCNTDQ 1
 #   endif
+#   if defined(__AVX512BF16__)
+#       define YAVL_X86_AVX512BF16 1
+#   endif
 #   if defined(__AVX2__)
 #       define YAVL_X86_AVX2 1
 #   endif
@@ -65,19 +68,27 @@
 #   if defined(__SSE4_2__)
 #       define YAVL_X86_SSE42 1
 #   endif
-#   if defined(__ARM_NEON)
-#       define YAVL_ARM_NEON
+// The NEON backend needs the aarch64 instruction set, the 32 bit one has
+// no double lanes, division or sqrt
+#   if defined(__ARM_NEON) && defined(__aarch64__)
+#       define YAVL_ARM_NEON 1
 #   endif
 #   if defined(__ARM_FEATURE_FMA)
-#       define YAVL_ARM_FMA
+#       define YAVL_ARM_FMA 1
+#   endif
+#   if defined(__ARM_FEATURE_SVE)
+#       define YAVL_ARM_SVE 1
 #   endif
 #endif
 
 #if defined(ARCH_X86_64) || defined(ARCH_X86_32)
 #   include <immintrin.h>
+#   if !defined(_MSC_VER)
+#       include <cpuid.h>
+#   endif
 #endif
 
-#if defined(YAML_ARM_NEON)
+#if defined(YAVL_ARM_NEON)
 #   include <arm_neon.h>
 #endif
 
@@ -139,6 +150,12 @@
     static constexpr bool has_avx512vpopcntdq = false;
 #endif
 
+#if defined(YAVL_X86_AVX512BF16)
+    static constexpr bool has_avx512bf16 = true;
+#else
+    static constexpr bool has_avx512bf16 = false;
+#endif
+
 #if defined(YAVL_X86_AVX2)
     static constexpr bool has_avx2 = true;
 #else
@@ -173,4 +190,133 @@
     static constexpr bool has_neon = true;
 #else
     static constexpr bool has_neon = false;
-#endif
\ No newline at end of file
+#endif
+
+#if defined(YAVL_ARM_FMA)
+    static constexpr bool has_arm_fma = true;
+#else
+    static constexpr bool has_arm_fma = false;
+#endif
+
+#if defined(YAVL_ARM_SVE)
+    static constexpr bool has_sve = true;
+#else
+    static constexpr bool has_sve = false;
+#endif
+
+// Runtime counterparts of the flags above. The constexpr flags tell what the
+// current translation unit was compiled for, these tell what the cpu running
+// the binary supports(including OS support for the wider register states).
+// Kept static so every translation unit, whatever isa flags it was compiled
+// with, gets its own copy.
+namespace yavl
+{
+
+struct cpu_features_t {
+    bool sse42 = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool avx512f = false;
+    bool avx512cd = false;
+    bool avx512dq = false;
+    bool avx512vl = false;
+    bool avx512bw = false;
+    bool avx512er = false;
+    bool avx512pf = false;
+    bool avx512vbmi = false;
+    bool avx512vpopcntdq = false;
+    bool avx512bf16 = false;
+    bool neon = false;
+};
+
+static inline cpu_features_t query_cpu_features() {
+    cpu_features_t f;
+#if defined(ARCH_X86_64) || defined(ARCH_X86_32)
+    auto cpuid = [](const unsigned leaf, const unsigned subleaf, unsigned* regs) {
+#   if defined(_MSC_VER)
+        __cpuidex(reinterpret_cast<int*>(regs), leaf, subleaf);
+#   else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#   endif
+    };
+
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    const unsigned max_leaf = regs[0];
+    if (max_leaf < 1)
+        return f;
+
+    cpuid(1, 0, regs);
+    const unsigned ecx1 = regs[2];
+
+    // Check the OS saves the ymm/zmm states before trusting the cpu bits
+    unsigned long long xcr0 = 0;
+    if (ecx1 & (1u << 27)) {
+#   if defined(_MSC_VER)
+        xcr0 = _xgetbv(0);
+#   else
+        unsigned lo, hi;
+        __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        xcr0 = (static_cast<unsigned long long>(hi) << 32) | lo;
+#   endif
+    }
+    const bool os_avx = (xcr0 & 0x6) == 0x6;
+    const bool os_avx512 = (xcr0 & 0xe6) == 0xe6;
+
+    f.sse42 = ecx1 & (1u << 20);
+    f.avx = os_avx && (ecx1 & (1u << 28));
+    f.fma = f.avx && (ecx1 & (1u << 12));
+    f.f16c = f.avx && (ecx1 & (1u << 29));
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        const unsigned ebx7 = regs[1], ecx7 = regs[2];
+        f.avx2 = f.avx && (ebx7 & (1u << 5));
+        if (os_avx512 && (ebx7 & (1u << 16))) {
+            f.avx512f = true;
+            f.avx512dq = ebx7 & (1u << 17);
+            f.avx512pf = ebx7 & (1u << 26);
+            f.avx512er = ebx7 & (1u << 27);
+            f.avx512cd = ebx7 & (1u << 28);
+            f.avx512bw = ebx7 & (1u << 30);
+            f.avx512vl = ebx7 & (1u << 31);
+            f.avx512vbmi = ecx7 & (1u << 1);
+            f.avx512vpopcntdq = ecx7 & (1u << 14);
+            if (regs[0] >= 1) {
+                cpuid(7, 1, regs);
+                f.avx512bf16 = regs[0] & (1u << 5);
+            }
+        }
+    }
+#elif defined(ARCH_ARM_64)
+    // Advanced SIMD is mandatory on aarch64
+    f.neon = true;
+#endif
+    return f;
+}
+
+static inline const cpu_features_t& cpu_features() {
+    static const cpu_features_t features = query_cpu_features();
+    return features;
+}
+
+static inline bool runtime_has_avx512f() { return cpu_features().avx512f; }
+static inline bool runtime_has_avx512cd() { return cpu_features().avx512cd; }
+static inline bool runtime_has_avx512dq() { return cpu_features().avx512dq; }
+static inline bool runtime_has_avx512vl() { return cpu_features().avx512vl; }
+static inline bool runtime_has_avx512bw() { return cpu_features().avx512bw; }
+static inline bool runtime_has_avx512pf() { return cpu_features().avx512pf; }
+static inline bool runtime_has_avx512er() { return cpu_features().avx512er; }
+static inline bool runtime_has_avx512vbmi() { return cpu_features().avx512vbmi; }
+static inline bool runtime_has_avx512vpopcntdq() { return cpu_features().avx512vpopcntdq; }
+static inline bool runtime_has_avx512bf16() { return cpu_features().avx512bf16; }
+static inline bool runtime_has_avx2() { return cpu_features().avx2; }
+static inline bool runtime_has_fma() { return cpu_features().fma; }
+static inline bool runtime_has_f16c() { return cpu_features().f16c; }
+static inline bool runtime_has_avx() { return cpu_features().avx; }
+static inline bool runtime_has_sse42() { return cpu_features().sse42; }
+static inline bool runtime_has_neon() { return cpu_features().neon; }
+
+} // namespace yavl
@@ -0,0 +1,397 @@
+#pragma once
+
+// Rotation quaternions stored in a Vec<T, 4> as (x, y, z, w), w being the
+// real part, so Quatf and Quatd sit in the same __m128/__m256d registers
+// as Vec4f and Vec4d and the Hamilton product is 4 shuffled products.
+//
+// rotate_vectors rotates arrays of Vec3f by one quaternion or by one
+// quaternion each(skinning). Batches of vectors(and quaternions) are
+// transposed to x, y, z registers like the bulk transforms in
+// mat_transform.h, and each rotation is v + w t + u x t with t = 2 u x v,
+// 15 multiplies or fmas per vector.
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_math.h>
+#include <yavl/mat/mat.h>
+#include <yavl/mat/mat_transform.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace quat_impl
+{
+
+// (x, y, z, -w)
+template <typename T>
+static inline Vec<T, 4> negate_w(const Vec<T, 4>& a) {
+    return Vec<T, 4>(a.x, a.y, a.z, -a.w);
+}
+
+// Dot product in every lane
+template <typename T>
+static inline Vec<T, 4> dot4(const Vec<T, 4>& a, const Vec<T, 4>& b) {
+    return Vec<T, 4>(a.dot(b));
+}
+
+// (x, y, z) with a zero padding lane
+template <typename T>
+static inline Vec<T, 3> imag(const Vec<T, 4>& a) {
+    return Vec<T, 3>(a.x, a.y, a.z);
+}
+
+#if defined(YAVL_X86_SSE42)
+
+static inline Vec<float, 4> negate_w(const Vec<float, 4>& a) {
+    return Vec<float, 4>(_mm_xor_ps(a.m, _mm_setr_ps(0.f, 0.f, 0.f, -0.f)));
+}
+
+static inline Vec<float, 4> dot4(const Vec<float, 4>& a, const Vec<float, 4>& b) {
+    return Vec<float, 4>(_mm_dp_ps(a.m, b.m, 0xFF));
+}
+
+static inline Vec<float, 3> imag(const Vec<float, 4>& a) {
+    return Vec<float, 3>(_mm_blend_ps(a.m, _mm_setzero_ps(), 0b1000));
+}
+
+#endif
+
+#if defined(YAVL_X86_AVX)
+
+static inline Vec<double, 4> negate_w(const Vec<double, 4>& a) {
+    return Vec<double, 4>(_mm256_xor_pd(a.m, _mm256_setr_pd(0., 0., 0., -0.)));
+}
+
+#endif
+
+// Hamilton product, lanes(x, y, z, w) of
+//   a.w * b + (a.x b.w, a.y b.w, a.z b.w, -a.x b.x)
+//     + (a.y b.z, a.z b.x, a.x b.y, -a.y b.y)
+//     - (a.z b.y, a.x b.z, a.y b.x, a.z b.z)
+template <typename T>
+static inline Vec<T, 4> hamilton(const Vec<T, 4>& a, const Vec<T, 4>& b) {
+    auto r = a.template shuffle<3, 3, 3, 3>() * b;
+    auto t = a.template shuffle<0, 1, 2, 0>() * b.template shuffle<3, 3, 3, 0>() +
+        a.template shuffle<1, 2, 0, 1>() * b.template shuffle<2, 0, 1, 1>();
+    return r + negate_w(t) - a.template shuffle<2, 0, 1, 2>() * b.template shuffle<1, 2, 0, 2>();
+}
+
+} // namespace quat_impl
+
+template <typename T>
+struct Quat {
+    using Scalar = T;
+
+    // (x, y, z) the imaginary part, w the real part
+    Vec<T, 4> v;
+
+    // Identity rotation
+    Quat() : v(0, 0, 0, 1) {}
+    Quat(const T x, const T y, const T z, const T w) : v(x, y, z, w) {}
+    explicit Quat(const Vec<T, 4>& q) : v(q) {}
+
+    // Rotation by angle radians around a unit axis, counterclockwise when
+    // looking down the axis
+    static Quat axis_angle(const Vec<T, 3>& axis, const T angle) {
+        const T s = std::sin(angle * static_cast<T>(0.5));
+        return Quat(axis.x * s, axis.y * s, axis.z * s, std::cos(angle * static_cast<T>(0.5)));
+    }
+
+    // Rotation of the upper 3x3 of a Mat3 or Mat4, which must be
+    // orthonormal. Shepperd's method, the largest of w, x, y and z is taken
+    // from the diagonal so the divisor never gets close to zero
+    template <typename M>
+        requires (std::is_same_v<M, Mat<T, 3>> || std::is_same_v<M, Mat<T, 4>>)
+    static Quat from_mat(const M& mat) {
+        // m(r, c) is row r, column c
+        auto m = [&](const uint32_t r, const uint32_t c) { return mat[c][r]; };
+        const T one = static_cast<T>(1);
+        const T quarter = static_cast<T>(0.25);
+        const T trace = m(0, 0) + m(1, 1) + m(2, 2);
+
+        if (trace > 0) {
+            T s = std::sqrt(trace + one) * 2;
+            return Quat((m(2, 1) - m(1, 2)) / s, (m(0, 2) - m(2, 0)) / s,
+                (m(1, 0) - m(0, 1)) / s, quarter * s);
+        }
+        else if (m(0, 0) > m(1, 1) && m(0, 0) > m(2, 2)) {
+            T s = std::sqrt(one + m(0, 0) - m(1, 1) - m(2, 2)) * 2;
+            return Quat(quarter * s, (m(0, 1) + m(1, 0)) / s,
+                (m(0, 2) + m(2, 0)) / s, (m(2, 1) - m(1, 2)) / s);
+        }
+        else if (m(1, 1) > m(2, 2)) {
+            T s = std::sqrt(one + m(1, 1) - m(0, 0) - m(2, 2)) * 2;
+            return Quat((m(0, 1) + m(1, 0)) / s, quarter * s,
+                (m(1, 2) + m(2, 1)) / s, (m(0, 2) - m(2, 0)) / s);
+        }
+        else {
+            T s = std::sqrt(one + m(2, 2) - m(0, 0) - m(1, 1)) * 2;
+            return Quat((m(0, 2) + m(2, 0)) / s, (m(1, 2) + m(2, 1)) / s,
+                quarter * s, (m(1, 0) - m(0, 1)) / s);
+        }
+    }
+
+    // Operators
+    auto operator *(const Quat& b) const {
+        return Quat(quat_impl::hamilton(v, b.v));
+    }
+
+    auto& operator *=(const Quat& b) {
+        v = quat_impl::hamilton(v, b.v);
+        return *this;
+    }
+
+    bool operator ==(const Quat& b) const {
+        return v == b.v;
+    }
+
+    bool operator !=(const Quat& b) const {
+        return v != b.v;
+    }
+
+    // Misc funcs
+    inline auto* data() {
+        return v.data();
+    }
+
+    inline auto* data() const {
+        return v.data();
+    }
+
+    // Math funcs
+    inline Scalar dot(const Quat& b) const {
+        return v.dot(b.v);
+    }
+
+    inline auto length_squared() const {
+        return dot(*this);
+    }
+
+    inline auto length() const {
+        return std::sqrt(length_squared());
+    }
+
+    inline Quat conjugate() const {
+        return Quat(quat_impl::negate_w(v) * static_cast<T>(-1));
+    }
+
+    // Conjugate over the squared norm, the conjugate is enough for unit
+    // quaternions
+    inline Quat inverse() const {
+        return Quat(conjugate().v / quat_impl::dot4(v, v));
+    }
+
+    // Scales by the refined reciprocal square root(rsqrt_ps_impl and
+    // rsqrt_pd_impl), rel err around 2^-22 for floats
+    inline Quat& normalize() {
+        v *= quat_impl::dot4(v, v).rsqrt();
+        return *this;
+    }
+
+    inline Quat normalized() const {
+        return Quat(v * quat_impl::dot4(v, v).rsqrt());
+    }
+
+    // Rotate p, the quaternion must have unit length. p + w t + u x t with
+    // t = 2 u x p is q p q* expanded
+    inline Vec<T, 3> rotate(const Vec<T, 3>& p) const {
+        auto u = quat_impl::imag(v);
+        auto t = u.cross(p) * static_cast<T>(2);
+        return p + t * v.w + u.cross(t);
+    }
+
+    // Matrix conversions, the quaternion must have unit length
+    Mat<T, 3> to_mat3() const {
+        auto [c0, c1, c2] = columns();
+        return Mat<T, 3>(c0[0], c0[1], c0[2], c1[0], c1[1], c1[2], c2[0], c2[1], c2[2]);
+    }
+
+    Mat<T, 4> to_mat4() const {
+        auto [c0, c1, c2] = columns();
+        const T zero = static_cast<T>(0);
+        return Mat<T, 4>(c0[0], c0[1], c0[2], zero, c1[0], c1[1], c1[2], zero,
+            c2[0], c2[1], c2[2], zero, zero, zero, zero, static_cast<T>(1));
+    }
+
+private:
+    std::array<std::array<T, 3>, 3> columns() const {
+        const T x = v.x, y = v.y, z = v.z, w = v.w;
+        const T one = static_cast<T>(1), two = static_cast<T>(2);
+        return {{
+            { one - two * (y * y + z * z), two * (x * y + w * z), two * (x * z - w * y) },
+            { two * (x * y - w * z), one - two * (x * x + z * z), two * (y * z + w * x) },
+            { two * (x * z + w * y), two * (y * z - w * x), one - two * (x * x + y * y) }
+        }};
+    }
+};
+
+// Normalized linear interpolation along the shorter arc, cheaper than slerp
+// with a non constant angular velocity
+template <typename T>
+inline Quat<T> nlerp(const Quat<T>& a, const Quat<T>& b, const T t) {
+    const T s = a.dot(b) < 0 ? static_cast<T>(-1) : static_cast<T>(1);
+    return Quat<T>(a.v.lerp(b.v * s, t)).normalized();
+}
+
+// Spherical linear interpolation along the shorter arc, falls back to
+// nlerp when the quaternions are too close for 1 / sin(theta)
+template <typename T>
+inline Quat<T> slerp(const Quat<T>& a, const Quat<T>& b, const T t) {
+    T d = a.dot(b);
+    T s = static_cast<T>(1);
+    if (d < 0) {
+        d = -d;
+        s = static_cast<T>(-1);
+    }
+    if (d > static_cast<T>(0.9995))
+        return nlerp(a, b, t);
+
+    const T theta = std::acos(d);
+    const T rsin = static_cast<T>(1) / std::sin(theta);
+    const T s0 = std::sin((1 - t) * theta) * rsin;
+    const T s1 = std::sin(t * theta) * rsin * s;
+    return Quat<T>(a.v * s0 + b.v * s1);
+}
+
+using Quatf = Quat<float>;
+using Quatd = Quat<double>;
+
+namespace quat_impl
+{
+
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_SSE42)
+
+// W records of 4 floats to x, y, z, w registers and back, see
+// transform_block in mat_transform.h for the lane order
+template <typename P>
+static inline void load_soa(const float* p, P (&a)[4]) {
+    using O = math_impl::packet_ops<P>;
+    static_for<4>([&](const auto i) {
+        a[i] = O::loadu(p + i * O::Width);
+    });
+    transform_impl::transpose4(a[0], a[1], a[2], a[3]);
+}
+
+template <typename P>
+static inline void store_soa(float* p, P (&a)[4]) {
+    using O = math_impl::packet_ops<P>;
+    transform_impl::transpose4(a[0], a[1], a[2], a[3]);
+    static_for<4>([&](const auto i) {
+        O::storeu(p + i * O::Width, a[i]);
+    });
+}
+
+// a = a + w t + u x t with t = 2 u x a, q holding u and w
+template <typename P>
+static inline void rotate_soa(const P (&q)[4], P (&a)[4]) {
+    using O = math_impl::packet_ops<P>;
+    const P two = O::set1(2.f);
+    P t[3];
+    t[0] = O::mul(two, O::fnmadd(q[2], a[1], O::mul(q[1], a[2])));
+    t[1] = O::mul(two, O::fnmadd(q[0], a[2], O::mul(q[2], a[0])));
+    t[2] = O::mul(two, O::fnmadd(q[1], a[0], O::mul(q[0], a[1])));
+
+    a[0] = O::fnmadd(q[2], t[1], O::fmadd(q[1], t[2], O::fmadd(q[3], t[0], a[0])));
+    a[1] = O::fnmadd(q[0], t[2], O::fmadd(q[2], t[0], O::fmadd(q[3], t[1], a[1])));
+    a[2] = O::fnmadd(q[1], t[0], O::fmadd(q[0], t[1], O::fmadd(q[3], t[2], a[2])));
+    // Padding lane of Vec3f
+    a[3] = O::set1(0.f);
+}
+
+// Rotate whole batches of W vectors by q, or by q[i] each when Each is
+// set, returns the vectors done
+template <typename P, bool Each>
+static inline std::size_t rotate_batches(const float* q, const float* in,
+    float* out, const std::size_t n)
+{
+    using O = math_impl::packet_ops<P>;
+    constexpr uint32_t W = O::Width;
+
+    P c[4];
+    if constexpr (!Each) {
+        static_for<4>([&](const auto i) {
+            c[i] = O::set1(q[i]);
+        });
+    }
+
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) {
+        if constexpr (Each)
+            load_soa(q + i * 4, c);
+        P a[4];
+        load_soa(in + i * 4, a);
+        rotate_soa(c, a);
+        store_soa(out + i * 4, a);
+    }
+    return i;
+}
+
+template <bool Each>
+static inline std::size_t rotate_widest(const float* q, const float* in,
+    float* out, const std::size_t n)
+{
+#if defined(YAVL_X86_AVX512F)
+    return rotate_batches<__m512, Each>(q, in, out, n);
+#elif defined(YAVL_X86_AVX2)
+    return rotate_batches<__m256, Each>(q, in, out, n);
+#else
+    return rotate_batches<__m128, Each>(q, in, out, n);
+#endif
+}
+
+#endif // YAVL_DISABLE_VECTORIZATION
+
+} // namespace quat_impl
+
+// out[i] = q.rotate(in[i]), in and out may be the same array
+inline void rotate_vectors(const Quatf& q, std::span<const Vec3f> in, std::span<Vec3f> out) {
+    assert(out.size() >= in.size());
+    std::size_t done = 0;
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_SSE42)
+    static_assert(sizeof(Vec3f) == 16 && sizeof(Quatf) == 16);
+    done = quat_impl::rotate_widest<false>(q.data(),
+        reinterpret_cast<const float*>(in.data()), reinterpret_cast<float*>(out.data()),
+        in.size());
+#endif
+    for (std::size_t i = done; i < in.size(); ++i)
+        out[i] = q.rotate(in[i]);
+}
+
+// out[i] = q[i].rotate(in[i]), one rotation per vector as in skinning. in
+// and out may be the same array
+inline void rotate_vectors(std::span<const Quatf> q, std::span<const Vec3f> in,
+    std::span<Vec3f> out)
+{
+    assert(q.size() >= in.size() && out.size() >= in.size());
+    std::size_t done = 0;
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_SSE42)
+    done = quat_impl::rotate_widest<true>(reinterpret_cast<const float*>(q.data()),
+        reinterpret_cast<const float*>(in.data()), reinterpret_cast<float*>(out.data()),
+        in.size());
+#endif
+    for (std::size_t i = done; i < in.size(); ++i)
+        out[i] = q[i].rotate(in[i]);
+}
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
@@ -0,0 +1,583 @@
+#pragma once
+
+// Reductions over arrays of floats, Vec3fs and Vec4fs: sums, min/max,
+// argmin/argmax, dot products, bounding boxes, mean and covariance.
+//
+// Vec::sum() and friends reduce the lanes of one vector, these reduce whole
+// arrays. An array of Vecs is read as a flat float stream with a period of
+// padded_lanes<float, N>, packets are a multiple of the period wide so a
+// register lane always holds the same component, and components are only
+// separated when the lanes are folded at the end. Padding lanes are folded
+// into nothing, whatever they hold.
+//
+// Kernels run in the widest packets of the build with at least 4
+// independent accumulators, so the add/min/max latency chain doesn't bound
+// the throughput. The last partial packet is one masked load(AVX-512 and
+// AVX2, a zero padded copy elsewhere) and a masked accumulator update.
+//
+// Sums and dot products are pairwise by default, blocks of 64 packets per
+// accumulator summed in registers and combined as a binary tree, with an
+// error growing with log(n) instead of n at no measurable cost. Kahan
+// summation carries a compensation term per lane at 4 adds per element.
+// Lanes are folded in double. NaN elements are skipped by min/max and the
+// argmin/argmax, they propagate through sums.
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <utility>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_math.h>
+#include <yavl/mat/mat.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+// How sum() adds up an array
+enum class summation {
+    plain,      // One accumulator per lane
+    pairwise,   // Blocks of plain sums combined as a binary tree
+    kahan       // Compensated sums per lane
+};
+
+namespace reduce_impl
+{
+
+// Widest packet of the build
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_AVX512F)
+template <typename T>
+using packet_t = math_impl::packet512_t<T>;
+#elif !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_AVX2)
+template <typename T>
+using packet_t = math_impl::packet256_t<T>;
+#elif !defined(YAVL_DISABLE_VECTORIZATION) && (defined(YAVL_X86_SSE42) || defined(YAVL_ARM_NEON))
+template <typename T>
+using packet_t = math_impl::packet128_t<T>;
+#else
+template <typename T>
+using packet_t = T;
+#endif
+
+// U accumulators of W lanes, U * W is a multiple of the period L so lane k
+// of the folded accumulators holds component k % L
+template <typename T, uint32_t L>
+struct shape {
+    using P = packet_t<T>;
+    using O = math_impl::packet_ops<P>;
+    static constexpr uint32_t W = O::Width;
+    static constexpr uint32_t U = std::lcm(4 * W, L) / W;
+    static constexpr uint32_t Lanes = U * W;
+    // Elements per pairwise block
+    static constexpr std::size_t Block = Lanes * 64;
+};
+
+template <typename T>
+static constexpr auto iota = [] {
+    std::array<T, 64> a{};
+    for (uint32_t i = 0; i < a.size(); ++i)
+        a[i] = static_cast<T>(i);
+    return a;
+}();
+
+// First n lanes from p, the others zero, without reading past p + n
+template <typename P, typename T>
+static inline P load_n(const T* p, const uint32_t n) {
+    using O = math_impl::packet_ops<P>;
+    if constexpr (requires { O::loadu_n(p, n); }) {
+        return O::loadu_n(p, n);
+    }
+#if !defined(YAVL_DISABLE_VECTORIZATION) && defined(YAVL_X86_AVX2)
+    else if constexpr (std::is_same_v<P, __m256>) {
+        const auto m = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n)),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        return _mm256_maskload_ps(p, m);
+    }
+#endif
+    else {
+        alignas(64) T buf[O::Width] = {};
+        std::memcpy(buf, p, n * sizeof(T));
+        return O::loadu(buf);
+    }
+}
+
+template <typename P>
+static inline auto tail_mask(const uint32_t n) {
+    using O = math_impl::packet_ops<P>;
+    if constexpr (requires { O::first_n(n); })
+        return O::first_n(n);
+    else
+        return O::lt(O::loadu(iota<typename O::Scalar>.data()),
+            O::set1(static_cast<typename O::Scalar>(n)));
+}
+
+// Lanes rotated by K inside every 128 bit lane, lane j gets lane j + K
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+#define YAVL_ROTATE_IMM(K) _MM_SHUFFLE((K + 3) % 4, (K + 2) % 4, (K + 1) % 4, K)
+#if defined(YAVL_X86_SSE42)
+template <int K>
+static inline __m128 rotate(const __m128 a) {
+    return _mm_shuffle_ps(a, a, YAVL_ROTATE_IMM(K));
+}
+#endif
+#if defined(YAVL_X86_AVX)
+template <int K>
+static inline __m256 rotate(const __m256 a) {
+    return _mm256_permute_ps(a, YAVL_ROTATE_IMM(K));
+}
+#endif
+#if defined(YAVL_X86_AVX512F)
+template <int K>
+static inline __m512 rotate(const __m512 a) {
+    return _mm512_permute_ps(a, YAVL_ROTATE_IMM(K));
+}
+#endif
+#if defined(YAVL_ARM_NEON)
+template <int K>
+static inline float32x4_t rotate(const float32x4_t a) {
+    return vextq_f32(a, a, K);
+}
+#endif
+#undef YAVL_ROTATE_IMM
+#endif
+
+// Ops have Accs accumulator packets per unrolled slot, init() sets them to
+// the identity and step() folds in one packet of each input
+struct sum_op {
+    static constexpr uint32_t Accs = 1;
+
+    template <typename O, typename P>
+    inline void init(P (&a)[Accs]) const {
+        a[0] = O::set1(0);
+    }
+
+    template <typename O, typename P>
+    inline void step(P (&a)[Accs], const std::array<P, 1>& x) const {
+        a[0] = O::add(a[0], x[0]);
+    }
+};
+
+// s and the compensation c, s - c is the sum
+struct kahan_op {
+    static constexpr uint32_t Accs = 2;
+
+    template <typename O, typename P>
+    inline void init(P (&a)[Accs]) const {
+        a[0] = a[1] = O::set1(0);
+    }
+
+    template <typename O, typename P>
+    inline void step(P (&a)[Accs], const std::array<P, 1>& x) const {
+        const P y = O::sub(x[0], a[1]);
+        const P t = O::add(a[0], y);
+        a[1] = O::sub(O::sub(t, a[0]), y);
+        a[0] = t;
+    }
+};
+
+struct dot_op {
+    static constexpr uint32_t Accs = 1;
+
+    template <typename O, typename P>
+    inline void init(P (&a)[Accs]) const {
+        a[0] = O::set1(0);
+    }
+
+    template <typename O, typename P>
+    inline void step(P (&a)[Accs], const std::array<P, 2>& x) const {
+        a[0] = O::fmadd(x[0], x[1], a[0]);
+    }
+};
+
+// min(x, acc) returns acc for a NaN x on every backend, so NaNs never get
+// into the accumulators
+template <bool Min, bool Max>
+struct extreme_op {
+    static constexpr uint32_t Accs = Min + Max;
+
+    template <typename O, typename P>
+    inline void init(P (&a)[Accs]) const {
+        using T = typename O::Scalar;
+        if constexpr (Min)
+            a[0] = O::set1(std::numeric_limits<T>::infinity());
+        if constexpr (Max)
+            a[Min] = O::set1(-std::numeric_limits<T>::infinity());
+    }
+
+    template <typename O, typename P>
+    inline void step(P (&a)[Accs], const std::array<P, 1>& x) const {
+        if constexpr (Min)
+            a[0] = O::min(x[0], a[0]);
+        if constexpr (Max)
+            a[Min] = O::max(x[0], a[Min]);
+    }
+};
+
+// Products of centered xyzw records with themselves, rotated by one and by
+// two lanes: xx yy zz, xy yz and xz end up in lanes 0-2, 0-1 and 0
+template <typename T>
+struct covariance_op {
+    static constexpr uint32_t Accs = 3;
+
+    std::array<T, 64> center;
+
+    template <typename O, typename P>
+    inline void init(P (&a)[Accs]) const {
+        a[0] = a[1] = a[2] = O::set1(0);
+    }
+
+    template <typename O, typename P>
+    inline void step(P (&a)[Accs], const std::array<P, 1>& x) const {
+        const P d = O::sub(x[0], O::loadu(center.data()));
+        a[0] = O::fmadd(d, d, a[0]);
+        a[1] = O::fmadd(d, rotate<1>(d), a[1]);
+        a[2] = O::fmadd(d, rotate<2>(d), a[2]);
+    }
+};
+
+template <typename T, uint32_t A, uint32_t Lanes>
+using lanes_t = std::array<std::array<T, Lanes>, A>;
+
+// Runs op over n elements of the I input streams, see shape for the lanes
+// of the result
+template <typename T, uint32_t L, typename Op, std::size_t I>
+static inline auto reduce_lanes(const Op& op, const std::array<const T*, I>& in,
+    const std::size_t n)
+{
+    using S = shape<T, L>;
+    using P = typename S::P;
+    using O = typename S::O;
+    constexpr uint32_t W = S::W;
+
+    P acc[S::U][Op::Accs];
+    static_for<S::U>([&](const int u) {
+        op.template init<O>(acc[u]);
+    });
+
+    auto load = [&](const std::size_t i) {
+        std::array<P, I> x;
+        for (std::size_t k = 0; k < I; ++k)
+            x[k] = O::loadu(in[k] + i);
+        return x;
+    };
+
+    std::size_t i = 0;
+    for (; i + S::Lanes <= n; i += S::Lanes) {
+        static_for<S::U>([&](const int u) {
+            op.template step<O>(acc[u], load(i + u * W));
+        });
+    }
+
+    // Fewer than U packets are left, the same slots keep the lane mapping
+    static_for<S::U>([&](const int u) {
+        if (i + W <= n) {
+            op.template step<O>(acc[u], load(i));
+            i += W;
+        }
+        else if (i < n) {
+            const auto tail = static_cast<uint32_t>(n - i);
+            std::array<P, I> x;
+            for (std::size_t k = 0; k < I; ++k)
+                x[k] = load_n<P>(in[k] + i, tail);
+            P prev[Op::Accs];
+            std::copy(acc[u], acc[u] + Op::Accs, prev);
+            op.template step<O>(acc[u], x);
+            const auto m = tail_mask<P>(tail);
+            for (uint32_t a = 0; a < Op::Accs; ++a)
+                acc[u][a] = O::select(m, acc[u][a], prev[a]);
+            i = n;
+        }
+    });
+
+    lanes_t<T, Op::Accs, S::Lanes> r;
+    static_for<S::U>([&](const int u) {
+        for (uint32_t a = 0; a < Op::Accs; ++a)
+            O::storeu(r[a].data() + u * W, acc[u][a]);
+    });
+    return r;
+}
+
+// Pairwise tree of reduce_lanes over blocks, for the additive ops. Halves
+// are whole blocks so the lane mapping holds on both sides
+template <typename T, uint32_t L, typename Op, std::size_t I>
+static inline auto reduce_pairwise(const Op& op, std::array<const T*, I> in,
+    const std::size_t n)
+{
+    constexpr std::size_t block = shape<T, L>::Block;
+    if (n <= block)
+        return reduce_lanes<T, L>(op, in, n);
+
+    const std::size_t half = (n / block + 1) / 2 * block;
+    auto l = reduce_pairwise<T, L>(op, in, half);
+    for (auto& p : in)
+        p += half;
+    const auto r = reduce_pairwise<T, L>(op, in, n - half);
+    for (uint32_t a = 0; a < Op::Accs; ++a)
+        for (std::size_t k = 0; k < l[a].size(); ++k)
+            l[a][k] += r[a][k];
+    return l;
+}
+
+// Components [0, N) of lanes of period L, f(acc, lane)
+template <typename R, uint32_t L, uint32_t N, typename T, std::size_t Lanes, typename F>
+static inline std::array<R, N> fold(const std::array<T, Lanes>& lanes, const R init,
+    const F& f)
+{
+    std::array<R, N> r;
+    r.fill(init);
+    for (std::size_t k = 0; k < Lanes; ++k)
+        if (k % L < N)
+            r[k % L] = f(r[k % L], lanes[k]);
+    return r;
+}
+
+// Per component sums of n records of N components with a period of L
+template <summation S, uint32_t L, uint32_t N, typename T>
+static inline std::array<double, N> sum(const T* p, const std::size_t n) {
+    auto add = [](const double acc, const T x) { return acc + x; };
+    const std::array<const T*, 1> in{ p };
+    if constexpr (S == summation::kahan) {
+        const auto l = reduce_lanes<T, L>(kahan_op{}, in, n * L);
+        const auto s = fold<double, L, N>(l[0], 0., add);
+        const auto c = fold<double, L, N>(l[1], 0., add);
+        std::array<double, N> r;
+        for (uint32_t i = 0; i < N; ++i)
+            r[i] = s[i] - c[i];
+        return r;
+    }
+    else if constexpr (S == summation::pairwise) {
+        return fold<double, L, N>(reduce_pairwise<T, L>(sum_op{}, in, n * L)[0], 0., add);
+    }
+    else {
+        return fold<double, L, N>(reduce_lanes<T, L>(sum_op{}, in, n * L)[0], 0., add);
+    }
+}
+
+template <typename T>
+static inline T min_of(const T a, const T b) {
+    return b < a ? b : a;
+}
+
+template <typename T>
+static inline T max_of(const T a, const T b) {
+    return b > a ? b : a;
+}
+
+// Per component min and max of n records
+template <bool Min, bool Max, uint32_t L, uint32_t N, typename T>
+static inline auto extremes(const T* p, const std::size_t n) {
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    const auto l = reduce_lanes<T, L>(extreme_op<Min, Max>{},
+        std::array<const T*, 1>{ p }, n * L);
+    std::array<std::array<T, N>, 2> r;
+    if constexpr (Min)
+        r[0] = fold<T, L, N>(l[0], inf, min_of<T>);
+    if constexpr (Max)
+        r[1] = fold<T, L, N>(l[Min], -inf, max_of<T>);
+    return r;
+}
+
+// Index of the first smallest(largest) non NaN element. The block holding
+// it is found in one pass of block minima and searched again
+template <bool Max, typename T>
+static inline std::size_t arg_extreme(const T* p, const std::size_t n) {
+    constexpr std::size_t block = shape<T, 1>::Block;
+    T best = Max ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+    std::size_t from = 0, to = n;
+    for (std::size_t b = 0; b < n; b += block) {
+        const std::size_t len = std::min(block, n - b);
+        const T m = extremes<!Max, Max, 1, 1>(p + b, len)[Max][0];
+        if (Max ? m > best : m < best) {
+            best = m;
+            from = b;
+            to = b + len;
+        }
+    }
+    // No element beats the identity, it is all infinities and NaNs
+    for (std::size_t i = from; i < to; ++i)
+        if (p[i] == best)
+            return i;
+    return n;
+}
+
+template <typename T>
+static inline Mat<T, 3> covariance(const Vec<T, 3>* p, const std::size_t n) {
+    constexpr uint32_t L = math_impl::padded_lanes<T, 3>;
+    using S = shape<T, L>;
+
+    const auto s = sum<summation::pairwise, L, 3>(reinterpret_cast<const T*>(p), n);
+    const double inv = 1. / n;
+    const double m[3] = { s[0] * inv, s[1] * inv, s[2] * inv };
+
+    // xx, yy, zz, xy, yz, xz
+    std::array<double, 6> c{};
+    if constexpr (L == 4 && S::W % 4 == 0) {
+        covariance_op<T> op;
+        for (uint32_t k = 0; k < op.center.size(); ++k)
+            op.center[k] = k % 4 < 3 ? static_cast<T>(m[k % 4]) : T(0);
+        const auto l = reduce_pairwise<T, L>(op,
+            std::array<const T*, 1>{ reinterpret_cast<const T*>(p) }, n * L);
+        auto add = [](const double acc, const T x) { return acc + x; };
+        const auto sq = fold<double, L, 3>(l[0], 0., add);
+        const auto r1 = fold<double, L, 2>(l[1], 0., add);
+        const auto r2 = fold<double, L, 1>(l[2], 0., add);
+        c = { sq[0], sq[1], sq[2], r1[0], r1[1], r2[0] };
+    }
+    else {
+        for (std::size_t i = 0; i < n; ++i) {
+            const double d[3] = { p[i][0] - m[0], p[i][1] - m[1], p[i][2] - m[2] };
+            c[0] += d[0] * d[0];
+            c[1] += d[1] * d[1];
+            c[2] += d[2] * d[2];
+            c[3] += d[0] * d[1];
+            c[4] += d[1] * d[2];
+            c[5] += d[0] * d[2];
+        }
+    }
+
+    for (auto& x : c)
+        x *= inv;
+    return Mat<T, 3>(c[0], c[3], c[5], c[3], c[1], c[4], c[5], c[4], c[2]);
+}
+
+template <typename T, uint32_t N>
+static inline Vec<T, N> to_vec(const std::array<T, N>& a) {
+    Vec<T, N> v;
+    for (uint32_t i = 0; i < N; ++i)
+        v[i] = a[i];
+    return v;
+}
+
+template <typename T, uint32_t N>
+static inline Vec<T, N> to_vec(const std::array<double, N>& a, const double scale = 1.) {
+    Vec<T, N> v;
+    for (uint32_t i = 0; i < N; ++i)
+        v[i] = static_cast<T>(a[i] * scale);
+    return v;
+}
+
+template <typename T, uint32_t N>
+static inline const T* scalars(std::span<const Vec<T, N>> a) {
+    return reinterpret_cast<const T*>(a.data());
+}
+
+} // namespace reduce_impl
+
+#define YAVL_DEFINE_VEC_REDUCTIONS(N)                                   \
+    template <summation S = summation::pairwise>                        \
+    inline Vec<float, N> sum(std::span<const Vec<float, N>> a) {        \
+        constexpr uint32_t L = math_impl::padded_lanes<float, N>;       \
+        return reduce_impl::to_vec<float, N>(                           \
+            reduce_impl::sum<S, L, N>(reduce_impl::scalars(a), a.size())); \
+    }                                                                   \
+    inline Vec<float, N> mean(std::span<const Vec<float, N>> a) {       \
+        constexpr uint32_t L = math_impl::padded_lanes<float, N>;       \
+        return reduce_impl::to_vec<float, N>(reduce_impl::sum<summation::pairwise, \
+            L, N>(reduce_impl::scalars(a), a.size()), 1. / a.size());   \
+    }                                                                   \
+    inline Vec<float, N> min(std::span<const Vec<float, N>> a) {        \
+        constexpr uint32_t L = math_impl::padded_lanes<float, N>;       \
+        return reduce_impl::to_vec<float, N>(reduce_impl::extremes<true, false, \
+            L, N>(reduce_impl::scalars(a), a.size())[0]);               \
+    }                                                                   \
+    inline Vec<float, N> max(std::span<const Vec<float, N>> a) {        \
+        constexpr uint32_t L = math_impl::padded_lanes<float, N>;       \
+        return reduce_impl::to_vec<float, N>(reduce_impl::extremes<false, true, \
+            L, N>(reduce_impl::scalars(a), a.size())[1]);               \
+    }                                                                   \
+    /* Sum of a[i].dot(b[i]) */                                         \
+    inline float dot(std::span<const Vec<float, N>> a, std::span<const Vec<float, N>> b) { \
+        assert(a.size() == b.size());                                   \
+        constexpr uint32_t L = math_impl::padded_lanes<float, N>;       \
+        const auto l = reduce_impl::reduce_pairwise<float, L>(reduce_impl::dot_op{}, \
+            std::array<const float*, 2>{ reduce_impl::scalars(a), reduce_impl::scalars(b) }, \
+            a.size() * L);                                              \
+        const auto c = reduce_impl::fold<double, L, N>(l[0], 0.,        \
+            [](const double acc, const float x) { return acc + x; });   \
+        return static_cast<float>(std::accumulate(c.begin(), c.end(), 0.)); \
+    }
+
+// Component wise sums, means, minima and maxima, and the sum of the
+// elementwise dot products. An empty array has a mean of NaN, a min of +inf
+// and a max of -inf
+YAVL_DEFINE_VEC_REDUCTIONS(3)
+YAVL_DEFINE_VEC_REDUCTIONS(4)
+
+#undef YAVL_DEFINE_VEC_REDUCTIONS
+
+template <summation S = summation::pairwise>
+inline float sum(std::span<const float> a) {
+    return static_cast<float>(reduce_impl::sum<S, 1, 1>(a.data(), a.size())[0]);
+}
+
+inline float mean(std::span<const float> a) {
+    return static_cast<float>(
+        reduce_impl::sum<summation::pairwise, 1, 1>(a.data(), a.size())[0] / a.size());
+}
+
+inline float min(std::span<const float> a) {
+    return reduce_impl::extremes<true, false, 1, 1>(a.data(), a.size())[0][0];
+}
+
+inline float max(std::span<const float> a) {
+    return reduce_impl::extremes<false, true, 1, 1>(a.data(), a.size())[1][0];
+}
+
+// Index of the first smallest/largest element, a.size() when a is empty or
+// all NaN
+inline std::size_t argmin(std::span<const float> a) {
+    return reduce_impl::arg_extreme<false>(a.data(), a.size());
+}
+
+inline std::size_t argmax(std::span<const float> a) {
+    return reduce_impl::arg_extreme<true>(a.data(), a.size());
+}
+
+inline float dot(std::span<const float> a, std::span<const float> b) {
+    assert(a.size() == b.size());
+    const auto l = reduce_impl::reduce_pairwise<float, 1>(reduce_impl::dot_op{},
+        std::array<const float*, 2>{ a.data(), b.data() }, a.size());
+    return static_cast<float>(reduce_impl::fold<double, 1, 1>(l[0], 0.,
+        [](const double acc, const float x) { return acc + x; })[0]);
+}
+
+// Axis aligned bounding box as (min, max) in one pass, (+inf, -inf) for an
+// empty array
+inline std::pair<Vec3f, Vec3f> bounds(std::span<const Vec3f> a) {
+    constexpr uint32_t L = math_impl::padded_lanes<float, 3>;
+    const auto r = reduce_impl::extremes<true, true, L, 3>(reduce_impl::scalars(a), a.size());
+    return std::make_pair(reduce_impl::to_vec<float, 3>(r[0]),
+        reduce_impl::to_vec<float, 3>(r[1]));
+}
+
+// Covariance matrix of the points around their mean, divided by n. Two
+// passes, the mean first, so a cloud far from the origin keeps its
+// precision
+inline Mat3f covariance(std::span<const Vec3f> a) {
+    return reduce_impl::covariance(a.data(), a.size());
+}
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
@@ -11,8 +11,13 @@
 #include <cmath>
 #include <cassert>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+#include <utility>
 
 #include <yavl/platform.h>
+#include <yavl/utils.h>
 
 namespace yavl
 {
@@ -41,6 +46,11 @@ struct pcg32 {
     uint32_t next_uint() {
         uint64_t oldstate = state;
         state = oldstate * PCG32_MULT + inc;
+        return output(oldstate);
+    }
+
+    // The 32 bit output of a state, xorshift then a state dependent rotation
+    static uint32_t output(uint64_t oldstate) {
         uint32_t xorshifted = (uint32_t) (((oldstate >> 18u) ^ oldstate) >> 27u);
         uint32_t rot = (uint32_t) (oldstate >> 59u);
         return (xorshifted >> rot) | (xorshifted << ((~rot + 1u) & 31));
@@ -117,9 +127,21 @@ struct pcg32 {
      * exponentiation.
      */
     void advance(int64_t delta_) {
+        auto [acc_mult, acc_plus] = advance_coeffs(delta_);
+        state = acc_mult * state + acc_plus * inc;
+    }
+
+    /**
+     * \brief Coefficients of the jump by delta steps
+     *
+     * Advancing maps the state to mult * state + plus * inc, neither
+     * coefficient depends on the state or the stream so generators on
+     * different streams jump with the same pair
+     */
+    static std::pair<uint64_t, uint64_t> advance_coeffs(int64_t delta_) {
         uint64_t
             cur_mult = PCG32_MULT,
-            cur_plus = inc,
+            cur_plus = 1u,
             acc_mult = 1u,
             acc_plus = 0u;
 
@@ -136,7 +158,7 @@ struct pcg32 {
             cur_mult *= cur_mult;
             delta /= 2;
         }
-        state = acc_mult * state + acc_plus;
+        return std::make_pair(acc_mult, acc_plus);
     }
 
     /**
@@ -182,12 +204,431 @@ struct pcg32 {
     bool operator!=(const pcg32 &other) const { return state != other.state || inc != other.inc; }
 };
 
+// Jump-ahead functions shared by pcg32x and its simd specializations,
+// which provide get_state() and apply_advance(mult, plus).
+//
+// advance() moves every lane by delta steps in O(log(delta)).
+// split(k, n) returns a copy moved to the start of block k out of n equal
+// blocks of the 2^64 period, the blocks of a lane never overlap so workers
+// calling split with the same n and distinct k draw disjoint streams as
+// long as they take less than split_length(n) numbers per lane.
+// distance() is the number of steps from other to this in every lane,
+// lanes must be on the same streams.
+#define YAVL_DEFINE_PCG32X_JUMP_FUNCS(N)                                \
+    void advance(int64_t delta) {                                       \
+        auto [mult, plus] = pcg32::advance_coeffs(delta);               \
+        apply_advance(mult, plus);                                      \
+    }                                                                   \
+    static uint64_t split_length(uint64_t n) {                          \
+        assert(n > 0);                                                  \
+        return ~0ull / n;                                               \
+    }                                                                   \
+    pcg32x split(uint64_t k, uint64_t n) const {                        \
+        assert(k < n);                                                  \
+        pcg32x ret = *this;                                             \
+        ret.advance(static_cast<int64_t>(k * split_length(n)));         \
+        return ret;                                                     \
+    }                                                                   \
+    pcg32 lane(uint32_t i) const {                                      \
+        assert(i < N);                                                  \
+        std::array<uint64_t, N> states, incs;                           \
+        get_state(states, incs);                                        \
+        pcg32 ret;                                                      \
+        ret.state = states[i];                                          \
+        ret.inc = incs[i];                                              \
+        return ret;                                                     \
+    }                                                                   \
+    std::array<int64_t, N> distance(const pcg32x& other) const {        \
+        std::array<int64_t, N> ret;                                     \
+        for (uint32_t i = 0; i < N; ++i)                                \
+            ret[i] = lane(i) - other.lane(i);                           \
+        return ret;                                                     \
+    }
+
+// fill_driver is instantiated with the register types of the simd
+// generators
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace pcg_impl
+{
+
+// Lane-wise operations on the 32 bit output of one step of a pcg32x,
+// specialized for the array of the generic generator and for the registers
+// of the simd ones. Masks have every bit of a selected lane set.
+template <typename Raw>
+struct block_ops;
+
+template <std::size_t N>
+struct block_ops<std::array<uint32_t, N>> {
+    using Raw = std::array<uint32_t, N>;
+
+    static void store_uints(uint32_t* dst, const Raw& r, bool) {
+        std::memcpy(dst, r.data(), N * sizeof(uint32_t));
+    }
+
+    static void store_floats(float* dst, const Raw& r, bool) {
+        for (std::size_t i = 0; i < N; ++i) {
+            union {
+                uint32_t u;
+                float f;
+            } x;
+            x.u = (r[i] >> 9) | 0x3f800000u;
+            dst[i] = x.f - 1.0f;
+        }
+    }
+
+    static void store_doubles(double* dst, const Raw& r, bool) {
+        for (std::size_t i = 0; i < N; ++i) {
+            union {
+                uint64_t u;
+                double d;
+            } x;
+            x.u = ((uint64_t) r[i] << 20) | 0x3ff0000000000000ULL;
+            dst[i] = x.d - 1.0;
+        }
+    }
+
+    static Raw set1(uint32_t v) {
+        Raw ret;
+        ret.fill(v);
+        return ret;
+    }
+
+    static Raw load_uints(const uint32_t* src) {
+        Raw ret;
+        std::memcpy(ret.data(), src, N * sizeof(uint32_t));
+        return ret;
+    }
+
+    // High and low halves of the lane-wise 64 bit product
+    static void mul_wide(const Raw& a, const Raw& b, Raw& hi, Raw& lo) {
+        for (std::size_t i = 0; i < N; ++i) {
+            uint64_t m = (uint64_t) a[i] * b[i];
+            hi[i] = (uint32_t) (m >> 32);
+            lo[i] = (uint32_t) m;
+        }
+    }
+
+    // Unsigned a < b
+    static Raw less(const Raw& a, const Raw& b) {
+        Raw ret;
+        for (std::size_t i = 0; i < N; ++i)
+            ret[i] = a[i] < b[i] ? ~0u : 0u;
+        return ret;
+    }
+
+    static bool any(const Raw& mask) {
+        for (std::size_t i = 0; i < N; ++i)
+            if (mask[i])
+                return true;
+        return false;
+    }
+
+    // b in the lanes selected by mask, a elsewhere
+    static Raw select(const Raw& a, const Raw& b, const Raw& mask) {
+        Raw ret;
+        for (std::size_t i = 0; i < N; ++i)
+            ret[i] = (a[i] & ~mask[i]) | (b[i] & mask[i]);
+        return ret;
+    }
+
+    static Raw mask_and(const Raw& a, const Raw& b) {
+        Raw ret;
+        for (std::size_t i = 0; i < N; ++i)
+            ret[i] = a[i] & b[i];
+        return ret;
+    }
+
+    static Raw mask_or(const Raw& a, const Raw& b) {
+        Raw ret;
+        for (std::size_t i = 0; i < N; ++i)
+            ret[i] = a[i] | b[i];
+        return ret;
+    }
+
+    static void fence() {}
+};
+
+/**
+ * \brief Bulk fills and bounded draws of pcg32x
+ *
+ * out[N * k + i] is the k-th draw of lane i, the same numbers in the same
+ * order as calling next_uints() and friends in a loop, and a partial last
+ * block still advances every lane. R provides raw_t, step(mult),
+ * scale_inc(), assign_state() and select_state().
+ *
+ * Consecutive steps of a lane form a chain of dependent 64 bit multiplies.
+ * The fill runs U copies of the generator one step apart, each jumping U
+ * steps per draw with state' = A_U * state + P_U * inc, so U independent
+ * chains are in flight while the output order stays the same.
+ */
+template <typename R, uint32_t N, uint32_t U>
+struct fill_driver {
+    using Raw = typename R::raw_t;
+    using Ops = block_ops<Raw>;
+
+    template <std::size_t... Js>
+    static std::array<R, U> leapfrog(const R& rng, uint64_t plus, std::index_sequence<Js...>) {
+        std::array<R, U> g{ ((void) Js, rng)... };
+        for (uint32_t j = 1; j < U; ++j) {
+            g[j].assign_state(g[j - 1]);
+            g[j].apply_advance(PCG32_MULT, 1u);
+        }
+        for (auto& gen : g)
+            gen.scale_inc(plus);
+        return g;
+    }
+
+    static std::array<R, U> leapfrog(const R& rng, uint64_t plus) {
+        return leapfrog(rng, plus, std::make_index_sequence<U>{});
+    }
+
+    // Non-temporal stores are issued 16 bytes at a time, blocks are
+    // multiples of that so only the start needs to be aligned
+    static bool streaming(const void* out, std::size_t bytes, store_policy policy) {
+        return use_streaming_stores(policy, bytes) &&
+            reinterpret_cast<uintptr_t>(out) % 16 == 0;
+    }
+
+    template <typename T, typename Store>
+    static void fill(R& rng, T* out, std::size_t n, store_policy policy,
+        const Store& store)
+    {
+        const bool stream = streaming(out, n * sizeof(T), policy);
+        const std::size_t blocks = n / N;
+        std::size_t k = 0;
+
+        if constexpr (U > 1) {
+            if (blocks >= U) {
+                const auto [mult, plus] = pcg32::advance_coeffs(U);
+                auto g = leapfrog(rng, plus);
+                for (; k + U <= blocks; k += U) {
+                    static_for<U>([&](const int j) {
+                        store(out + (k + j) * N, g[j].step(mult), stream);
+                    });
+                }
+                rng.assign_state(g[0]);
+            }
+        }
+
+        for (; k < blocks; ++k)
+            store(out + k * N, rng.step(PCG32_MULT), stream);
+        if (stream)
+            Ops::fence();
+
+        if (k * N < n) {
+            alignas(64) T tmp[N];
+            store(tmp, rng.step(PCG32_MULT), false);
+            std::memcpy(out + k * N, tmp, (n - k * N) * sizeof(T));
+        }
+    }
+
+    // Lemire's multiply-shift, hi is the high half of r * bound and draws
+    // whose low half is under threshold = 2^32 % bound are rejected
+    static Raw bounded(const Raw& r, const Raw& bound, const Raw& threshold, Raw& hi) {
+        Raw lo;
+        Ops::mul_wide(r, bound, hi, lo);
+        return Ops::less(lo, threshold);
+    }
+
+    // One block of bounded draws, lanes that reject draw again while the
+    // others keep their state
+    static Raw bounded_block(R& rng, const Raw& bound, const Raw& threshold) {
+        Raw hi;
+        Raw reject = bounded(rng.step(PCG32_MULT), bound, threshold, hi);
+        while (Ops::any(reject)) {
+            R next = rng;
+            Raw retry_hi;
+            Raw retry_reject = bounded(next.step(PCG32_MULT), bound, threshold, retry_hi);
+            rng.select_state(next, reject);
+            hi = Ops::select(hi, retry_hi, reject);
+            reject = Ops::mask_and(reject, retry_reject);
+        }
+        return hi;
+    }
+
+    // The same with a bound per lane. The threshold is below the bound, so
+    // lanes whose low half is at least the bound are accepted right away
+    // and the modulo is only computed for the rare ones that are not
+    static Raw rejected_lanes(const Raw& lo, const Raw& bound) {
+        Raw maybe = Ops::less(lo, bound);
+        if (!Ops::any(maybe))
+            return maybe;
+
+        alignas(64) uint32_t l[N], b[N], m[N];
+        Ops::store_uints(l, lo, false);
+        Ops::store_uints(b, bound, false);
+        Ops::store_uints(m, maybe, false);
+        for (uint32_t i = 0; i < N; ++i)
+            if (m[i])
+                m[i] = l[i] < (~b[i] + 1u) % b[i] ? ~0u : 0u;
+        return Ops::load_uints(m);
+    }
+
+    static Raw bounded_block(R& rng, const Raw& bound) {
+        Raw hi, lo;
+        Ops::mul_wide(rng.step(PCG32_MULT), bound, hi, lo);
+        Raw reject = rejected_lanes(lo, bound);
+        while (Ops::any(reject)) {
+            R next = rng;
+            Raw retry_hi;
+            Ops::mul_wide(next.step(PCG32_MULT), bound, retry_hi, lo);
+            rng.select_state(next, reject);
+            hi = Ops::select(hi, retry_hi, reject);
+            reject = Ops::mask_and(reject, rejected_lanes(lo, bound));
+        }
+        return hi;
+    }
+
+    static void fill_bounded(R& rng, uint32_t* out, std::size_t n, uint32_t bound,
+        store_policy policy)
+    {
+        assert(bound > 0);
+        const uint32_t threshold = (~bound + 1u) % bound;
+        const Raw vbound = Ops::set1(bound);
+        const Raw vthreshold = Ops::set1(threshold);
+        const bool stream = streaming(out, n * sizeof(uint32_t), policy);
+        const std::size_t blocks = n / N;
+        std::size_t k = 0;
+
+        // The leapfrog copies only pay off while a rejection anywhere in a
+        // group of U blocks is rare, on one the group is redrawn with the
+        // masked retry. Bounds that reject often go to the retry directly.
+        if constexpr (U > 1) {
+            if (blocks >= U && threshold <= ~0u / (8 * N * U)) {
+                const auto [mult, plus] = pcg32::advance_coeffs(U);
+                auto g = leapfrog(rng, plus);
+                while (k + U <= blocks) {
+                    const R start = g[0];
+                    std::array<Raw, U> hi;
+                    Raw reject = bounded(g[0].step(mult), vbound, vthreshold, hi[0]);
+                    static_for<U - 1>([&](const int j) {
+                        reject = Ops::mask_or(reject,
+                            bounded(g[j + 1].step(mult), vbound, vthreshold, hi[j + 1]));
+                    });
+
+                    if (!Ops::any(reject)) {
+                        static_for<U>([&](const int j) {
+                            Ops::store_uints(out + (k + j) * N, hi[j], stream);
+                        });
+                    }
+                    else {
+                        rng.assign_state(start);
+                        for (uint32_t j = 0; j < U; ++j)
+                            Ops::store_uints(out + (k + j) * N,
+                                bounded_block(rng, vbound, vthreshold), stream);
+                        g = leapfrog(rng, plus);
+                    }
+                    k += U;
+                }
+                rng.assign_state(g[0]);
+            }
+        }
+
+        for (; k < blocks; ++k)
+            Ops::store_uints(out + k * N, bounded_block(rng, vbound, vthreshold), stream);
+        if (stream)
+            Ops::fence();
+
+        if (k * N < n) {
+            alignas(64) uint32_t tmp[N];
+            Ops::store_uints(tmp, bounded_block(rng, vbound, vthreshold), false);
+            std::memcpy(out + k * N, tmp, (n - k * N) * sizeof(uint32_t));
+        }
+    }
+};
+
+} // namespace pcg_impl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
+
+// Bulk fill functions shared by pcg32x and its simd specializations, see
+// pcg_impl::fill_driver for the order of the output and the hooks needed.
+// U is the number of leapfrogged generator copies.
+//
+// Outputs past streaming_store_threshold bytes are written with
+// non-temporal stores under store_policy::automatic when the span is 16
+// byte aligned. fill_uint32_bounded() draws r < bound with Lemire's
+// multiply-shift method instead of the modulo of pcg32::next_uint(bound),
+// the two are unbiased but give different numbers.
+#define YAVL_DEFINE_PCG32X_FILL_FUNCS(N, U)                             \
+    void fill_uint32(std::span<uint32_t> out,                           \
+        store_policy policy = store_policy::automatic) {                \
+        pcg_impl::fill_driver<pcg32x, N, U>::fill(*this, out.data(),    \
+            out.size(), policy, [](auto* dst, const raw_t& r, bool s) { \
+                pcg_impl::block_ops<raw_t>::store_uints(dst, r, s);     \
+            });                                                         \
+    }                                                                   \
+    void fill_uniform_float(std::span<float> out,                       \
+        store_policy policy = store_policy::automatic) {                \
+        pcg_impl::fill_driver<pcg32x, N, U>::fill(*this, out.data(),    \
+            out.size(), policy, [](auto* dst, const raw_t& r, bool s) { \
+                pcg_impl::block_ops<raw_t>::store_floats(dst, r, s);    \
+            });                                                         \
+    }                                                                   \
+    void fill_uniform_double(std::span<double> out,                     \
+        store_policy policy = store_policy::automatic) {                \
+        pcg_impl::fill_driver<pcg32x, N, U>::fill(*this, out.data(),    \
+            out.size(), policy, [](auto* dst, const raw_t& r, bool s) { \
+                pcg_impl::block_ops<raw_t>::store_doubles(dst, r, s);   \
+            });                                                         \
+    }                                                                   \
+    void fill_uint32_bounded(std::span<uint32_t> out, uint32_t bound,   \
+        store_policy policy = store_policy::automatic) {                \
+        pcg_impl::fill_driver<pcg32x, N, U>::fill_bounded(*this,        \
+            out.data(), out.size(), bound, policy);                     \
+    }                                                                   \
+    template <typename, uint32_t, uint32_t>                             \
+    friend struct pcg_impl::fill_driver;
+
+// Bounded draws shared by pcg32x and its simd specializations.
+// next_uints(bound) draws r < bound in every lane with the multiply-shift
+// method of fill_uint32_bounded(). shuffle() is the Fisher-Yates shuffle of
+// pcg32::shuffle with the indices of N consecutive positions drawn at once,
+// each from its own bound, so the permutations differ from the scalar ones.
+#define YAVL_DEFINE_PCG32X_BOUNDED_FUNCS(N)                             \
+    auto next_uints(uint32_t bound) {                                   \
+        assert(bound > 0);                                              \
+        return pcg_impl::fill_driver<pcg32x, N, 1>::bounded_block(      \
+            *this, pcg_impl::block_ops<raw_t>::set1(bound));            \
+    }                                                                   \
+    void next_uints(std::array<uint32_t, N>& result, uint32_t bound) {  \
+        pcg_impl::block_ops<raw_t>::store_uints(result.data(),          \
+            next_uints(bound), false);                                  \
+    }                                                                   \
+    template <typename Iterator>                                        \
+    void shuffle(Iterator begin, Iterator end) {                        \
+        using Ops = pcg_impl::block_ops<raw_t>;                         \
+        assert(end - begin <= (int64_t) ~0u);                           \
+        alignas(64) uint32_t bounds[N], idx[N];                         \
+        uint32_t i = (uint32_t) (end - begin);                          \
+        while (i > 1) {                                                 \
+            for (uint32_t l = 0; l < N; ++l)                            \
+                bounds[l] = i > l + 1 ? i - l : 1u;                     \
+            Ops::store_uints(idx, pcg_impl::fill_driver<pcg32x, N, 1>:: \
+                bounded_block(*this, Ops::load_uints(bounds)), false);  \
+            for (uint32_t l = 0; l < N && i > 1; ++l, --i)              \
+                std::iter_swap(begin + (i - 1), begin + idx[l]);        \
+        }                                                               \
+    }
+
 template <uint32_t N>
 struct pcg32x {
     pcg32 rng[N];
 
     pcg32x() {
-        std::array<uint64_t, N> initstate{ PCG32_DEFAULT_STATE };
+        std::array<uint64_t, N> initstate;
+        initstate.fill(PCG32_DEFAULT_STATE);
         std::array<uint64_t, N> initseq = integer_range_array<uint64_t, 1, N>;
 
         seed(initstate, initseq);
@@ -216,6 +657,56 @@ struct pcg32x {
         for (int i = 0; i < N; ++i)
             result[i] = rng[i].next_double();
     }
+
+    // Jump-ahead
+    YAVL_DEFINE_PCG32X_JUMP_FUNCS(N)
+
+    // Bulk fills, the lanes are independent chains already
+    YAVL_DEFINE_PCG32X_FILL_FUNCS(N, 1)
+
+    // Bounded draws and shuffles
+    YAVL_DEFINE_PCG32X_BOUNDED_FUNCS(N)
+
+private:
+    using raw_t = std::array<uint32_t, N>;
+
+    void get_state(std::array<uint64_t, N>& states, std::array<uint64_t, N>& incs) const {
+        for (uint32_t i = 0; i < N; ++i) {
+            states[i] = rng[i].state;
+            incs[i] = rng[i].inc;
+        }
+    }
+
+    void apply_advance(uint64_t mult, uint64_t plus) {
+        for (uint32_t i = 0; i < N; ++i)
+            rng[i].state = mult * rng[i].state + plus * rng[i].inc;
+    }
+
+    // Fill hooks, a step with a given multiplier, see pcg_impl::fill_driver
+    raw_t step(uint64_t mult) {
+        raw_t ret;
+        for (uint32_t i = 0; i < N; ++i) {
+            ret[i] = pcg32::output(rng[i].state);
+            rng[i].state = rng[i].state * mult + rng[i].inc;
+        }
+        return ret;
+    }
+
+    void scale_inc(uint64_t plus) {
+        for (uint32_t i = 0; i < N; ++i)
+            rng[i].inc *= plus;
+    }
+
+    void assign_state(const pcg32x& other) {
+        for (uint32_t i = 0; i < N; ++i)
+            rng[i].state = other.rng[i].state;
+    }
+
+    void select_state(const pcg32x& other, const raw_t& mask) {
+        for (uint32_t i = 0; i < N; ++i)
+            if (mask[i])
+                rng[i].state = other.rng[i].state;
+    }
 };
 
 #if !defined(YAVL_DISABLE_VECTORIZATION)
@@ -230,8 +721,202 @@ struct pcg32x {
 // Do nothing here for now
 #endif
 
+#if defined(YAVL_X86_AVX512VL) || defined(YAVL_X86_AVX2)
+
+namespace pcg_impl
+{
+
+// Outputs of the avx512 and avx2 generators, 8 lanes in a ymm register.
+// Non-temporal stores go out 16 bytes at a time, see fill_driver.
+template <>
+struct block_ops<__m256i> {
+    static void store_uints(uint32_t* dst, __m256i r, bool stream) {
+        if (stream) {
+            _mm_stream_si128((__m128i*) dst, _mm256_castsi256_si128(r));
+            _mm_stream_si128((__m128i*) dst + 1, _mm256_extracti128_si256(r, 1));
+        }
+        else
+            _mm256_storeu_si256((__m256i*) dst, r);
+    }
+
+    static void store_floats(float* dst, __m256i r, bool stream) {
+        const __m256i const1 = _mm256_set1_epi32((int) 0x3f800000u);
+        __m256i fltval = _mm256_or_si256(_mm256_srli_epi32(r, 9), const1);
+        __m256 f = _mm256_sub_ps(_mm256_castsi256_ps(fltval), _mm256_castsi256_ps(const1));
+        if (stream) {
+            _mm_stream_ps(dst, _mm256_castps256_ps128(f));
+            _mm_stream_ps(dst + 4, _mm256_extractf128_ps(f, 1));
+        }
+        else
+            _mm256_storeu_ps(dst, f);
+    }
+
+    static void store_doubles(double* dst, __m256i r, bool stream) {
+        const __m256i const1 = _mm256_set1_epi64x((long long) 0x3ff0000000000000ull);
+        __m256i lo = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(r));
+        __m256i hi = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(r, 1));
+        __m256d d[2] = {
+            _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_slli_epi64(lo, 20), const1)),
+                          _mm256_castsi256_pd(const1)),
+            _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_slli_epi64(hi, 20), const1)),
+                          _mm256_castsi256_pd(const1))
+        };
+        static_for<2>([&](const int i) {
+            if (stream) {
+                _mm_stream_pd(dst + i * 4, _mm256_castpd256_pd128(d[i]));
+                _mm_stream_pd(dst + i * 4 + 2, _mm256_extractf128_pd(d[i], 1));
+            }
+            else
+                _mm256_storeu_pd(dst + i * 4, d[i]);
+        });
+    }
+
+    static __m256i set1(uint32_t v) {
+        return _mm256_set1_epi32((int) v);
+    }
+
+    static __m256i load_uints(const uint32_t* src) {
+        return _mm256_loadu_si256((const __m256i*) src);
+    }
+
+    // 32x32 bit products of the even and odd lanes
+    static void mul_wide(__m256i a, __m256i b, __m256i& hi, __m256i& lo) {
+        __m256i even = _mm256_mul_epu32(a, b);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0b10101010);
+        lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0b10101010);
+    }
+
+    // No unsigned compare before avx512, flip the sign bits instead
+    static __m256i less(__m256i a, __m256i b) {
+        const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+        return _mm256_cmpgt_epi32(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+    }
+
+    static bool any(__m256i mask) {
+        return !_mm256_testz_si256(mask, mask);
+    }
+
+    static __m256i select(__m256i a, __m256i b, __m256i mask) {
+        return _mm256_blendv_epi8(a, b, mask);
+    }
+
+    static __m256i mask_and(__m256i a, __m256i b) {
+        return _mm256_and_si256(a, b);
+    }
+
+    static __m256i mask_or(__m256i a, __m256i b) {
+        return _mm256_or_si256(a, b);
+    }
+
+    static void fence() {
+        _mm_sfence();
+    }
+};
+
+} // namespace pcg_impl
+
+#endif
+
 #if defined(YAVL_X86_AVX512VL)
 
+namespace pcg_impl
+{
+
+// Low 64 bits of the lane-wise product
+inline __m512i mul64(const __m512i a, const __m512i b) {
+#if defined(YAVL_X86_AVX512DQ)
+    return _mm512_mullo_epi64(a, b);
+#else
+    __m512i m_hl = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), b);
+    __m512i m_lh = _mm512_mul_epu32(a, _mm512_srli_epi64(b, 32));
+    __m512i m_ll = _mm512_mul_epu32(a, b);
+    return _mm512_add_epi64(
+        _mm512_slli_epi64(_mm512_add_epi64(m_hl, m_lh), 32), m_ll);
+#endif
+}
+
+// Outputs of the 16 lane avx512 generator
+template <>
+struct block_ops<__m512i> {
+    static void store_uints(uint32_t* dst, __m512i r, bool stream) {
+        if (stream)
+            stream_x4(dst, r);
+        else
+            _mm512_storeu_si512(dst, r);
+    }
+
+    static void store_floats(float* dst, __m512i r, bool stream) {
+        const __m512i const1 = _mm512_set1_epi32((int) 0x3f800000u);
+        __m512i fltval = _mm512_or_si512(_mm512_srli_epi32(r, 9), const1);
+        __m512 f = _mm512_sub_ps(_mm512_castsi512_ps(fltval), _mm512_castsi512_ps(const1));
+        store_uints((uint32_t*) dst, _mm512_castps_si512(f), stream);
+    }
+
+    static void store_doubles(double* dst, __m512i r, bool stream) {
+        const __m512i const1 = _mm512_set1_epi64(0x3ff0000000000000ull);
+        const __m256i v[2] = {
+            _mm512_castsi512_si256(r), _mm512_extracti64x4_epi64(r, 1)
+        };
+        static_for<2>([&](const int i) {
+            __m512i t = _mm512_or_si512(_mm512_slli_epi64(_mm512_cvtepu32_epi64(v[i]), 20), const1);
+            __m512d d = _mm512_sub_pd(_mm512_castsi512_pd(t), _mm512_castsi512_pd(const1));
+            store_uints((uint32_t*) (dst + i * 8), _mm512_castpd_si512(d), stream);
+        });
+    }
+
+    static __m512i set1(uint32_t v) {
+        return _mm512_set1_epi32((int) v);
+    }
+
+    static __m512i load_uints(const uint32_t* src) {
+        return _mm512_loadu_si512(src);
+    }
+
+    static void mul_wide(__m512i a, __m512i b, __m512i& hi, __m512i& lo) {
+        __m512i even = _mm512_mul_epu32(a, b);
+        __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+        hi = _mm512_mask_blend_epi32(0xaaaa, _mm512_srli_epi64(even, 32), odd);
+        lo = _mm512_mask_blend_epi32(0xaaaa, even, _mm512_slli_epi64(odd, 32));
+    }
+
+    static __m512i less(__m512i a, __m512i b) {
+        return _mm512_maskz_set1_epi32(_mm512_cmplt_epu32_mask(a, b), -1);
+    }
+
+    static bool any(__m512i mask) {
+        return _mm512_test_epi32_mask(mask, mask) != 0;
+    }
+
+    static __m512i select(__m512i a, __m512i b, __m512i mask) {
+        return _mm512_mask_blend_epi32(_mm512_test_epi32_mask(mask, mask), a, b);
+    }
+
+    static __m512i mask_and(__m512i a, __m512i b) {
+        return _mm512_and_si512(a, b);
+    }
+
+    static __m512i mask_or(__m512i a, __m512i b) {
+        return _mm512_or_si512(a, b);
+    }
+
+    static void fence() {
+        _mm_sfence();
+    }
+
+private:
+    // Non-temporal stores 16 bytes at a time, see fill_driver
+    static void stream_x4(uint32_t* dst, __m512i r) {
+        _mm_stream_si128((__m128i*) dst, _mm512_extracti32x4_epi32(r, 0));
+        _mm_stream_si128((__m128i*) dst + 1, _mm512_extracti32x4_epi32(r, 1));
+        _mm_stream_si128((__m128i*) dst + 2, _mm512_extracti32x4_epi32(r, 2));
+        _mm_stream_si128((__m128i*) dst + 3, _mm512_extracti32x4_epi32(r, 3));
+    }
+};
+
+} // namespace pcg_impl
+
+// 8 parallel PCG32 generators with the whole 64 bit state in one zmm register
 template <>
 struct alignas(64) pcg32x<8> {
     __m512i state;
@@ -239,7 +924,12 @@ struct alignas(64) pcg32x<8> {
 
     // Ctors
     pcg32x() {
-        std::array<uint64_t, 8> initstate{ PCG32_DEFAULT_STATE };
+        std::array<uint64_t, 8> initstate = {
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE
+        };
         std::array<uint64_t, 8> initseq{ 1, 2, 3, 4, 5, 6, 7, 8 };
 
         seed(initstate, initseq);
@@ -255,17 +945,17 @@ struct alignas(64) pcg32x<8> {
 
         state = _mm512_setzero_si512();
         inc = _mm512_or_si512(
-            _mm512_slli_epi64(_mm512_load_si512((__m512i*) &initseq), 1), one);
+            _mm512_slli_epi64(_mm512_loadu_si512(initseq.data()), 1), one);
         step();
 
-        state = _mm512_add_epi64(state, _mm512_load_si256((__m512i*) &initstate));
+        state = _mm512_add_epi64(state, _mm512_loadu_si512(initstate.data()));
 
         step();
     }
 
     // Generate 8 uniformly distributed unsigned 32-bit random numbers
     void next_uints(std::array<uint32_t, 8>& result) {
-        _mm256_store_si256((__m256i*) result.data(), step());
+        _mm256_storeu_si256((__m256i*) result.data(), step());
     }
 
     __m256i next_uints() {
@@ -284,7 +974,7 @@ struct alignas(64) pcg32x<8> {
     }
 
     void next_floats(std::array<float, 8>& result) {
-        _mm256_store_ps(result.data(), next_floats());
+        _mm256_storeu_ps(result.data(), next_floats());
     }
 
     // Generate 8 double precision floating point value on the interval [0, 1)
@@ -302,61 +992,203 @@ struct alignas(64) pcg32x<8> {
 
     void next_doubles(std::array<double, 8>& result) {
         auto value = next_doubles();
-        _mm512_store_pd(result.data(), value);
+        _mm512_storeu_pd(result.data(), value);
     }
 
+    // Jump-ahead
+    YAVL_DEFINE_PCG32X_JUMP_FUNCS(8)
+
+    // Bulk fills, four chains cover the latency of the 64 bit multiply
+    YAVL_DEFINE_PCG32X_FILL_FUNCS(8, 4)
+
+    // Bounded draws and shuffles
+    YAVL_DEFINE_PCG32X_BOUNDED_FUNCS(8)
+
 private:
-    inline __m256i step() {
-        const __m512i pcg32_mult_l = _mm512_set1_epi64(pcg32_mult & 0xffffffffu);
-        const __m512i pcg32_mult_h = _mm512_set1_epi64(pcg32_mult >> 32);
-        const __m512i mask_l       = _mm512_set1_epi64(0x3ff0000000000000ull);
-        const __m512i shift        = _mm512_set_epi32(6, 4, 2, 0, 7, 7, 7, 7,
-                                                      7, 7, 7, 7, 6, 4, 2, 0);
-        const __m256i const32      = _mm256_set1_epi32(32);
+    using raw_t = __m256i;
 
-        auto s = state;
+    void get_state(std::array<uint64_t, 8>& states, std::array<uint64_t, 8>& incs) const {
+        _mm512_storeu_si512(states.data(), state);
+        _mm512_storeu_si512(incs.data(), inc);
+    }
 
-        /* extract low and high words for partial products below */
-        __m512i lo = _mm512_and_si512(s, mask_l);
-        __m512i hi = _mm512_srli_epi64(s, 32);
+    void apply_advance(uint64_t mult, uint64_t plus) {
+        state = _mm512_add_epi64(
+            pcg_impl::mul64(state, _mm512_set1_epi64((long long) mult)),
+            pcg_impl::mul64(inc, _mm512_set1_epi64((long long) plus)));
+    }
 
-        /* improve high bits using xorshift step */
-        __m512i ss = _mm512_srli_epi64(s, 18);
-        __m512 sx = _mm512_xor_si512(ss, s);
-        __m512i sxs = _mm512_srli_epi64(sx, 27);
-        __m512i xors = _mm512_and_si512(mask_l, sxs);
+    void scale_inc(uint64_t plus) {
+        inc = pcg_impl::mul64(inc, _mm512_set1_epi64((long long) plus));
+    }
 
-        /* use high bits to choose a bit-level rotation */
-        __m512i rot = _mm512_srli_epi64(s, 59);
+    void assign_state(const pcg32x& other) {
+        state = other.state;
+    }
 
-        /* 64 bit multiplication using 32 bit partial products :( */
-        __m512i m_hl = _mm512_mul_epi32(hi, pcg32_mult_l);
-        __m512i m_lh = _mm512_mul_epi32(lo, pcg32_mult_h);
+    void select_state(const pcg32x& other, const __m256i mask) {
+        __mmask8 k = (__mmask8) _mm256_movemask_ps(_mm256_castsi256_ps(mask));
+        state = _mm512_mask_mov_epi64(state, k, other.state);
+    }
 
-        /* assemble lower 32 bits, will be merged into one 256 bit vector below */
-        xors = _mm512_permutevar_epi32(xors, shift);
-        rot = _mm512_permutevar_epi32(rot, shift);
+    // The multiplier is only changed by the leapfrogged fills
+    inline __m256i step(uint64_t mult = PCG32_MULT) {
+        auto s = state;
 
-        /* continue with partial products */
-        __m512i m_ll = _mm512_mul_epi32(lo, pcg32_mult_l);
-        __m512i mh = _mm512_add_epi64(m_hl, m_lh);
-        __m512i mhs = _mm512_slli_epi64(mh, 32);
-        __m512i sn = _mm512_add_epi64(mhs, m_ll);
+        /* improve high bits using xorshift step, then narrow to 32 bit lanes */
+        __m512i sx = _mm512_xor_si512(_mm512_srli_epi64(s, 18), s);
+        __m256i xors = _mm512_cvtepi64_epi32(_mm512_srli_epi64(sx, 27));
 
-        __m256i xors256 = _mm256_or_si256(_mm512_extracti32x8_epi32(xors, 0),
-                                          _mm512_extracti32x8_epi32(xors, 1));
-        __m256i rot256  = _mm256_or_si256(_mm512_extracti32x8_epi32(rot, 0),
-                                          _mm512_extracti32x8_epi32(rot, 1));
+        /* use high bits to choose a bit-level rotation */
+        __m256i rot = _mm512_cvtepi64_epi32(_mm512_srli_epi64(s, 59));
 
-        state = _mm512_add_epi64(sn, inc);
+        state = _mm512_add_epi64(pcg_impl::mul64(s, _mm512_set1_epi64((long long) mult)), inc);
 
         /* finally, rotate and return the result */
-        __m256i result = _mm256_or_si256(
-            _mm256_srlv_epi32(xors256, rot256),
-            _mm256_sllv_epi32(xors256, _mm256_sub_epi32(const32, rot256))
-        );
+        return _mm256_rorv_epi32(xors, rot);
+    }
+};
 
-        return result;
+// 16 parallel PCG32 generators in two zmm registers, lanes 0-7 in the first
+template <>
+struct alignas(64) pcg32x<16> {
+    __m512i state[2];
+    __m512i inc[2];
+
+    // Ctors
+    pcg32x() {
+        std::array<uint64_t, 16> initstate;
+        initstate.fill(PCG32_DEFAULT_STATE);
+        std::array<uint64_t, 16> initseq = integer_range_array<uint64_t, 1, 16>;
+
+        seed(initstate, initseq);
+    }
+
+    pcg32x(const std::array<uint64_t, 16>& initstate, const std::array<uint64_t, 16>& initseq) {
+        seed(initstate, initseq);
+    }
+
+    // Seed the pseudorandom number generator
+    void seed(const std::array<uint64_t, 16>& initstate, const std::array<uint64_t, 16>& initseq) {
+        const __m512i one = _mm512_set1_epi64(1);
+
+        static_for<2>([&](const auto i) {
+            state[i] = _mm512_setzero_si512();
+            inc[i] = _mm512_or_si512(
+                _mm512_slli_epi64(_mm512_loadu_si512(&initseq[i << 3]), 1), one);
+        });
+        step();
+
+        static_for<2>([&](const auto i) {
+            state[i] = _mm512_add_epi64(state[i], _mm512_loadu_si512(&initstate[i << 3]));
+        });
+        step();
+    }
+
+    // Generate 16 uniformly distributed unsigned 32-bit random numbers
+    void next_uints(std::array<uint32_t, 16>& result) {
+        _mm512_storeu_si512(result.data(), step());
+    }
+
+    __m512i next_uints() {
+        return step();
+    }
+
+    // Generate 16 single precision floating point value on the interval [0, 1)
+    __m512 next_floats() {
+        const __m512i const1 = _mm512_set1_epi32((int) 0x3f800000u);
+
+        __m512i value = step();
+        __m512i fltval = _mm512_or_si512(_mm512_srli_epi32(value, 9), const1);
+
+        return _mm512_sub_ps(_mm512_castsi512_ps(fltval), _mm512_castsi512_ps(const1));
+    }
+
+    void next_floats(std::array<float, 16>& result) {
+        _mm512_storeu_ps(result.data(), next_floats());
+    }
+
+    // Generate 16 double precision floating point value on the interval [0, 1)
+    std::pair<__m512d, __m512d> next_doubles() {
+        const __m512i const1 = _mm512_set1_epi64(0x3ff0000000000000ull);
+
+        __m512i value = step();
+        __m512i lo = _mm512_cvtepu32_epi64(_mm512_castsi512_si256(value));
+        __m512i hi = _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(value, 1));
+        __m512i tlo = _mm512_or_si512(_mm512_slli_epi64(lo, 20), const1);
+        __m512i thi = _mm512_or_si512(_mm512_slli_epi64(hi, 20), const1);
+        return std::make_pair(
+            _mm512_sub_pd(_mm512_castsi512_pd(tlo), _mm512_castsi512_pd(const1)),
+            _mm512_sub_pd(_mm512_castsi512_pd(thi), _mm512_castsi512_pd(const1)));
+    }
+
+    void next_doubles(std::array<double, 16>& result) {
+        auto [lo, hi] = next_doubles();
+        _mm512_storeu_pd(&result[0], lo);
+        _mm512_storeu_pd(&result[8], hi);
+    }
+
+    // Jump-ahead
+    YAVL_DEFINE_PCG32X_JUMP_FUNCS(16)
+
+    // Bulk fills, two copies of the two state registers
+    YAVL_DEFINE_PCG32X_FILL_FUNCS(16, 2)
+
+    // Bounded draws and shuffles
+    YAVL_DEFINE_PCG32X_BOUNDED_FUNCS(16)
+
+private:
+    using raw_t = __m512i;
+
+    void get_state(std::array<uint64_t, 16>& states, std::array<uint64_t, 16>& incs) const {
+        static_for<2>([&](const auto i) {
+            _mm512_storeu_si512(&states[i << 3], state[i]);
+            _mm512_storeu_si512(&incs[i << 3], inc[i]);
+        });
+    }
+
+    void apply_advance(uint64_t mult, uint64_t plus) {
+        const __m512i vmult = _mm512_set1_epi64((long long) mult);
+        const __m512i vplus = _mm512_set1_epi64((long long) plus);
+        static_for<2>([&](const auto i) {
+            state[i] = _mm512_add_epi64(pcg_impl::mul64(state[i], vmult),
+                pcg_impl::mul64(inc[i], vplus));
+        });
+    }
+
+    void scale_inc(uint64_t plus) {
+        const __m512i vplus = _mm512_set1_epi64((long long) plus);
+        inc[0] = pcg_impl::mul64(inc[0], vplus);
+        inc[1] = pcg_impl::mul64(inc[1], vplus);
+    }
+
+    void assign_state(const pcg32x& other) {
+        state[0] = other.state[0];
+        state[1] = other.state[1];
+    }
+
+    void select_state(const pcg32x& other, const __m512i mask) {
+        __mmask16 k = _mm512_test_epi32_mask(mask, mask);
+        state[0] = _mm512_mask_mov_epi64(state[0], (__mmask8) k, other.state[0]);
+        state[1] = _mm512_mask_mov_epi64(state[1], (__mmask8) (k >> 8), other.state[1]);
+    }
+
+    // The multiplier is only changed by the leapfrogged fills
+    inline __m512i step(uint64_t mult = PCG32_MULT) {
+        const __m512i vmult = _mm512_set1_epi64((long long) mult);
+
+        __m256i xors[2], rot[2];
+        static_for<2>([&](const auto i) {
+            __m512i s = state[i];
+            __m512i sx = _mm512_xor_si512(_mm512_srli_epi64(s, 18), s);
+            xors[i] = _mm512_cvtepi64_epi32(_mm512_srli_epi64(sx, 27));
+            rot[i] = _mm512_cvtepi64_epi32(_mm512_srli_epi64(s, 59));
+            state[i] = _mm512_add_epi64(pcg_impl::mul64(s, vmult), inc[i]);
+        });
+
+        return _mm512_rorv_epi32(
+            _mm512_inserti64x4(_mm512_castsi256_si512(xors[0]), xors[1], 1),
+            _mm512_inserti64x4(_mm512_castsi256_si512(rot[0]), rot[1], 1));
     }
 };
 
@@ -399,22 +1231,22 @@ struct alignas(32) pcg32x<8> {
 
         state[0] = state[1] = _mm256_setzero_si256();
         inc[0] = _mm256_or_si256(
-            _mm256_slli_epi64(_mm256_load_si256((__m256i *) &initseq[0]), 1),
+            _mm256_slli_epi64(_mm256_loadu_si256((const __m256i *) &initseq[0]), 1),
             one);
         inc[1] = _mm256_or_si256(
-            _mm256_slli_epi64(_mm256_load_si256((__m256i *) &initseq[4]), 1),
+            _mm256_slli_epi64(_mm256_loadu_si256((const __m256i *) &initseq[4]), 1),
             one);
         step();
 
-        state[0] = _mm256_add_epi64(state[0], _mm256_load_si256((__m256i *) &initstate[0]));
-        state[1] = _mm256_add_epi64(state[1], _mm256_load_si256((__m256i *) &initstate[4]));
+        state[0] = _mm256_add_epi64(state[0], _mm256_loadu_si256((const __m256i *) &initstate[0]));
+        state[1] = _mm256_add_epi64(state[1], _mm256_loadu_si256((const __m256i *) &initstate[4]));
 
         step();
     }
 
     // Generate 8 uniformly distributed unsigned 32-bit random numbers
     void next_uints(std::array<uint32_t, 8>& result) {
-        _mm256_store_si256((__m256i *) result.data(), step());
+        _mm256_storeu_si256((__m256i *) result.data(), step());
     }
 
     // Generate 8 uniformly distributed unsigned 32-bit random numbers
@@ -438,7 +1270,7 @@ struct alignas(32) pcg32x<8> {
 
     // Generate eight single precision floating point value on the interval [0, 1)
     void next_floats(std::array<float, 8>& result) {
-        _mm256_store_ps(result.data(), next_floats());
+        _mm256_storeu_ps(result.data(), next_floats());
     }
 
     /**
@@ -482,14 +1314,69 @@ struct alignas(32) pcg32x<8> {
     void next_doubles(std::array<double, 8>& result) {
         std::pair<__m256d, __m256d> value = next_doubles();
 
-        _mm256_store_pd(&result[0], value.first);
-        _mm256_store_pd(&result[4], value.second);
+        _mm256_storeu_pd(&result[0], value.first);
+        _mm256_storeu_pd(&result[4], value.second);
     }
 
+    // Jump-ahead
+    YAVL_DEFINE_PCG32X_JUMP_FUNCS(8)
+
+    // Bulk fills, two copies of the two state registers, four were slower
+    YAVL_DEFINE_PCG32X_FILL_FUNCS(8, 2)
+
+    // Bounded draws and shuffles
+    YAVL_DEFINE_PCG32X_BOUNDED_FUNCS(8)
+
 private:
-    inline __m256i step() {
-        const __m256i pcg32_mult_l = _mm256_set1_epi64x((long long) (PCG32_MULT & 0xffffffffu));
-        const __m256i pcg32_mult_h = _mm256_set1_epi64x((long long) (PCG32_MULT >> 32));
+    using raw_t = __m256i;
+
+    void get_state(std::array<uint64_t, 8>& states, std::array<uint64_t, 8>& incs) const {
+        static_for<2>([&](const auto i) {
+            _mm256_storeu_si256((__m256i *) &states[i << 2], state[i]);
+            _mm256_storeu_si256((__m256i *) &incs[i << 2], inc[i]);
+        });
+    }
+
+    // Low 64 bits of the lane-wise product
+    static inline __m256i mul64(const __m256i a, const __m256i b) {
+        __m256i m_hl = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+        __m256i m_lh = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+        __m256i m_ll = _mm256_mul_epu32(a, b);
+        return _mm256_add_epi64(
+            _mm256_slli_epi64(_mm256_add_epi64(m_hl, m_lh), 32), m_ll);
+    }
+
+    void apply_advance(uint64_t mult, uint64_t plus) {
+        const __m256i vmult = _mm256_set1_epi64x((long long) mult);
+        const __m256i vplus = _mm256_set1_epi64x((long long) plus);
+        static_for<2>([&](const auto i) {
+            state[i] = _mm256_add_epi64(mul64(state[i], vmult), mul64(inc[i], vplus));
+        });
+    }
+
+    void scale_inc(uint64_t plus) {
+        const __m256i vplus = _mm256_set1_epi64x((long long) plus);
+        inc[0] = mul64(inc[0], vplus);
+        inc[1] = mul64(inc[1], vplus);
+    }
+
+    void assign_state(const pcg32x& other) {
+        state[0] = other.state[0];
+        state[1] = other.state[1];
+    }
+
+    // Widen the 32 bit lane mask to the 64 bit state lanes
+    void select_state(const pcg32x& other, const __m256i mask) {
+        __m256i m0 = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(mask));
+        __m256i m1 = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(mask, 1));
+        state[0] = _mm256_blendv_epi8(state[0], other.state[0], m0);
+        state[1] = _mm256_blendv_epi8(state[1], other.state[1], m1);
+    }
+
+    // The multiplier is only changed by the leapfrogged fills
+    inline __m256i step(uint64_t mult = PCG32_MULT) {
+        const __m256i pcg32_mult_l = _mm256_set1_epi64x((long long) (mult & 0xffffffffu));
+        const __m256i pcg32_mult_h = _mm256_set1_epi64x((long long) (mult >> 32));
         const __m256i mask_l       = _mm256_set1_epi64x((long long) 0x00000000ffffffffull);
         const __m256i shift0       = _mm256_set_epi32(7, 7, 7, 7, 6, 4, 2, 0);
         const __m256i shift1       = _mm256_set_epi32(6, 4, 2, 0, 7, 7, 7, 7);
@@ -563,14 +1450,126 @@ private:
 
 #elif defined(YAVL_X86_SSE42)
 
+namespace pcg_impl
+{
+
+// Outputs of the sse4.2 generator, lanes 4-7 in first and 0-3 in second
 template <>
-strcut alignas(16) pcg32x<8> {
+struct block_ops<std::pair<__m128i, __m128i>> {
+    using Raw = std::pair<__m128i, __m128i>;
+
+    static void store_uints(uint32_t* dst, const Raw& r, bool stream) {
+        if (stream) {
+            _mm_stream_si128((__m128i*) dst, r.second);
+            _mm_stream_si128((__m128i*) dst + 1, r.first);
+        }
+        else {
+            _mm_storeu_si128((__m128i*) dst, r.second);
+            _mm_storeu_si128((__m128i*) dst + 1, r.first);
+        }
+    }
+
+    static void store_floats(float* dst, const Raw& r, bool stream) {
+        const __m128i const1 = _mm_set1_epi32((int) 0x3f800000u);
+        const __m128i v[2] = { r.second, r.first };
+        static_for<2>([&](const int i) {
+            __m128i fltval = _mm_or_si128(_mm_srli_epi32(v[i], 9), const1);
+            __m128 f = _mm_sub_ps(_mm_castsi128_ps(fltval), _mm_castsi128_ps(const1));
+            if (stream)
+                _mm_stream_ps(dst + i * 4, f);
+            else
+                _mm_storeu_ps(dst + i * 4, f);
+        });
+    }
+
+    static void store_doubles(double* dst, const Raw& r, bool stream) {
+        const __m128i const1 = _mm_set1_epi64x((long long) 0x3ff0000000000000ull);
+        const __m128i v[4] = {
+            r.second, _mm_shuffle_epi32(r.second, 0b01001110),
+            r.first, _mm_shuffle_epi32(r.first, 0b01001110)
+        };
+        static_for<4>([&](const int i) {
+            __m128i t = _mm_or_si128(_mm_slli_epi64(_mm_cvtepu32_epi64(v[i]), 20), const1);
+            __m128d d = _mm_sub_pd(_mm_castsi128_pd(t), _mm_castsi128_pd(const1));
+            if (stream)
+                _mm_stream_pd(dst + i * 2, d);
+            else
+                _mm_storeu_pd(dst + i * 2, d);
+        });
+    }
+
+    static Raw set1(uint32_t v) {
+        return std::make_pair(_mm_set1_epi32((int) v), _mm_set1_epi32((int) v));
+    }
+
+    static Raw load_uints(const uint32_t* src) {
+        return std::make_pair(_mm_loadu_si128((const __m128i*) src + 1),
+            _mm_loadu_si128((const __m128i*) src));
+    }
+
+    // Per half, see the avx2 version
+    static void mul_wide(__m128i a, __m128i b, __m128i& hi, __m128i& lo) {
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        hi = _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0b11001100);
+        lo = _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0b11001100);
+    }
+
+    static void mul_wide(const Raw& a, const Raw& b, Raw& hi, Raw& lo) {
+        mul_wide(a.first, b.first, hi.first, lo.first);
+        mul_wide(a.second, b.second, hi.second, lo.second);
+    }
+
+    static __m128i less(__m128i a, __m128i b) {
+        const __m128i sign = _mm_set1_epi32(INT32_MIN);
+        return _mm_cmpgt_epi32(_mm_xor_si128(b, sign), _mm_xor_si128(a, sign));
+    }
+
+    static Raw less(const Raw& a, const Raw& b) {
+        return std::make_pair(less(a.first, b.first), less(a.second, b.second));
+    }
+
+    static bool any(const Raw& mask) {
+        __m128i m = _mm_or_si128(mask.first, mask.second);
+        return !_mm_testz_si128(m, m);
+    }
+
+    static Raw select(const Raw& a, const Raw& b, const Raw& mask) {
+        return std::make_pair(_mm_blendv_epi8(a.first, b.first, mask.first),
+            _mm_blendv_epi8(a.second, b.second, mask.second));
+    }
+
+    static Raw mask_and(const Raw& a, const Raw& b) {
+        return std::make_pair(_mm_and_si128(a.first, b.first),
+            _mm_and_si128(a.second, b.second));
+    }
+
+    static Raw mask_or(const Raw& a, const Raw& b) {
+        return std::make_pair(_mm_or_si128(a.first, b.first),
+            _mm_or_si128(a.second, b.second));
+    }
+
+    static void fence() {
+        _mm_sfence();
+    }
+};
+
+} // namespace pcg_impl
+
+// 8 parallel PCG32 generators, two 64 bit states per xmm register
+template <>
+struct alignas(16) pcg32x<8> {
     __m128i state[4];
     __m128i inc[4];
 
     // Ctors
     pcg32x() {
-        std::array<uint64_t, 8> initstate{ PCG32_DEFAULT_STATE };
+        std::array<uint64_t, 8> initstate = {
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE
+        };
         std::array<uint64_t, 8> initseq{ 1, 2, 3, 4, 5, 6, 7, 8 };
 
         seed(initstate, initseq);
@@ -587,13 +1586,14 @@ strcut alignas(16) pcg32x<8> {
         static_for<4>([&](const auto i) {
             state[i] = _mm_setzero_si128();
             inc[i] = _mm_or_si128(
-                _mm_slli_epi64(_mm_load_si128((__m128i*) &initseq[i << 1]), 1),
+                _mm_slli_epi64(_mm_loadu_si128((const __m128i*) &initseq[i << 1]), 1),
                 one);
         });
         step();
 
         static_for<4>([&](const auto i) {
-            state[i] = _mm_add_epi64(state[i], _mm_load_si128((__m128i*) &initstate[i << 1]));
+            state[i] = _mm_add_epi64(state[i],
+                _mm_loadu_si128((const __m128i*) &initstate[i << 1]));
         });
         step();
     }
@@ -601,8 +1601,8 @@ strcut alignas(16) pcg32x<8> {
     // Generate 8 uniformly distributed unsigned 32-bit random numbers
     void next_uints(std::array<uint32_t, 8>& result) {
         auto [hi, lo] = step();
-        _mm_store_si128((__m128i*) &result[0]);
-        _mm_store_si128((__m128i*) &result[4]);
+        _mm_storeu_si128((__m128i*) &result[0], lo);
+        _mm_storeu_si128((__m128i*) &result[4], hi);
     }
 
     std::pair<__m128i, __m128i> next_uints() {
@@ -623,8 +1623,8 @@ strcut alignas(16) pcg32x<8> {
 
     void next_floats(std::array<float, 8>& result) {
         auto [hi, lo] = next_floats();
-        _mm_store_ps(&result[0], lo);
-        _mm_store_ps(&result[4], hi);
+        _mm_storeu_ps(&result[0], lo);
+        _mm_storeu_ps(&result[4], hi);
     }
 
     // Generate 8 double precision floating point value on the interval [0, 1)
@@ -636,146 +1636,431 @@ strcut alignas(16) pcg32x<8> {
 
         __m128i lo0 = _mm_cvtepu32_epi64(vlo);
         __m128i lo1 = _mm_cvtepu32_epi64(_mm_shuffle_epi32(vlo, 0b01001110));
-        __m128i hi0 = _mm_cvtepi32_epi64(vhi);
+        __m128i hi0 = _mm_cvtepu32_epi64(vhi);
         __m128i hi1 = _mm_cvtepu32_epi64(_mm_shuffle_epi32(vhi, 0b01001110));
         __m128i tlo0 = _mm_or_si128(_mm_slli_epi64(lo0, 20), const1);
-        __m128i tlo0 = _mm_or_si128(_mm_slli_epi64(lo1, 20), const1);
+        __m128i tlo1 = _mm_or_si128(_mm_slli_epi64(lo1, 20), const1);
         __m128i thi0 = _mm_or_si128(_mm_slli_epi64(hi0, 20), const1);
         __m128i thi1 = _mm_or_si128(_mm_slli_epi64(hi1, 20), const1);
-        __m128d flo0 = _mm_sub_pd(_mm_castsi128_pd(tlo0));
-        __m128d flo1 = _mm_sub_pd(_mm_castsi128_pd(tlo1));
-        __m128d fhi0 = _mm_sub_pd(_mm_castsi128_pd(thi0));
-        __m128d fhi1 = _mm_sub_pd(_mm_castsi128_pd(thi1));
+        __m128d flo0 = _mm_sub_pd(_mm_castsi128_pd(tlo0), _mm_castsi128_pd(const1));
+        __m128d flo1 = _mm_sub_pd(_mm_castsi128_pd(tlo1), _mm_castsi128_pd(const1));
+        __m128d fhi0 = _mm_sub_pd(_mm_castsi128_pd(thi0), _mm_castsi128_pd(const1));
+        __m128d fhi1 = _mm_sub_pd(_mm_castsi128_pd(thi1), _mm_castsi128_pd(const1));
         return { fhi1, fhi0, flo1, flo0 };
     }
 
     void next_doubles(std::array<double, 8>& result) {
         auto [r3, r2, r1, r0] = next_doubles();
-        _mm_store_pd(&result[0], r0);
-        _mm_store_pd(&result[2], r1);
-        _mm_store_pd(&result[4], r2);
-        _mm_store_pd(&result[6], r3);
+        _mm_storeu_pd(&result[0], r0);
+        _mm_storeu_pd(&result[2], r1);
+        _mm_storeu_pd(&result[4], r2);
+        _mm_storeu_pd(&result[6], r3);
     }
 
+    // Jump-ahead
+    YAVL_DEFINE_PCG32X_JUMP_FUNCS(8)
+
+    // Bulk fills, the four state registers are independent chains and
+    // leapfrogging them further measured no faster
+    YAVL_DEFINE_PCG32X_FILL_FUNCS(8, 1)
+
+    // Bounded draws and shuffles
+    YAVL_DEFINE_PCG32X_BOUNDED_FUNCS(8)
+
 private:
-    inline std::pair<__m128i, __m128i> step() {
-        const __m128i pcg32_mult_l  = _mm_set1_epi64x((long long) (PCG32_MULT & 0xffffffffu));
-        const __m128i pcg32_mult_h  = _mm_set1_epi64x((long long) (PCG32_MULT >> 32));
+    using raw_t = std::pair<__m128i, __m128i>;
+
+    void get_state(std::array<uint64_t, 8>& states, std::array<uint64_t, 8>& incs) const {
+        static_for<4>([&](const auto i) {
+            _mm_storeu_si128((__m128i*) &states[i << 1], state[i]);
+            _mm_storeu_si128((__m128i*) &incs[i << 1], inc[i]);
+        });
+    }
+
+    // Low 64 bits of the lane-wise product
+    static inline __m128i mul64(const __m128i a, const __m128i b) {
+        __m128i m_hl = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+        __m128i m_lh = _mm_mul_epu32(a, _mm_srli_epi64(b, 32));
+        __m128i m_ll = _mm_mul_epu32(a, b);
+        return _mm_add_epi64(_mm_slli_epi64(_mm_add_epi64(m_hl, m_lh), 32), m_ll);
+    }
+
+    void apply_advance(uint64_t mult, uint64_t plus) {
+        const __m128i vmult = _mm_set1_epi64x((long long) mult);
+        const __m128i vplus = _mm_set1_epi64x((long long) plus);
+        static_for<4>([&](const auto i) {
+            state[i] = _mm_add_epi64(mul64(state[i], vmult), mul64(inc[i], vplus));
+        });
+    }
+
+    void scale_inc(uint64_t plus) {
+        const __m128i vplus = _mm_set1_epi64x((long long) plus);
+        static_for<4>([&](const auto i) {
+            inc[i] = mul64(inc[i], vplus);
+        });
+    }
+
+    void assign_state(const pcg32x& other) {
+        static_for<4>([&](const auto i) {
+            state[i] = other.state[i];
+        });
+    }
+
+    // Widen the 32 bit lane mask to the 64 bit state lanes
+    void select_state(const pcg32x& other, const raw_t& mask) {
+        const __m128i m[4] = {
+            _mm_cvtepi32_epi64(mask.second),
+            _mm_cvtepi32_epi64(_mm_srli_si128(mask.second, 8)),
+            _mm_cvtepi32_epi64(mask.first),
+            _mm_cvtepi32_epi64(_mm_srli_si128(mask.first, 8))
+        };
+        static_for<4>([&](const auto i) {
+            state[i] = _mm_blendv_epi8(state[i], other.state[i], m[i]);
+        });
+    }
+
+    // The multiplier is only changed by the leapfrogged fills
+    inline std::pair<__m128i, __m128i> step(uint64_t mult = PCG32_MULT) {
+        const __m128i pcg32_mult_l  = _mm_set1_epi64x((long long) (mult & 0xffffffffu));
+        const __m128i pcg32_mult_h  = _mm_set1_epi64x((long long) (mult >> 32));
         const __m128i mask_l        = _mm_set1_epi64x((long long) 0x00000000ffffffffull);
-        const __m128i const32       = _mm_set1_epi32(32);
-
-        __m128i s0 = state[0], s1 = state[1], s2 = state[2], s3 = state[3];
-
-        // Extract low and high words for partial products
-        __m128i s0_l = _mm_and_si128(s0, mask_l);
-        __m128i s0_h = _mm_srli_epi64(s0, 32);
-        __m128i s1_l = _mm_and_si128(s1, mask_l);
-        __m128i s1_h = _mm_srli_epi64(s1, 32);
-        __m128i s2_l = _mm_and_si128(s2, mask_l);
-        __m128i s2_h = _mm_srli_epi64(s2, 32);
-        __m128i s3_l = _mm_and_si128(s3, mask_l);
-        __m128i s3_h = _mm_srli_epi64(s3, 32);
-
-        // Improve high bits using xorshift step
-        __m128i s0s = _mm_srli_epi64(s0, 18);
-        __m128i s1s = _mm_srli_epi64(s1, 18);
-        __m128i s2s = _mm_srli_epi64(s2, 18);
-        __m128i s3s = _mm_srli_epi64(s3, 18);
-
-        __m128i s0x = _mm_xor_si128(s0s, s0);
-        __m128i s1x = _mm_xor_si128(s1s, s1);
-        __m128i s2x = _mm_xor_si128(s2s, s2);
-        __m128i s3x = _mm_xor_si128(s3s, s3);
-
-        __m128i s0xs = _mm_srli_epi64(s0x, 27);
-        __m128i s1xs = _mm_srli_epi64(s1x, 27);
-        __m128i s2xs = _mm_srli_epi64(s2x, 27);
-        __m128i s3xs = _mm_srli_epi64(s3x, 27);
-
-        __m128i xors0 = _mm_and_si128(mask_l, s0xs);
-        __m128i xors1 = _mm_and_si128(mask_l, s1xs);
-        __m128i xors2 = _mm_and_si128(mask_l, s2xs);
-        __m128i xors3 = _mm_and_si128(mask_l, s3xs);
-
-        // Use high bits to choose a bit-level rotation
-        __m128i rot0 = _mm_srli_epi64(s0, 59);
-        __m128i rot1 = _mm_srli_epi64(s1, 59);
-        __m128i rot2 = _mm_srli_epi64(s2, 59);
-        __m128i rot3 = _mm_srli_epi64(s3, 59);
-
-        // 64 bit multiplication using 32 bit partial products
-        __m128i m0_hl = _mm_mul_epi32(s0_h, pcg32_mult_l);
-        __m128i m1_hl = _mm_mul_epi32(s1_h, pcg32_mult_l);
-        __m128i m2_hl = _mm_mul_epi32(s2_h, pcg32_mult_l);
-        __m128i m3_hl = _mm_mul_epi32(s3_h, pcg32_mult_l);
-        __m128i m0_hl = _mm_mul_epi32(s0_l, pcg32_mult_h);
-        __m128i m1_hl = _mm_mul_epi32(s1_l, pcg32_mult_h);
-        __m128i m2_hl = _mm_mul_epi32(s2_l, pcg32_mult_h);
-        __m128i m3_hl = _mm_mul_epi32(s3_l, pcg32_mult_h);
-
-        // Assemble lower 32 bits, will be merged into one 256 bit vector
-        __m128i x6240l = _mm_unpacklo_epi32(xors0, xors1);
-        xors0 = _mm_shuffle_epi32(x6240l, 0b11011000);
-        xors1 = _mm_shuffle_epi32(xors1, 0b11111111);
-        __m128i r6240l = _mm_unpacklo_epi32(rot0, rot1);
-        rot0 = _mm_shuffle_epi32(r6240l, 0b11011000);
-        rot1 = _mm_shuffle_epi32(rot1, 0b11111111);
-        __m128i x6240h = _mm_unpack_epi32(xors2, xors3);
-        xors2 = _mm_shuffle_epi32(xors3, 0b11111111);
-        xors3 = _mm_shuffle_epi32(x6240h, 0b11011000);
-        __m128i r6240h = _mm_unpacklo_epi32(rot2, rot3);
-        rot2 = _mm_shuffle_epi32(rot3, 0b11111111);
-        rot3 = _mm_shuffle_epi32(r6240h, 0b11011000);
-
-        // Continue with partial products
-        __m128i m0_ll = _mm_mul_epu32(s0_l, pcg32_mult_l);
-        __m128i m1_ll = _mm_mul_epu32(s1_l, pcg32_mult_l);
-        __m128i m2_ll = _mm_mul_epu32(s2_l, pcg32_mult_l);
-        __m128i m3_ll = _mm_mul_epu32(s3_l, pcg32_mult_l);
-
-        __m128i m0h = _mm_add_epi64(m0_hl, m0_lh);
-        __m128i m1h = _mm_add_epi64(m1_hl, m1_lh);
-        __m128i m2h = _mm_add_epi64(m2_hl, m2_lh);
-        __m128i m3h = _mm_add_epi64(m3_hl, m3_lh);
-
-        __m128i m0hs = _mm_slli_epi64(m0h, 32);
-        __m128i m1hs = _mm_slli_epi64(m1h, 32);
-        __m128i m2hs = _mm_slli_epi64(m2h, 32);
-        __m128i m3hs = _mm_slli_epi64(m3h, 32);
-
-        __m128i s0n = _mm256_add_epi64(m0hs, m0_ll);
-        __m128i s1n = _mm256_add_epi64(m1hs, m1_ll);
-        __m128i s2n = _mm256_add_epi64(m2hs, m2_ll);
-        __m128i s3n = _mm256_add_epi64(m3hs, m3_ll);
-
-        __m128i xorsl = _mm_or_si128(xors0, xors2);
-        __m128i xorsh = _mm_or_si128(xors1, xors3);
-        __m128i rotl = _mm_or_si128(rot0, rot2);
-        __m128i roth = _mm_or_si128(rot1, rot3);
-
-        state[0] = _mm_add_epi64(s0n, inc[0]);
-        state[1] = _mm_add_epi64(s1n, inc[1]);
-        state[2] = _mm_add_epi64(s2n, inc[2]);
-        state[3] = _mm_add_epi64(s3n, inc[3]);
-
-        // Rotate and return
-        __m128i retl = _mm_or_si128(
-            _mm_srlv_epi32(xorsl, rotl),
-            _mm_sllv_epi32(xorsl, _mm_sub_epi32(const32, rotl))
-        );
-        __m128i reth = _mm_or_si128(
-            _mm_srlv_epi32(xorsh, roth),
-            _mm_sllv_epi32(xorsh, _mm_sub_epi32(const32, roth))
-        );
+        const __m128i const31       = _mm_set1_epi64x(31);
+        const __m128i const32       = _mm_set1_epi64x(32);
+        const __m128i exp_bias      = _mm_set1_epi32(127);
+
+        __m128i rets[4];
+        static_for<4>([&](const auto i) {
+            __m128i s = state[i];
+
+            // Extract low and high words for partial products
+            __m128i s_l = _mm_and_si128(s, mask_l);
+            __m128i s_h = _mm_srli_epi64(s, 32);
+
+            // Improve high bits using xorshift step
+            __m128i sx = _mm_xor_si128(_mm_srli_epi64(s, 18), s);
+            __m128i xors = _mm_and_si128(mask_l, _mm_srli_epi64(sx, 27));
+
+            // Use high bits to choose a bit-level rotation
+            __m128i rot = _mm_srli_epi64(s, 59);
+
+            // 64 bit multiplication using 32 bit partial products
+            __m128i m_hl = _mm_mul_epu32(s_h, pcg32_mult_l);
+            __m128i m_lh = _mm_mul_epu32(s_l, pcg32_mult_h);
+            __m128i m_ll = _mm_mul_epu32(s_l, pcg32_mult_l);
+            __m128i mhs = _mm_slli_epi64(_mm_add_epi64(m_hl, m_lh), 32);
+            state[i] = _mm_add_epi64(_mm_add_epi64(mhs, m_ll), inc[i]);
+
+            // No variable shifts before avx2. Rotating right by rot is rotating
+            // left by (32 - rot) & 31, and multiplying by that power of two in
+            // a 64 bit lane leaves the bits rotated out in the high dword.
+            // The power of two is built from the float exponent field.
+            __m128i n = _mm_and_si128(_mm_sub_epi64(const32, rot), const31);
+            __m128i pow2 = _mm_cvttps_epi32(_mm_castsi128_ps(
+                _mm_slli_epi32(_mm_add_epi32(n, exp_bias), 23)));
+            __m128i prod = _mm_mul_epu32(xors, pow2);
+            rets[i] = _mm_or_si128(prod, _mm_srli_epi64(prod, 32));
+        });
+
+        // Gather the low dword of every 64 bit lane
+        __m128i retl = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(rets[0]),
+            _mm_castsi128_ps(rets[1]), _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i reth = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(rets[2]),
+            _mm_castsi128_ps(rets[3]), _MM_SHUFFLE(2, 0, 2, 0)));
 
         return std::make_pair(reth, retl);
     }
 };
 
+#elif defined(YAVL_ARM_NEON)
+
+namespace pcg_impl
+{
+
+// Outputs of the neon generator, lanes 0-3 in val[0] and 4-7 in val[1].
+// There are no non-temporal store intrinsics, streaming fills use plain
+// stores
+template <>
+struct block_ops<uint32x4x2_t> {
+    using Raw = uint32x4x2_t;
+
+    static void store_uints(uint32_t* dst, const Raw& r, bool) {
+        vst1q_u32(dst, r.val[0]);
+        vst1q_u32(dst + 4, r.val[1]);
+    }
+
+    static void store_floats(float* dst, const Raw& r, bool) {
+        const uint32x4_t const1 = vdupq_n_u32(0x3f800000u);
+        static_for<2>([&](const int i) {
+            uint32x4_t fltval = vorrq_u32(vshrq_n_u32(r.val[i], 9), const1);
+            vst1q_f32(dst + i * 4, vsubq_f32(vreinterpretq_f32_u32(fltval),
+                vreinterpretq_f32_u32(const1)));
+        });
+    }
+
+    static void store_doubles(double* dst, const Raw& r, bool) {
+        const uint64x2_t const1 = vdupq_n_u64(0x3ff0000000000000ull);
+        const uint64x2_t v[4] = {
+            vmovl_u32(vget_low_u32(r.val[0])), vmovl_high_u32(r.val[0]),
+            vmovl_u32(vget_low_u32(r.val[1])), vmovl_high_u32(r.val[1])
+        };
+        static_for<4>([&](const int i) {
+            uint64x2_t t = vorrq_u64(vshlq_n_u64(v[i], 20), const1);
+            vst1q_f64(dst + i * 2, vsubq_f64(vreinterpretq_f64_u64(t),
+                vreinterpretq_f64_u64(const1)));
+        });
+    }
+
+    static Raw set1(uint32_t v) {
+        return { vdupq_n_u32(v), vdupq_n_u32(v) };
+    }
+
+    static Raw load_uints(const uint32_t* src) {
+        return { vld1q_u32(src), vld1q_u32(src + 4) };
+    }
+
+    // The 64 bit products of lanes 0-1 and 2-3, unzipped into the even
+    // (low) and odd(high) halves
+    static void mul_wide(uint32x4_t a, uint32x4_t b, uint32x4_t& hi, uint32x4_t& lo) {
+        uint32x4_t p0 = vreinterpretq_u32_u64(vmull_u32(vget_low_u32(a), vget_low_u32(b)));
+        uint32x4_t p1 = vreinterpretq_u32_u64(vmull_high_u32(a, b));
+        hi = vuzp2q_u32(p0, p1);
+        lo = vuzp1q_u32(p0, p1);
+    }
+
+    static void mul_wide(const Raw& a, const Raw& b, Raw& hi, Raw& lo) {
+        mul_wide(a.val[0], b.val[0], hi.val[0], lo.val[0]);
+        mul_wide(a.val[1], b.val[1], hi.val[1], lo.val[1]);
+    }
+
+    static Raw less(const Raw& a, const Raw& b) {
+        return { vcltq_u32(a.val[0], b.val[0]), vcltq_u32(a.val[1], b.val[1]) };
+    }
+
+    static bool any(const Raw& mask) {
+        return vmaxvq_u32(vorrq_u32(mask.val[0], mask.val[1])) != 0;
+    }
+
+    static Raw select(const Raw& a, const Raw& b, const Raw& mask) {
+        return { vbslq_u32(mask.val[0], b.val[0], a.val[0]),
+            vbslq_u32(mask.val[1], b.val[1], a.val[1]) };
+    }
+
+    static Raw mask_and(const Raw& a, const Raw& b) {
+        return { vandq_u32(a.val[0], b.val[0]), vandq_u32(a.val[1], b.val[1]) };
+    }
+
+    static Raw mask_or(const Raw& a, const Raw& b) {
+        return { vorrq_u32(a.val[0], b.val[0]), vorrq_u32(a.val[1], b.val[1]) };
+    }
+
+    static void fence() {}
+};
+
+} // namespace pcg_impl
+
+// 8 parallel PCG32 generators, two 64 bit states per q register
+template <>
+struct alignas(16) pcg32x<8> {
+    uint64x2_t state[4];
+    uint64x2_t inc[4];
+
+    // Ctors
+    pcg32x() {
+        std::array<uint64_t, 8> initstate = {
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+            PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE
+        };
+        std::array<uint64_t, 8> initseq{ 1, 2, 3, 4, 5, 6, 7, 8 };
+
+        seed(initstate, initseq);
+    }
+
+    pcg32x(const std::array<uint64_t, 8>& initstate, const std::array<uint64_t, 8>& initseq) {
+        seed(initstate, initseq);
+    }
+
+    // Seed the pseudorandom number generator
+    void seed(const std::array<uint64_t, 8>& initstate, const std::array<uint64_t, 8>& initseq) {
+        const uint64x2_t one = vdupq_n_u64(1);
+
+        static_for<4>([&](const auto i) {
+            state[i] = vdupq_n_u64(0);
+            inc[i] = vorrq_u64(vshlq_n_u64(vld1q_u64(&initseq[i << 1]), 1), one);
+        });
+        step();
+
+        static_for<4>([&](const auto i) {
+            state[i] = vaddq_u64(state[i], vld1q_u64(&initstate[i << 1]));
+        });
+        step();
+    }
+
+    // Generate 8 uniformly distributed unsigned 32-bit random numbers
+    void next_uints(std::array<uint32_t, 8>& result) {
+        pcg_impl::block_ops<raw_t>::store_uints(result.data(), step(), false);
+    }
+
+    uint32x4x2_t next_uints() {
+        return step();
+    }
+
+    // Generate 8 single precision floating point value on the interval [0, 1)
+    float32x4x2_t next_floats() {
+        const uint32x4_t const1 = vdupq_n_u32(0x3f800000u);
+
+        auto r = step();
+        float32x4x2_t ret;
+        static_for<2>([&](const int i) {
+            uint32x4_t fltval = vorrq_u32(vshrq_n_u32(r.val[i], 9), const1);
+            ret.val[i] = vsubq_f32(vreinterpretq_f32_u32(fltval),
+                vreinterpretq_f32_u32(const1));
+        });
+        return ret;
+    }
+
+    void next_floats(std::array<float, 8>& result) {
+        pcg_impl::block_ops<raw_t>::store_floats(result.data(), step(), false);
+    }
+
+    // Generate 8 double precision floating point value on the interval [0, 1),
+    // lanes 0-1 in the first register
+    std::array<float64x2_t, 4> next_doubles() {
+        alignas(16) std::array<double, 8> tmp;
+        next_doubles(tmp);
+        return { vld1q_f64(&tmp[0]), vld1q_f64(&tmp[2]), vld1q_f64(&tmp[4]),
+            vld1q_f64(&tmp[6]) };
+    }
+
+    void next_doubles(std::array<double, 8>& result) {
+        pcg_impl::block_ops<raw_t>::store_doubles(result.data(), step(), false);
+    }
+
+    // Jump-ahead
+    YAVL_DEFINE_PCG32X_JUMP_FUNCS(8)
+
+    // Bulk fills, the four state registers are independent chains already
+    YAVL_DEFINE_PCG32X_FILL_FUNCS(8, 1)
+
+    // Bounded draws and shuffles
+    YAVL_DEFINE_PCG32X_BOUNDED_FUNCS(8)
+
+private:
+    using raw_t = uint32x4x2_t;
+
+    void get_state(std::array<uint64_t, 8>& states, std::array<uint64_t, 8>& incs) const {
+        static_for<4>([&](const auto i) {
+            vst1q_u64(&states[i << 1], state[i]);
+            vst1q_u64(&incs[i << 1], inc[i]);
+        });
+    }
+
+    // Low 64 bits of the lane-wise product, the high halves only meet in
+    // the cross terms whose low 32 bits are needed
+    static inline uint64x2_t mul64(const uint64x2_t a, const uint64x2_t b) {
+        uint32x2_t a_l = vmovn_u64(a), a_h = vshrn_n_u64(a, 32);
+        uint32x2_t b_l = vmovn_u64(b), b_h = vshrn_n_u64(b, 32);
+        uint32x2_t cross = vmla_u32(vmul_u32(a_h, b_l), a_l, b_h);
+        return vaddq_u64(vmull_u32(a_l, b_l), vshll_n_u32(cross, 32));
+    }
+
+    void apply_advance(uint64_t mult, uint64_t plus) {
+        const uint64x2_t vmult = vdupq_n_u64(mult);
+        const uint64x2_t vplus = vdupq_n_u64(plus);
+        static_for<4>([&](const auto i) {
+            state[i] = vaddq_u64(mul64(state[i], vmult), mul64(inc[i], vplus));
+        });
+    }
+
+    void scale_inc(uint64_t plus) {
+        const uint64x2_t vplus = vdupq_n_u64(plus);
+        static_for<4>([&](const auto i) {
+            inc[i] = mul64(inc[i], vplus);
+        });
+    }
+
+    void assign_state(const pcg32x& other) {
+        static_for<4>([&](const auto i) {
+            state[i] = other.state[i];
+        });
+    }
+
+    // Widen the 32 bit lane mask to the 64 bit state lanes
+    void select_state(const pcg32x& other, const raw_t& mask) {
+        const int32x4_t lo = vreinterpretq_s32_u32(mask.val[0]);
+        const int32x4_t hi = vreinterpretq_s32_u32(mask.val[1]);
+        const uint64x2_t m[4] = {
+            vreinterpretq_u64_s64(vmovl_s32(vget_low_s32(lo))),
+            vreinterpretq_u64_s64(vmovl_high_s32(lo)),
+            vreinterpretq_u64_s64(vmovl_s32(vget_low_s32(hi))),
+            vreinterpretq_u64_s64(vmovl_high_s32(hi))
+        };
+        static_for<4>([&](const auto i) {
+            state[i] = vbslq_u64(m[i], other.state[i], state[i]);
+        });
+    }
+
+    // The multiplier is only changed by the leapfrogged fills
+    inline uint32x4x2_t step(uint64_t mult = PCG32_MULT) {
+        const uint64x2_t vmult = vdupq_n_u64(mult);
+        const int32x2_t const32 = vdup_n_s32(32);
+
+        uint32x2_t rets[4];
+        static_for<4>([&](const auto i) {
+            uint64x2_t s = state[i];
+
+            // Improve high bits using xorshift step
+            uint32x2_t xors = vmovn_u64(vshrq_n_u64(veorq_u64(vshrq_n_u64(s, 18), s), 27));
+
+            // Use high bits to choose a bit-level rotation
+            int32x2_t rot = vreinterpret_s32_u32(vmovn_u64(vshrq_n_u64(s, 59)));
+
+            state[i] = vaddq_u64(mul64(s, vmult), inc[i]);
+
+            // Variable shifts shift right for negative counts and give 0
+            // for a count of 32
+            rets[i] = vorr_u32(vshl_u32(xors, vneg_s32(rot)),
+                vshl_u32(xors, vsub_s32(const32, rot)));
+        });
+
+        return { vcombine_u32(rets[0], rets[1]), vcombine_u32(rets[2], rets[3]) };
+    }
+};
+
 #endif
 
 #pragma GCC diagnostic pop
 
 #endif
 
+/**
+ * \brief Hands out pcg32x generators to a fixed number of workers
+ *
+ * Worker i gets block i of the base generator split thread_count ways, so
+ * the result only depends on the base seed and the worker index, not on
+ * scheduling. Streams never overlap as long as a worker draws less than
+ * draws_per_thread() numbers per lane, 2^57 with 128 workers.
+ */
+template <uint32_t N>
+struct pcg32x_factory {
+    pcg32x<N> base;
+    uint32_t thread_count;
+
+    explicit pcg32x_factory(uint32_t thread_count_, const pcg32x<N>& base_ = {})
+        : base(base_)
+        , thread_count(thread_count_)
+    {
+        assert(thread_count > 0);
+    }
+
+    pcg32x<N> make(uint32_t thread) const {
+        return base.split(thread, thread_count);
+    }
+
+    uint64_t draws_per_thread() const {
+        return pcg32x<N>::split_length(thread_count);
+    }
+};
+
 } // namespace yavl
\ No newline at end of file
@@ -0,0 +1,262 @@
+#pragma once
+
+// Batched samplers on top of pcg32x: normal and exponential deviates,
+// uniform directions on the sphere and hemisphere, uniform points on the
+// unit disk and cosine weighted directions.
+//
+// Uniforms are drawn a chunk at a time with the leapfrogged bulk fills of
+// pcg32x and mapped in the widest packets of vec_math.h, so every sampler
+// runs at the full register width of the build whatever the lane count of
+// the generator. Normals use Box-Muller, each pair of uniforms gives one
+// deviate from the cosine and one from the sine. The geometric samplers
+// invert the cdf in polar coordinates, so one sample always takes exactly
+// two uniforms and the output is reproducible without rejection loops.
+//
+// Outputs are either std::span<Vec3f>/std::span<Vec2f> or an array of one
+// span per component(SoA), the two give the same numbers for the same seed.
+// Directions are in a frame with z up.
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <numbers>
+#include <span>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_math.h>
+#include <yavl/rng/pcg.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace sampling_impl
+{
+
+// Samples per chunk, a multiple of every packet and generator width
+static constexpr uint32_t chunk_size = 256;
+static constexpr uint32_t max_width = 16;
+
+/**
+ * \brief Run a sampler over n samples
+ *
+ * For every chunk, U uniform streams of the chunk's length(rounded up to a
+ * whole packet) are drawn and f.template operator()<P>(u, res, i) maps
+ * lanes [i, i + width of P) of them to the R result streams. write(offset,
+ * count, res) then copies count samples out.
+ */
+template <uint32_t U, uint32_t R, uint32_t N, typename F, typename W>
+inline void run(pcg32x<N>& rng, const std::size_t n, const F& f, const W& write) {
+    alignas(64) float u[U][chunk_size];
+    alignas(64) float res[R][chunk_size];
+
+    for (std::size_t offset = 0; offset < n; offset += chunk_size) {
+        const uint32_t count = (uint32_t) std::min<std::size_t>(chunk_size, n - offset);
+        const uint32_t lanes = (count + max_width - 1) / max_width * max_width;
+
+        for (uint32_t k = 0; k < U; ++k)
+            rng.fill_uniform_float({ u[k], lanes }, store_policy::cached);
+
+        math_impl::for_each_packet<float>(lanes, [&]<typename P>(const uint32_t i) {
+            f.template operator()<P>(u, res, i);
+        });
+        write(offset, count, res);
+    }
+}
+
+// -log(1 - u), 1 - u is in (0, 1] so the log is finite
+template <typename P>
+static inline P neg_log1m(const P u) {
+    using O = math_impl::packet_ops<P>;
+    return O::sub(O::set1(0.f), math_impl::log_impl(O::sub(O::set1(1.f), u)));
+}
+
+// Point on the unit circle at angle 2 pi u
+template <typename P>
+static inline void unit_circle(const P u, P& c, P& s) {
+    using O = math_impl::packet_ops<P>;
+    math_impl::sincos_impl(O::mul(u, O::set1(2.f * std::numbers::pi_v<float>)), s, c);
+}
+
+// sqrt(max(x, 0)), rounding can push 1 - z * z slightly negative
+template <typename P>
+static inline P safe_sqrt(const P x) {
+    using O = math_impl::packet_ops<P>;
+    return O::sqrt(O::max(x, O::set1(0.f)));
+}
+
+// Point on the unit disk, r = sqrt(u0) keeps the density uniform in area
+struct disk {
+    template <typename P>
+    void operator()(const P u0, const P u1, std::array<P, 2>& out) const {
+        using O = math_impl::packet_ops<P>;
+        P c, s;
+        unit_circle(u1, c, s);
+        P r = O::sqrt(u0);
+        out[0] = O::mul(r, c);
+        out[1] = O::mul(r, s);
+    }
+};
+
+// z uniform in [-1, 1] is uniform on the sphere(Archimedes)
+struct sphere {
+    template <typename P>
+    void operator()(const P u0, const P u1, std::array<P, 3>& out) const {
+        using O = math_impl::packet_ops<P>;
+        out[2] = O::fnmadd(O::set1(2.f), u0, O::set1(1.f));
+        P r = safe_sqrt(O::fnmadd(out[2], out[2], O::set1(1.f)));
+        P c, s;
+        unit_circle(u1, c, s);
+        out[0] = O::mul(r, c);
+        out[1] = O::mul(r, s);
+    }
+};
+
+struct hemisphere {
+    template <typename P>
+    void operator()(const P u0, const P u1, std::array<P, 3>& out) const {
+        using O = math_impl::packet_ops<P>;
+        out[2] = O::sub(O::set1(1.f), u0);
+        P r = safe_sqrt(O::fnmadd(out[2], out[2], O::set1(1.f)));
+        P c, s;
+        unit_circle(u1, c, s);
+        out[0] = O::mul(r, c);
+        out[1] = O::mul(r, s);
+    }
+};
+
+// Malley's method, a uniform disk point lifted to the hemisphere. The disk
+// radius is sqrt(u0) so z = sqrt(1 - u0).
+struct cosine_hemisphere {
+    template <typename P>
+    void operator()(const P u0, const P u1, std::array<P, 3>& out) const {
+        using O = math_impl::packet_ops<P>;
+        std::array<P, 2> xy;
+        disk{}(u0, u1, xy);
+        out[0] = xy[0];
+        out[1] = xy[1];
+        out[2] = O::sqrt(O::sub(O::set1(1.f), u0));
+    }
+};
+
+// Run a two uniform sampler with D output components, write gets the
+// offset, count and component streams of every chunk
+template <uint32_t D, uint32_t N, typename F, typename W>
+inline void sample(pcg32x<N>& rng, const std::size_t n, const F& f, const W& write) {
+    run<2, D>(rng, n, [&]<typename P>(auto& u, auto& res, const uint32_t i) {
+        using O = math_impl::packet_ops<P>;
+        std::array<P, D> out;
+        f(O::loadu(u[0] + i), O::loadu(u[1] + i), out);
+        for (uint32_t k = 0; k < D; ++k)
+            O::storeu(res[k] + i, out[k]);
+    }, write);
+}
+
+template <uint32_t D>
+inline auto write_soa(const std::array<float*, D>& dst) {
+    return [dst](const std::size_t offset, const uint32_t count, auto& res) {
+        for (uint32_t k = 0; k < D; ++k)
+            std::memcpy(dst[k] + offset, res[k], count * sizeof(float));
+    };
+}
+
+template <typename V>
+inline auto write_aos(const std::span<V> out) {
+    return [out](const std::size_t offset, const uint32_t count, auto& res) {
+        for (uint32_t j = 0; j < count; ++j) {
+            if constexpr (V::Size == 2)
+                out[offset + j] = V{ res[0][j], res[1][j] };
+            else
+                out[offset + j] = V{ res[0][j], res[1][j], res[2][j] };
+        }
+    };
+}
+
+} // namespace sampling_impl
+
+/**
+ * \brief Fill out with normal deviates
+ *
+ * Box-Muller on m pairs of uniforms gives 2m deviates, the first m from the
+ * cosines and the next m from the sines. Pairs are taken a chunk at a time
+ * so out[2k] and out[2k + 1] come from different pairs.
+ */
+template <uint32_t N>
+inline void fill_normal(pcg32x<N>& rng, std::span<float> out, const float mean = 0.f,
+    const float stddev = 1.f)
+{
+    using namespace sampling_impl;
+    run<2, 2>(rng, (out.size() + 1) / 2, [&]<typename P>(auto& u, auto& res, const uint32_t i) {
+        using O = math_impl::packet_ops<P>;
+        P r = O::mul(O::set1(stddev),
+            O::sqrt(O::mul(O::set1(2.f), neg_log1m(O::loadu(u[0] + i)))));
+        P c, s;
+        unit_circle(O::loadu(u[1] + i), c, s);
+        O::storeu(res[0] + i, O::fmadd(r, c, O::set1(mean)));
+        O::storeu(res[1] + i, O::fmadd(r, s, O::set1(mean)));
+    }, [&](const std::size_t offset, const uint32_t count, auto& res) {
+        // The last pair of an odd sized output only has its cosine used
+        const std::size_t first = 2 * offset;
+        const std::size_t sines = std::min<std::size_t>(count, out.size() - first - count);
+        std::memcpy(out.data() + first, res[0], count * sizeof(float));
+        std::memcpy(out.data() + first + count, res[1], sines * sizeof(float));
+    });
+}
+
+// Fill out with exponential deviates of rate lambda
+template <uint32_t N>
+inline void fill_exponential(pcg32x<N>& rng, std::span<float> out, const float lambda = 1.f) {
+    assert(lambda > 0.f);
+    using namespace sampling_impl;
+    run<1, 1>(rng, out.size(), [&]<typename P>(auto& u, auto& res, const uint32_t i) {
+        using O = math_impl::packet_ops<P>;
+        O::storeu(res[0] + i, O::mul(neg_log1m(O::loadu(u[0] + i)), O::set1(1.f / lambda)));
+    }, write_soa<1>({ out.data() }));
+}
+
+#define YAVL_DEFINE_SAMPLER(NAME, SAMPLER, V, D)                        \
+    template <uint32_t N>                                               \
+    inline void NAME(pcg32x<N>& rng, std::span<V> out) {                \
+        sampling_impl::sample<D>(rng, out.size(), sampling_impl::SAMPLER{}, \
+            sampling_impl::write_aos(out));                             \
+    }                                                                   \
+    template <uint32_t N>                                               \
+    inline void NAME(pcg32x<N>& rng, const std::array<std::span<float>, D>& out) { \
+        std::array<float*, D> dst;                                      \
+        for (uint32_t k = 0; k < D; ++k) {                              \
+            assert(out[k].size() == out[0].size());                     \
+            dst[k] = out[k].data();                                     \
+        }                                                               \
+        sampling_impl::sample<D>(rng, out[0].size(), sampling_impl::SAMPLER{}, \
+            sampling_impl::write_soa<D>(dst));                          \
+    }
+
+// Uniform directions on the unit sphere
+YAVL_DEFINE_SAMPLER(sample_sphere, sphere, Vec3f, 3)
+// Uniform directions on the hemisphere z >= 0
+YAVL_DEFINE_SAMPLER(sample_hemisphere, hemisphere, Vec3f, 3)
+// Directions on the hemisphere z >= 0 with density cos(theta) / pi
+YAVL_DEFINE_SAMPLER(sample_cosine_hemisphere, cosine_hemisphere, Vec3f, 3)
+// Uniform points on the unit disk
+YAVL_DEFINE_SAMPLER(sample_disk, disk, Vec2f, 2)
+
+#undef YAVL_DEFINE_SAMPLER
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
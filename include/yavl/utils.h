@@ -3,6 +3,8 @@
 #include <array>
 #include <cassert>
 #include <concepts>
+#include <cstddef>
+#include <new>
 #include <numeric>
 #include <stdint.h>
 #include <tuple>
@@ -12,6 +14,19 @@
 namespace yavl
 {
 
+// Accuracy of rcp, rsqrt, division, normalization and the matrix inverses,
+// passed as a template argument. Defaults keep the behaviour each function
+// had before it took one
+//  fast:     the hardware estimate as is, 12 bits with SSE/AVX, 14 with
+//            AVX512VL and one refinement of the 8 bit estimate on NEON
+//  standard: the estimate refined by Newton-Raphson, a couple of ulps
+//  exact:    IEEE division and square root
+enum class precision : uint32_t {
+    fast,
+    standard,
+    exact
+};
+
 // Macros
 #define YAVL_TYPE_ALIAS(TYPE, N, INTRIN_N)                              \
     using Scalar = std::decay_t<TYPE>;                                  \
@@ -107,6 +122,17 @@ inline void static_for(const Func& func) {
     static_for(func, std::make_integer_sequence<int, N>{});
 }
 
+// static_for up to Limit iterations and a plain loop past that, unrolling
+// large sizes only bloats the code
+template <int N, int Limit = 16, typename Func>
+inline void bounded_static_for(const Func& func) {
+    if constexpr (N <= Limit)
+        static_for<N>(func);
+    else
+        for (int i = 0; i < N; ++i)
+            func(i);
+}
+
 template <int N, typename... Ts>
 inline auto head(Ts... args) {
     return std::tuple();
@@ -245,16 +271,62 @@ using enable_if_int64_t = std::enable_if_t<is_int64_v<T>, int>;
 // Types
 struct empty_t {};
 
+// How bulk kernels write their output
+enum class store_policy {
+    cached,     // Regular stores
+    streaming,  // Non-temporal stores, bypassing the cache
+    automatic   // Streaming when the output exceeds streaming_store_threshold
+};
+
+// Allocator for containers holding data that will be loaded into simd
+// registers, default alignment is a cache line which also satisfies avx512
+template <typename T, std::size_t Align = 64>
+struct aligned_allocator {
+    using value_type = T;
+    static constexpr std::align_val_t alignment{Align};
+
+    template <typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    aligned_allocator() = default;
+
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, alignment);
+    }
+
+    template <typename U>
+    bool operator ==(const aligned_allocator<U, Align>&) const {
+        return true;
+    }
+};
+
 // Variables
 template <typename T>
 constexpr T epsilon = static_cast<T>(1e-6f);
 
+// Roughly the last level cache size of a desktop cpu
+static constexpr std::size_t streaming_store_threshold = 8u << 20;
+
+inline bool use_streaming_stores(const store_policy policy, const std::size_t bytes) {
+    return policy == store_policy::streaming ||
+        (policy == store_policy::automatic && bytes > streaming_store_threshold);
+}
+
 // Functions
-void escape(void *p) {
+inline void escape(void *p) {
     asm volatile("" : : "g"(p) : "memory");
 }
 
-void clobber() {
+inline void clobber() {
     asm volatile("" : : : "memory");
 }
 
@@ -27,6 +27,14 @@ inline Vec base_shuffle_impl(const Vec& v, Ts ...args) {
     return tmp;
 }
 
+// sqrt as rcp(rsqrt) for the approximate length(), x * rsqrt(x) would turn
+// a zero length into 0 * inf. Kept out of the class so int Vecs, which
+// have no rsqrt, don't look it up
+template <precision P, typename Vec>
+inline auto length_approx_impl(const Vec& v) {
+    return Vec(v.length_squared()).template rsqrt<P>().template rcp<P>()[0];
+}
+
 // Operator macros
 #define COPY_ASSIGN_EXPRS(BITS, IT)                                     \
     {                                                                   \
@@ -115,21 +123,47 @@ inline Vec base_shuffle_impl(const Vec& v, Ts ...args) {
     }
 
 #define MATH_LENGTH_FUNC                                                \
+    template <precision P = precision::exact>                           \
     inline auto length() const {                                        \
-        return std::sqrt(length_squared());                             \
+        if constexpr (P == precision::exact)                            \
+            return std::sqrt(length_squared());                         \
+        else                                                            \
+            return length_approx_impl<P>(*this);                        \
     }
 
+// Non exact normalizations scale by rsqrt of the squared length
 #define MATH_NORMALIZE_FUNC(VT)                                         \
+    template <precision P = precision::exact>                           \
     inline VT& normalize() {                                            \
-        Scalar rcp = 1. / length();                                     \
-        *this *= rcp;                                                   \
+        if constexpr (P == precision::exact) {                          \
+            Scalar rcp = 1. / length();                                 \
+            *this *= rcp;                                               \
+        }                                                               \
+        else                                                            \
+            *this *= VT(length_squared()).template rsqrt<P>();          \
         return *this;                                                   \
     }
 
-#define MATH_NORMALIZED_FUNC                                            \
+#define MATH_NORMALIZED_FUNC(VT)                                        \
+    template <precision P = precision::exact>                           \
     inline auto normalized() const {                                    \
-        Scalar rcp = 1. / length();                                     \
-        return *this * rcp;                                             \
+        if constexpr (P == precision::exact) {                          \
+            Scalar rcp = 1. / length();                                 \
+            return *this * rcp;                                         \
+        }                                                               \
+        else                                                            \
+            return *this * VT(length_squared()).template rsqrt<P>();    \
+    }
+
+// a / b with a non exact P multiplies by rcp<P>(b), operator / is always
+// exact
+#define MATH_DIV_FUNC(VT)                                               \
+    template <precision P = precision::exact>                           \
+    inline auto div(const VT& b) const {                                \
+        if constexpr (P == precision::exact)                            \
+            return *this / b;                                           \
+        else                                                            \
+            return *this * b.template rcp<P>();                         \
     }
 
 #define MATH_ABS_FUNC(VT, BITS, IT1, IT2)                               \
@@ -190,6 +224,7 @@ inline Vec base_shuffle_impl(const Vec& v, Ts ...args) {
     }
 
 #define MATH_RCP_FUNC(VT)                                               \
+    template <precision P = precision::standard>                        \
     inline auto rcp() const {                                           \
         MATH_RCP_EXPRS(VT)                                              \
     }
@@ -214,6 +249,7 @@ inline Vec base_shuffle_impl(const Vec& v, Ts ...args) {
     }
 
 #define MATH_RSQRT_FUNC                                                 \
+    template <precision P = precision::standard>                        \
     inline auto rsqrt() const {                                         \
         MATH_RSQRT_EXPRS                                                \
     }
@@ -223,34 +259,8 @@ inline Vec base_shuffle_impl(const Vec& v, Ts ...args) {
         return 1. / sqrt();                                             \
     }
 
-/*
-// Put these functions into a seperated file
-#define MATH_EXP_FUNC                                                   \
-    inline auto exp() const {                                           \
-        MATH_EXP_EXPRS                                                  \
-    }
-
-#define MATH_EXP_EXPRS                                                  \
-    {                                                                   \
-        Vec tmp;                                                        \
-        for (int i = 0; i < Size; ++i)                                  \
-            tmp[i] = std::exp(arr[i]);                                  \
-        return tmp;                                                     \
-    }
-
-#define MATH_POW_FUNC                                                   \
-    inline auto pow(const Scalar beta) const {                          \
-        MATH_POW_EXPRS                                                  \
-    }
-
-#define MATH_POW_EXPRS                                                  \
-    {                                                                   \
-        Vec tmp;                                                        \
-        for (int i = 0; i < N; ++i)                                     \
-            tmp[i] = std::pow(arr[i]);                                  \
-        return tmp;                                                     \
-    }
-*/
+// exp, pow and the other transcendental functions are free functions in
+// vec/vec_math.h
 
 #define MATH_LERP_FUNC(VT, BITS, IT)                                    \
     inline auto lerp(const VT& b, const Scalar t) const {               \
@@ -278,6 +288,8 @@ inline Vec base_shuffle_impl(const Vec& v, Ts ...args) {
 
 #define YAVL_DEFINE_MATH_FP_FUNCS(VT, BITS, IT)                         \
     MATH_NORMALIZE_FUNC(VT)                                             \
+    MATH_NORMALIZED_FUNC(VT)                                            \
+    MATH_DIV_FUNC(VT)                                                   \
     MATH_RCP_FUNC(VT)                                                   \
     MATH_SQRT_FUNC(VT)                                                  \
     MATH_RSQRT_FUNC                                                     \
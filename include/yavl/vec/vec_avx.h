@@ -3,8 +3,10 @@
 namespace yavl
 {
 
-template <int Size>
+template <int Size, precision P = precision::standard>
 static inline __m256d rcp_pd_impl(const __m256d m) {
+    if constexpr (P == precision::exact)
+        return _mm256_div_pd(_mm256_set1_pd(1.), m);
     #if defined(YAVL_X86_AVX512ER) || defined(YAVL_X86_AVX512VL)
         __m256d r;
     #if defined(YAVL_X86_AVX512ER)
@@ -15,6 +17,8 @@ static inline __m256d rcp_pd_impl(const __m256d m) {
         // rel err < 2^-14
         r = _mm256_rcp14_pd(m);
     #endif
+        if constexpr (P == precision::fast)
+            return r;
 
     #ifndef YAVL_X86_AVX512VL
         __m256d ro = r;
@@ -43,8 +47,10 @@ static inline __m256d rcp_pd_impl(const __m256d m) {
     #endif
 }
 
-template <int Size>
+template <int Size, precision P = precision::standard>
 static inline __m256d rsqrt_pd_impl(const __m256d m) {
+    if constexpr (P == precision::exact)
+        return _mm256_div_pd(_mm256_set1_pd(1.), _mm256_sqrt_pd(m));
     #if defined(YAVL_X86_AVX512ER) || defined(YAVL_X86_AVX512VL)
     __m256d r;
     #if defined(YAVL_X86_AVX512ER)
@@ -55,8 +61,10 @@ static inline __m256d rsqrt_pd_impl(const __m256d m) {
         // rel err < 2^-14
         r = _mm256_rsqrt14_pd(m);
     #endif
+        if constexpr (P == precision::fast)
+            return r;
 
-    const __m256d c0 = _mm256_set1_pd(0.5);
+    const __m256d c0 = _mm256_set1_pd(0.5),
                   c1 = _mm256_set1_pd(3.0);
 
     #ifndef YAVL_X86_AVX512VL
@@ -86,6 +94,79 @@ static inline __m256d rsqrt_pd_impl(const __m256d m) {
     #endif
 }
 
+template <precision P = precision::standard>
+static inline __m256 rcp_ps_impl(const __m256 m) {
+    // Same as the __m128 version in vec_sse42.h, widened to 8 lanes
+    if constexpr (P == precision::exact)
+        return _mm256_div_ps(_mm256_set1_ps(1.f), m);
+    __m256 r;
+#if defined(YAVL_X86_AVX512VL)
+    r = _mm256_rcp14_ps(m);     // rel error < 2^-14
+#else
+    r = _mm256_rcp_ps(m);       // rel error < 1.5*2^-12
+#endif
+    if constexpr (P == precision::fast)
+        return r;
+
+    // Refine with one Newton-Raphson iteration
+    __m256 t0 = _mm256_add_ps(r, r),
+           t1 = _mm256_mul_ps(r, m);
+
+#ifndef YAVL_X86_AVX512VL
+    __m256 ro = r;
+#endif
+
+#if defined(YAVL_X86_FMA)
+    r = _mm256_fnmadd_ps(t1, r, t0);
+#else
+    r = _mm256_sub_ps(t0, _mm256_mul_ps(r, t1));
+#endif
+
+#if defined(YAVL_X86_AVX512VL)
+    return _mm256_fixupimm_ps(r, m, _mm256_set1_epi32(0x0087A622), 0);
+#else
+    return _mm256_blendv_ps(r, ro, t1);
+#endif
+}
+
+template <precision P = precision::standard>
+static inline __m256 rsqrt_ps_impl(const __m256 m) {
+    if constexpr (P == precision::exact)
+        return _mm256_div_ps(_mm256_set1_ps(1.f), _mm256_sqrt_ps(m));
+    __m256 r;
+#if defined(YAVL_X86_AVX512VL)
+    r = _mm256_rsqrt14_ps(m);   // rel err < 2^-14
+#else
+    r = _mm256_rsqrt_ps(m);     // rel err < 1.5*2^-12
+#endif
+    if constexpr (P == precision::fast)
+        return r;
+
+    // One Newton-Raphson iteration, check rsqrt_ps_impl in vec_sse42.h
+    // for the derivation
+    const __m256 c0 = _mm256_set1_ps(.5f),
+                 c1 = _mm256_set1_ps(3.f);
+
+    __m256 t0 = _mm256_mul_ps(r, c0),
+           t1 = _mm256_mul_ps(r, m);
+
+#ifndef YAVL_X86_AVX512VL
+    __m256 ro = r;
+#endif
+
+#if defined(YAVL_X86_FMA)
+    r = _mm256_mul_ps(_mm256_fnmadd_ps(t1, r, c1), t0);
+#else
+    r = _mm256_mul_ps(_mm256_sub_ps(c1, _mm256_mul_ps(t1, r)), t0);
+#endif
+
+#if defined(YAVL_X86_AVX512VL)
+    return _mm256_fixupimm_ps(r, m, _mm256_set1_epi32(0x0383A622), 0);
+#else
+    return _mm256_blendv_ps(r, ro, t1);
+#endif
+}
+
 #define MATH_ABS_EXPRS(VT, BITS, IT1, IT2)                              \
     {                                                                   \
         return Vec(_mm##BITS##_andnot_##IT1(_mm##BITS##_set1_##IT2(-0.), m)); \
@@ -93,7 +174,7 @@ static inline __m256d rsqrt_pd_impl(const __m256d m) {
 
 #define MATH_RCP_EXPRS(VT)                                              \
     {                                                                   \
-        return Vec(rcp_pd_impl<Size>(m));                               \
+        return Vec(rcp_pd_impl<Size, P>(m));                            \
     }
 
 #define MATH_SQRT_EXPRS(VT)                                             \
@@ -103,7 +184,7 @@ static inline __m256d rsqrt_pd_impl(const __m256d m) {
 
 #define MATH_RSQRT_EXPRS                                                \
     {                                                                   \
-        return Vec(rsqrt_pd_impl<Size>(m));                             \
+        return Vec(rsqrt_pd_impl<Size, P>(m));                          \
     }
 
 #define MATH_ALL_EXPRS                                                  \
@@ -111,7 +192,7 @@ static inline __m256d rsqrt_pd_impl(const __m256d m) {
         return _mm256_movemask_pd(m) == 0xF;                            \
     }
 
-#define MATH_ALL_EXPRS                                                  \
+#define MATH_ANY_EXPRS                                                  \
     {                                                                   \
         return _mm256_movemask_pd(m) != 0x0;                            \
     }
@@ -161,6 +242,21 @@ struct alignas(32) Vec<double, 4> {
     YAVL_DEFINE_MATH_FUNCS(Vec, 256, pd, pd)
 
     #undef MATH_SUM_EXPRS
+
+    // Compare ops
+    bool operator ==(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        auto epsilon_vec = Vec(epsilon<Scalar>);
+        auto ret = Vec(_mm256_cmp_pd(abs_diff.m, epsilon_vec.m, _CMP_LE_OQ));
+        return ret.all();
+    }
+
+    bool operator !=(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        auto epsilon_vec = Vec(epsilon<Scalar>);
+        auto ret = Vec(_mm256_cmp_pd(abs_diff.m, epsilon_vec.m, _CMP_GT_OQ));
+        return ret.any();
+    }
 };
 
 template <>
@@ -207,11 +303,118 @@ struct alignas(32) Vec<double, 3> {
     YAVL_DEFINE_MATH_FUNCS(Vec, 256, pd, pd)
 
     #undef MATH_SUM_EXPRS
+
+    // Compare ops
+    bool operator ==(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        auto epsilon_vec = Vec(epsilon<Scalar>);
+        auto ret = Vec(_mm256_cmp_pd(abs_diff.m, epsilon_vec.m, _CMP_LE_OQ));
+        return ret.all();
+    }
+
+    bool operator !=(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        auto epsilon_vec = Vec(epsilon<Scalar>);
+        auto ret = Vec(_mm256_cmp_pd(abs_diff.m, epsilon_vec.m, _CMP_GT_OQ));
+        return ret.any();
+    }
+};
+
+#undef MATH_RCP_EXPRS
+#define MATH_RCP_EXPRS(VT)                                              \
+    {                                                                   \
+        return Vec(rcp_ps_impl<P>(m));                                  \
+    }
+
+#undef MATH_SQRT_EXPRS
+#define MATH_SQRT_EXPRS(VT)                                             \
+    {                                                                   \
+        return Vec(_mm256_sqrt_ps(m));                                  \
+    }
+
+#undef MATH_RSQRT_EXPRS
+#define MATH_RSQRT_EXPRS                                                \
+    {                                                                   \
+        return Vec(rsqrt_ps_impl<P>(m));                                \
+    }
+
+#undef MATH_ALL_EXPRS
+#define MATH_ALL_EXPRS                                                  \
+    {                                                                   \
+        return _mm256_movemask_ps(m) == 0xFF;                           \
+    }
+
+#undef MATH_ANY_EXPRS
+#define MATH_ANY_EXPRS                                                  \
+    {                                                                   \
+        return _mm256_movemask_ps(m) != 0x0;                            \
+    }
+
+// 8 lane float vector, mostly used as a packet for SoA layout rather than
+// as a geometric vector, hence no xyzw members
+template <>
+struct alignas(32) Vec<float, 8> {
+    YAVL_VEC_ALIAS_VECTORIZED(float, 8, 8)
+
+    union {
+        std::array<Scalar, Size> arr;
+        __m256 m;
+    };
+
+    // Ctors
+    YAVL_VECTORIZED_CTOR(256, ps, __m256)
+
+    // Operators
+    YAVL_DEFINE_VEC_FP_OP(Vec, 256, ps, ps)
+
+    // Misc funcs
+    YAVL_DEFINE_MISC_FUNCS(Vec)
+
+    // Geo funcs
+    #define GEO_DOT_EXPRS                                               \
+    {                                                                   \
+        return operator *(b).sum();                                     \
+    }
+
+    YAVL_DEFINE_GEO_FUNCS(Vec)
+
+    #undef GEO_DOT_EXPRS
+
+    // Math funcs
+    #define MATH_SUM_EXPRS                                              \
+    {                                                                   \
+        auto t1 = _mm_add_ps(_mm256_castps256_ps128(m),                 \
+            _mm256_extractf128_ps(m, 1));                               \
+        auto t2 = _mm_hadd_ps(t1, t1);                                  \
+        auto t3 = _mm_hadd_ps(t2, t2);                                  \
+        return _mm_cvtss_f32(t3);                                       \
+    }
+
+    YAVL_DEFINE_MATH_FUNCS(Vec, 256, ps, ps)
+
+    #undef MATH_SUM_EXPRS
+
+    // Compare ops
+    bool operator ==(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        auto epsilon_vec = Vec(epsilon<Scalar>);
+        auto ret = Vec(_mm256_cmp_ps(abs_diff.m, epsilon_vec.m, _CMP_LE_OQ));
+        return ret.all();
+    }
+
+    bool operator !=(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        auto epsilon_vec = Vec(epsilon<Scalar>);
+        auto ret = Vec(_mm256_cmp_ps(abs_diff.m, epsilon_vec.m, _CMP_GT_OQ));
+        return ret.any();
+    }
 };
 
 #undef MATH_ABS_EXPRS
 #undef MATH_RCP_EXPRS
 #undef MATH_SQRT_EXPRS
 #undef MATH_RSQRT_EXPRS
+#undef MATH_ALL_EXPRS
+#undef MATH_ANY_EXPRS
 
 }
\ No newline at end of file
@@ -15,6 +15,16 @@ namespace yavl
         }                                                               \
     }
 
+#define MATH_ALL_EXPRS                                                  \
+    {                                                                   \
+        return _mm256_movemask_pd(_mm256_castsi256_pd(m)) == 0xF;       \
+    }
+
+#define MATH_ANY_EXPRS                                                  \
+    {                                                                   \
+        return _mm256_movemask_pd(_mm256_castsi256_pd(m)) != 0x0;       \
+    }
+
 #define VEC_AVX2_SPECIAL_OP(OP)                                         \
     auto operator OP(const Vec& v) const {                              \
         Vec tmp;                                                        \
@@ -125,5 +135,7 @@ struct alignas(32) Vec<I, 3, enable_if_int64_t<I>> {
 };
 
 #undef MATH_ABS_EXPRS
+#undef MATH_ALL_EXPRS
+#undef MATH_ANY_EXPRS
 
 }
\ No newline at end of file
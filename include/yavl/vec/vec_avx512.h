@@ -0,0 +1,298 @@
+#pragma once
+
+namespace yavl
+{
+
+// 16 and 8 lane packets for SoA layout and batch kernels. Same refinement
+// as the narrower rcp/rsqrt, the fma is always available on zmm registers
+// and fixupimm patches 0, inf and NaN inputs the Newton-Raphson step breaks
+
+template <precision P = precision::standard>
+static inline __m512 rcp_ps_impl(const __m512 m) {
+    if constexpr (P == precision::exact)
+        return _mm512_div_ps(_mm512_set1_ps(1.f), m);
+#if defined(YAVL_X86_AVX512ER)
+    // rel err < 2^-28, use as is
+    return _mm512_rcp28_ps(m);
+#else
+    __m512 r = _mm512_rcp14_ps(m);  // rel err < 2^-14
+    if constexpr (P == precision::fast)
+        return r;
+
+    // One Newton-Raphson iteration, check rcp_ps_impl in vec_sse42.h
+    __m512 t0 = _mm512_add_ps(r, r),
+           t1 = _mm512_mul_ps(r, m);
+    r = _mm512_fnmadd_ps(t1, r, t0);
+
+    return _mm512_fixupimm_ps(r, m, _mm512_set1_epi32(0x0087A622), 0);
+#endif
+}
+
+template <precision P = precision::standard>
+static inline __m512 rsqrt_ps_impl(const __m512 m) {
+    if constexpr (P == precision::exact)
+        return _mm512_div_ps(_mm512_set1_ps(1.f), _mm512_sqrt_ps(m));
+#if defined(YAVL_X86_AVX512ER)
+    // rel err < 2^-28, use as is
+    return _mm512_rsqrt28_ps(m);
+#else
+    __m512 r = _mm512_rsqrt14_ps(m);    // rel err < 2^-14
+    if constexpr (P == precision::fast)
+        return r;
+
+    // One Newton-Raphson iteration, check rsqrt_ps_impl in vec_sse42.h
+    const __m512 c0 = _mm512_set1_ps(.5f),
+                 c1 = _mm512_set1_ps(3.f);
+
+    __m512 t0 = _mm512_mul_ps(r, c0),
+           t1 = _mm512_mul_ps(r, m);
+    r = _mm512_mul_ps(_mm512_fnmadd_ps(t1, r, c1), t0);
+
+    return _mm512_fixupimm_ps(r, m, _mm512_set1_epi32(0x0383A622), 0);
+#endif
+}
+
+template <precision P = precision::standard>
+static inline __m512d rcp_pd_impl(const __m512d m) {
+    if constexpr (P == precision::exact)
+        return _mm512_div_pd(_mm512_set1_pd(1.), m);
+    __m512d r;
+#if defined(YAVL_X86_AVX512ER)
+    r = _mm512_rcp28_pd(m);         // rel err < 2^-28
+#else
+    r = _mm512_rcp14_pd(m);         // rel err < 2^-14
+#endif
+    if constexpr (P == precision::fast)
+        return r;
+
+    __m512d t0, t1;
+    static_for<has_avx512er ? 1 : 2>([&](const auto i) {
+        t0 = _mm512_add_pd(r, r);
+        t1 = _mm512_mul_pd(r, m);
+        r = _mm512_fnmadd_pd(t1, r, t0);
+    });
+
+    return _mm512_fixupimm_pd(r, m, _mm512_set1_epi32(0x0087A622), 0);
+}
+
+template <precision P = precision::standard>
+static inline __m512d rsqrt_pd_impl(const __m512d m) {
+    if constexpr (P == precision::exact)
+        return _mm512_div_pd(_mm512_set1_pd(1.), _mm512_sqrt_pd(m));
+    __m512d r;
+#if defined(YAVL_X86_AVX512ER)
+    r = _mm512_rsqrt28_pd(m);       // rel err < 2^-28
+#else
+    r = _mm512_rsqrt14_pd(m);       // rel err < 2^-14
+#endif
+    if constexpr (P == precision::fast)
+        return r;
+
+    const __m512d c0 = _mm512_set1_pd(0.5),
+                  c1 = _mm512_set1_pd(3.0);
+
+    __m512d t0, t1;
+    static_for<has_avx512er ? 1 : 2>([&](const auto i) {
+        t0 = _mm512_mul_pd(r, c0);
+        t1 = _mm512_mul_pd(r, m);
+        r = _mm512_mul_pd(_mm512_fnmadd_pd(t1, r, c1), t0);
+    });
+
+    return _mm512_fixupimm_pd(r, m, _mm512_set1_epi32(0x0383A622), 0);
+}
+
+// Sign bits as a mask, _mm512_movepi32_mask needs DQ
+static inline __mmask16 sign_mask(const __m512 m) {
+    return _mm512_cmplt_epi32_mask(_mm512_castps_si512(m), _mm512_setzero_si512());
+}
+
+static inline __mmask8 sign_mask(const __m512d m) {
+    return _mm512_cmplt_epi64_mask(_mm512_castpd_si512(m), _mm512_setzero_si512());
+}
+
+// The float logic ops need DQ and there is no movemask, abs and the sign
+// tests go through the AVX512F instructions instead
+#define MATH_ABS_EXPRS(VT, BITS, IT1, IT2)                              \
+    {                                                                   \
+        return Vec(_mm512_abs_##IT1(m));                                \
+    }
+
+#define MATH_RCP_EXPRS(VT)                                              \
+    {                                                                   \
+        return Vec(rcp_ps_impl<P>(m));                                  \
+    }
+
+#define MATH_SQRT_EXPRS(VT)                                             \
+    {                                                                   \
+        return Vec(_mm512_sqrt_ps(m));                                  \
+    }
+
+#define MATH_RSQRT_EXPRS                                                \
+    {                                                                   \
+        return Vec(rsqrt_ps_impl<P>(m));                                \
+    }
+
+#define MATH_ALL_EXPRS                                                  \
+    {                                                                   \
+        return sign_mask(m) == 0xFFFF;                              \
+    }
+
+#define MATH_ANY_EXPRS                                                  \
+    {                                                                   \
+        return sign_mask(m) != 0x0;                                 \
+    }
+
+#define MATH_SUM_EXPRS                                                  \
+    {                                                                   \
+        return _mm512_reduce_add_ps(m);                                 \
+    }
+
+// _mm512_setr_ps is a macro in GCC and can't take a pack, lanes are set
+// through the array member instead
+#define YAVL_VECTORIZED512_CTOR(IT, REGI_TYPE)                          \
+    Vec() : m(_mm512_set1_##IT(static_cast<Scalar>(0))) {}              \
+    template <typename V>                                               \
+        requires std::default_initializable<V> && std::convertible_to<V, Scalar> \
+    Vec(V v) : m(_mm512_set1_##IT(static_cast<Scalar>(v))) {}           \
+    template <typename ...Ts>                                           \
+        requires (sizeof...(Ts) == Size) &&                             \
+            (std::convertible_to<Ts, Scalar> && ...)                    \
+    constexpr Vec(Ts... args) : arr{ static_cast<Scalar>(args)... } {}  \
+    Vec(const REGI_TYPE val) : m(val) {}
+
+template <>
+struct alignas(64) Vec<float, 16> {
+    YAVL_VEC_ALIAS_VECTORIZED(float, 16, 16)
+
+    union {
+        std::array<Scalar, Size> arr;
+        __m512 m;
+    };
+
+    // Ctors
+    YAVL_VECTORIZED512_CTOR(ps, __m512)
+
+    // Operators
+    YAVL_DEFINE_VEC_FP_OP(Vec, 512, ps, ps)
+
+    // Misc funcs
+    YAVL_DEFINE_MISC_FUNCS(Vec)
+
+    // Geo funcs
+    #define GEO_DOT_EXPRS                                               \
+    {                                                                   \
+        return operator *(b).sum();                                     \
+    }
+
+    YAVL_DEFINE_GEO_FUNCS(Vec)
+
+    #undef GEO_DOT_EXPRS
+
+    // Math funcs
+    YAVL_DEFINE_MATH_FUNCS(Vec, 512, ps, ps)
+
+    // Compare ops
+    bool operator ==(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        return _mm512_cmp_ps_mask(abs_diff.m, _mm512_set1_ps(epsilon<Scalar>),
+            _CMP_LE_OQ) == 0xFFFF;
+    }
+
+    bool operator !=(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        return _mm512_cmp_ps_mask(abs_diff.m, _mm512_set1_ps(epsilon<Scalar>),
+            _CMP_GT_OQ) != 0x0;
+    }
+};
+
+#undef MATH_RCP_EXPRS
+#define MATH_RCP_EXPRS(VT)                                              \
+    {                                                                   \
+        return Vec(rcp_pd_impl<P>(m));                                  \
+    }
+
+#undef MATH_SQRT_EXPRS
+#define MATH_SQRT_EXPRS(VT)                                             \
+    {                                                                   \
+        return Vec(_mm512_sqrt_pd(m));                                  \
+    }
+
+#undef MATH_RSQRT_EXPRS
+#define MATH_RSQRT_EXPRS                                                \
+    {                                                                   \
+        return Vec(rsqrt_pd_impl<P>(m));                                \
+    }
+
+#undef MATH_ALL_EXPRS
+#define MATH_ALL_EXPRS                                                  \
+    {                                                                   \
+        return sign_mask(m) == 0xFF;                                \
+    }
+
+#undef MATH_ANY_EXPRS
+#define MATH_ANY_EXPRS                                                  \
+    {                                                                   \
+        return sign_mask(m) != 0x0;                                 \
+    }
+
+#undef MATH_SUM_EXPRS
+#define MATH_SUM_EXPRS                                                  \
+    {                                                                   \
+        return _mm512_reduce_add_pd(m);                                 \
+    }
+
+template <>
+struct alignas(64) Vec<double, 8> {
+    YAVL_VEC_ALIAS_VECTORIZED(double, 8, 8)
+
+    union {
+        std::array<Scalar, Size> arr;
+        __m512d m;
+    };
+
+    // Ctors
+    YAVL_VECTORIZED512_CTOR(pd, __m512d)
+
+    // Operators
+    YAVL_DEFINE_VEC_FP_OP(Vec, 512, pd, pd)
+
+    // Misc funcs
+    YAVL_DEFINE_MISC_FUNCS(Vec)
+
+    // Geo funcs
+    #define GEO_DOT_EXPRS                                               \
+    {                                                                   \
+        return operator *(b).sum();                                     \
+    }
+
+    YAVL_DEFINE_GEO_FUNCS(Vec)
+
+    #undef GEO_DOT_EXPRS
+
+    // Math funcs
+    YAVL_DEFINE_MATH_FUNCS(Vec, 512, pd, pd)
+
+    // Compare ops
+    bool operator ==(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        return _mm512_cmp_pd_mask(abs_diff.m, _mm512_set1_pd(epsilon<Scalar>),
+            _CMP_LE_OQ) == 0xFF;
+    }
+
+    bool operator !=(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        return _mm512_cmp_pd_mask(abs_diff.m, _mm512_set1_pd(epsilon<Scalar>),
+            _CMP_GT_OQ) != 0x0;
+    }
+};
+
+#undef YAVL_VECTORIZED512_CTOR
+#undef MATH_ABS_EXPRS
+#undef MATH_RCP_EXPRS
+#undef MATH_SQRT_EXPRS
+#undef MATH_RSQRT_EXPRS
+#undef MATH_ALL_EXPRS
+#undef MATH_ANY_EXPRS
+#undef MATH_SUM_EXPRS
+
+} // namespace yavl
@@ -0,0 +1,358 @@
+#pragma once
+
+// Opt-in lazy expressions over Vecs and contiguous arrays.
+//
+// Every Vec operator returns a temporary, so a * b + c * d - e over the
+// fallback Vec(or a naive loop per operator over arrays) stores and reloads
+// four intermediates. Wrapping the operands in lazy() builds an expression
+// tree instead, which assign() and eval() run in a single pass of the
+// widest packets, every operand loaded once and the result stored once. A
+// product feeding an add or a sub is contracted to one fma.
+//
+//   assign(out, lazy(a) * lazy(b) + lazy(c) * 2.f - lazy(e));
+//   Vec4f r = eval(lazy(u) * lazy(v) + lazy(w));
+//
+// Expressions hold pointers to their operands, evaluate them in the
+// statement that builds them. out may be one of the operands but must not
+// partially overlap them.
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_math.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace expr_impl
+{
+
+// Every node has Scalar, the Vec size it evaluates to(0 for arrays and
+// broadcasts), the lane count(0 for broadcasts) and packet<P>(i) giving
+// lanes [i, i + width of P). A nonzero tail loads only the first tail
+// lanes, for packets with masked loads
+template <typename P>
+concept masked_packet = requires(const P a) {
+    math_impl::packet_ops<P>::storeu_n(nullptr, a, 0u);
+};
+
+template <typename E>
+concept expression = requires { typename E::is_expression; };
+
+template <typename T, uint32_t N>
+struct terminal {
+    using is_expression = void;
+    using Scalar = T;
+    static constexpr uint32_t VecSize = N;
+
+    const T* p;
+    std::size_t n;
+
+    inline std::size_t size() const {
+        return n;
+    }
+
+    template <typename P>
+    inline P packet(const std::size_t i, [[maybe_unused]] const uint32_t tail = 0) const {
+        if constexpr (masked_packet<P>) {
+            if (tail)
+                return math_impl::packet_ops<P>::loadu_n(p + i, tail);
+        }
+        return math_impl::packet_ops<P>::loadu(p + i);
+    }
+};
+
+template <typename T>
+struct broadcast {
+    using is_expression = void;
+    using Scalar = T;
+    static constexpr uint32_t VecSize = 0;
+
+    T s;
+
+    inline std::size_t size() const {
+        return 0;
+    }
+
+    template <typename P>
+    inline P packet(const std::size_t, const uint32_t = 0) const {
+        return math_impl::packet_ops<P>::set1(s);
+    }
+};
+
+#define YAVL_DEFINE_EXPR_OP(NAME, ...)                                  \
+    struct NAME {                                                       \
+        template <typename O, typename... Ps>                           \
+        static inline auto apply(const Ps... a) {                       \
+            return __VA_ARGS__;                                         \
+        }                                                               \
+    };
+
+YAVL_DEFINE_EXPR_OP(add_op, O::add(a...))
+YAVL_DEFINE_EXPR_OP(sub_op, O::sub(a...))
+YAVL_DEFINE_EXPR_OP(mul_op, O::mul(a...))
+YAVL_DEFINE_EXPR_OP(div_op, O::div(a...))
+YAVL_DEFINE_EXPR_OP(min_op, O::min(a...))
+YAVL_DEFINE_EXPR_OP(max_op, O::max(a...))
+YAVL_DEFINE_EXPR_OP(neg_op, O::sub(O::set1(0), a...))
+YAVL_DEFINE_EXPR_OP(abs_op, O::abs(a...))
+YAVL_DEFINE_EXPR_OP(sqrt_op, O::sqrt(a...))
+
+#undef YAVL_DEFINE_EXPR_OP
+
+// Lanes and Vec size of the operands, which must agree
+template <typename L, typename R>
+static constexpr uint32_t merge_vec_size() {
+    static_assert(L::VecSize == 0 || R::VecSize == 0 || L::VecSize == R::VecSize,
+        "Vec operands of an expression must have the same size");
+    return L::VecSize ? L::VecSize : R::VecSize;
+}
+
+template <typename L, typename R>
+static inline std::size_t merge_size(const L& l, const R& r) {
+    assert(l.size() == 0 || r.size() == 0 || l.size() == r.size());
+    return l.size() ? l.size() : r.size();
+}
+
+template <typename Op, typename A>
+struct unary {
+    using is_expression = void;
+    using Scalar = typename A::Scalar;
+    static constexpr uint32_t VecSize = A::VecSize;
+
+    A a;
+
+    inline std::size_t size() const {
+        return a.size();
+    }
+
+    template <typename P>
+    inline P packet(const std::size_t i, const uint32_t tail = 0) const {
+        return Op::template apply<math_impl::packet_ops<P>>(a.template packet<P>(i, tail));
+    }
+};
+
+template <typename Op, typename L, typename R>
+struct binary;
+
+template <typename E>
+static constexpr bool is_product = false;
+
+template <typename L, typename R>
+static constexpr bool is_product<binary<mul_op, L, R>> = true;
+
+template <typename Op, typename L, typename R>
+struct binary {
+    using is_expression = void;
+    using Scalar = typename L::Scalar;
+    static constexpr uint32_t VecSize = merge_vec_size<L, R>();
+    static_assert(std::is_same_v<Scalar, typename R::Scalar>,
+        "Operands of an expression must have the same scalar type");
+
+    L l;
+    R r;
+
+    inline std::size_t size() const {
+        return merge_size(l, r);
+    }
+
+    template <typename P>
+    inline P packet(const std::size_t i, const uint32_t tail = 0) const {
+        using O = math_impl::packet_ops<P>;
+        constexpr bool add = std::is_same_v<Op, add_op>;
+        constexpr bool sub = std::is_same_v<Op, sub_op>;
+
+        // Contract a product into the add or sub consuming it
+        if constexpr (add && is_product<L>)
+            return O::fmadd(l.l.template packet<P>(i, tail), l.r.template packet<P>(i, tail),
+                r.template packet<P>(i, tail));
+        else if constexpr (add && is_product<R>)
+            return O::fmadd(r.l.template packet<P>(i, tail), r.r.template packet<P>(i, tail),
+                l.template packet<P>(i, tail));
+        else if constexpr (sub && is_product<L>)
+            return O::fmsub(l.l.template packet<P>(i, tail), l.r.template packet<P>(i, tail),
+                r.template packet<P>(i, tail));
+        else if constexpr (sub && is_product<R>)
+            return O::fnmadd(r.l.template packet<P>(i, tail), r.r.template packet<P>(i, tail),
+                l.template packet<P>(i, tail));
+        else
+            return Op::template apply<O>(l.template packet<P>(i, tail), r.template packet<P>(i, tail));
+    }
+};
+
+// Scalars are broadcast, expressions are kept as is
+template <typename E, typename T>
+static inline auto as_node(const T& v) {
+    if constexpr (expression<T>)
+        return v;
+    else
+        return broadcast<typename E::Scalar>{ static_cast<typename E::Scalar>(v) };
+}
+
+template <typename Op, typename A, typename B>
+static inline auto make_binary(const A& a, const B& b) {
+    if constexpr (expression<A>) {
+        auto r = as_node<A>(b);
+        return binary<Op, A, decltype(r)>{ a, r };
+    }
+    else {
+        auto l = as_node<B>(a);
+        return binary<Op, decltype(l), B>{ l, b };
+    }
+}
+
+// Evaluate e over n lanes into out, widest packets first
+template <typename T, typename E>
+static inline void evaluate(T* out, const std::size_t n, const E& e) {
+    std::size_t i = 0;
+    auto run = [&]<typename P>() {
+        using O = math_impl::packet_ops<P>;
+        for (; i + O::Width <= n; i += O::Width)
+            O::storeu(out + i, e.template packet<P>(i));
+    };
+
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+#if defined(YAVL_X86_AVX512F)
+    run.template operator()<math_impl::packet512_t<T>>();
+    // Array tails are one masked packet rather than a cascade of narrower
+    // ones, Vecs fit in the narrower packets and stay out of zmm registers
+    if constexpr (E::VecSize == 0) {
+        using O = math_impl::packet_ops<math_impl::packet512_t<T>>;
+        if (i < n) {
+            const auto tail = static_cast<uint32_t>(n - i);
+            O::storeu_n(out + i, e.template packet<math_impl::packet512_t<T>>(i, tail), tail);
+        }
+        return;
+    }
+#endif
+#if defined(YAVL_X86_AVX2)
+    run.template operator()<math_impl::packet256_t<T>>();
+#endif
+#if defined(YAVL_X86_SSE42) || defined(YAVL_ARM_NEON)
+    run.template operator()<math_impl::packet128_t<T>>();
+#endif
+#endif
+    run.template operator()<T>();
+}
+
+template <typename A, typename B>
+concept operands = (expression<A> && (expression<B> || std::is_arithmetic_v<B>)) ||
+    (std::is_arithmetic_v<A> && expression<B>);
+
+} // namespace expr_impl
+
+// Lazy operands. Vecs include their padding lanes, so Vec3f expressions
+// run as one __m128 like the Vec3f operators do
+template <typename T>
+    requires std::is_floating_point_v<T>
+inline auto lazy(std::span<const T> a) {
+    return expr_impl::terminal<T, 0>{ a.data(), a.size() };
+}
+
+template <typename T>
+    requires std::is_floating_point_v<T>
+inline auto lazy(std::span<T> a) {
+    return expr_impl::terminal<T, 0>{ a.data(), a.size() };
+}
+
+template <typename T, typename A>
+    requires std::is_floating_point_v<T>
+inline auto lazy(const std::vector<T, A>& a) {
+    return expr_impl::terminal<T, 0>{ a.data(), a.size() };
+}
+
+template <typename T, uint32_t N>
+    requires std::is_floating_point_v<T>
+inline auto lazy(const Vec<T, N>& v) {
+    return expr_impl::terminal<T, N>{ reinterpret_cast<const T*>(&v),
+        math_impl::padded_lanes<T, N> };
+}
+
+#define YAVL_DEFINE_EXPR_BINARY_OP(OP, NAME)                            \
+    template <typename A, typename B>                                   \
+        requires expr_impl::operands<A, B>                              \
+    inline auto operator OP(const A& a, const B& b) {                   \
+        return expr_impl::make_binary<expr_impl::NAME>(a, b);           \
+    }
+
+YAVL_DEFINE_EXPR_BINARY_OP(+, add_op)
+YAVL_DEFINE_EXPR_BINARY_OP(-, sub_op)
+YAVL_DEFINE_EXPR_BINARY_OP(*, mul_op)
+YAVL_DEFINE_EXPR_BINARY_OP(/, div_op)
+
+#undef YAVL_DEFINE_EXPR_BINARY_OP
+
+template <typename A, typename B>
+    requires expr_impl::operands<A, B>
+inline auto min(const A& a, const B& b) {
+    return expr_impl::make_binary<expr_impl::min_op>(a, b);
+}
+
+template <typename A, typename B>
+    requires expr_impl::operands<A, B>
+inline auto max(const A& a, const B& b) {
+    return expr_impl::make_binary<expr_impl::max_op>(a, b);
+}
+
+template <expr_impl::expression A>
+inline auto operator -(const A& a) {
+    return expr_impl::unary<expr_impl::neg_op, A>{ a };
+}
+
+template <expr_impl::expression A>
+inline auto abs(const A& a) {
+    return expr_impl::unary<expr_impl::abs_op, A>{ a };
+}
+
+template <expr_impl::expression A>
+inline auto sqrt(const A& a) {
+    return expr_impl::unary<expr_impl::sqrt_op, A>{ a };
+}
+
+// out[i] = e[i], array expressions only
+template <typename T, expr_impl::expression E>
+inline void assign(std::span<T> out, const E& e) {
+    static_assert(E::VecSize == 0, "Vec expressions are evaluated with eval()");
+    static_assert(std::is_same_v<T, typename E::Scalar>);
+    assert(e.size() == out.size());
+    expr_impl::evaluate(out.data(), out.size(), e);
+}
+
+template <typename T, typename A, expr_impl::expression E>
+inline void assign(std::vector<T, A>& out, const E& e) {
+    assign(std::span<T>(out), e);
+}
+
+// Result of a Vec expression
+template <expr_impl::expression E>
+inline auto eval(const E& e) {
+    static_assert(E::VecSize > 0, "Array expressions are evaluated with assign()");
+    using T = typename E::Scalar;
+    Vec<T, E::VecSize> r;
+    expr_impl::evaluate(reinterpret_cast<T*>(&r), math_impl::padded_lanes<T, E::VecSize>, e);
+    return r;
+}
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
@@ -0,0 +1,368 @@
+#pragma once
+
+// 16 bit float storage: IEEE half(fp16) and bfloat16(the upper half of a
+// float). Arithmetic stays in float, these exist to halve the memory
+// traffic of bandwidth bound buffers like vertex and particle attributes.
+//
+// half and bfloat16 are a uint16_t each, Vec<half, N>/Vec<bfloat16, N> are
+// the generic Vec and hold N of them back to back without padding. widen()
+// turns one into a Vec<float, N>, going straight into the register for the
+// vectorized Vec3f/Vec4f, narrow<T>() goes back. convert() moves whole
+// arrays in the widest packets of the build:
+//
+// - half <-> float: _mm512_cvtph_ps/_mm512_cvtps_ph with AVX-512,
+//   _mm256_cvtph_ps/_mm256_cvtps_ph with F16C and vcvt_f32_f16/vcvt_f16_f32
+//   on NEON
+// - bfloat16 -> float is a 16 bit shift of zero extended lanes
+// - float -> bfloat16 is _mm512_cvtneps_pbh with AVX512-BF16, an integer
+//   round to nearest even elsewhere
+//
+// Narrowing rounds to nearest even everywhere. Values past the half range
+// become infinities, NaNs stay NaNs(quiet). bfloat16 has the float
+// exponent range, but the AVX512-BF16 instruction flushes float denormals
+// to zero where the other paths round them.
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+
+namespace yavl
+{
+
+namespace half_impl
+{
+
+static constexpr uint16_t float_to_half(const float f) {
+    const uint32_t x = std::bit_cast<uint32_t>(f);
+    const uint32_t sign = (x >> 16) & 0x8000;
+    const uint32_t ax = x & 0x7fffffff;
+
+    // Inf and NaN, NaNs keep the top of the payload and get the quiet bit
+    if (ax >= 0x7f800000)
+        return sign | 0x7c00 | (ax > 0x7f800000 ? 0x200 | ((ax >> 13) & 0x3ff) : 0);
+    // 65520 and up round past the largest half(65504)
+    if (ax >= 0x477ff000)
+        return sign | 0x7c00;
+    // Below 2^-14 the result is denormal, adding 0.5 puts the 2^-24 half
+    // ulp at the last float mantissa bit and lets the float add round
+    if (ax < 0x38800000) {
+        const float d = std::bit_cast<float>(ax) + 0.5f;
+        return sign | (std::bit_cast<uint32_t>(d) - 0x3f000000);
+    }
+    // Rebias the exponent(127 - 15) and round the 13 dropped bits to even,
+    // a carry out of the mantissa bumps the exponent as it should
+    const uint32_t odd = (ax >> 13) & 1;
+    return sign | ((ax + 0xc8000fff + odd) >> 13);
+}
+
+static constexpr float half_to_float(const uint16_t h) {
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    const uint32_t e = (h >> 10) & 0x1f, m = h & 0x3ff;
+    if (e == 0x1f)
+        return std::bit_cast<float>(sign | 0x7f800000 | (m << 13));
+    // Zero and denormals, m * 2^-24 is exact
+    if (e == 0)
+        return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(m * 0x1p-24f));
+    return std::bit_cast<float>(sign | ((e + 112) << 23) | (m << 13));
+}
+
+static constexpr uint16_t float_to_bfloat16(const float f) {
+    const uint32_t x = std::bit_cast<uint32_t>(f);
+    if ((x & 0x7fffffff) > 0x7f800000)
+        return (x >> 16) | 0x40;
+    return (x + 0x7fff + ((x >> 16) & 1)) >> 16;
+}
+
+static constexpr float bfloat16_to_float(const uint16_t b) {
+    return std::bit_cast<float>(static_cast<uint32_t>(b) << 16);
+}
+
+} // namespace half_impl
+
+struct half {
+    uint16_t bits;
+
+    half() = default;
+    constexpr explicit half(const float f) : bits(half_impl::float_to_half(f)) {}
+
+    constexpr operator float() const {
+        return half_impl::half_to_float(bits);
+    }
+
+    static constexpr half from_bits(const uint16_t b) {
+        half h;
+        h.bits = b;
+        return h;
+    }
+};
+
+struct bfloat16 {
+    uint16_t bits;
+
+    bfloat16() = default;
+    constexpr explicit bfloat16(const float f) : bits(half_impl::float_to_bfloat16(f)) {}
+
+    constexpr operator float() const {
+        return half_impl::bfloat16_to_float(bits);
+    }
+
+    static constexpr bfloat16 from_bits(const uint16_t b) {
+        bfloat16 h;
+        h.bits = b;
+        return h;
+    }
+};
+
+template <typename T>
+concept half_storage = std::same_as<T, half> || std::same_as<T, bfloat16>;
+
+// Vec type aliasing, storage only
+using Vec2h = Vec2<half>;
+using Vec3h = Vec3<half>;
+using Vec4h = Vec4<half>;
+
+using Vec2bf = Vec2<bfloat16>;
+using Vec3bf = Vec3<bfloat16>;
+using Vec4bf = Vec4<bfloat16>;
+
+static_assert(sizeof(Vec3h) == 6 && sizeof(Vec4h) == 8);
+static_assert(sizeof(Vec3bf) == 6 && sizeof(Vec4bf) == 8);
+
+namespace half_impl
+{
+
+// Four lanes from p, the 128 bit register of the vectorized Vec3f/Vec4f.
+// Overloads for the storage types the isa converts in registers
+template <typename T>
+void widen4(const T*) = delete;
+
+template <typename R, typename T>
+void narrow4(const R, T*) = delete;
+
+#if defined(YAVL_X86_F16C)
+static inline __m128 widen4(const half* p) {
+    return _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+static inline void narrow4(const __m128 v, half* p) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p),
+        _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+}
+#elif defined(YAVL_ARM_NEON)
+static inline float32x4_t widen4(const half* p) {
+    return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(&p->bits)));
+}
+
+static inline void narrow4(const float32x4_t v, half* p) {
+    vst1_u16(&p->bits, vreinterpret_u16_f16(vcvt_f16_f32(v)));
+}
+#endif
+
+#if defined(YAVL_X86_SSE42)
+static inline __m128 widen4(const bfloat16* p) {
+    const __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_cvtepu16_epi32(b), 16));
+}
+#elif defined(YAVL_ARM_NEON)
+static inline float32x4_t widen4(const bfloat16* p) {
+    return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(&p->bits), 16));
+}
+#endif
+
+template <typename T>
+concept has_widen4 = requires(const T* p) { widen4(p); };
+
+template <typename T>
+concept has_narrow4 = requires(T* p) { narrow4(widen4(p), p); };
+
+// Array kernels, the widest packets first and the tail element by element
+
+static inline void widen(const half* src, float* dst, const std::size_t n) {
+    std::size_t i = 0;
+#if defined(YAVL_X86_AVX512F)
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))));
+#endif
+#if defined(YAVL_X86_F16C)
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+#elif defined(YAVL_ARM_NEON)
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, widen4(src + i));
+#endif
+    for (; i < n; ++i)
+        dst[i] = src[i];
+}
+
+static inline void narrow(const float* src, half* dst, const std::size_t n) {
+    std::size_t i = 0;
+#if defined(YAVL_X86_AVX512F)
+    for (; i + 16 <= n; i += 16)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_cvtps_ph(
+            _mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+#endif
+#if defined(YAVL_X86_F16C)
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_cvtps_ph(
+            _mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+#elif defined(YAVL_ARM_NEON)
+    for (; i + 4 <= n; i += 4)
+        narrow4(vld1q_f32(src + i), dst + i);
+#endif
+    for (; i < n; ++i)
+        dst[i] = half(src[i]);
+}
+
+static inline void widen(const bfloat16* src, float* dst, const std::size_t n) {
+    std::size_t i = 0;
+#if defined(YAVL_X86_AVX512F)
+    for (; i + 16 <= n; i += 16) {
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm512_storeu_ps(dst + i, _mm512_castsi512_ps(
+            _mm512_slli_epi32(_mm512_cvtepu16_epi32(b), 16)));
+    }
+#endif
+#if defined(YAVL_X86_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(
+            _mm256_slli_epi32(_mm256_cvtepu16_epi32(b), 16)));
+    }
+#endif
+#if defined(YAVL_X86_SSE42)
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, widen4(src + i));
+#elif defined(YAVL_ARM_NEON)
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, widen4(src + i));
+#endif
+    for (; i < n; ++i)
+        dst[i] = src[i];
+}
+
+// Round to nearest even on the integer bits, NaNs are truncated and made
+// quiet so they can't round into an infinity
+static inline void narrow(const float* src, bfloat16* dst, const std::size_t n) {
+    std::size_t i = 0;
+#if defined(YAVL_X86_AVX512BF16)
+    for (; i + 16 <= n; i += 16)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+            std::bit_cast<__m256i>(_mm512_cvtneps_pbh(_mm512_loadu_ps(src + i))));
+#elif defined(YAVL_X86_AVX512F)
+    for (; i + 16 <= n; i += 16) {
+        const __m512 v = _mm512_loadu_ps(src + i);
+        const __m512i x = _mm512_castps_si512(v), hi = _mm512_srli_epi32(x, 16);
+        const __m512i bias = _mm512_add_epi32(_mm512_set1_epi32(0x7fff),
+            _mm512_and_si512(hi, _mm512_set1_epi32(1)));
+        __m512i r = _mm512_srli_epi32(_mm512_add_epi32(x, bias), 16);
+        r = _mm512_mask_or_epi32(r, _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q), hi,
+            _mm512_set1_epi32(0x40));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_cvtepi32_epi16(r));
+    }
+#endif
+#if defined(YAVL_X86_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(src + i);
+        const __m256i x = _mm256_castps_si256(v), hi = _mm256_srli_epi32(x, 16);
+        const __m256i bias = _mm256_add_epi32(_mm256_set1_epi32(0x7fff),
+            _mm256_and_si256(hi, _mm256_set1_epi32(1)));
+        __m256i r = _mm256_srli_epi32(_mm256_add_epi32(x, bias), 16);
+        r = _mm256_blendv_epi8(r, _mm256_or_si256(hi, _mm256_set1_epi32(0x40)),
+            _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi32(
+            _mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1)));
+    }
+#endif
+#if defined(YAVL_X86_SSE42)
+    for (; i + 4 <= n; i += 4) {
+        const __m128 v = _mm_loadu_ps(src + i);
+        const __m128i x = _mm_castps_si128(v), hi = _mm_srli_epi32(x, 16);
+        const __m128i bias = _mm_add_epi32(_mm_set1_epi32(0x7fff),
+            _mm_and_si128(hi, _mm_set1_epi32(1)));
+        __m128i r = _mm_srli_epi32(_mm_add_epi32(x, bias), 16);
+        r = _mm_blendv_epi8(r, _mm_or_si128(hi, _mm_set1_epi32(0x40)),
+            _mm_castps_si128(_mm_cmpunord_ps(v, v)));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi32(r, r));
+    }
+#elif defined(YAVL_ARM_NEON)
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t v = vld1q_f32(src + i);
+        const uint32x4_t x = vreinterpretq_u32_f32(v), hi = vshrq_n_u32(x, 16);
+        const uint32x4_t bias = vaddq_u32(vdupq_n_u32(0x7fff),
+            vandq_u32(hi, vdupq_n_u32(1)));
+        uint32x4_t r = vshrq_n_u32(vaddq_u32(x, bias), 16);
+        r = vbslq_u32(vceqq_f32(v, v), r, vorrq_u32(hi, vdupq_n_u32(0x40)));
+        vst1_u16(&dst[i].bits, vmovn_u32(r));
+    }
+#endif
+    for (; i < n; ++i)
+        dst[i] = bfloat16(src[i]);
+}
+
+} // namespace half_impl
+
+// Vec<half, N>/Vec<bfloat16, N> to floats. The vectorized Vec3f/Vec4f
+// convert in their register, reading 8 bytes from a copy of v
+template <half_storage T, uint32_t N>
+inline Vec<float, N> widen(const Vec<T, N>& v) {
+    if constexpr (N <= 4 && Vec<float, N>::vectorized && half_impl::has_widen4<T>) {
+        T tmp[4] = {};
+        std::memcpy(tmp, v.arr.data(), N * sizeof(T));
+        return Vec<float, N>(half_impl::widen4(tmp));
+    }
+    else {
+        Vec<float, N> ret;
+        for (uint32_t i = 0; i < N; ++i)
+            ret[i] = v[i];
+        return ret;
+    }
+}
+
+// And back, rounding to nearest even
+template <half_storage T, uint32_t N>
+inline Vec<T, N> narrow(const Vec<float, N>& v) {
+    Vec<T, N> ret;
+    if constexpr (N <= 4 && Vec<float, N>::vectorized && half_impl::has_narrow4<T>) {
+        T tmp[4];
+        half_impl::narrow4(v.m, tmp);
+        std::memcpy(ret.arr.data(), tmp, N * sizeof(T));
+    }
+    else {
+        for (uint32_t i = 0; i < N; ++i)
+            ret[i] = T(v[i]);
+    }
+    return ret;
+}
+
+// Bulk conversions, src and dst have the same size
+inline void convert(std::span<const half> src, std::span<float> dst) {
+    assert(src.size() == dst.size());
+    half_impl::widen(src.data(), dst.data(), src.size());
+}
+
+inline void convert(std::span<const float> src, std::span<half> dst) {
+    assert(src.size() == dst.size());
+    half_impl::narrow(src.data(), dst.data(), src.size());
+}
+
+inline void convert(std::span<const bfloat16> src, std::span<float> dst) {
+    assert(src.size() == dst.size());
+    half_impl::widen(src.data(), dst.data(), src.size());
+}
+
+inline void convert(std::span<const float> src, std::span<bfloat16> dst) {
+    assert(src.size() == dst.size());
+    half_impl::narrow(src.data(), dst.data(), src.size());
+}
+
+} // namespace yavl
@@ -0,0 +1,400 @@
+#pragma once
+
+// Lane masks of Vec compares, for branch free selection and culling.
+//
+// Vec::operator== and != compare whole vectors within epsilon and return a
+// bool, all()/any() reduce the lane values. The compares here work lane by
+// lane: <, <=, >, >= and eq()/neq() return a Mask<T, N> holding the
+// compare result in the form of the Vec's register, an all ones __m128,
+// __m256 or NEON lane, or an AVX-512 __mmask. Vecs without a register, and
+// the AVX only __m256 ones which have no packet ops, use a uint32_t of lane
+// bits. Compares are ordered, NaN lanes are false except for neq().
+//
+// A Mask feeds select(), masked_load()/masked_store(), which never touch
+// the memory of inactive lanes, and compress_store()/compress_indices(),
+// which pack the active lanes or their indices to the front of an output
+// array and return how many were written, e.g. the survivors of a culling
+// test. bits() has lane l in bit l, count() and first() are its popcount
+// and lowest set lane.
+//
+// Masked loads and stores are AVX maskload/maskstore and AVX-512 masked
+// moves, compresses are AVX-512 compress stores for up to 16 lanes, a loop
+// over the set bits elsewhere. Padding lanes, the 4th of a Vec3f, are never
+// active whatever the register holds.
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_math.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace mask_impl
+{
+
+// Register of a vectorized Vec with packet ops, void otherwise
+template <typename V>
+struct register_of {
+    using type = void;
+};
+
+template <typename V>
+    requires V::vectorized
+        && requires { typename math_impl::packet_ops<decltype(V::m)>::Mask; }
+struct register_of<V> {
+    using type = decltype(V::m);
+};
+
+template <typename R>
+struct mask_of {
+    using type = typename math_impl::packet_ops<R>::Mask;
+};
+
+template <>
+struct mask_of<void> {
+    using type = uint32_t;
+};
+
+// Overloads for the registers the isa has masked moves for
+template <typename T, typename M>
+void maskload(const T*, const M) = delete;
+
+template <typename T, typename M, typename R>
+void maskstore(T*, const M, const R) = delete;
+
+template <typename T, typename R>
+void compressstore(T*, const uint32_t, const R) = delete;
+
+#if defined(YAVL_X86_AVX)
+static inline __m128 maskload(const float* p, const __m128 m) {
+    return _mm_maskload_ps(p, _mm_castps_si128(m));
+}
+
+static inline __m128d maskload(const double* p, const __m128d m) {
+    return _mm_maskload_pd(p, _mm_castpd_si128(m));
+}
+
+static inline void maskstore(float* p, const __m128 m, const __m128 a) {
+    _mm_maskstore_ps(p, _mm_castps_si128(m), a);
+}
+
+static inline void maskstore(double* p, const __m128d m, const __m128d a) {
+    _mm_maskstore_pd(p, _mm_castpd_si128(m), a);
+}
+#endif
+
+#if defined(YAVL_X86_AVX2)
+static inline __m256 maskload(const float* p, const __m256 m) {
+    return _mm256_maskload_ps(p, _mm256_castps_si256(m));
+}
+
+static inline __m256d maskload(const double* p, const __m256d m) {
+    return _mm256_maskload_pd(p, _mm256_castpd_si256(m));
+}
+
+static inline void maskstore(float* p, const __m256 m, const __m256 a) {
+    _mm256_maskstore_ps(p, _mm256_castps_si256(m), a);
+}
+
+static inline void maskstore(double* p, const __m256d m, const __m256d a) {
+    _mm256_maskstore_pd(p, _mm256_castpd_si256(m), a);
+}
+#endif
+
+#if defined(YAVL_X86_AVX512F)
+static inline __m512 maskload(const float* p, const __mmask16 m) {
+    return _mm512_maskz_loadu_ps(m, p);
+}
+
+static inline __m512d maskload(const double* p, const __mmask8 m) {
+    return _mm512_maskz_loadu_pd(m, p);
+}
+
+static inline void maskstore(float* p, const __mmask16 m, const __m512 a) {
+    _mm512_mask_storeu_ps(p, m, a);
+}
+
+static inline void maskstore(double* p, const __mmask8 m, const __m512d a) {
+    _mm512_mask_storeu_pd(p, m, a);
+}
+
+// The narrower registers go through the 512 bit compress, their upper
+// lanes are never in the mask
+static inline void compressstore(float* p, const uint32_t m, const __m128 a) {
+    _mm512_mask_compressstoreu_ps(p, static_cast<__mmask16>(m), _mm512_castps128_ps512(a));
+}
+
+static inline void compressstore(double* p, const uint32_t m, const __m128d a) {
+    _mm512_mask_compressstoreu_pd(p, static_cast<__mmask8>(m), _mm512_castpd128_pd512(a));
+}
+
+static inline void compressstore(float* p, const uint32_t m, const __m256 a) {
+    _mm512_mask_compressstoreu_ps(p, static_cast<__mmask16>(m), _mm512_castps256_ps512(a));
+}
+
+static inline void compressstore(double* p, const uint32_t m, const __m256d a) {
+    _mm512_mask_compressstoreu_pd(p, static_cast<__mmask8>(m), _mm512_castpd256_pd512(a));
+}
+
+static inline void compressstore(float* p, const uint32_t m, const __m512 a) {
+    _mm512_mask_compressstoreu_ps(p, static_cast<__mmask16>(m), a);
+}
+
+static inline void compressstore(double* p, const uint32_t m, const __m512d a) {
+    _mm512_mask_compressstoreu_pd(p, static_cast<__mmask8>(m), a);
+}
+#endif
+
+// Whether the isa has the masked move or compress store for mask type K
+// and register R, false for the uint32_t masks of the scalar Vecs
+template <typename T, typename K, typename R>
+concept has_maskload = requires(const T* p, K k) {
+    { maskload(p, k) } -> std::same_as<R>;
+};
+
+template <typename T, typename K, typename R>
+concept has_maskstore = requires(T* p, K k, R a) { maskstore(p, k, a); };
+
+template <typename T, typename R>
+concept has_compressstore = requires(T* p, uint32_t m, R a) { compressstore(p, m, a); };
+
+} // namespace mask_impl
+
+template <typename T, uint32_t N>
+struct Mask {
+    using Scalar = T;
+    using VecType = Vec<T, N>;
+    using Register = typename mask_impl::register_of<VecType>::type;
+    using Type = typename mask_impl::mask_of<Register>::type;
+    static constexpr uint32_t Size = N;
+    static constexpr bool vectorized = !std::is_void_v<Register>;
+    static constexpr uint32_t lanes = N < 32 ? (1u << N) - 1 : ~0u;
+
+    static_assert(N <= 32);
+
+    Type m;
+
+    // Ctors
+    Mask() : Mask(false) {}
+    explicit Mask(const bool b) : Mask(from_bits(b ? lanes : 0u)) {}
+    explicit Mask(const Type val) : m(val) {}
+
+    static Mask from_bits(const uint32_t b) {
+        if constexpr (!vectorized || std::is_integral_v<Type>)
+            return Mask(static_cast<Type>(b & lanes));
+        else {
+            using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+            VecType tmp;
+            for (uint32_t l = 0; l < N; ++l)
+                tmp[l] = std::bit_cast<T>((b >> l) & 1 ? ~Bits(0) : Bits(0));
+            return Mask(std::bit_cast<Type>(tmp.m));
+        }
+    }
+
+    // The first n lanes, for the tail of an array
+    static Mask first_n(const uint32_t n) {
+        return from_bits(n < 32 ? (1u << n) - 1 : ~0u);
+    }
+
+    // Lane l in bit l
+    inline uint32_t bits() const {
+        if constexpr (vectorized)
+            return math_impl::packet_ops<Register>::bits(m) & lanes;
+        else
+            return m;
+    }
+
+    inline bool operator [](const uint32_t l) const { return (bits() >> l) & 1; }
+    inline bool all() const { return bits() == lanes; }
+    inline bool any() const { return bits() != 0; }
+    inline bool none() const { return bits() == 0; }
+    inline uint32_t count() const { return std::popcount(bits()); }
+    // Lowest active lane, N when there is none
+    inline uint32_t first() const {
+        const uint32_t b = bits();
+        return b ? std::countr_zero(b) : N;
+    }
+
+    // Logic ops, ~ only flips the N lanes
+    inline Mask operator &(const Mask& b) const {
+        if constexpr (vectorized)
+            return Mask(math_impl::packet_ops<Register>::mand(m, b.m));
+        else
+            return Mask(m & b.m);
+    }
+
+    inline Mask operator |(const Mask& b) const {
+        if constexpr (vectorized)
+            return Mask(math_impl::packet_ops<Register>::mor(m, b.m));
+        else
+            return Mask(m | b.m);
+    }
+
+    inline Mask operator ^(const Mask& b) const {
+        return andnot(*this & b, *this | b);
+    }
+
+    inline Mask operator ~() const {
+        return andnot(*this, Mask(true));
+    }
+
+    inline Mask& operator &=(const Mask& b) { return *this = *this & b; }
+    inline Mask& operator |=(const Mask& b) { return *this = *this | b; }
+    inline Mask& operator ^=(const Mask& b) { return *this = *this ^ b; }
+
+    // ~a & b
+    static inline Mask andnot(const Mask& a, const Mask& b) {
+        if constexpr (vectorized)
+            return Mask(math_impl::packet_ops<Register>::mandnot(a.m, b.m));
+        else
+            return Mask(~a.m & b.m);
+    }
+
+    // Same lanes, not same register bits
+    inline bool operator ==(const Mask& b) const { return bits() == b.bits(); }
+    inline bool operator !=(const Mask& b) const { return bits() != b.bits(); }
+};
+
+// Compares
+#define YAVL_DEFINE_MASK_CMP(NAME, OP)                                  \
+    template <typename T, uint32_t N>                                   \
+    inline Mask<T, N> NAME(const Vec<T, N>& a, const Vec<T, N>& b) {    \
+        using M = Mask<T, N>;                                           \
+        if constexpr (M::vectorized)                                    \
+            return M(math_impl::packet_ops<typename M::Register>::NAME(a.m, b.m)); \
+        else {                                                          \
+            uint32_t r = 0;                                             \
+            for (uint32_t l = 0; l < N; ++l)                            \
+                r |= static_cast<uint32_t>(a[l] OP b[l]) << l;          \
+            return M(r);                                                \
+        }                                                               \
+    }                                                                   \
+    template <typename T, uint32_t N>                                   \
+    inline Mask<T, N> operator OP(const Vec<T, N>& a, const Vec<T, N>& b) { \
+        return NAME(a, b);                                              \
+    }
+
+YAVL_DEFINE_MASK_CMP(lt, <)
+YAVL_DEFINE_MASK_CMP(le, <=)
+YAVL_DEFINE_MASK_CMP(gt, >)
+YAVL_DEFINE_MASK_CMP(ge, >=)
+
+#undef YAVL_DEFINE_MASK_CMP
+
+// Exact lane equality, operator == stays the epsilon compare of the whole
+// Vec
+template <typename T, uint32_t N>
+inline Mask<T, N> eq(const Vec<T, N>& a, const Vec<T, N>& b) {
+    using M = Mask<T, N>;
+    if constexpr (M::vectorized)
+        return M(math_impl::packet_ops<typename M::Register>::eq(a.m, b.m));
+    else {
+        uint32_t r = 0;
+        for (uint32_t l = 0; l < N; ++l)
+            r |= static_cast<uint32_t>(a[l] == b[l]) << l;
+        return M(r);
+    }
+}
+
+// True on NaN lanes
+template <typename T, uint32_t N>
+inline Mask<T, N> neq(const Vec<T, N>& a, const Vec<T, N>& b) {
+    return ~eq(a, b);
+}
+
+// m ? a : b lane by lane
+template <typename T, uint32_t N>
+inline Vec<T, N> select(const Mask<T, N>& m, const Vec<T, N>& a, const Vec<T, N>& b) {
+    using M = Mask<T, N>;
+    if constexpr (M::vectorized)
+        return Vec<T, N>(math_impl::packet_ops<typename M::Register>::select(m.m, a.m, b.m));
+    else {
+        Vec<T, N> ret;
+        for (uint32_t l = 0; l < N; ++l)
+            ret[l] = (m.m >> l) & 1 ? a[l] : b[l];
+        return ret;
+    }
+}
+
+// Active lanes from p[l], zero in the others
+template <typename T, uint32_t N>
+inline Vec<T, N> masked_load(const T* p, const Mask<T, N>& m) {
+    using M = Mask<T, N>;
+    using R = typename M::Register;
+    if constexpr (mask_impl::has_maskload<T, typename M::Type, R>)
+        return Vec<T, N>(mask_impl::maskload(p, (m & M(true)).m));
+    else {
+        Vec<T, N> ret(static_cast<T>(0));
+        for (uint32_t b = m.bits(); b; b &= b - 1)
+            ret[std::countr_zero(b)] = p[std::countr_zero(b)];
+        return ret;
+    }
+}
+
+// Active lanes to p[l], the others are left alone
+template <typename T, uint32_t N>
+inline void masked_store(T* p, const Vec<T, N>& v, const Mask<T, N>& m) {
+    using M = Mask<T, N>;
+    if constexpr (mask_impl::has_maskstore<T, typename M::Type, typename M::Register>)
+        mask_impl::maskstore(p, (m & M(true)).m, v.m);
+    else {
+        for (uint32_t b = m.bits(); b; b &= b - 1)
+            p[std::countr_zero(b)] = v[std::countr_zero(b)];
+    }
+}
+
+// Active lanes to p[0], p[1]... in lane order, returns how many
+template <typename T, uint32_t N>
+inline uint32_t compress_store(T* p, const Vec<T, N>& v, const Mask<T, N>& m) {
+    using M = Mask<T, N>;
+    const uint32_t b = m.bits();
+    if constexpr (mask_impl::has_compressstore<T, typename M::Register>)
+        mask_impl::compressstore(p, b, v.m);
+    else {
+        uint32_t k = 0;
+        for (uint32_t r = b; r; r &= r - 1)
+            p[k++] = v[std::countr_zero(r)];
+    }
+    return std::popcount(b);
+}
+
+// first + l of the active lanes l, the indices of the survivors when the
+// Vec holds elements first to first + N - 1 of an array
+template <typename T, uint32_t N>
+inline uint32_t compress_indices(uint32_t* p, const uint32_t first, const Mask<T, N>& m) {
+    const uint32_t b = m.bits();
+#if defined(YAVL_X86_AVX512F)
+    if constexpr (N <= 16) {
+        const __m512i idx = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(first)),
+            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+        _mm512_mask_compressstoreu_epi32(p, static_cast<__mmask16>(b), idx);
+        return std::popcount(b);
+    }
+#endif
+    uint32_t k = 0;
+    for (uint32_t r = b; r; r &= r - 1)
+        p[k++] = first + std::countr_zero(r);
+    return k;
+}
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
@@ -0,0 +1,1364 @@
+#pragma once
+
+// Vectorized transcendental functions for Vec<float, N> and Vec<double, N>.
+//
+// Every function is written once against packet_ops<P>, a thin static wrapper
+// around one register type(or a plain scalar), and instantiated for float,
+// double and each register width the build has. A Vec is processed in the
+// widest packets that fit its lanes, falling back to narrower ones and then
+// to the scalar instantiation, which runs the same polynomials so results
+// don't depend on the lane a value sits in.
+//
+// Range reductions and polynomials are the Cephes(float) and fdlibm(double)
+// ones. Error bounds are measured against <cmath>(float results against the
+// double precision call rounded to float) by tests/vec_math_tests.cpp and
+// are listed on each function. Subnormal results may lose a few more bits.
+//
+// The 256 bit paths need AVX2 for the integer exponent tricks, AVX only
+// builds use the 128 bit path. On aarch64 the 128 bit path is NEON.
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+namespace math_impl
+{
+
+template <typename P>
+struct packet_ops;
+
+template <typename T>
+struct scalar_packet_ops {
+    using Scalar = T;
+    using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    using Mask = bool;
+    static constexpr uint32_t Width = 1;
+
+    static inline T set1(const T s) { return s; }
+    static inline T set1_bits(const Bits b) { return std::bit_cast<T>(b); }
+    static inline T loadu(const T* p) { return *p; }
+    static inline void storeu(T* p, const T a) { *p = a; }
+
+    static inline T add(const T a, const T b) { return a + b; }
+    static inline T sub(const T a, const T b) { return a - b; }
+    static inline T mul(const T a, const T b) { return a * b; }
+    static inline T div(const T a, const T b) { return a / b; }
+    // 1 / a with the accuracy of Vec::rcp<P>()
+    template <precision P>
+    static inline T rcp(const T a) { return T(1) / a; }
+    // a * b + c
+    static inline T fmadd(const T a, const T b, const T c) { return a * b + c; }
+    // c - a * b
+    static inline T fnmadd(const T a, const T b, const T c) { return c - a * b; }
+    // a * b - c
+    static inline T fmsub(const T a, const T b, const T c) { return a * b - c; }
+    static inline T min(const T a, const T b) { return a < b ? a : b; }
+    static inline T max(const T a, const T b) { return a > b ? a : b; }
+    static inline T abs(const T a) { return std::abs(a); }
+    static inline T sqrt(const T a) { return std::sqrt(a); }
+    static inline T round(const T a) { return std::nearbyint(a); }
+
+    static inline T and_(const T a, const T b) {
+        return std::bit_cast<T>(std::bit_cast<Bits>(a) & std::bit_cast<Bits>(b));
+    }
+    static inline T or_(const T a, const T b) {
+        return std::bit_cast<T>(std::bit_cast<Bits>(a) | std::bit_cast<Bits>(b));
+    }
+    static inline T xor_(const T a, const T b) {
+        return std::bit_cast<T>(std::bit_cast<Bits>(a) ^ std::bit_cast<Bits>(b));
+    }
+    template <int K>
+    static inline T shl(const T a) {
+        return std::bit_cast<T>(static_cast<Bits>(std::bit_cast<Bits>(a) << K));
+    }
+    template <int K>
+    static inline T shr(const T a) {
+        return std::bit_cast<T>(static_cast<Bits>(std::bit_cast<Bits>(a) >> K));
+    }
+
+    static inline Mask lt(const T a, const T b) { return a < b; }
+    static inline Mask gt(const T a, const T b) { return a > b; }
+    static inline Mask le(const T a, const T b) { return a <= b; }
+    static inline Mask ge(const T a, const T b) { return a >= b; }
+    static inline Mask eq(const T a, const T b) { return a == b; }
+    static inline Mask isnan(const T a) { return a != a; }
+    static inline Mask mand(const Mask a, const Mask b) { return a && b; }
+    static inline Mask mor(const Mask a, const Mask b) { return a || b; }
+    static inline Mask mandnot(const Mask a, const Mask b) { return !a && b; }
+    // Lane l of the mask in bit l
+    static inline uint32_t bits(const Mask m) { return m; }
+
+    // m ? a : b
+    static inline T select(const Mask m, const T a, const T b) { return m ? a : b; }
+    // Sign bit of s set ? a : b
+    static inline T select_sign(const T s, const T a, const T b) {
+        return std::signbit(s) ? a : b;
+    }
+};
+
+template <>
+struct packet_ops<float> : scalar_packet_ops<float> {};
+
+template <>
+struct packet_ops<double> : scalar_packet_ops<double> {};
+
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+
+// Shared by the SSE and AVX packets, they only differ in compares
+#define YAVL_DEFINE_PACKET_OPS(PT, T, BITS, SIBITS, IT, II)             \
+    using Scalar = T;                                                   \
+    using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>; \
+    using Mask = PT;                                                    \
+    static constexpr uint32_t Width = sizeof(PT) / sizeof(T);           \
+    static inline PT set1(const T s) { return _mm##BITS##_set1_##IT(s); } \
+    static inline PT set1_bits(const Bits b) {                          \
+        return set1(std::bit_cast<T>(b));                               \
+    }                                                                   \
+    static inline PT loadu(const T* p) { return _mm##BITS##_loadu_##IT(p); } \
+    static inline void storeu(T* p, const PT a) { _mm##BITS##_storeu_##IT(p, a); } \
+    static inline PT add(const PT a, const PT b) { return _mm##BITS##_add_##IT(a, b); } \
+    static inline PT sub(const PT a, const PT b) { return _mm##BITS##_sub_##IT(a, b); } \
+    static inline PT mul(const PT a, const PT b) { return _mm##BITS##_mul_##IT(a, b); } \
+    static inline PT div(const PT a, const PT b) { return _mm##BITS##_div_##IT(a, b); } \
+    static inline PT fmadd(const PT a, const PT b, const PT c) {        \
+        return MULADD(BITS, IT, a, b, c);                               \
+    }                                                                   \
+    static inline PT fnmadd(const PT a, const PT b, const PT c) {       \
+        return FNMADD(BITS, IT, a, b, c);                               \
+    }                                                                   \
+    static inline PT fmsub(const PT a, const PT b, const PT c) {        \
+        return MULSUB(BITS, IT, a, b, c);                               \
+    }                                                                   \
+    static inline PT min(const PT a, const PT b) { return _mm##BITS##_min_##IT(a, b); } \
+    static inline PT max(const PT a, const PT b) { return _mm##BITS##_max_##IT(a, b); } \
+    static inline PT abs(const PT a) {                                  \
+        return _mm##BITS##_andnot_##IT(set1(static_cast<T>(-0.)), a);   \
+    }                                                                   \
+    static inline PT sqrt(const PT a) { return _mm##BITS##_sqrt_##IT(a); } \
+    static inline PT round(const PT a) {                                \
+        return _mm##BITS##_round_##IT(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); \
+    }                                                                   \
+    static inline PT and_(const PT a, const PT b) { return _mm##BITS##_and_##IT(a, b); } \
+    static inline PT or_(const PT a, const PT b) { return _mm##BITS##_or_##IT(a, b); } \
+    static inline PT xor_(const PT a, const PT b) { return _mm##BITS##_xor_##IT(a, b); } \
+    template <int K>                                                    \
+    static inline PT shl(const PT a) {                                  \
+        return _mm##BITS##_castsi##SIBITS##_##IT(                       \
+            _mm##BITS##_slli_##II(_mm##BITS##_cast##IT##_si##SIBITS(a), K)); \
+    }                                                                   \
+    template <int K>                                                    \
+    static inline PT shr(const PT a) {                                  \
+        return _mm##BITS##_castsi##SIBITS##_##IT(                       \
+            _mm##BITS##_srli_##II(_mm##BITS##_cast##IT##_si##SIBITS(a), K)); \
+    }                                                                   \
+    static inline Mask mand(const Mask a, const Mask b) { return and_(a, b); } \
+    static inline Mask mor(const Mask a, const Mask b) { return or_(a, b); } \
+    static inline Mask mandnot(const Mask a, const Mask b) {            \
+        return _mm##BITS##_andnot_##IT(a, b);                           \
+    }                                                                   \
+    static inline uint32_t bits(const Mask m) {                         \
+        return static_cast<uint32_t>(_mm##BITS##_movemask_##IT(m));     \
+    }                                                                   \
+    static inline PT select(const Mask m, const PT a, const PT b) {     \
+        return _mm##BITS##_blendv_##IT(b, a, m);                        \
+    }                                                                   \
+    static inline PT select_sign(const PT s, const PT a, const PT b) {  \
+        return _mm##BITS##_blendv_##IT(b, a, s);                        \
+    }
+
+#if defined(YAVL_X86_FMA)
+#define FNMADD(BITS, IT, A, B, C) _mm##BITS##_fnmadd_##IT(A, B, C)
+#else
+#define FNMADD(BITS, IT, A, B, C) _mm##BITS##_sub_##IT(C, _mm##BITS##_mul_##IT(A, B))
+#endif
+
+#if defined(YAVL_X86_SSE42)
+
+#define YAVL_DEFINE_SSE_PACKET_CMP(PT, IT)                              \
+    static inline Mask lt(const PT a, const PT b) { return _mm_cmplt_##IT(a, b); } \
+    static inline Mask gt(const PT a, const PT b) { return _mm_cmpgt_##IT(a, b); } \
+    static inline Mask le(const PT a, const PT b) { return _mm_cmple_##IT(a, b); } \
+    static inline Mask ge(const PT a, const PT b) { return _mm_cmpge_##IT(a, b); } \
+    static inline Mask eq(const PT a, const PT b) { return _mm_cmpeq_##IT(a, b); } \
+    static inline Mask isnan(const PT a) { return _mm_cmpunord_##IT(a, a); }
+
+template <>
+struct packet_ops<__m128> {
+    YAVL_DEFINE_PACKET_OPS(__m128, float, , 128, ps, epi32)
+    YAVL_DEFINE_SSE_PACKET_CMP(__m128, ps)
+    template <precision P>
+    static inline __m128 rcp(const __m128 a) { return rcp_ps_impl<P>(a); }
+};
+
+template <>
+struct packet_ops<__m128d> {
+    YAVL_DEFINE_PACKET_OPS(__m128d, double, , 128, pd, epi64)
+    YAVL_DEFINE_SSE_PACKET_CMP(__m128d, pd)
+    template <precision P>
+    static inline __m128d rcp(const __m128d a) { return rcp_pd_impl<P>(a); }
+};
+
+#undef YAVL_DEFINE_SSE_PACKET_CMP
+
+#endif
+
+#if defined(YAVL_X86_AVX2)
+
+#define YAVL_DEFINE_AVX_PACKET_CMP(PT, IT)                              \
+    static inline Mask lt(const PT a, const PT b) {                     \
+        return _mm256_cmp_##IT(a, b, _CMP_LT_OQ);                       \
+    }                                                                   \
+    static inline Mask gt(const PT a, const PT b) {                     \
+        return _mm256_cmp_##IT(a, b, _CMP_GT_OQ);                       \
+    }                                                                   \
+    static inline Mask le(const PT a, const PT b) {                     \
+        return _mm256_cmp_##IT(a, b, _CMP_LE_OQ);                       \
+    }                                                                   \
+    static inline Mask ge(const PT a, const PT b) {                     \
+        return _mm256_cmp_##IT(a, b, _CMP_GE_OQ);                       \
+    }                                                                   \
+    static inline Mask eq(const PT a, const PT b) {                     \
+        return _mm256_cmp_##IT(a, b, _CMP_EQ_OQ);                       \
+    }                                                                   \
+    static inline Mask isnan(const PT a) {                              \
+        return _mm256_cmp_##IT(a, a, _CMP_UNORD_Q);                     \
+    }
+
+template <>
+struct packet_ops<__m256> {
+    YAVL_DEFINE_PACKET_OPS(__m256, float, 256, 256, ps, epi32)
+    YAVL_DEFINE_AVX_PACKET_CMP(__m256, ps)
+    template <precision P>
+    static inline __m256 rcp(const __m256 a) { return rcp_ps_impl<P>(a); }
+};
+
+template <>
+struct packet_ops<__m256d> {
+    YAVL_DEFINE_PACKET_OPS(__m256d, double, 256, 256, pd, epi64)
+    YAVL_DEFINE_AVX_PACKET_CMP(__m256d, pd)
+    template <precision P>
+    static inline __m256d rcp(const __m256d a) { return rcp_pd_impl<4, P>(a); }
+};
+
+#undef YAVL_DEFINE_AVX_PACKET_CMP
+
+#endif
+
+#undef YAVL_DEFINE_PACKET_OPS
+
+#if defined(YAVL_X86_AVX512F)
+
+// k masks leave their register through kmov. GCC 12 may instead spill the
+// zero extended mask with a 16 bit kmovw store and reload it with a 32 bit
+// load, leaving stack bytes in the upper bits. The empty asm pins the value
+// to a general register, where kmovw zero extends
+template <typename M>
+static inline uint32_t kmask_bits(const M m) {
+    uint32_t r = _cvtmask16_u32(m);
+#if defined(__GNUC__)
+    __asm__("" : "+r"(r));
+#endif
+    return r;
+}
+
+// AVX-512 compares produce k masks and the float logic ops need DQ, so bit
+// manipulation goes through the integer domain
+#define YAVL_DEFINE_AVX512_PACKET_OPS(PT, T, IT, II, MT)                \
+    using Scalar = T;                                                   \
+    using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>; \
+    using Mask = MT;                                                    \
+    static constexpr uint32_t Width = sizeof(PT) / sizeof(T);           \
+    static inline PT set1(const T s) { return _mm512_set1_##IT(s); }    \
+    static inline PT set1_bits(const Bits b) {                          \
+        return set1(std::bit_cast<T>(b));                               \
+    }                                                                   \
+    static inline PT loadu(const T* p) { return _mm512_loadu_##IT(p); } \
+    static inline void storeu(T* p, const PT a) { _mm512_storeu_##IT(p, a); } \
+    /* Masked tails of n < Width lanes */                             \
+    static inline Mask first_n(const uint32_t n) {                      \
+        return static_cast<Mask>((1u << n) - 1);                        \
+    }                                                                   \
+    static inline PT loadu_n(const T* p, const uint32_t n) {            \
+        return _mm512_maskz_loadu_##IT(first_n(n), p);                  \
+    }                                                                   \
+    static inline void storeu_n(T* p, const PT a, const uint32_t n) {   \
+        _mm512_mask_storeu_##IT(p, first_n(n), a);                      \
+    }                                                                   \
+    static inline PT add(const PT a, const PT b) { return _mm512_add_##IT(a, b); } \
+    static inline PT sub(const PT a, const PT b) { return _mm512_sub_##IT(a, b); } \
+    static inline PT mul(const PT a, const PT b) { return _mm512_mul_##IT(a, b); } \
+    static inline PT div(const PT a, const PT b) { return _mm512_div_##IT(a, b); } \
+    static inline PT fmadd(const PT a, const PT b, const PT c) {        \
+        return _mm512_fmadd_##IT(a, b, c);                              \
+    }                                                                   \
+    static inline PT fnmadd(const PT a, const PT b, const PT c) {       \
+        return _mm512_fnmadd_##IT(a, b, c);                             \
+    }                                                                   \
+    static inline PT fmsub(const PT a, const PT b, const PT c) {        \
+        return _mm512_fmsub_##IT(a, b, c);                              \
+    }                                                                   \
+    static inline PT min(const PT a, const PT b) { return _mm512_min_##IT(a, b); } \
+    static inline PT max(const PT a, const PT b) { return _mm512_max_##IT(a, b); } \
+    static inline PT abs(const PT a) { return _mm512_abs_##IT(a); }     \
+    static inline PT sqrt(const PT a) { return _mm512_sqrt_##IT(a); }   \
+    static inline PT round(const PT a) {                                \
+        return _mm512_roundscale_##IT(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); \
+    }                                                                   \
+    static inline PT and_(const PT a, const PT b) {                     \
+        return _mm512_castsi512_##IT(_mm512_and_si512(                  \
+            _mm512_cast##IT##_si512(a), _mm512_cast##IT##_si512(b)));   \
+    }                                                                   \
+    static inline PT or_(const PT a, const PT b) {                      \
+        return _mm512_castsi512_##IT(_mm512_or_si512(                   \
+            _mm512_cast##IT##_si512(a), _mm512_cast##IT##_si512(b)));   \
+    }                                                                   \
+    static inline PT xor_(const PT a, const PT b) {                     \
+        return _mm512_castsi512_##IT(_mm512_xor_si512(                  \
+            _mm512_cast##IT##_si512(a), _mm512_cast##IT##_si512(b)));   \
+    }                                                                   \
+    template <int K>                                                    \
+    static inline PT shl(const PT a) {                                  \
+        return _mm512_castsi512_##IT(                                   \
+            _mm512_slli_##II(_mm512_cast##IT##_si512(a), K));           \
+    }                                                                   \
+    template <int K>                                                    \
+    static inline PT shr(const PT a) {                                  \
+        return _mm512_castsi512_##IT(                                   \
+            _mm512_srli_##II(_mm512_cast##IT##_si512(a), K));           \
+    }                                                                   \
+    static inline Mask lt(const PT a, const PT b) {                     \
+        return _mm512_cmp_##IT##_mask(a, b, _CMP_LT_OQ);                \
+    }                                                                   \
+    static inline Mask gt(const PT a, const PT b) {                     \
+        return _mm512_cmp_##IT##_mask(a, b, _CMP_GT_OQ);                \
+    }                                                                   \
+    static inline Mask le(const PT a, const PT b) {                     \
+        return _mm512_cmp_##IT##_mask(a, b, _CMP_LE_OQ);                \
+    }                                                                   \
+    static inline Mask ge(const PT a, const PT b) {                     \
+        return _mm512_cmp_##IT##_mask(a, b, _CMP_GE_OQ);                \
+    }                                                                   \
+    static inline Mask eq(const PT a, const PT b) {                     \
+        return _mm512_cmp_##IT##_mask(a, b, _CMP_EQ_OQ);                \
+    }                                                                   \
+    static inline Mask isnan(const PT a) {                              \
+        return _mm512_cmp_##IT##_mask(a, a, _CMP_UNORD_Q);              \
+    }                                                                   \
+    static inline Mask mand(const Mask a, const Mask b) { return a & b; } \
+    static inline Mask mor(const Mask a, const Mask b) { return a | b; } \
+    static inline Mask mandnot(const Mask a, const Mask b) { return ~a & b; } \
+    static inline uint32_t bits(const Mask m) { return kmask_bits(m); } \
+    static inline PT select(const Mask m, const PT a, const PT b) {     \
+        return _mm512_mask_blend_##IT(m, b, a);                         \
+    }                                                                   \
+    static inline PT select_sign(const PT s, const PT a, const PT b) {  \
+        auto sbits = _mm512_cast##IT##_si512(s);                        \
+        auto m = _mm512_test_##II##_mask(sbits,                         \
+            _mm512_cast##IT##_si512(set1(static_cast<T>(-0.))));        \
+        return select(m, a, b);                                         \
+    }
+
+template <>
+struct packet_ops<__m512> {
+    YAVL_DEFINE_AVX512_PACKET_OPS(__m512, float, ps, epi32, __mmask16)
+    template <precision P>
+    static inline __m512 rcp(const __m512 a) { return rcp_ps_impl<P>(a); }
+};
+
+template <>
+struct packet_ops<__m512d> {
+    YAVL_DEFINE_AVX512_PACKET_OPS(__m512d, double, pd, epi64, __mmask8)
+    template <precision P>
+    static inline __m512d rcp(const __m512d a) { return rcp_pd_impl<P>(a); }
+};
+
+#undef YAVL_DEFINE_AVX512_PACKET_OPS
+
+#endif
+
+#if defined(YAVL_ARM_NEON)
+
+// NEON compares produce integer lane masks, the bit ops go through the
+// integer registers. min and max are selects, vminq/vmaxq return NaN for
+// any NaN operand where the x86 versions return the second one, which the
+// functions here rely on
+#define YAVL_DEFINE_NEON_PACKET_OPS(PT, T, IT, UT, ST, MT)              \
+    using Scalar = T;                                                   \
+    using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>; \
+    using Mask = MT;                                                    \
+    static constexpr uint32_t Width = sizeof(PT) / sizeof(T);           \
+    static inline PT set1(const T s) { return vdupq_n_##IT(s); }        \
+    static inline PT set1_bits(const Bits b) {                          \
+        return vreinterpretq_##IT##_##UT(vdupq_n_##UT(b));              \
+    }                                                                   \
+    static inline PT loadu(const T* p) { return vld1q_##IT(p); }        \
+    static inline void storeu(T* p, const PT a) { vst1q_##IT(p, a); }   \
+    static inline PT add(const PT a, const PT b) { return vaddq_##IT(a, b); } \
+    static inline PT sub(const PT a, const PT b) { return vsubq_##IT(a, b); } \
+    static inline PT mul(const PT a, const PT b) { return vmulq_##IT(a, b); } \
+    static inline PT div(const PT a, const PT b) { return vdivq_##IT(a, b); } \
+    static inline PT fmadd(const PT a, const PT b, const PT c) {        \
+        return vfmaq_##IT(c, a, b);                                     \
+    }                                                                   \
+    static inline PT fnmadd(const PT a, const PT b, const PT c) {       \
+        return vfmsq_##IT(c, a, b);                                     \
+    }                                                                   \
+    static inline PT fmsub(const PT a, const PT b, const PT c) {        \
+        return vnegq_##IT(vfmsq_##IT(c, a, b));                         \
+    }                                                                   \
+    static inline PT min(const PT a, const PT b) { return vbslq_##IT(vcltq_##IT(a, b), a, b); } \
+    static inline PT max(const PT a, const PT b) { return vbslq_##IT(vcgtq_##IT(a, b), a, b); } \
+    static inline PT abs(const PT a) { return vabsq_##IT(a); }          \
+    static inline PT sqrt(const PT a) { return vsqrtq_##IT(a); }        \
+    static inline PT round(const PT a) { return vrndnq_##IT(a); }       \
+    static inline PT and_(const PT a, const PT b) {                     \
+        return vreinterpretq_##IT##_##UT(vandq_##UT(                    \
+            vreinterpretq_##UT##_##IT(a), vreinterpretq_##UT##_##IT(b))); \
+    }                                                                   \
+    static inline PT or_(const PT a, const PT b) {                      \
+        return vreinterpretq_##IT##_##UT(vorrq_##UT(                    \
+            vreinterpretq_##UT##_##IT(a), vreinterpretq_##UT##_##IT(b))); \
+    }                                                                   \
+    static inline PT xor_(const PT a, const PT b) {                     \
+        return vreinterpretq_##IT##_##UT(veorq_##UT(                    \
+            vreinterpretq_##UT##_##IT(a), vreinterpretq_##UT##_##IT(b))); \
+    }                                                                   \
+    template <int K>                                                    \
+    static inline PT shl(const PT a) {                                  \
+        return vreinterpretq_##IT##_##UT(                               \
+            vshlq_n_##UT(vreinterpretq_##UT##_##IT(a), K));             \
+    }                                                                   \
+    template <int K>                                                    \
+    static inline PT shr(const PT a) {                                  \
+        return vreinterpretq_##IT##_##UT(                               \
+            vshrq_n_##UT(vreinterpretq_##UT##_##IT(a), K));             \
+    }                                                                   \
+    static inline Mask lt(const PT a, const PT b) { return vcltq_##IT(a, b); } \
+    static inline Mask gt(const PT a, const PT b) { return vcgtq_##IT(a, b); } \
+    static inline Mask le(const PT a, const PT b) { return vcleq_##IT(a, b); } \
+    static inline Mask ge(const PT a, const PT b) { return vcgeq_##IT(a, b); } \
+    static inline Mask eq(const PT a, const PT b) { return vceqq_##IT(a, b); } \
+    static inline Mask isnan(const PT a) {                              \
+        return veorq_##UT(vceqq_##IT(a, a), vdupq_n_##UT(~Bits(0)));    \
+    }                                                                   \
+    static inline Mask mand(const Mask a, const Mask b) { return vandq_##UT(a, b); } \
+    static inline Mask mor(const Mask a, const Mask b) { return vorrq_##UT(a, b); } \
+    static inline Mask mandnot(const Mask a, const Mask b) { return vbicq_##UT(b, a); } \
+    static inline uint32_t bits(const Mask m) {                         \
+        Bits lanes[Width];                                              \
+        vst1q_##UT(lanes, m);                                           \
+        uint32_t r = 0;                                                 \
+        for (uint32_t l = 0; l < Width; ++l)                            \
+            r |= static_cast<uint32_t>(lanes[l] & 1) << l;              \
+        return r;                                                       \
+    }                                                                   \
+    static inline PT select(const Mask m, const PT a, const PT b) {     \
+        return vbslq_##IT(m, a, b);                                     \
+    }                                                                   \
+    static inline PT select_sign(const PT s, const PT a, const PT b) {  \
+        /* Arithmetic shift spreads the sign bit over the lane */       \
+        auto m = vreinterpretq_##UT##_##ST(vshrq_n_##ST(                \
+            vreinterpretq_##ST##_##IT(s), sizeof(T) * 8 - 1));          \
+        return select(m, a, b);                                         \
+    }
+
+template <>
+struct packet_ops<float32x4_t> {
+    YAVL_DEFINE_NEON_PACKET_OPS(float32x4_t, float, f32, u32, s32, uint32x4_t)
+    template <precision P>
+    static inline float32x4_t rcp(const float32x4_t a) { return rcp_f32_impl<P>(a); }
+};
+
+template <>
+struct packet_ops<float64x2_t> {
+    YAVL_DEFINE_NEON_PACKET_OPS(float64x2_t, double, f64, u64, s64, uint64x2_t)
+    template <precision P>
+    static inline float64x2_t rcp(const float64x2_t a) { return rcp_f64_impl<P>(a); }
+};
+
+#undef YAVL_DEFINE_NEON_PACKET_OPS
+
+#endif
+
+#undef FNMADD
+
+#endif // YAVL_DISABLE_VECTORIZATION
+
+// Horner evaluation, coefficients from the highest degree down
+template <typename O, typename P>
+static inline P horner(const P, const P acc) {
+    return acc;
+}
+
+template <typename O, typename P, typename... Cs>
+static inline P horner(const P x, const P acc, const typename O::Scalar c,
+    const Cs... cs)
+{
+    return horner<O>(x, O::fmadd(acc, x, O::set1(c)), cs...);
+}
+
+template <typename O, typename P, typename... Cs>
+static inline P poly(const P x, const typename O::Scalar c, const Cs... cs) {
+    return horner<O>(x, O::set1(c), cs...);
+}
+
+template <typename P>
+static inline P copysign_impl(const P mag, const P sgn) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    auto sign_mask = O::set1(static_cast<T>(-0.));
+    return O::or_(O::abs(mag), O::and_(sgn, sign_mask));
+}
+
+// Exact product, a * b = hi + lo
+template <typename P>
+static inline P two_prod(const P a, const P b, P& lo) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    auto hi = O::mul(a, b);
+#if (defined(YAVL_X86_FMA) || defined(YAVL_ARM_NEON)) && !defined(YAVL_DISABLE_VECTORIZATION)
+    if constexpr (!std::is_floating_point_v<P>) {
+        lo = O::fmadd(a, b, O::sub(O::set1(T(0)), hi));
+        return hi;
+    }
+#endif
+    // Dekker's splitting
+    constexpr T split = sizeof(T) == 4 ? 4097. : 134217729.;
+    auto split_hi = [&](const P v) {
+        auto c = O::mul(O::set1(split), v);
+        return O::sub(c, O::sub(c, v));
+    };
+    auto ah = split_hi(a), bh = split_hi(b);
+    auto al = O::sub(a, ah), bl = O::sub(b, bh);
+    lo = O::add(O::add(O::add(O::sub(O::mul(ah, bh), hi), O::mul(ah, bl)),
+        O::mul(al, bh)), O::mul(al, bl));
+    return hi;
+}
+
+// 2^n for integral n in the normal exponent range, n + magic puts n in
+// the low mantissa bits and the shift moves it into the exponent field
+template <typename P>
+static inline P pow2n(const P n) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    if constexpr (sizeof(T) == 4)
+        return O::template shl<23>(O::add(n, O::set1(T(8388608. + 127.))));
+    else
+        return O::template shl<52>(O::add(n, O::set1(T(4503599627370496. + 1023.))));
+}
+
+// v * 2^n for n in twice the normal exponent range
+template <typename P>
+static inline P scale_pow2(const P v, const P n) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    auto n1 = O::round(O::mul(n, O::set1(T(0.5))));
+    auto n2 = O::sub(n, n1);
+    return O::mul(O::mul(v, pow2n(n1)), pow2n(n2));
+}
+
+// exp(hi - lo) for |hi - lo| <= ln2 / 2, fdlibm's kernel
+template <typename P>
+static inline P exp_reduced_f64(const P hi, const P lo) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    auto r = O::sub(hi, lo);
+    auto t = O::mul(r, r);
+    auto c = O::fnmadd(t, poly<O>(t,
+        4.13813679705723846039e-08,
+        -1.65339022054652515390e-06,
+        6.61375632143793436117e-05,
+        -2.77777777770155933842e-03,
+        1.66666666666666019037e-01), r);
+    auto rc = O::div(O::mul(r, c), O::sub(O::set1(T(2)), c));
+    return O::sub(O::set1(T(1)), O::sub(O::sub(lo, rc), hi));
+}
+
+// exp(r) for |r| <= ln2 / 2, Cephes' expf polynomial
+template <typename P>
+static inline P exp_reduced_f32(const P r) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    auto y = poly<O>(r,
+        1.9875691500E-4,
+        1.3981999507E-3,
+        8.3334519073E-3,
+        4.1665795894E-2,
+        1.6666665459E-1,
+        5.0000001201E-1);
+    return O::fmadd(y, O::mul(r, r), O::add(r, O::set1(T(1))));
+}
+
+template <typename P>
+static inline P exp_impl(const P x) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+
+    // Past these exp over/underflows anyway, clamping keeps n in the range
+    // scale_pow2 handles
+    P xc;
+    if constexpr (sizeof(T) == 4)
+        xc = O::min(O::max(x, O::set1(T(-104))), O::set1(T(89)));
+    else
+        xc = O::min(O::max(x, O::set1(T(-746))), O::set1(T(710)));
+
+    auto n = O::round(O::mul(xc, O::set1(T(1.44269504088896338700e+00))));
+    P y;
+    if constexpr (sizeof(T) == 4) {
+        auto r = O::fnmadd(n, O::set1(T(0.693359375)), xc);
+        r = O::fnmadd(n, O::set1(T(-2.12194440e-4)), r);
+        y = exp_reduced_f32(r);
+    }
+    else {
+        auto hi = O::fnmadd(n, O::set1(T(6.93147180369123816490e-01)), xc);
+        auto lo = O::mul(n, O::set1(T(1.90821492927058770002e-10)));
+        y = exp_reduced_f64(hi, lo);
+    }
+
+    y = scale_pow2(y, n);
+    return O::select(O::isnan(x), x, y);
+}
+
+template <typename P>
+static inline P exp2_impl(const P x) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+
+    P xc;
+    if constexpr (sizeof(T) == 4)
+        xc = O::min(O::max(x, O::set1(T(-151))), O::set1(T(129)));
+    else
+        xc = O::min(O::max(x, O::set1(T(-1076))), O::set1(T(1025)));
+
+    auto n = O::round(xc);
+    auto r = O::sub(xc, n);
+    P y;
+    if constexpr (sizeof(T) == 4) {
+        y = exp_reduced_f32(O::mul(r, O::set1(T(6.93147180559945309417e-01))));
+    }
+    else {
+        P lo;
+        auto hi = two_prod(r, O::set1(T(6.93147180559945309417e-01)), lo);
+        lo = O::fmadd(r, O::set1(T(2.31904681384629955842e-17)), lo);
+        y = exp_reduced_f64(hi, O::sub(O::set1(T(0)), lo));
+    }
+
+    y = scale_pow2(y, n);
+    return O::select(O::isnan(x), x, y);
+}
+
+// Split positive finite x into x = 2^e * (1 + f), 1 + f in [sqrt(0.5), sqrt(2))
+template <typename P>
+static inline P log_split(const P x, P& e) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+
+    constexpr bool is_f32 = sizeof(T) == 4;
+    constexpr T min_normal = std::numeric_limits<T>::min();
+    constexpr T subnormal_scale = is_f32 ? 8388608. : 4503599627370496.;
+    constexpr T subnormal_bias = is_f32 ? 23 : 52;
+    constexpr T magic = subnormal_scale;
+    constexpr T exp_bias = is_f32 ? 126 : 1022;
+
+    // Lift subnormals into the normal range first
+    auto subnormal = O::lt(x, O::set1(min_normal));
+    auto xs = O::select(subnormal, O::mul(x, O::set1(subnormal_scale)), x);
+
+    // Biased exponent as a float through the same magic number trick as pow2n
+    P be;
+    P m;
+    if constexpr (is_f32) {
+        be = O::sub(O::or_(O::template shr<23>(xs), O::set1(magic)), O::set1(magic));
+        m = O::or_(O::and_(xs, O::set1_bits(0x807fffffu)), O::set1(T(0.5)));
+    }
+    else {
+        be = O::sub(O::or_(O::template shr<52>(xs), O::set1(magic)), O::set1(magic));
+        m = O::or_(O::and_(xs, O::set1_bits(0x800fffffffffffffull)), O::set1(T(0.5)));
+    }
+    e = O::sub(be, O::set1(exp_bias));
+    e = O::select(subnormal, O::sub(e, O::set1(subnormal_bias)), e);
+
+    // m is in [0.5, 1) now
+    auto small = O::lt(m, O::set1(T(7.07106781186547524401e-01)));
+    m = O::select(small, O::add(m, m), m);
+    e = O::select(small, O::sub(e, O::set1(T(1))), e);
+    return O::sub(m, O::set1(T(1)));
+}
+
+template <typename P>
+static inline P log_special(const P x, const P r) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+
+    auto ret = O::select(O::eq(x, O::set1(T(0))), O::set1(-inf), r);
+    ret = O::select(O::lt(x, O::set1(T(0))), O::set1(std::numeric_limits<T>::quiet_NaN()), ret);
+    ret = O::select(O::eq(x, O::set1(inf)), x, ret);
+    return O::select(O::isnan(x), x, ret);
+}
+
+// fdlibm's log(1 + f) = f - hfsq + s * (hfsq + R), s = f / (2 + f)
+template <typename P>
+static inline void log1p_reduced_f64(const P f, P& hfsq, P& s, P& sr) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+
+    s = O::div(f, O::add(O::set1(T(2)), f));
+    auto z = O::mul(s, s);
+    auto w = O::mul(z, z);
+    auto t1 = O::mul(w, poly<O>(w,
+        1.531383769920937332e-01,
+        2.222219843214978396e-01,
+        3.999999999940941908e-01));
+    auto t2 = O::mul(z, poly<O>(w,
+        1.479819860511658591e-01,
+        1.818357216161805012e-01,
+        2.857142874366239149e-01,
+        6.666666666666735130e-01));
+    hfsq = O::mul(O::mul(O::set1(T(0.5)), f), f);
+    sr = O::mul(s, O::add(hfsq, O::add(t2, t1)));
+}
+
+// Cephes' logf, log(1 + f) - f + 0.5 * f^2
+template <typename P>
+static inline P log1p_reduced_f32(const P f) {
+    using O = packet_ops<P>;
+    auto z = O::mul(f, f);
+    return O::mul(O::mul(f, z), poly<O>(f,
+        7.0376836292E-2,
+        -1.1514610310E-1,
+        1.1676998740E-1,
+        -1.2420140846E-1,
+        1.4249322787E-1,
+        -1.6668057665E-1,
+        2.0000714765E-1,
+        -2.4999993993E-1,
+        3.3333331174E-1));
+}
+
+template <typename P>
+static inline P log_impl(const P x) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+
+    P e;
+    auto f = log_split(x, e);
+    P r;
+    if constexpr (sizeof(T) == 4) {
+        auto y = log1p_reduced_f32(f);
+        y = O::fmadd(e, O::set1(T(-2.12194440e-4)), y);
+        y = O::fnmadd(O::set1(T(0.5)), O::mul(f, f), y);
+        r = O::fmadd(e, O::set1(T(0.693359375)), O::add(f, y));
+    }
+    else {
+        P hfsq, s, sr;
+        log1p_reduced_f64(f, hfsq, s, sr);
+        auto t = O::sub(hfsq, O::fmadd(e, O::set1(T(1.90821492927058770002e-10)), sr));
+        r = O::fmadd(e, O::set1(T(6.93147180369123816490e-01)), O::sub(f, t));
+    }
+    return log_special(x, r);
+}
+
+template <typename P>
+static inline P log2_impl(const P x) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    const auto log2e = O::set1(T(1.44269504088896340736));
+
+    P e;
+    auto f = log_split(x, e);
+    P r;
+    if constexpr (sizeof(T) == 4) {
+        auto y = log1p_reduced_f32(f);
+        y = O::fnmadd(O::set1(T(0.5)), O::mul(f, f), y);
+        r = O::add(O::fmadd(y, log2e, O::mul(f, log2e)), e);
+    }
+    else {
+        P hfsq, s, sr;
+        log1p_reduced_f64(f, hfsq, s, sr);
+        // log(1 + f) as hi + lo, then times log2e in two parts
+        auto hi = O::sub(f, hfsq);
+        auto lo = O::add(O::sub(O::sub(f, hi), hfsq), sr);
+        P val_lo;
+        auto val_hi = two_prod(hi, log2e, val_lo);
+        val_lo = O::add(val_lo, O::fmadd(lo, log2e,
+            O::mul(O::add(hi, lo), O::set1(T(2.04202552036609479549e-17)))));
+        r = O::add(O::add(e, val_hi), val_lo);
+    }
+    return log_special(x, r);
+}
+
+// x = q * pi / 2 + r, |r| <= pi / 4
+template <typename P>
+static inline P trig_reduce(const P x, P& q) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+
+    q = O::round(O::mul(x, O::set1(T(6.36619772367581382433e-01))));
+    if constexpr (sizeof(T) == 4) {
+        auto r = O::fnmadd(q, O::set1(T(1.5703125)), x);
+        r = O::fnmadd(q, O::set1(T(4.837512969970703125e-4)), r);
+        return O::fnmadd(q, O::set1(T(7.54978995489188216e-8)), r);
+    }
+    else {
+        auto r = O::fnmadd(q, O::set1(T(1.57079632673412561417e+00)), x);
+        r = O::fnmadd(q, O::set1(T(6.07710050630396597660e-11)), r);
+        return O::fnmadd(q, O::set1(T(2.02226624871116645580e-21)), r);
+    }
+}
+
+template <typename P>
+static inline P sin_reduced(const P r) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    auto z = O::mul(r, r);
+    if constexpr (sizeof(T) == 4) {
+        return O::fmadd(O::mul(r, z), poly<O>(z,
+            -1.9515295891E-4,
+            8.3321608736E-3,
+            -1.6666654611E-1), r);
+    }
+    else {
+        return O::fmadd(O::mul(r, z), poly<O>(z,
+            1.58969099521155010221e-10,
+            -2.50507602534068634195e-08,
+            2.75573137070700676789e-06,
+            -1.98412698298579493134e-04,
+            8.33333333332248946124e-03,
+            -1.66666666666666324348e-01), r);
+    }
+}
+
+template <typename P>
+static inline P cos_reduced(const P r) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    auto z = O::mul(r, r);
+    const auto one = O::set1(T(1));
+    if constexpr (sizeof(T) == 4) {
+        return O::fmadd(O::mul(z, z), poly<O>(z,
+            2.443315711809948E-5,
+            -1.388731625493765E-3,
+            4.166664568298827E-2), O::fnmadd(O::set1(T(0.5)), z, one));
+    }
+    else {
+        auto p = O::mul(O::mul(z, z), poly<O>(z,
+            -1.13596475577881948265e-11,
+            2.08757232129817482790e-09,
+            -2.75573143513906633035e-07,
+            2.48015872894767294178e-05,
+            -1.38888888888741095749e-03,
+            4.16666666666666019037e-02));
+        auto hz = O::mul(O::set1(T(0.5)), z);
+        auto w = O::sub(one, hz);
+        return O::add(w, O::add(O::sub(O::sub(one, w), hz), p));
+    }
+}
+
+// Quadrant q as an integer in the low mantissa bits, valid for |q| < 2^22
+// in float and 2^51 in double
+template <typename P>
+static inline P quadrant_bits(const P q) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    if constexpr (sizeof(T) == 4)
+        return O::add(q, O::set1(T(12582912.)));
+    else
+        return O::add(q, O::set1(T(6755399441055744.)));
+}
+
+// Pick sin or cos of the reduced argument and fix the sign, bit 0 of the
+// quadrant swaps them and bit 1 flips the sign
+template <typename P>
+static inline P trig_combine(const P qb, const P s, const P c) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    constexpr int sign_bit = sizeof(T) * 8 - 1;
+    auto swap = O::template shl<sign_bit>(qb);
+    auto flip = O::and_(O::template shl<sign_bit - 1>(qb), O::set1(T(-0.)));
+    return O::xor_(O::select_sign(swap, c, s), flip);
+}
+
+template <typename P>
+static inline void sincos_impl(const P x, P& s, P& c) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    P q;
+    auto r = trig_reduce(x, q);
+    auto sr = sin_reduced(r);
+    auto cr = cos_reduced(r);
+    auto qb = quadrant_bits(q);
+    s = trig_combine(qb, sr, cr);
+    // cos(x) = sin(x + pi / 2)
+    c = trig_combine(O::add(qb, O::set1(T(1))), sr, cr);
+}
+
+template <typename P>
+static inline P sin_impl(const P x) {
+    P s, c;
+    sincos_impl(x, s, c);
+    return s;
+}
+
+template <typename P>
+static inline P cos_impl(const P x) {
+    P s, c;
+    sincos_impl(x, s, c);
+    return c;
+}
+
+template <typename P>
+static inline P tan_impl(const P x) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    constexpr int sign_bit = sizeof(T) * 8 - 1;
+    P q;
+    auto r = trig_reduce(x, q);
+    auto sr = sin_reduced(r);
+    auto cr = cos_reduced(r);
+    // Odd quadrants give -cos / sin
+    auto odd = O::template shl<sign_bit>(quadrant_bits(q));
+    auto num = O::select_sign(odd, O::xor_(cr, O::set1(T(-0.))), sr);
+    auto den = O::select_sign(odd, sr, cr);
+    return O::div(num, den);
+}
+
+template <typename P>
+static inline P atan_impl(const P x) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+
+    auto ax = O::abs(x);
+    const auto one = O::set1(T(1));
+    // atan(x) = pi / 2 + atan(-1 / x) above tan(3pi / 8) and
+    // pi / 4 + atan((x - 1) / (x + 1)) in the middle range
+    auto big = O::gt(ax, O::set1(T(2.41421356237309504880)));
+    auto mid = O::mandnot(big, O::gt(ax, O::set1(T(sizeof(T) == 4 ? 0.4142135623730950 : 0.66))));
+    auto num = O::select(big, O::set1(T(-1)), O::select(mid, O::sub(ax, one), ax));
+    auto den = O::select(big, ax, O::select(mid, O::add(ax, one), one));
+    auto xr = O::div(num, den);
+    auto y0 = O::select(big, O::set1(T(1.57079632679489661923)),
+        O::select(mid, O::set1(T(7.85398163397448309616e-01)), O::set1(T(0))));
+
+    auto z = O::mul(xr, xr);
+    P y;
+    if constexpr (sizeof(T) == 4) {
+        y = O::fmadd(O::mul(poly<O>(z,
+            8.05374449538e-2,
+            -1.38776856032E-1,
+            1.99777106478E-1,
+            -3.33329491539E-1), z), xr, xr);
+    }
+    else {
+        auto p = O::div(O::mul(z, poly<O>(z,
+            -8.750608600031904122785E-1,
+            -1.615753718733365076637E1,
+            -7.500855792314704667340E1,
+            -1.228866684490136173410E2,
+            -6.485021904942025371773E1)), poly<O>(z,
+            1.,
+            2.485846490142306297962E1,
+            1.650270098316988542046E2,
+            4.328810604912902668951E2,
+            4.853903996359136964868E2,
+            1.945506571482613964425E2));
+        y = O::fmadd(xr, p, xr);
+        // Low bits of pi / 2 and pi / 4
+        const T morebits = 6.123233995736765886130E-17;
+        y = O::add(y, O::select(big, O::set1(morebits),
+            O::select(mid, O::set1(T(0.5) * morebits), O::set1(T(0)))));
+    }
+    y = O::add(y0, y);
+    return O::xor_(y, O::and_(x, O::set1(T(-0.))));
+}
+
+template <typename P>
+static inline P atan2_impl(const P y, const P x) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+
+    auto ax = O::abs(x);
+    auto ay = O::abs(y);
+    const auto zero = O::set1(T(0));
+
+    // atan of the smaller over the larger magnitude, then fold the octant
+    auto swap = O::gt(ay, ax);
+    auto t = O::div(O::select(swap, ax, ay), O::select(swap, ay, ax));
+    // inf / inf, and 0 / 0 which needs an angle of 0
+    t = O::select(O::eq(ax, ay), O::set1(T(1)), t);
+    t = O::select(O::eq(ay, zero), zero, t);
+
+    auto a = atan_impl(t);
+    a = O::select(swap, O::add(O::sub(O::set1(T(1.57079632679489661923)), a),
+        O::set1(T(6.123233995736765886130E-17))), a);
+    a = O::select_sign(x, O::add(O::sub(O::set1(T(3.14159265358979323846)), a),
+        O::set1(T(1.2246467991473531772E-16))), a);
+    a = O::xor_(a, O::and_(y, O::set1(T(-0.))));
+    return O::select(O::mor(O::isnan(x), O::isnan(y)), O::add(x, y), a);
+}
+
+template <typename P>
+static inline P is_integer(const P v, typename packet_ops<P>::Mask& m) {
+    using O = packet_ops<P>;
+    auto r = O::round(v);
+    m = O::eq(r, v);
+    return r;
+}
+
+// Double precision only, float pow goes through it, see yavl::pow
+template <typename P>
+static inline P pow_impl(const P x, const P y) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    static_assert(sizeof(T) == 8);
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    const auto zero = O::set1(T(0));
+    const auto one = O::set1(T(1));
+
+    auto ax = O::abs(x);
+
+    // log(|x|) as hi + lo
+    P e;
+    auto f = log_split(ax, e);
+    P hfsq, s, sr;
+    log1p_reduced_f64(f, hfsq, s, sr);
+    P hfsq_lo;
+    two_prod(O::mul(O::set1(T(0.5)), f), f, hfsq_lo);
+    // f - hfsq is exact up to rounding that lands in a_lo, |f| >= hfsq
+    auto a_hi = O::sub(f, hfsq);
+    auto a_lo = O::sub(O::sub(f, a_hi), hfsq);
+    auto tail = O::add(O::sub(sr, hfsq_lo), a_lo);
+    // e * ln2_hi is exact
+    auto eh = O::mul(e, O::set1(T(6.93147180369123816490e-01)));
+    auto b_hi = O::add(eh, a_hi);
+    auto bb = O::sub(b_hi, eh);
+    auto b_lo = O::add(O::sub(eh, O::sub(b_hi, bb)), O::sub(a_hi, bb));
+    auto lo = O::add(O::add(b_lo, tail), O::mul(e, O::set1(T(1.90821492927058770002e-10))));
+    auto hi = O::add(b_hi, lo);
+    lo = O::sub(lo, O::sub(hi, b_hi));
+    hi = O::select(O::eq(ax, zero), O::set1(-inf), hi);
+    hi = O::select(O::eq(ax, O::set1(inf)), O::set1(inf), hi);
+
+    // y * log(|x|)
+    P p_lo;
+    auto p_hi = two_prod(y, hi, p_lo);
+    p_lo = O::fmadd(y, lo, p_lo);
+    auto finite = O::lt(O::abs(p_hi), O::set1(T(746)));
+    p_lo = O::select(finite, p_lo, zero);
+    p_hi = O::min(O::max(p_hi, O::set1(T(-746))), O::set1(T(710)));
+
+    // exp(p_hi + p_lo)
+    auto n = O::round(O::mul(p_hi, O::set1(T(1.44269504088896338700e+00))));
+    auto rhi = O::fnmadd(n, O::set1(T(6.93147180369123816490e-01)), p_hi);
+    auto rlo = O::fmadd(n, O::set1(T(1.90821492927058770002e-10)), O::sub(zero, p_lo));
+    auto r = scale_pow2(exp_reduced_f64(rhi, rlo), n);
+
+    // Negative base
+    typename O::Mask y_int, half_int;
+    is_integer(y, y_int);
+    is_integer(O::mul(y, O::set1(T(0.5))), half_int);
+    auto y_odd = O::mandnot(half_int, y_int);
+    r = O::select(O::mand(y_odd, O::lt(x, zero)), O::xor_(r, O::set1(T(-0.))), r);
+    // pow(-0, odd) keeps the sign
+    r = O::select(O::mand(y_odd, O::eq(x, zero)), O::or_(r, O::and_(x, O::set1(T(-0.)))), r);
+    auto neg_finite = O::mand(O::lt(x, zero), O::gt(x, O::set1(-inf)));
+    r = O::select(O::mandnot(y_int, neg_finite), O::set1(std::numeric_limits<T>::quiet_NaN()), r);
+
+    r = O::select(O::mor(O::isnan(x), O::isnan(y)), O::add(x, y), r);
+    auto y_inf = O::eq(O::abs(y), O::set1(inf));
+    auto unit = O::mor(O::eq(y, zero), O::eq(x, one));
+    unit = O::mor(unit, O::mand(y_inf, O::eq(ax, one)));
+    return O::select(unit, one, r);
+}
+
+template <typename P>
+static inline P erf_impl(const P x) {
+    using O = packet_ops<P>;
+    using T = typename O::Scalar;
+    const auto one = O::set1(T(1));
+
+    auto ax = O::abs(x);
+
+    // |x| < 0.84375, erf(x) = x + x * R(x^2)
+    auto z = O::mul(x, x);
+    auto r = poly<O>(z,
+        -2.37630166566501626084e-05,
+        -5.77027029648944159157e-03,
+        -2.84817495755985104766e-02,
+        -3.25042107247001499370e-01,
+        1.28379167095512558561e-01);
+    auto s = poly<O>(z,
+        -3.96022827877536812320e-06,
+        1.32494738004321644526e-04,
+        5.08130628187576562776e-03,
+        6.50222499887672944485e-02,
+        3.97917223959155352819e-01,
+        1.);
+    auto small = O::fmadd(x, O::div(r, s), x);
+
+    // |x| < 1.25, erf(x) = erx + P(|x| - 1) / Q(|x| - 1)
+    auto sm = O::sub(ax, one);
+    auto pa = poly<O>(sm,
+        -2.16637559486879084300e-03,
+        3.54783043256182359371e-02,
+        -1.10894694282396677476e-01,
+        3.18346619901161753674e-01,
+        -3.72207876035701323847e-01,
+        4.14856118683748331666e-01,
+        -2.36211856075265944077e-03);
+    auto qa = poly<O>(sm,
+        1.19844998467991074170e-02,
+        1.36370839120290507362e-02,
+        1.26171219808761642112e-01,
+        7.18286544141962662868e-02,
+        5.40397917702171048937e-01,
+        1.06420880400844228286e-01,
+        1.);
+    auto medium = O::add(O::set1(T(8.45062911510467529297e-01)), O::div(pa, qa));
+
+    // Otherwise erf(x) = 1 - exp(-x^2 - 0.5625 + R(1 / x^2) / S(1 / x^2)) / x
+    auto si = O::div(one, O::mul(ax, ax));
+    auto near = O::lt(ax, O::set1(T(2.85714285714285))); // 1 / 0.35
+    auto ra = poly<O>(si,
+        -9.81432934416914548592e+00,
+        -8.12874355063065934246e+01,
+        -1.84605092906711035994e+02,
+        -1.62396669462573470355e+02,
+        -6.23753324503260060396e+01,
+        -1.05586262253232909814e+01,
+        -6.93858572707181764372e-01,
+        -9.86494403484714822705e-03);
+    auto sa = poly<O>(si,
+        -6.04244152148580987438e-02,
+        6.57024977031928170135e+00,
+        1.08635005541779435134e+02,
+        4.29008140027567833386e+02,
+        6.45387271733267880336e+02,
+        4.34565877475229228821e+02,
+        1.37657754143519042600e+02,
+        1.96512716674392571292e+01,
+        1.);
+    auto rb = poly<O>(si,
+        -4.83519191608651397019e+02,
+        -1.02509513161107724954e+03,
+        -6.37566443368389627722e+02,
+        -1.60636384855821916062e+02,
+        -1.77579549177547519889e+01,
+        -7.99283237680523006574e-01,
+        -9.86494292470009928597e-03);
+    auto sb = poly<O>(si,
+        -2.24409524465858183362e+01,
+        4.74528541206955367215e+02,
+        2.55305040643316442583e+03,
+        3.19985821950859553908e+03,
+        1.53672958608443695994e+03,
+        3.25792512996573918826e+02,
+        3.03380607434824582924e+01,
+        1.);
+    auto rs = O::div(O::select(near, ra, rb), O::select(near, sa, sb));
+    // Split x^2 so the exponent stays exact
+    P zt;
+    if constexpr (sizeof(T) == 4)
+        zt = O::and_(ax, O::set1_bits(0xffffe000u));
+    else
+        zt = O::and_(ax, O::set1_bits(0xffffffff00000000ull));
+    auto ex = O::mul(
+        exp_impl(O::sub(O::mul(O::sub(O::set1(T(0)), zt), zt), O::set1(T(0.5625)))),
+        exp_impl(O::fmadd(O::sub(zt, ax), O::add(zt, ax), rs)));
+    auto large = O::sub(one, O::div(ex, ax));
+    large = O::select(O::lt(ax, O::set1(T(6))), large, one);
+
+    auto ret = O::select(O::lt(ax, O::set1(T(1.25))), medium, large);
+    ret = O::xor_(ret, O::and_(x, O::set1(T(-0.))));
+    ret = O::select(O::lt(ax, O::set1(T(0.84375))), small, ret);
+    return O::select(O::isnan(x), x, ret);
+}
+
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+
+// Register types for a scalar type at each width
+#if defined(YAVL_X86_SSE42)
+template <typename T>
+using packet128_t = std::conditional_t<sizeof(T) == 4, __m128, __m128d>;
+#elif defined(YAVL_ARM_NEON)
+template <typename T>
+using packet128_t = std::conditional_t<sizeof(T) == 4, float32x4_t, float64x2_t>;
+#endif
+
+#if defined(YAVL_X86_AVX2)
+template <typename T>
+using packet256_t = std::conditional_t<sizeof(T) == 4, __m256, __m256d>;
+#endif
+
+#if defined(YAVL_X86_AVX512F)
+template <typename T>
+using packet512_t = std::conditional_t<sizeof(T) == 4, __m512, __m512d>;
+#endif
+
+#endif // YAVL_DISABLE_VECTORIZATION
+
+// Call f.template operator()<P>(i) over count lanes, widest packets first
+template <typename T, typename F>
+static inline void for_each_packet(const uint32_t count, const F& f) {
+    uint32_t i = 0;
+    auto run = [&]<typename P>() {
+        constexpr uint32_t W = packet_ops<P>::Width;
+        for (; i + W <= count; i += W)
+            f.template operator()<P>(i);
+    };
+
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+#if defined(YAVL_X86_AVX512F)
+    run.template operator()<packet512_t<T>>();
+#endif
+#if defined(YAVL_X86_AVX2)
+    run.template operator()<packet256_t<T>>();
+#endif
+#if defined(YAVL_X86_SSE42) || defined(YAVL_ARM_NEON)
+    run.template operator()<packet128_t<T>>();
+#endif
+#endif
+    run.template operator()<T>();
+}
+
+// Lanes of a Vec including the register padding of Vec3 types
+template <typename T, uint32_t N>
+static constexpr uint32_t padded_lanes = sizeof(Vec<T, N>) / sizeof(T);
+
+// Copy of the Vec lanes as U, padding lanes are set to 1 which is inside
+// the domain of every function here
+template <typename U, typename T, uint32_t N>
+static inline auto load_lanes(const Vec<T, N>& v) {
+    std::array<U, padded_lanes<T, N>> buf;
+    for (uint32_t i = 0; i < buf.size(); ++i)
+        buf[i] = i < N ? static_cast<U>(v.arr[i]) : U(1);
+    return buf;
+}
+
+template <typename T, uint32_t N, typename U, std::size_t L>
+static inline Vec<T, N> store_lanes(const std::array<U, L>& buf) {
+    Vec<T, N> ret;
+    for (uint32_t i = 0; i < N; ++i)
+        ret.arr[i] = static_cast<T>(buf[i]);
+    return ret;
+}
+
+// Apply f lane wise in precision U to one or two Vecs
+template <typename U, typename T, uint32_t N, typename F, typename... Vs>
+    requires (sizeof...(Vs) <= 1)
+static inline Vec<T, N> map(const F& f, const Vec<T, N>& v, const Vs&... vs) {
+    auto in = load_lanes<U>(v);
+    std::array<decltype(in), sizeof...(Vs)> rest{ load_lanes<U>(vs)... };
+    decltype(in) out;
+    for_each_packet<U>(in.size(), [&]<typename P>(const uint32_t i) {
+        using O = packet_ops<P>;
+        if constexpr (sizeof...(Vs) == 0)
+            O::storeu(out.data() + i, f(O::loadu(in.data() + i)));
+        else
+            O::storeu(out.data() + i, f(O::loadu(in.data() + i),
+                O::loadu(rest[0].data() + i)));
+    });
+    return store_lanes<T, N>(out);
+}
+
+} // namespace math_impl
+
+#define YAVL_DEFINE_VEC_MATH_FUNC(NAME)                                 \
+    template <typename T, uint32_t N>                                   \
+        requires std::is_floating_point_v<T>                            \
+    inline Vec<T, N> NAME(const Vec<T, N>& v) {                         \
+        return math_impl::map<T>([](const auto p) {                     \
+            return math_impl::NAME##_impl(p);                           \
+        }, v);                                                          \
+    }
+
+// Max error against <cmath> over the tested ranges, float / double:
+// exp      1 / 1 ulp
+YAVL_DEFINE_VEC_MATH_FUNC(exp)
+// exp2     1 / 1 ulp
+YAVL_DEFINE_VEC_MATH_FUNC(exp2)
+// log      1 / 1 ulp
+YAVL_DEFINE_VEC_MATH_FUNC(log)
+// log2     2 / 1 ulp
+YAVL_DEFINE_VEC_MATH_FUNC(log2)
+// sin, cos 1 / 2 ulp for |x| < 8192(float) and 2^20(double), there's no
+//          large argument reduction so the error grows with |x| past that
+YAVL_DEFINE_VEC_MATH_FUNC(sin)
+YAVL_DEFINE_VEC_MATH_FUNC(cos)
+// tan      3 / 3 ulp, same ranges as sin
+YAVL_DEFINE_VEC_MATH_FUNC(tan)
+// atan     2 / 1 ulp
+YAVL_DEFINE_VEC_MATH_FUNC(atan)
+// erf      2 / 1 ulp
+YAVL_DEFINE_VEC_MATH_FUNC(erf)
+
+#undef YAVL_DEFINE_VEC_MATH_FUNC
+
+// sin and cos sharing one range reduction, same error as sin
+template <typename T, uint32_t N>
+    requires std::is_floating_point_v<T>
+inline std::pair<Vec<T, N>, Vec<T, N>> sincos(const Vec<T, N>& v) {
+    auto in = math_impl::load_lanes<T>(v);
+    decltype(in) s, c;
+    math_impl::for_each_packet<T>(in.size(), [&]<typename P>(const uint32_t i) {
+        using O = math_impl::packet_ops<P>;
+        P ps, pc;
+        math_impl::sincos_impl(O::loadu(in.data() + i), ps, pc);
+        O::storeu(s.data() + i, ps);
+        O::storeu(c.data() + i, pc);
+    });
+    return std::make_pair(math_impl::store_lanes<T, N>(s),
+        math_impl::store_lanes<T, N>(c));
+}
+
+// atan2    3 / 2 ulp
+template <typename T, uint32_t N>
+    requires std::is_floating_point_v<T>
+inline Vec<T, N> atan2(const Vec<T, N>& y, const Vec<T, N>& x) {
+    return math_impl::map<T>([](const auto py, const auto px) {
+        return math_impl::atan2_impl(py, px);
+    }, y, x);
+}
+
+// pow      1 / 1 ulp, float is evaluated in double precision since a float
+//          log doesn't carry enough bits for large exponents
+template <typename T, uint32_t N>
+    requires std::is_floating_point_v<T>
+inline Vec<T, N> pow(const Vec<T, N>& x, const Vec<T, N>& y) {
+    return math_impl::map<double>([](const auto px, const auto py) {
+        return math_impl::pow_impl(px, py);
+    }, x, y);
+}
+
+template <typename T, uint32_t N>
+    requires std::is_floating_point_v<T>
+inline Vec<T, N> pow(const Vec<T, N>& x, const T y) {
+    return pow(x, Vec<T, N>(y));
+}
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
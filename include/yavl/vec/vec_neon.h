@@ -0,0 +1,419 @@
+#pragma once
+
+namespace yavl
+{
+
+// aarch64 NEON impl of the 128 bit Vecs. The intrinsics are named
+// v<op>q_<type> instead of _mm_<op>_<type>, the common macros of
+// vec_simd.h are redefined for them. fma is part of the base isa
+#undef YAVL_VECTORIZED_CTOR
+#undef COPY_ASSIGN_EXPRS
+#undef OP_VEC_EXPRS
+#undef OP_VEC_ASSIGN_EXPRS
+#undef OP_SCALAR_EXPRS
+#undef OP_SCALAR_ASSIGN_EXPRS
+#undef OP_FRIEND_SCALAR_EXPRS
+#undef MULADD
+#undef MULSUB
+#undef MATH_LERP_SCALAR_EXPRS
+#undef MATH_LERP_VEC_EXPRS
+
+// There is no setr, lanes go through memory and the padding lane of Vec3
+// is zeroed
+#define YAVL_VECTORIZED_CTOR(BITS, IT, REGI_TYPE)                       \
+    Vec() : m(vdupq_n_##IT(static_cast<Scalar>(0))) {}                  \
+    template <typename V>                                               \
+        requires std::default_initializable<V> && std::convertible_to<V, Scalar> \
+    Vec(V v) : m(vdupq_n_##IT(static_cast<Scalar>(v))) {}               \
+    template <typename ...Ts>                                           \
+        requires (std::default_initializable<Ts> && ...) &&             \
+            (std::convertible_to<Ts, Scalar> && ...)                    \
+    constexpr Vec(Ts... args) {                                         \
+        static_assert(sizeof...(args) > 1);                             \
+        const Scalar lanes[IntrinSize] = { static_cast<Scalar>(args)... }; \
+        m = vld1q_##IT(lanes);                                          \
+    }                                                                   \
+    Vec(const REGI_TYPE val) : m(val) {}
+
+#define COPY_ASSIGN_EXPRS(BITS, IT)                                     \
+    {                                                                   \
+        vst1q_##IT(arr.data(), b.m);                                    \
+        return *this;                                                   \
+    }
+
+#define OP_VEC_EXPRS(BITS, OP, AT, NAME, IT)                            \
+    return Vec(v##NAME##q_##IT(m, v.m));
+
+#define OP_VEC_ASSIGN_EXPRS(BITS, OP, AT, NAME, IT)                     \
+    m = v##NAME##q_##IT(m, v.m);                                        \
+    return *this;
+
+#define OP_SCALAR_EXPRS(BITS, OP, AT, NAME, IT)                         \
+    auto vv = vdupq_n_##IT(v);                                          \
+    return Vec(v##NAME##q_##IT(m, vv));
+
+#define OP_SCALAR_ASSIGN_EXPRS(BITS, OP, AT, NAME, IT)                  \
+    {                                                                   \
+        auto vv = vdupq_n_##IT(v);                                      \
+        m = v##NAME##q_##IT(m, vv);                                     \
+        return *this;                                                   \
+    }
+
+#define OP_FRIEND_SCALAR_EXPRS(BITS, OP, AT, NAME, IT)                  \
+    auto vv = vdupq_n_##IT(s);                                          \
+    return Vec(v##NAME##q_##IT(vv, v.m));
+
+// vfmaq takes the addend first
+#define MULADD(BITS, IT, A, B, C) vfmaq_##IT(C, A, B)
+#define MULSUB(BITS, IT, A, B, C) vnegq_##IT(vfmsq_##IT(C, A, B))
+
+#define MATH_LERP_SCALAR_EXPRS(BITS, IT)                                \
+    {                                                                   \
+        auto vomt = vdupq_n_##IT(1 - t);                                \
+        auto t1 = vmulq_n_##IT(b.m, t);                                 \
+        auto ret = MULADD(BITS, IT, vomt, m, t1);                       \
+        return Vec(ret);                                                \
+    }
+
+#define MATH_LERP_VEC_EXPRS(BITS, IT)                                   \
+    {                                                                   \
+        Vec vomt = 1 - t;                                               \
+        auto t1 = vmulq_##IT(b.m, t.m);                                 \
+        auto ret = MULADD(BITS, IT, vomt.m, m, t1);                     \
+        return Vec(ret);                                                \
+    }
+
+// Byte table moving lane Is[k] to lane k, constant indices fold into a
+// single tbl
+template <int... Is>
+static inline uint8x16_t lane_table() {
+    constexpr int lanes[] = { Is... };
+    constexpr uint32_t B = 16 / sizeof...(Is);
+    alignas(16) uint8_t t[16];
+    for (uint32_t i = 0; i < 16; ++i)
+        t[i] = static_cast<uint8_t>(lanes[i / B] * B + i % B);
+    return vld1q_u8(t);
+}
+
+template <int... Is>
+static inline float32x4_t permute_f32(const float32x4_t m) {
+    return vreinterpretq_f32_u8(vqtbl1q_u8(vreinterpretq_u8_f32(m), lane_table<Is...>()));
+}
+
+template <int... Is>
+static inline float64x2_t permute_f64(const float64x2_t m) {
+    return vreinterpretq_f64_u8(vqtbl1q_u8(vreinterpretq_u8_f64(m), lane_table<Is...>()));
+}
+
+// The estimates are good to 8 bits, every vrecpsq/vrsqrtsq step doubles
+// that. The steps are defined to give 2 and 1.5 for 0 * inf, so 0 and inf
+// inputs come out as inf and 0 without any fixup. 8 bits is too coarse to
+// be of use, precision::fast keeps one step and lands close to the x86
+// estimates
+template <precision P = precision::standard>
+static inline float32x4_t rcp_f32_impl(const float32x4_t m) {
+    if constexpr (P == precision::exact)
+        return vdivq_f32(vdupq_n_f32(1.f), m);
+    float32x4_t r = vrecpeq_f32(m);
+    r = vmulq_f32(vrecpsq_f32(m, r), r);
+    if constexpr (P == precision::fast)
+        return r;
+    return vmulq_f32(vrecpsq_f32(m, r), r);
+}
+
+template <precision P = precision::standard>
+static inline float64x2_t rcp_f64_impl(const float64x2_t m) {
+    if constexpr (P == precision::exact)
+        return vdivq_f64(vdupq_n_f64(1.), m);
+    float64x2_t r = vrecpeq_f64(m);
+    static_for<P == precision::fast ? 1 : 3>([&](const auto i) {
+        r = vmulq_f64(vrecpsq_f64(m, r), r);
+    });
+    return r;
+}
+
+// r * (3 - m * r^2) / 2 with r^2 formed first, m * r would be 0 * inf
+template <precision P = precision::standard>
+static inline float32x4_t rsqrt_f32_impl(const float32x4_t m) {
+    if constexpr (P == precision::exact)
+        return vdivq_f32(vdupq_n_f32(1.f), vsqrtq_f32(m));
+    float32x4_t r = vrsqrteq_f32(m);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(r, r), m));
+    if constexpr (P == precision::fast)
+        return r;
+    return vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(r, r), m));
+}
+
+template <precision P = precision::standard>
+static inline float64x2_t rsqrt_f64_impl(const float64x2_t m) {
+    if constexpr (P == precision::exact)
+        return vdivq_f64(vdupq_n_f64(1.), vsqrtq_f64(m));
+    float64x2_t r = vrsqrteq_f64(m);
+    static_for<P == precision::fast ? 1 : 3>([&](const auto i) {
+        r = vmulq_f64(r, vrsqrtsq_f64(vmulq_f64(r, r), m));
+    });
+    return r;
+}
+
+// Sign bits of the first N lanes, the others count as set for all and
+// clear for any
+template <uint32_t N>
+static inline bool all_signs(const uint32x4_t bits) {
+    auto s = vshrq_n_u32(bits, 31);
+    if constexpr (N < 4)
+        s = vsetq_lane_u32(1, s, 3);
+    return vminvq_u32(s) != 0;
+}
+
+template <uint32_t N>
+static inline bool any_signs(const uint32x4_t bits) {
+    auto s = vshrq_n_u32(bits, 31);
+    if constexpr (N < 4)
+        s = vsetq_lane_u32(0, s, 3);
+    return vmaxvq_u32(s) != 0;
+}
+
+#define MATH_ABS_EXPRS(VT, BITS, IT1, IT2)                              \
+    {                                                                   \
+        return Vec(vabsq_##IT1(m));                                     \
+    }
+
+#define MATH_RCP_EXPRS(VT)                                              \
+    {                                                                   \
+        return Vec(rcp_f32_impl<P>(m));                                 \
+    }
+
+#define MATH_SQRT_EXPRS(VT)                                             \
+    {                                                                   \
+        return Vec(vsqrtq_f32(m));                                      \
+    }
+
+#define MATH_RSQRT_EXPRS                                                \
+    {                                                                   \
+        return Vec(rsqrt_f32_impl<P>(m));                               \
+    }
+
+#define MATH_ALL_EXPRS                                                  \
+    {                                                                   \
+        return all_signs<Size>(vreinterpretq_u32_f32(m));               \
+    }
+
+#define MATH_ANY_EXPRS                                                  \
+    {                                                                   \
+        return any_signs<Size>(vreinterpretq_u32_f32(m));               \
+    }
+
+template <>
+struct alignas(16) Vec<float, 4> {
+    YAVL_VEC_ALIAS_VECTORIZED(float, 4, 4)
+
+    union {
+        YAVL_VEC4_MEMBERS
+        float32x4_t m;
+    };
+
+    // Ctors
+    YAVL_VECTORIZED_CTOR(, f32, float32x4_t)
+
+    // Operators
+    YAVL_DEFINE_VEC_FP_OP(Vec,, f32, f32)
+
+    // Misc funcs
+    template <int I0, int I1, int I2, int I3>
+    inline Vec shuffle() const {
+        return Vec(permute_f32<I0, I1, I2, I3>(m));
+    }
+
+    YAVL_DEFINE_MISC_FUNCS(Vec)
+
+    // Geo funcs
+#define GEO_DOT_EXPRS                                                   \
+    {                                                                   \
+        return vaddvq_f32(vmulq_f32(m, b.m));                           \
+    }
+
+    YAVL_DEFINE_GEO_FUNCS(Vec)
+
+#undef GEO_DOT_EXPRS
+
+    // Math funcs
+#define MATH_SUM_EXPRS                                                  \
+    {                                                                   \
+        return vaddvq_f32(m);                                           \
+    }
+
+    YAVL_DEFINE_MATH_FUNCS(Vec,, f32, f32)
+
+#undef MATH_SUM_EXPRS
+
+    // Compare ops
+    bool operator ==(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        return all_signs<Size>(vcleq_f32(abs_diff.m, vdupq_n_f32(epsilon<Scalar>)));
+    }
+
+    bool operator !=(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        return any_signs<Size>(vcgtq_f32(abs_diff.m, vdupq_n_f32(epsilon<Scalar>)));
+    }
+};
+
+template <>
+struct alignas(16) Vec<float, 3> {
+    YAVL_VEC_ALIAS_VECTORIZED(float, 3, 4)
+
+    union {
+        YAVL_VEC3_MEMBERS
+        float32x4_t m;
+    };
+
+    // Ctors
+    YAVL_VECTORIZED_CTOR(, f32, float32x4_t)
+
+    // Operators
+    YAVL_DEFINE_VEC_FP_OP(Vec,, f32, f32)
+
+    // Misc funcs
+    template <int I0, int I1, int I2>
+    inline Vec shuffle() const {
+        return Vec(permute_f32<I0, I1, I2, 3>(m));
+    }
+
+    YAVL_DEFINE_MISC_FUNCS(Vec)
+
+    // Geo funcs, the padding lane may hold anything after a division
+#define GEO_DOT_EXPRS                                                   \
+    {                                                                   \
+        return vaddvq_f32(vsetq_lane_f32(0.f, vmulq_f32(m, b.m), 3));   \
+    }
+
+    YAVL_DEFINE_GEO_FUNCS(Vec)
+
+#undef GEO_DOT_EXPRS
+
+    YAVL_DEFINE_CROSS_FUNC(, f32)
+
+    // Math funcs
+#define MATH_SUM_EXPRS                                                  \
+    {                                                                   \
+        return x + y + z;                                               \
+    }
+
+    YAVL_DEFINE_MATH_FUNCS(Vec,, f32, f32)
+
+#undef MATH_SUM_EXPRS
+
+    // Compare ops
+    bool operator ==(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        return all_signs<Size>(vcleq_f32(abs_diff.m, vdupq_n_f32(epsilon<Scalar>)));
+    }
+
+    bool operator !=(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        return any_signs<Size>(vcgtq_f32(abs_diff.m, vdupq_n_f32(epsilon<Scalar>)));
+    }
+};
+
+#undef MATH_RCP_EXPRS
+#define MATH_RCP_EXPRS(VT)                                              \
+    {                                                                   \
+        return Vec(rcp_f64_impl<P>(m));                                 \
+    }
+
+#undef MATH_SQRT_EXPRS
+#define MATH_SQRT_EXPRS(VT)                                             \
+    {                                                                   \
+        return Vec(vsqrtq_f64(m));                                      \
+    }
+
+#undef MATH_RSQRT_EXPRS
+#define MATH_RSQRT_EXPRS                                                \
+    {                                                                   \
+        return Vec(rsqrt_f64_impl<P>(m));                               \
+    }
+
+#undef MATH_ALL_EXPRS
+#define MATH_ALL_EXPRS                                                  \
+    {                                                                   \
+        return (vgetq_lane_u64(vreinterpretq_u64_f64(m), 0) &           \
+            vgetq_lane_u64(vreinterpretq_u64_f64(m), 1)) >> 63;         \
+    }
+
+#undef MATH_ANY_EXPRS
+#define MATH_ANY_EXPRS                                                  \
+    {                                                                   \
+        return (vgetq_lane_u64(vreinterpretq_u64_f64(m), 0) |           \
+            vgetq_lane_u64(vreinterpretq_u64_f64(m), 1)) >> 63;         \
+    }
+
+template <>
+struct alignas(16) Vec<double, 2> {
+    YAVL_VEC_ALIAS_VECTORIZED(double, 2, 2)
+
+    union {
+        YAVL_VEC2_MEMBERS
+        float64x2_t m;
+    };
+
+    // Ctors
+    YAVL_VECTORIZED_CTOR(, f64, float64x2_t)
+
+    // Operators
+    YAVL_DEFINE_VEC_FP_OP(Vec,, f64, f64)
+
+    // Misc funcs
+    template <int I0, int I1>
+    inline Vec shuffle() const {
+        return Vec(permute_f64<I0, I1>(m));
+    }
+
+    YAVL_DEFINE_MISC_FUNCS(Vec)
+
+    // Geo funcs
+#define GEO_DOT_EXPRS                                                   \
+    {                                                                   \
+        return vaddvq_f64(vmulq_f64(m, b.m));                           \
+    }
+
+    YAVL_DEFINE_GEO_FUNCS(Vec)
+
+#undef GEO_DOT_EXPRS
+
+    inline auto cross(const Vec& b) const {
+        auto t1 = operator*(b.shuffle<1, 0>());
+        return t1[0] - t1[1];
+    }
+
+    // Math funcs
+#define MATH_SUM_EXPRS                                                  \
+    {                                                                   \
+        return x + y;                                                   \
+    }
+
+    YAVL_DEFINE_MATH_FUNCS(Vec,, f64, f64)
+
+#undef MATH_SUM_EXPRS
+
+    // Compare ops
+    bool operator ==(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        auto le = vcleq_f64(abs_diff.m, vdupq_n_f64(epsilon<Scalar>));
+        return vgetq_lane_u64(le, 0) & vgetq_lane_u64(le, 1);
+    }
+
+    bool operator !=(const Vec& b) const {
+        auto abs_diff = (*this - b).abs();
+        auto gt = vcgtq_f64(abs_diff.m, vdupq_n_f64(epsilon<Scalar>));
+        return vgetq_lane_u64(gt, 0) | vgetq_lane_u64(gt, 1);
+    }
+};
+
+#undef MATH_ABS_EXPRS
+#undef MATH_RCP_EXPRS
+#undef MATH_SQRT_EXPRS
+#undef MATH_RSQRT_EXPRS
+#undef MATH_ALL_EXPRS
+#undef MATH_ANY_EXPRS
+
+} // namespace yavl
@@ -172,6 +172,14 @@ inline Vec shuffle_impl(const Vec& v, Ts ...args) {
     #include <yavl/vec/vec_avx2.h>
 #endif
 
+#if defined(YAVL_X86_AVX512F)
+    #include <yavl/vec/vec_avx512.h>
+#endif
+
+#if defined(YAVL_ARM_NEON)
+    #include <yavl/vec/vec_neon.h>
+#endif
+
 #undef COPY_ASSIGN_EXPRS
 #undef OP_VEC_EXPRS
 #undef OP_VEC_ASSIGN_EXPRS
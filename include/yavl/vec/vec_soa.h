@@ -0,0 +1,446 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+
+namespace yavl
+{
+
+// Lane count of the widest register available for T
+template <typename T>
+constexpr uint32_t native_width = (has_avx512f ? 64 : (has_avx ? 32 : 16)) / sizeof(T);
+
+// Plain memcpy works for both the register backed specializations and the
+// fallback one, compiler turns it into a single (un)aligned load/store
+template <typename V>
+inline V load_packet(const typename V::Scalar* p) {
+    V v;
+    std::memcpy(v.arr.data(), p, sizeof(typename V::Scalar) * V::Size);
+    return v;
+}
+
+template <typename V>
+inline void store_packet(typename V::Scalar* p, const V& v) {
+    std::memcpy(p, v.arr.data(), sizeof(typename V::Scalar) * V::Size);
+}
+
+#define SOA_OP_SOA_EXPRS(OP)                                            \
+    {                                                                   \
+        VecSoA tmp;                                                     \
+        static_for<Size>([&](const auto i) {                            \
+            tmp.arr[i] = arr[i] OP v.arr[i];                            \
+        });                                                             \
+        return tmp;                                                     \
+    }
+
+#define SOA_OP_BROADCAST_EXPRS(OP)                                      \
+    {                                                                   \
+        VecSoA tmp;                                                     \
+        static_for<Size>([&](const auto i) {                            \
+            tmp.arr[i] = arr[i] OP v;                                   \
+        });                                                             \
+        return tmp;                                                     \
+    }
+
+#define SOA_OP_ASSIGN_EXPRS(OP, RHS)                                    \
+    {                                                                   \
+        static_for<Size>([&](const auto i) {                            \
+            arr[i] OP##= RHS;                                           \
+        });                                                             \
+        return *this;                                                   \
+    }
+
+#define YAVL_DEFINE_SOA_OP(OP)                                          \
+    auto operator OP(const VecSoA& v) const SOA_OP_SOA_EXPRS(OP)        \
+    auto operator OP(const Packet& v) const SOA_OP_BROADCAST_EXPRS(OP)  \
+    auto operator OP(const Scalar v) const SOA_OP_BROADCAST_EXPRS(OP)   \
+    auto& operator OP##=(const VecSoA& v) SOA_OP_ASSIGN_EXPRS(OP, v.arr[i]) \
+    auto& operator OP##=(const Packet& v) SOA_OP_ASSIGN_EXPRS(OP, v)    \
+    auto& operator OP##=(const Scalar v) SOA_OP_ASSIGN_EXPRS(OP, v)     \
+    friend auto operator OP(const Packet& s, const VecSoA& v) {         \
+        VecSoA tmp;                                                     \
+        static_for<Size>([&](const auto i) {                            \
+            tmp.arr[i] = s OP v.arr[i];                                 \
+        });                                                             \
+        return tmp;                                                     \
+    }                                                                   \
+    friend auto operator OP(const Scalar s, const VecSoA& v) {          \
+        return Packet(s) OP v;                                          \
+    }
+
+// Width vectors of N components in SoA layout. Each component lives in its
+// own Vec<T, Width> so geometric ops become vertical simd instructions and
+// the horizontal shuffles the AoS Vec needs for dot/length/sum go away.
+// Works for any Width, register backed Vec specializations are picked up
+// when available and the fallback Vec is used otherwise.
+template <typename T, uint32_t N, uint32_t W = native_width<T>>
+struct VecSoA {
+    YAVL_TYPE_ALIAS(T, N, W)
+    static constexpr uint32_t Width = W;
+    static constexpr bool vectorized = Vec<T, W>::vectorized;
+
+    using Packet = Vec<Scalar, Width>;
+    using Element = Vec<Scalar, Size>;
+
+    std::array<Packet, Size> arr;
+
+    // Ctors
+    VecSoA() = default;
+
+    VecSoA(const Scalar s) {
+        arr.fill(Packet(s));
+    }
+
+    // Broadcast a single vector to all lanes
+    VecSoA(const Element& v) {
+        static_for<Size>([&](const auto i) {
+            arr[i] = Packet(v[i]);
+        });
+    }
+
+    template <typename... Ts>
+        requires (sizeof...(Ts) == N) && (std::same_as<Ts, Vec<T, W>> && ...)
+    VecSoA(const Ts&... packets) : arr{ packets... } {}
+
+    // Load/store from per component streams
+    static VecSoA load(const std::array<const Scalar*, Size>& streams) {
+        VecSoA tmp;
+        static_for<Size>([&](const auto i) {
+            tmp.arr[i] = load_packet<Packet>(streams[i]);
+        });
+        return tmp;
+    }
+
+    void store(const std::array<Scalar*, Size>& streams) const {
+        static_for<Size>([&](const auto i) {
+            store_packet(streams[i], arr[i]);
+        });
+    }
+
+    // Load/store from Width consecutive AoS vectors
+    static VecSoA load(const Element* src) {
+        VecSoA tmp;
+        for (uint32_t l = 0; l < Width; ++l)
+            tmp.set(l, src[l]);
+        return tmp;
+    }
+
+    void store(Element* dst) const {
+        for (uint32_t l = 0; l < Width; ++l)
+            dst[l] = get(l);
+    }
+
+    // Lane access
+    Element get(const uint32_t lane) const {
+        assert(lane < Width);
+        Element tmp;
+        static_for<Size>([&](const auto i) {
+            tmp[i] = arr[i][lane];
+        });
+        return tmp;
+    }
+
+    void set(const uint32_t lane, const Element& v) {
+        assert(lane < Width);
+        static_for<Size>([&](const auto i) {
+            arr[i][lane] = v[i];
+        });
+    }
+
+    // Operators
+    Packet& operator [](const uint32_t i) {
+        assert(i < Size);
+        return arr[i];
+    }
+
+    const Packet& operator [](const uint32_t i) const {
+        assert(i < Size);
+        return arr[i];
+    }
+
+    YAVL_DEFINE_SOA_OP(+)
+    YAVL_DEFINE_SOA_OP(-)
+    YAVL_DEFINE_SOA_OP(*)
+    YAVL_DEFINE_SOA_OP(/)
+
+    // Geo funcs
+    inline Packet dot(const VecSoA& b) const {
+        Packet tmp = arr[0] * b.arr[0];
+        static_for<Size - 1>([&](const auto i) {
+            tmp += arr[i + 1] * b.arr[i + 1];
+        });
+        return tmp;
+    }
+
+    inline VecSoA cross(const VecSoA& b) const {
+        static_assert(Size == 3);
+        return VecSoA(
+            arr[1] * b.arr[2] - arr[2] * b.arr[1],
+            arr[2] * b.arr[0] - arr[0] * b.arr[2],
+            arr[0] * b.arr[1] - arr[1] * b.arr[0]);
+    }
+
+    // Math funcs
+    inline Packet length_squared() const {
+        return dot(*this);
+    }
+
+    // Non exact lengths are rcp(rsqrt), check length_approx_impl in vec.h
+    template <precision P = precision::exact>
+    inline Packet length() const {
+        if constexpr (P == precision::exact)
+            return length_squared().sqrt();
+        else
+            return length_squared().template rsqrt<P>().template rcp<P>();
+    }
+
+    template <precision P = precision::standard>
+    inline VecSoA& normalize() {
+        *this *= length_squared().template rsqrt<P>();
+        return *this;
+    }
+
+    template <precision P = precision::standard>
+    inline VecSoA normalized() const {
+        return *this * length_squared().template rsqrt<P>();
+    }
+
+    inline Packet sum() const {
+        Packet tmp = arr[0];
+        static_for<Size - 1>([&](const auto i) {
+            tmp += arr[i + 1];
+        });
+        return tmp;
+    }
+
+    #define SOA_MATH_COMPONENT_FUNC(NAME)                               \
+    inline VecSoA NAME() const {                                        \
+        VecSoA tmp;                                                     \
+        static_for<Size>([&](const auto i) {                            \
+            tmp.arr[i] = arr[i].NAME();                                 \
+        });                                                             \
+        return tmp;                                                     \
+    }
+
+    #define SOA_MATH_PRECISION_FUNC(NAME)                               \
+    template <precision P = precision::standard>                        \
+    inline VecSoA NAME() const {                                        \
+        VecSoA tmp;                                                     \
+        static_for<Size>([&](const auto i) {                            \
+            tmp.arr[i] = arr[i].template NAME<P>();                     \
+        });                                                             \
+        return tmp;                                                     \
+    }
+
+    SOA_MATH_COMPONENT_FUNC(abs)
+    SOA_MATH_COMPONENT_FUNC(square)
+    SOA_MATH_PRECISION_FUNC(rcp)
+    SOA_MATH_COMPONENT_FUNC(sqrt)
+    SOA_MATH_PRECISION_FUNC(rsqrt)
+
+    #undef SOA_MATH_COMPONENT_FUNC
+    #undef SOA_MATH_PRECISION_FUNC
+
+    template <precision P = precision::exact>
+    inline VecSoA div(const VecSoA& b) const {
+        VecSoA tmp;
+        static_for<Size>([&](const auto i) {
+            tmp.arr[i] = arr[i].template div<P>(b.arr[i]);
+        });
+        return tmp;
+    }
+
+    inline VecSoA lerp(const VecSoA& b, const Scalar t) const {
+        VecSoA tmp;
+        static_for<Size>([&](const auto i) {
+            tmp.arr[i] = arr[i].lerp(b.arr[i], t);
+        });
+        return tmp;
+    }
+
+    // Per lane interpolation factor
+    inline VecSoA lerp(const VecSoA& b, const Packet& t) const {
+        VecSoA tmp;
+        static_for<Size>([&](const auto i) {
+            tmp.arr[i] = arr[i].lerp(b.arr[i], t);
+        });
+        return tmp;
+    }
+};
+
+#undef SOA_OP_SOA_EXPRS
+#undef SOA_OP_BROADCAST_EXPRS
+#undef SOA_OP_ASSIGN_EXPRS
+#undef YAVL_DEFINE_SOA_OP
+
+// Growable SoA container, one aligned stream per component. Streams are
+// padded to a multiple of MaxWidth so a packet of any supported width can
+// be loaded at the tail without masking, padded lanes are kept at zero
+// until they become part of the array.
+template <typename T, uint32_t N>
+struct VecArray {
+    YAVL_TYPE_ALIAS(T, N, N)
+    static constexpr std::size_t MaxWidth = 64 / sizeof(T);
+
+    using Element = Vec<Scalar, Size>;
+    using Stream = std::vector<Scalar, aligned_allocator<Scalar>>;
+
+    std::array<Stream, Size> streams;
+    std::size_t count = 0;
+
+    // Ctors
+    VecArray() = default;
+
+    explicit VecArray(const std::size_t n) {
+        resize(n);
+    }
+
+    // Capacity
+    inline std::size_t size() const {
+        return count;
+    }
+
+    inline bool empty() const {
+        return count == 0;
+    }
+
+    void reserve(const std::size_t n) {
+        for (auto& s : streams)
+            s.reserve(padded_size(n));
+    }
+
+    void resize(const std::size_t n) {
+        for (auto& s : streams)
+            s.resize(padded_size(n), static_cast<Scalar>(0));
+        count = n;
+        clear_padding();
+    }
+
+    void clear() {
+        resize(0);
+    }
+
+    void push_back(const Element& v) {
+        if (count == streams[0].size()) {
+            for (auto& s : streams)
+                s.resize(padded_size(count + 1), static_cast<Scalar>(0));
+        }
+        set(count++, v);
+    }
+
+    // Element access, AoS vectors are assembled on the fly
+    inline Element get(const std::size_t i) const {
+        assert(i < count);
+        Element tmp;
+        static_for<Size>([&](const auto c) {
+            tmp[c] = streams[c][i];
+        });
+        return tmp;
+    }
+
+    inline void set(const std::size_t i, const Element& v) {
+        assert(i < streams[0].size());
+        static_for<Size>([&](const auto c) {
+            streams[c][i] = v[c];
+        });
+    }
+
+    inline Element operator [](const std::size_t i) const {
+        return get(i);
+    }
+
+    inline Scalar* stream(const uint32_t c) {
+        return streams[c].data();
+    }
+
+    inline const Scalar* stream(const uint32_t c) const {
+        return streams[c].data();
+    }
+
+    // Packet access, i is expected to be a multiple of W
+    template <uint32_t W = native_width<T>>
+    inline VecSoA<T, N, W> load(const std::size_t i) const {
+        static_assert(MaxWidth % W == 0);
+        std::array<const Scalar*, Size> ptrs;
+        static_for<Size>([&](const auto c) {
+            ptrs[c] = streams[c].data() + i;
+        });
+        return VecSoA<T, N, W>::load(ptrs);
+    }
+
+    template <uint32_t W>
+    inline void store(const std::size_t i, const VecSoA<T, N, W>& v) {
+        static_assert(MaxWidth % W == 0);
+        std::array<Scalar*, Size> ptrs;
+        static_for<Size>([&](const auto c) {
+            ptrs[c] = streams[c].data() + i;
+        });
+        v.store(ptrs);
+    }
+
+    // Bulk ops, f is called with a VecSoA<T, N, W>& for every packet
+    template <uint32_t W = native_width<T>, typename F>
+    void for_each_packet(F&& f) {
+        for_each_packet<W>(0, count, f);
+    }
+
+    // The same over records [begin, end). begin is a multiple of W and so
+    // is end unless it is count, disjoint ranges then touch disjoint packets
+    template <uint32_t W = native_width<T>, typename F>
+    void for_each_packet(const std::size_t begin, const std::size_t end, F&& f) {
+        assert(begin % W == 0 && (end % W == 0 || end == count) && end <= count);
+        for (std::size_t i = begin; i < end; i += W) {
+            auto v = load<W>(i);
+            f(v);
+            store(i, v);
+        }
+    }
+
+    template <uint32_t W = native_width<T>, precision P = precision::standard>
+    void normalize() {
+        normalize<W, P>(0, count);
+    }
+
+    template <uint32_t W = native_width<T>, precision P = precision::standard>
+    void normalize(const std::size_t begin, const std::size_t end) {
+        for_each_packet<W>(begin, end, [](auto& v) { v.template normalize<P>(); });
+        // Padded lanes got 0 * inf, put them back to zero
+        if (end == count)
+            clear_padding();
+    }
+
+private:
+    void clear_padding() {
+        for (auto& s : streams)
+            std::fill(s.begin() + count, s.end(), static_cast<Scalar>(0));
+    }
+
+    static constexpr std::size_t padded_size(const std::size_t n) {
+        return (n + MaxWidth - 1) / MaxWidth * MaxWidth;
+    }
+};
+
+// SoA type aliasing
+template <typename T, uint32_t W = native_width<T>>
+using Vec3SoA = VecSoA<T, 3, W>;
+
+template <typename T, uint32_t W = native_width<T>>
+using Vec4SoA = VecSoA<T, 4, W>;
+
+using Vec3fSoA = Vec3SoA<float>;
+using Vec3dSoA = Vec3SoA<double>;
+using Vec4fSoA = Vec4SoA<float>;
+using Vec4dSoA = Vec4SoA<double>;
+
+using Vec3fArray = VecArray<float, 3>;
+using Vec3dArray = VecArray<double, 3>;
+using Vec4fArray = VecArray<float, 4>;
+using Vec4dArray = VecArray<double, 4>;
+
+} // namespace yavl
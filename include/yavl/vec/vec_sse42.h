@@ -3,14 +3,15 @@
 namespace yavl
 {
 
+template <precision P = precision::standard>
 static inline __m128 rcp_ps_impl(const __m128 m) {
     // Copied from enoki with some extra comments
+    if constexpr (P == precision::exact)
+        return _mm_div_ps(_mm_set1_ps(1.f), m);
 #if defined(YAVL_X86_AVX512ER)
-    // rel err < 2^28, use as is
+    // rel err < 2^-28, use as is
     return _mm512_castps512_ps128(
-        _mm512_rcp28_ps(_mm512_castps128_ps512(m));
-    );
-    r = _mm_rcp14_ps(m);
+        _mm512_rcp28_ps(_mm512_castps128_ps512(m)));
 #else
     __m128 r;
 #if defined(YAVL_X86_AVX512VL)
@@ -20,6 +21,8 @@ static inline __m128 rcp_ps_impl(const __m128 m) {
     // is the worst one...
     r = _mm_rcp_ps(m);      // rel error < 1.5*2^-12
 #endif
+    if constexpr (P == precision::fast)
+        return r;
 
     // Refine with one Newton-Raphson iteration
     // Function for the iteration:
@@ -53,8 +56,11 @@ static inline __m128 rcp_ps_impl(const __m128 m) {
 #endif
 }
 
+template <precision P = precision::standard>
 static inline __m128d rcp_pd_impl(const __m128d m) {
     // Copied from enoki
+    if constexpr (P == precision::exact)
+        return _mm_div_pd(_mm_set1_pd(1.), m);
 #if defined(YAVL_X86_AVX512ER) || defined(YAVL_X86_AVX512VL)
     __m128d r;
 #if defined(YAVL_X86_AVX512ER)
@@ -65,6 +71,8 @@ static inline __m128d rcp_pd_impl(const __m128d m) {
     // rel err < 2^-14
     r = _mm_rcp14_pd(m);
 #endif
+    if constexpr (P == precision::fast)
+        return r;
 
     __m128d ro = r, t0, t1;
     static_for<has_avx512er ? 1 : 2>([&](const auto i) {
@@ -76,7 +84,7 @@ static inline __m128d rcp_pd_impl(const __m128d m) {
 #if defined(YAVL_X86_AVX512VL)
     return _mm_fixupimm_pd(r, m, _mm_set1_epi32(0x0087A622), 0);
 #else
-    return _mm_blendv_pd(r, ro, t1)
+    return _mm_blendv_pd(r, ro, t1);
 #endif
 
 #else
@@ -86,13 +94,15 @@ static inline __m128d rcp_pd_impl(const __m128d m) {
 #endif
 }
 
+template <precision P = precision::standard>
 static inline __m128 rsqrt_ps_impl(const __m128 m) {
     // Copied from enoki with extra comments
+    if constexpr (P == precision::exact)
+        return _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(m));
 #if defined(YAVL_X86_AVX512ER)
+    // rel err < 2^-28, use as is
     return _mm512_castps512_ps128(
-        // rel err < 2^-28, use as is
-        _mm512_rsqrt28_ps(_mm512_castps128_ps512(m));
-    )
+        _mm512_rsqrt28_ps(_mm512_castps128_ps512(m)));
 #else
     __m128 r;
 #if defined(YAVL_X86_AVX512VL)
@@ -100,6 +110,8 @@ static inline __m128 rsqrt_ps_impl(const __m128 m) {
 #else
     r = _mm_rsqrt_ps(m);    // rel err < 1.5*2^-12
 #endif
+    if constexpr (P == precision::fast)
+        return r;
 
     // Refine with one Newton-Raphson iteration
     // Function for the iteration:
@@ -114,7 +126,7 @@ static inline __m128 rsqrt_ps_impl(const __m128 m) {
 
     __m128 t0 = _mm_mul_ps(r, c0),
            t1 = _mm_mul_ps(r, m);
-#ifndef YAVL_x86_AVX512VL
+#ifndef YAVL_X86_AVX512VL
     __m128 ro = r;
     (void) ro;
 #endif
@@ -133,8 +145,11 @@ static inline __m128 rsqrt_ps_impl(const __m128 m) {
 #endif
 }
 
+template <precision P = precision::standard>
 static inline __m128d rsqrt_pd_impl(const __m128d m) {
     // Copied from enoki
+    if constexpr (P == precision::exact)
+        return _mm_div_pd(_mm_set1_pd(1.), _mm_sqrt_pd(m));
 #if defined(YAVL_X86_AVX512ER) || defined(YAVL_X86_AVX512VL)
     __m128d r;
 #if defined(YAVL_X86_AVX512ER)
@@ -145,6 +160,8 @@ static inline __m128d rsqrt_pd_impl(const __m128d m) {
     // rel err < 2^-14
     r = _mm_rsqrt14_pd(m);
 #endif
+    if constexpr (P == precision::fast)
+        return r;
 
     const __m128d c0 = _mm_set1_pd(0.5),
                   c1 = _mm_set1_pd(3.0);
@@ -183,7 +200,7 @@ static inline __m128d rsqrt_pd_impl(const __m128d m) {
 
 #define MATH_RCP_EXPRS(VT)                                              \
     {                                                                   \
-        return Vec(rcp_ps_impl(m));                                     \
+        return Vec(rcp_ps_impl<P>(m));                                  \
     }
 
 #define MATH_SQRT_EXPRS(VT)                                             \
@@ -193,7 +210,7 @@ static inline __m128d rsqrt_pd_impl(const __m128d m) {
 
 #define MATH_RSQRT_EXPRS                                                \
     {                                                                   \
-        return Vec(rsqrt_ps_impl(m));                                   \
+        return Vec(rsqrt_ps_impl<P>(m));                                \
     }
 
 #define MATH_ALL_EXPRS                                                  \
@@ -342,7 +359,7 @@ struct alignas(16) Vec<float, 3> {
 #undef MATH_RCP_EXPRS
 #define MATH_RCP_EXPRS(VT)                                              \
     {                                                                   \
-        return Vec(rcp_pd_impl(m));                                     \
+        return Vec(rcp_pd_impl<P>(m));                                  \
     }
 
 #undef MATH_SQRT_EXPRS
@@ -354,7 +371,7 @@ struct alignas(16) Vec<float, 3> {
 #undef MATH_RSQRT_EXPRS
 #define MATH_RSQRT_EXPRS                                                \
     {                                                                   \
-        return Vec(rsqrt_pd_impl(m));                                   \
+        return Vec(rsqrt_pd_impl<P>(m));                                \
     }
 
 #undef MATH_ALL_EXPRS
@@ -0,0 +1,502 @@
+#pragma once
+
+// Non-owning views of external scalar buffers(mesh files, numpy arrays, GPU
+// staging memory) as arrays of Vec<T, N>, nothing is copied.
+//
+// view_layout::packed is records of N scalars back to back, the xyzxyz...
+// layout a Vec3f can't be reinterpreted as since it's padded to 16 bytes
+// under SSE. strided takes the distance between records at run time, for
+// interleaved vertex buffers. aligned is the layout of Vec<T, N> itself,
+// padding included, and hands out a std::span for the span based bulk
+// functions.
+//
+// load<W>/store<W> move W records from and to a VecSoA<T, N, W> with
+// unaligned loads and in-register shuffles, there are no gathers or
+// scatters. Each 128 bit lane of a register takes 4 records: packed xyz is
+// 3 loads per lane and 5 shuffles to split them into x, y and z(7 on the
+// way back), the other layouts a load per record and a 4x4 transpose. NEON
+// uses vld3q/vst3q for packed xyz. Other scalar types and sizes go lane by
+// lane.
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include <yavl/platform.h>
+#include <yavl/utils.h>
+#include <yavl/vec/vec.h>
+#include <yavl/vec/vec_soa.h>
+#include <yavl/vec/vec_math.h>
+
+// Register types are used as template arguments
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wignored-attributes"
+#endif
+
+namespace yavl
+{
+
+enum class view_layout {
+    packed,     // N scalars per record, no gaps
+    strided,    // Record starts a run time stride apart
+    aligned     // Layout of Vec<T, N>, padding included
+};
+
+namespace view_impl
+{
+
+// Register holding W floats, void if the build has none
+template <uint32_t W>
+struct float_packet {
+    using type = void;
+};
+
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+
+#if defined(YAVL_X86_SSE42) || defined(YAVL_ARM_NEON)
+template <>
+struct float_packet<4> {
+    using type = math_impl::packet128_t<float>;
+};
+#endif
+
+#if defined(YAVL_X86_AVX)
+template <>
+struct float_packet<8> {
+    using type = __m256;
+};
+#endif
+
+#if defined(YAVL_X86_AVX512F)
+template <>
+struct float_packet<16> {
+    using type = __m512;
+};
+#endif
+
+#if defined(YAVL_X86_SSE42)
+
+// Transpose the 4x4 block in every 128 bit lane, the unpacks never cross
+// lanes so the same sequence serves all widths.
+// deinterleave3 turns x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 in each lane
+// of a, b and c into x, y and z, interleave3 goes the other way
+#define YAVL_DEFINE_VIEW_SHUFFLE_FUNCS(BITS, PT)                        \
+    static inline void transpose4(PT& a0, PT& a1, PT& a2, PT& a3) {    \
+        auto t0 = _mm##BITS##_castps_pd(_mm##BITS##_unpacklo_ps(a0, a1)); \
+        auto t1 = _mm##BITS##_castps_pd(_mm##BITS##_unpacklo_ps(a2, a3)); \
+        auto t2 = _mm##BITS##_castps_pd(_mm##BITS##_unpackhi_ps(a0, a1)); \
+        auto t3 = _mm##BITS##_castps_pd(_mm##BITS##_unpackhi_ps(a2, a3)); \
+        a0 = _mm##BITS##_castpd_ps(_mm##BITS##_unpacklo_pd(t0, t1));    \
+        a1 = _mm##BITS##_castpd_ps(_mm##BITS##_unpackhi_pd(t0, t1));    \
+        a2 = _mm##BITS##_castpd_ps(_mm##BITS##_unpacklo_pd(t2, t3));    \
+        a3 = _mm##BITS##_castpd_ps(_mm##BITS##_unpackhi_pd(t2, t3));    \
+    }                                                                   \
+    static inline void deinterleave3(const PT a, const PT b, const PT c, \
+        PT& x, PT& y, PT& z)                                            \
+    {                                                                   \
+        const PT t0 = _mm##BITS##_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); \
+        const PT t1 = _mm##BITS##_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); \
+        x = _mm##BITS##_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));     \
+        y = _mm##BITS##_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));    \
+        z = _mm##BITS##_shuffle_ps(t1, c, _MM_SHUFFLE(3, 0, 3, 1));     \
+    }                                                                   \
+    static inline void interleave3(const PT x, const PT y, const PT z,  \
+        PT& a, PT& b, PT& c)                                            \
+    {                                                                   \
+        const PT xy = _mm##BITS##_unpacklo_ps(x, y);                    \
+        const PT zx = _mm##BITS##_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)); \
+        a = _mm##BITS##_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 1, 0));    \
+        const PT yz = _mm##BITS##_shuffle_ps(y, z, _MM_SHUFFLE(2, 1, 2, 1)); \
+        const PT xy2 = _mm##BITS##_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)); \
+        b = _mm##BITS##_shuffle_ps(yz, xy2, _MM_SHUFFLE(2, 0, 2, 0));   \
+        const PT xy3 = _mm##BITS##_unpackhi_ps(x, y);                   \
+        const PT zxy = _mm##BITS##_shuffle_ps(z, xy3, _MM_SHUFFLE(3, 2, 3, 2)); \
+        c = _mm##BITS##_shuffle_ps(zxy, zxy, _MM_SHUFFLE(1, 3, 2, 0));  \
+    }
+
+YAVL_DEFINE_VIEW_SHUFFLE_FUNCS(, __m128)
+
+// Lane k of the result is the 4 floats at p + k * lane_stride
+static inline __m128 load_lanes(const float* p, const std::size_t, __m128) {
+    return _mm_loadu_ps(p);
+}
+
+static inline void store_lanes(float* p, const std::size_t, const __m128 a) {
+    _mm_storeu_ps(p, a);
+}
+
+// Only the first 3 floats of each lane, for records with no padding
+static inline void store3_lanes(float* p, const std::size_t, const __m128 a) {
+    _mm_storel_pi(reinterpret_cast<__m64*>(p), a);
+    _mm_store_ss(p + 2, _mm_movehl_ps(a, a));
+}
+#endif
+
+#if defined(YAVL_X86_AVX)
+YAVL_DEFINE_VIEW_SHUFFLE_FUNCS(256, __m256)
+
+static inline __m256 load_lanes(const float* p, const std::size_t lane_stride, __m256) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)),
+        _mm_loadu_ps(p + lane_stride), 1);
+}
+
+static inline void store_lanes(float* p, const std::size_t lane_stride, const __m256 a) {
+    _mm_storeu_ps(p, _mm256_castps256_ps128(a));
+    _mm_storeu_ps(p + lane_stride, _mm256_extractf128_ps(a, 1));
+}
+
+static inline void store3_lanes(float* p, const std::size_t lane_stride, const __m256 a) {
+    store3_lanes(p, 0, _mm256_castps256_ps128(a));
+    store3_lanes(p + lane_stride, 0, _mm256_extractf128_ps(a, 1));
+}
+#endif
+
+#if defined(YAVL_X86_AVX512F)
+YAVL_DEFINE_VIEW_SHUFFLE_FUNCS(512, __m512)
+
+static inline __m512 load_lanes(const float* p, const std::size_t lane_stride, __m512) {
+    __m512 r = _mm512_castps128_ps512(_mm_loadu_ps(p));
+    r = _mm512_insertf32x4(r, _mm_loadu_ps(p + lane_stride), 1);
+    r = _mm512_insertf32x4(r, _mm_loadu_ps(p + lane_stride * 2), 2);
+    return _mm512_insertf32x4(r, _mm_loadu_ps(p + lane_stride * 3), 3);
+}
+
+static inline void store_lanes(float* p, const std::size_t lane_stride, const __m512 a) {
+    _mm_storeu_ps(p, _mm512_castps512_ps128(a));
+    _mm_storeu_ps(p + lane_stride, _mm512_extractf32x4_ps(a, 1));
+    _mm_storeu_ps(p + lane_stride * 2, _mm512_extractf32x4_ps(a, 2));
+    _mm_storeu_ps(p + lane_stride * 3, _mm512_extractf32x4_ps(a, 3));
+}
+
+static inline void store3_lanes(float* p, const std::size_t lane_stride, const __m512 a) {
+    store3_lanes(p, 0, _mm512_castps512_ps128(a));
+    store3_lanes(p + lane_stride, 0, _mm512_extractf32x4_ps(a, 1));
+    store3_lanes(p + lane_stride * 2, 0, _mm512_extractf32x4_ps(a, 2));
+    store3_lanes(p + lane_stride * 3, 0, _mm512_extractf32x4_ps(a, 3));
+}
+#endif
+
+#undef YAVL_DEFINE_VIEW_SHUFFLE_FUNCS
+
+#if defined(YAVL_X86_SSE42)
+// 4 packed xyz records per lane, 12 floats
+template <typename P>
+static inline void load_packed3(const float* p, P& x, P& y, P& z) {
+    deinterleave3(load_lanes(p, 12, P{}), load_lanes(p + 4, 12, P{}),
+        load_lanes(p + 8, 12, P{}), x, y, z);
+}
+
+template <typename P>
+static inline void store_packed3(float* p, const P x, const P y, const P z) {
+    P a, b, c;
+    interleave3(x, y, z, a, b, c);
+    store_lanes(p, 12, a);
+    store_lanes(p + 4, 12, b);
+    store_lanes(p + 8, 12, c);
+}
+#endif
+
+#if defined(YAVL_ARM_NEON)
+static inline void transpose4(float32x4_t& a0, float32x4_t& a1,
+    float32x4_t& a2, float32x4_t& a3)
+{
+    const float32x4x2_t t0 = vtrnq_f32(a0, a1);
+    const float32x4x2_t t1 = vtrnq_f32(a2, a3);
+    a0 = vcombine_f32(vget_low_f32(t0.val[0]), vget_low_f32(t1.val[0]));
+    a1 = vcombine_f32(vget_low_f32(t0.val[1]), vget_low_f32(t1.val[1]));
+    a2 = vcombine_f32(vget_high_f32(t0.val[0]), vget_high_f32(t1.val[0]));
+    a3 = vcombine_f32(vget_high_f32(t0.val[1]), vget_high_f32(t1.val[1]));
+}
+
+static inline float32x4_t load_lanes(const float* p, const std::size_t, float32x4_t) {
+    return vld1q_f32(p);
+}
+
+static inline void store_lanes(float* p, const std::size_t, const float32x4_t a) {
+    vst1q_f32(p, a);
+}
+
+static inline void store3_lanes(float* p, const std::size_t, const float32x4_t a) {
+    vst1_f32(p, vget_low_f32(a));
+    vst1q_lane_f32(p + 2, a, 2);
+}
+
+static inline void load_packed3(const float* p, float32x4_t& x, float32x4_t& y,
+    float32x4_t& z)
+{
+    const float32x4x3_t r = vld3q_f32(p);
+    x = r.val[0];
+    y = r.val[1];
+    z = r.val[2];
+}
+
+static inline void store_packed3(float* p, const float32x4_t x, const float32x4_t y,
+    const float32x4_t z)
+{
+    vst3q_f32(p, float32x4x3_t{ { x, y, z } });
+}
+#endif
+
+// W records at p, stride floats apart, into one register per component.
+// Dense3 records are packed xyz, the others are read 4 floats at a time
+template <typename P, uint32_t N, bool Dense3>
+static inline void load_records(const float* p, const std::size_t stride, P (&r)[N]) {
+    if constexpr (Dense3) {
+        load_packed3(p, r[0], r[1], r[2]);
+    }
+    else {
+        // Register j gets record j of every group of 4
+        P a[4];
+        static_for<4>([&](const auto j) {
+            a[j] = load_lanes(p + j * stride, stride * 4, P{});
+        });
+        transpose4(a[0], a[1], a[2], a[3]);
+        static_for<N>([&](const auto c) {
+            r[c] = a[c];
+        });
+    }
+}
+
+// Whole means 4 floats can be written per record, the padding of an
+// aligned Vec3f gets zero
+template <typename P, uint32_t N, bool Dense3, bool Whole>
+static inline void store_records(float* p, const std::size_t stride, const P (&r)[N]) {
+    if constexpr (Dense3) {
+        store_packed3(p, r[0], r[1], r[2]);
+    }
+    else {
+        P a[4];
+        static_for<N>([&](const auto c) {
+            a[c] = r[c];
+        });
+        if constexpr (N == 3)
+            a[3] = P{};
+        transpose4(a[0], a[1], a[2], a[3]);
+        static_for<4>([&](const auto j) {
+            if constexpr (Whole)
+                store_lanes(p + j * stride, stride * 4, a[j]);
+            else
+                store3_lanes(p + j * stride, stride * 4, a[j]);
+        });
+    }
+}
+
+#endif // YAVL_DISABLE_VECTORIZATION
+
+template <uint32_t W>
+using float_packet_t = typename float_packet<W>::type;
+
+template <typename T, uint32_t N, uint32_t W>
+static constexpr bool has_kernel = std::is_same_v<T, float> && (N == 3 || N == 4) &&
+    !std::is_void_v<float_packet_t<W>> && Vec<float, W>::vectorized;
+
+} // namespace view_impl
+
+template <typename T, uint32_t N, view_layout L = view_layout::packed>
+struct VecView {
+    YAVL_TYPE_ALIAS(T, N, N)
+    static constexpr view_layout Layout = L;
+
+    using Element = Vec<Scalar, Size>;
+
+    // Record stride known at compile time, 0 for strided views
+    static constexpr std::size_t FixedStride = L == view_layout::packed ? N :
+        (L == view_layout::aligned ? math_impl::padded_lanes<T, N> : 0);
+
+    Scalar* arr = nullptr;
+    std::size_t count = 0;
+    std::size_t stride = FixedStride;
+
+    // Ctors
+    VecView() = default;
+
+    VecView(const Scalar* d, const std::size_t n) requires (L != view_layout::strided)
+        : arr(const_cast<Scalar*>(d)), count(n)
+    {
+        if constexpr (L == view_layout::aligned)
+            assert(reinterpret_cast<uintptr_t>(d) % alignof(Element) == 0);
+    }
+
+    // s is in scalars, from the start of one record to the next
+    VecView(const Scalar* d, const std::size_t n, const std::size_t s)
+        requires (L == view_layout::strided)
+        : arr(const_cast<Scalar*>(d)), count(n), stride(s)
+    {
+        assert(s >= N);
+    }
+
+    explicit VecView(std::span<const Element> s) requires (L == view_layout::aligned)
+        : VecView(reinterpret_cast<const Scalar*>(s.data()), s.size()) {}
+
+    // Capacity
+    inline std::size_t size() const {
+        return count;
+    }
+
+    inline bool empty() const {
+        return count == 0;
+    }
+
+    inline Scalar* data() const {
+        return arr;
+    }
+
+    inline Scalar* record(const std::size_t i) const {
+        return arr + i * (FixedStride ? FixedStride : stride);
+    }
+
+    inline std::span<Element> span() const requires (L == view_layout::aligned) {
+        return std::span<Element>(reinterpret_cast<Element*>(arr), count);
+    }
+
+    // Records [offset, offset + n) with the same layout
+    inline VecView subview(const std::size_t offset, const std::size_t n) const {
+        assert(offset + n <= count);
+        VecView tmp = *this;
+        tmp.arr = record(offset);
+        tmp.count = n;
+        return tmp;
+    }
+
+    // Element access, a view doesn't own the records so these are const
+    // the way std::span is
+    inline Element get(const std::size_t i) const {
+        assert(i < count);
+        const Scalar* p = record(i);
+        Element tmp;
+        static_for<Size>([&](const auto c) {
+            tmp[c] = p[c];
+        });
+        return tmp;
+    }
+
+    inline void set(const std::size_t i, const Element& v) const {
+        assert(i < count);
+        Scalar* p = record(i);
+        static_for<Size>([&](const auto c) {
+            p[c] = v[c];
+        });
+    }
+
+    inline Element operator [](const std::size_t i) const {
+        return get(i);
+    }
+
+    // Packet access, records i to i + W - 1 must be in the view
+    template <uint32_t W = native_width<T>>
+    inline VecSoA<T, N, W> load(const std::size_t i) const {
+        assert(i + W <= count);
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+        if constexpr (view_impl::has_kernel<T, N, W>) {
+            if (kernel_fits<W>(i)) {
+                using P = view_impl::float_packet_t<W>;
+                P r[N];
+                view_impl::load_records<P, N, FixedStride == 3>(record(i), stride, r);
+                VecSoA<T, N, W> tmp;
+                static_for<Size>([&](const auto c) {
+                    tmp.arr[c] = typename VecSoA<T, N, W>::Packet(r[c]);
+                });
+                return tmp;
+            }
+        }
+#endif
+        return load_partial<W>(i, W);
+    }
+
+    template <uint32_t W>
+    inline void store(const std::size_t i, const VecSoA<T, N, W>& v) const {
+        assert(i + W <= count);
+#if !defined(YAVL_DISABLE_VECTORIZATION)
+        if constexpr (view_impl::has_kernel<T, N, W>) {
+            using P = view_impl::float_packet_t<W>;
+            P r[N];
+            static_for<Size>([&](const auto c) {
+                r[c] = v.arr[c].m;
+            });
+            view_impl::store_records<P, N, FixedStride == 3,
+                N == 4 || FixedStride == 4>(record(i), stride, r);
+            return;
+        }
+#endif
+        store_partial(i, v, W);
+    }
+
+    // First n records of a packet, the other lanes are zero
+    template <uint32_t W = native_width<T>>
+    inline VecSoA<T, N, W> load_partial(const std::size_t i, const std::size_t n) const {
+        assert(n <= W && i + n <= count);
+        VecSoA<T, N, W> tmp(static_cast<Scalar>(0));
+        for (uint32_t l = 0; l < n; ++l)
+            tmp.set(l, get(i + l));
+        return tmp;
+    }
+
+    template <uint32_t W>
+    inline void store_partial(const std::size_t i, const VecSoA<T, N, W>& v,
+        const std::size_t n) const
+    {
+        assert(n <= W && i + n <= count);
+        for (uint32_t l = 0; l < n; ++l)
+            set(i + l, v.get(l));
+    }
+
+    // Bulk ops, f is called with a VecSoA<T, N, W>& for every packet and
+    // the partial one at the end
+    template <uint32_t W = native_width<T>, typename F>
+    void for_each_packet(F&& f) const {
+        std::size_t i = 0;
+        for (; i + W <= count; i += W) {
+            auto v = load<W>(i);
+            f(v);
+            store(i, v);
+        }
+        if (i < count) {
+            auto v = load_partial<W>(i, count - i);
+            f(v);
+            store_partial(i, v, count - i);
+        }
+    }
+
+    template <uint32_t W = native_width<T>, precision P = precision::standard>
+    void normalize() const {
+        for_each_packet<W>([](auto& v) { v.template normalize<P>(); });
+    }
+
+private:
+    // Records without padding are read 4 floats at a time, which runs past
+    // the end of the buffer on the last one
+    template <uint32_t W>
+    inline bool kernel_fits(const std::size_t i) const {
+        if constexpr (N == 4 || FixedStride == 3 || FixedStride == 4)
+            return true;
+        else
+            return i + W < count;
+    }
+};
+
+// View type aliasing
+template <typename T, uint32_t N>
+using PackedView = VecView<T, N, view_layout::packed>;
+
+template <typename T, uint32_t N>
+using StridedView = VecView<T, N, view_layout::strided>;
+
+template <typename T, uint32_t N>
+using AlignedView = VecView<T, N, view_layout::aligned>;
+
+using Vec3fView = PackedView<float, 3>;
+using Vec4fView = PackedView<float, 4>;
+
+} // namespace yavl
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
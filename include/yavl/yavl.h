@@ -7,10 +7,28 @@
 #if !defined(YAVL_DISABLE_VECTORIZATION)
     #include <yavl/vec/vec_simd.h>
 #endif
+#include <yavl/vec/vec_soa.h>
+#include <yavl/vec/vec_math.h>
+#include <yavl/vec/vec_expr.h>
+#include <yavl/vec/vec_view.h>
+#include <yavl/vec/vec_half.h>
+#include <yavl/vec/vec_mask.h>
 
 #include <yavl/mat/mat.h>
 #if !defined(YAVL_DISABLE_VECTORIZATION)
     #include <yavl/mat/mat_simd.h>
 #endif
+#include <yavl/mat/mat_transform.h>
+#include <yavl/mat/mat_soa.h>
+#include <yavl/mat/mat_view.h>
 
-#include <yavl/rng/pcg.h>
\ No newline at end of file
+#include <yavl/reduce.h>
+
+#include <yavl/quat/quat.h>
+
+#include <yavl/geo/intersect.h>
+
+#include <yavl/rng/pcg.h>
+#include <yavl/rng/sampling.h>
+
+#include <yavl/parallel.h>
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#include <yavl/platform.h>
+#include <yavl/rng/pcg.h>
+
+#include "kernel_tables.h"
+
+namespace yavl
+{
+
+namespace
+{
+
+constexpr const char* level_names[] = {
+    "scalar",
+    "sse42",
+    "avx2",
+    "avx512"
+};
+
+static_assert(std::size(level_names) == static_cast<uint32_t>(isa_level::count));
+
+std::atomic<const kernel_table*> active_table{ nullptr };
+
+bool cpu_supports(const isa_level level) {
+    const auto& f = cpu_features();
+    switch (level) {
+        case isa_level::scalar:
+            return true;
+        case isa_level::sse42:
+            return f.sse42;
+        case isa_level::avx2:
+            return f.avx2 && f.fma;
+        case isa_level::avx512:
+            return f.avx512f && f.avx512vl && f.avx512dq && f.avx512bw;
+        default:
+            return false;
+    }
+}
+
+const kernel_table* initial_table() {
+    if (const char* env = std::getenv("YAVL_ISA_LEVEL")) {
+        for (uint32_t i = 0; i < std::size(level_names); ++i) {
+            auto level = static_cast<isa_level>(i);
+            if (std::strcmp(env, level_names[i]) == 0 && isa_level_supported(level))
+                return kernels_for(level);
+        }
+    }
+    return kernels_for(detect_isa_level());
+}
+
+} // namespace
+
+pcg32x8_state::pcg32x8_state() {
+    // Same default as pcg32x<8>
+    const uint64_t initstate[8] = {
+        PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+        PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+        PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE,
+        PCG32_DEFAULT_STATE, PCG32_DEFAULT_STATE
+    };
+    const uint64_t initseq[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    seed(initstate, initseq);
+}
+
+pcg32x8_state::pcg32x8_state(const uint64_t* initstate, const uint64_t* initseq) {
+    seed(initstate, initseq);
+}
+
+void pcg32x8_state::seed(const uint64_t* initstate, const uint64_t* initseq) {
+    for (int i = 0; i < 8; ++i) {
+        pcg32 rng(initstate[i], initseq[i]);
+        state[i] = rng.state;
+        inc[i] = rng.inc;
+    }
+}
+
+isa_level detect_isa_level() {
+    for (uint32_t i = static_cast<uint32_t>(isa_level::count) - 1; i > 0; --i) {
+        auto level = static_cast<isa_level>(i);
+        if (isa_level_supported(level))
+            return level;
+    }
+    return isa_level::scalar;
+}
+
+bool isa_level_supported(const isa_level level) {
+    return kernels_for(level) != nullptr && cpu_supports(level);
+}
+
+const char* isa_level_name(const isa_level level) {
+    if (level >= isa_level::count)
+        return "unknown";
+    return level_names[static_cast<uint32_t>(level)];
+}
+
+bool force_isa_level(const isa_level level) {
+    if (!isa_level_supported(level))
+        return false;
+    active_table.store(kernels_for(level), std::memory_order_release);
+    return true;
+}
+
+void reset_isa_level() {
+    active_table.store(kernels_for(detect_isa_level()), std::memory_order_release);
+}
+
+isa_level active_isa_level() {
+    return kernels().level;
+}
+
+const kernel_table& kernels() {
+    auto table = active_table.load(std::memory_order_acquire);
+    if (table == nullptr) {
+        // Racing initializations all pick the same table
+        const kernel_table* expected = nullptr;
+        table = initial_table();
+        if (!active_table.compare_exchange_strong(expected, table,
+            std::memory_order_acq_rel))
+            table = expected;
+    }
+    return *table;
+}
+
+const kernel_table* kernels_for(const isa_level level) {
+    switch (level) {
+        case isa_level::scalar:
+            return &scalar_kernel_table;
+#if defined(__x86_64__) || defined(_M_X64)
+        case isa_level::sse42:
+            return &sse42_kernel_table;
+        case isa_level::avx2:
+            return &avx2_kernel_table;
+        case isa_level::avx512:
+            return &avx512_kernel_table;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace yavl
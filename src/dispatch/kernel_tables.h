@@ -0,0 +1,16 @@
+#pragma once
+
+#include <yavl/dispatch.h>
+
+namespace yavl
+{
+
+// Defined by kernels_<level>.cpp
+extern const kernel_table scalar_kernel_table;
+#if defined(__x86_64__) || defined(_M_X64)
+extern const kernel_table sse42_kernel_table;
+extern const kernel_table avx2_kernel_table;
+extern const kernel_table avx512_kernel_table;
+#endif
+
+} // namespace yavl
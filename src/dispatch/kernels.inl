@@ -0,0 +1,129 @@
+// Kernel bodies shared by every isa level. Each kernels_<level>.cpp defines
+// YAVL_DISPATCH_LEVEL, YAVL_DISPATCH_NAMESPACE and YAVL_DISPATCH_TABLE and
+// includes this file, the build gives each of them its own isa flags.
+
+#include <cstring>
+
+#include "kernel_tables.h"
+
+using public_pcg32x8_state = yavl::pcg32x8_state;
+
+// The library is header only, so every level emits the same inline functions
+// and the linker keeps one copy of each, compiled for whatever isa it met
+// first. Renaming the namespace gives each level its own copies. For the
+// same reason the kernels avoid std algorithms on plain types.
+#define yavl YAVL_DISPATCH_NAMESPACE
+#include <yavl/yavl.h>
+
+namespace yavl
+{
+
+namespace kernels_impl
+{
+
+static inline void load_rng(pcg32x<8>& rng, const public_pcg32x8_state& s) {
+#if defined(YAVL_X86_AVX512VL) || defined(YAVL_X86_AVX2) || defined(YAVL_X86_SSE42)
+    // Register backed generators keep lane i at 64 bit offset i
+    std::memcpy(&rng.state, s.state, sizeof(s.state));
+    std::memcpy(&rng.inc, s.inc, sizeof(s.inc));
+#else
+    for (int i = 0; i < 8; ++i) {
+        rng.rng[i].state = s.state[i];
+        rng.rng[i].inc = s.inc[i];
+    }
+#endif
+}
+
+static inline void store_rng(const pcg32x<8>& rng, public_pcg32x8_state& s) {
+#if defined(YAVL_X86_AVX512VL) || defined(YAVL_X86_AVX2) || defined(YAVL_X86_SSE42)
+    std::memcpy(s.state, &rng.state, sizeof(s.state));
+    std::memcpy(s.inc, &rng.inc, sizeof(s.inc));
+#else
+    for (int i = 0; i < 8; ++i) {
+        s.state[i] = rng.rng[i].state;
+        s.inc[i] = rng.rng[i].inc;
+    }
+#endif
+}
+
+static void normalize3f(float* x, float* y, float* z, std::size_t n) {
+    using Packet = VecSoA<float, 3>;
+    constexpr uint32_t W = Packet::Width;
+
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) {
+        auto v = Packet::load({ x + i, y + i, z + i });
+        v.normalize();
+        v.store({ x + i, y + i, z + i });
+    }
+
+    if (i < n) {
+        // Pad the tail with unit vectors so the unused lanes stay finite
+        const std::size_t rest = n - i;
+        alignas(64) float tx[W], ty[W], tz[W];
+        for (uint32_t l = 0; l < W; ++l) {
+            tx[l] = 1.f;
+            ty[l] = tz[l] = 0.f;
+        }
+        std::memcpy(tx, x + i, rest * sizeof(float));
+        std::memcpy(ty, y + i, rest * sizeof(float));
+        std::memcpy(tz, z + i, rest * sizeof(float));
+
+        auto v = Packet::load({ tx, ty, tz });
+        v.normalize();
+        v.store({ tx, ty, tz });
+
+        std::memcpy(x + i, tx, rest * sizeof(float));
+        std::memcpy(y + i, ty, rest * sizeof(float));
+        std::memcpy(z + i, tz, rest * sizeof(float));
+    }
+}
+
+static void transform4f(const float* mat, const float* in, float* out,
+    std::size_t n)
+{
+    Mat<float, 4> m;
+    std::memcpy(m.data(), mat, 16 * sizeof(float));
+
+    for (std::size_t i = 0; i < n; ++i) {
+        Vec<float, 4> v;
+        std::memcpy(v.arr.data(), in + i * 4, 4 * sizeof(float));
+        auto r = m * v;
+        std::memcpy(out + i * 4, r.arr.data(), 4 * sizeof(float));
+    }
+}
+
+static void fill_uniform_float(public_pcg32x8_state& s, float* out,
+    std::size_t n)
+{
+    pcg32x<8> rng;
+    load_rng(rng, s);
+    rng.fill_uniform_float({ out, n });
+    store_rng(rng, s);
+}
+
+static void fill_uint32(public_pcg32x8_state& s, uint32_t* out, std::size_t n) {
+    pcg32x<8> rng;
+    load_rng(rng, s);
+    rng.fill_uint32({ out, n });
+    store_rng(rng, s);
+}
+
+} // namespace kernels_impl
+
+} // namespace yavl
+
+#undef yavl
+
+namespace yavl
+{
+
+const kernel_table YAVL_DISPATCH_TABLE {
+    isa_level::YAVL_DISPATCH_LEVEL,
+    &YAVL_DISPATCH_NAMESPACE::kernels_impl::normalize3f,
+    &YAVL_DISPATCH_NAMESPACE::kernels_impl::transform4f,
+    &YAVL_DISPATCH_NAMESPACE::kernels_impl::fill_uniform_float,
+    &YAVL_DISPATCH_NAMESPACE::kernels_impl::fill_uint32
+};
+
+} // namespace yavl
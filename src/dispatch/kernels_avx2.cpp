@@ -0,0 +1,8 @@
+#if !defined(__AVX2__) || !defined(__FMA__) || defined(__AVX512F__)
+#error "kernels_avx2.cpp must be compiled with AVX2 and FMA and without AVX-512"
+#endif
+
+#define YAVL_DISPATCH_LEVEL avx2
+#define YAVL_DISPATCH_NAMESPACE yavl_avx2
+#define YAVL_DISPATCH_TABLE avx2_kernel_table
+#include "kernels.inl"
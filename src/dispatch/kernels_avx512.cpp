@@ -0,0 +1,8 @@
+#if !defined(__AVX512F__) || !defined(__AVX512VL__) || !defined(__AVX512DQ__) || !defined(__AVX512BW__)
+#error "kernels_avx512.cpp must be compiled with AVX512F, VL, DQ and BW"
+#endif
+
+#define YAVL_DISPATCH_LEVEL avx512
+#define YAVL_DISPATCH_NAMESPACE yavl_avx512
+#define YAVL_DISPATCH_TABLE avx512_kernel_table
+#include "kernels.inl"
@@ -0,0 +1,7 @@
+// Fallback level, plain c++ without any yavl simd specialization
+#define YAVL_DISABLE_VECTORIZATION
+
+#define YAVL_DISPATCH_LEVEL scalar
+#define YAVL_DISPATCH_NAMESPACE yavl_scalar
+#define YAVL_DISPATCH_TABLE scalar_kernel_table
+#include "kernels.inl"
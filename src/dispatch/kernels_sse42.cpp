@@ -0,0 +1,8 @@
+#if !defined(__SSE4_2__) || defined(__AVX__)
+#error "kernels_sse42.cpp must be compiled with SSE4.2 and without AVX"
+#endif
+
+#define YAVL_DISPATCH_LEVEL sse42
+#define YAVL_DISPATCH_NAMESPACE yavl_sse42
+#define YAVL_DISPATCH_TABLE sse42_kernel_table
+#include "kernels.inl"
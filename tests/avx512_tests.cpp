@@ -0,0 +1,151 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+using Catch::Approx;
+
+// Built with the AVX-512 flags whatever the host supports, runs natively or
+// under Intel SDE when the machine lacks AVX-512
+#if defined(YAVL_X86_AVX512F) && !defined(YAVL_DISABLE_VECTORIZATION)
+
+TEMPLATE_TEST_CASE("AVX-512 Vec", "[avx512]", (Vec<float, 16>), (Vec<double, 8>)) {
+    using V = TestType;
+    using T = typename V::Scalar;
+    static_assert(V::vectorized && sizeof(V) == 64);
+
+    V a, b;
+    for (uint32_t i = 0; i < V::Size; ++i) {
+        a[i] = T(0.5) + i;
+        b[i] = T(2) - T(0.75) * i;
+    }
+
+    SECTION("Arithmetic") {
+        V add = a + b, sub = a - b, mul = a * b, div = a / b;
+        for (uint32_t i = 0; i < V::Size; ++i) {
+            REQUIRE(add[i] == Approx(a[i] + b[i]));
+            REQUIRE(sub[i] == Approx(a[i] - b[i]));
+            REQUIRE(mul[i] == Approx(a[i] * b[i]));
+            REQUIRE(div[i] == Approx(a[i] / b[i]));
+        }
+        REQUIRE(a == a);
+        REQUIRE(a != b);
+    }
+
+    SECTION("Math funcs") {
+        V abs = b.abs(), sqrt = a.sqrt();
+        T sum = 0;
+        for (uint32_t i = 0; i < V::Size; ++i) {
+            REQUIRE(abs[i] == Approx(std::abs(b[i])));
+            REQUIRE(sqrt[i] == Approx(std::sqrt(a[i])));
+            sum += a[i];
+        }
+        REQUIRE(a.sum() == Approx(sum));
+        REQUIRE(a.dot(b) == Approx((a * b).sum()));
+        REQUIRE((V(0) - a).all());
+        REQUIRE(!a.any());
+        REQUIRE(b.any());
+        REQUIRE(!b.all());
+    }
+
+    SECTION("Rcp and rsqrt") {
+        // Full precision after refinement, well under the 2^-14 of rcp14
+        const T eps = std::is_same_v<T, float> ? 1e-6 : 1e-13;
+        V r = a.rcp(), rs = a.rsqrt();
+        for (uint32_t i = 0; i < V::Size; ++i) {
+            REQUIRE(r[i] == Approx(1 / a[i]).epsilon(eps));
+            REQUIRE(rs[i] == Approx(1 / std::sqrt(a[i])).epsilon(eps));
+        }
+
+        // fixupimm takes over where the Newton-Raphson step gives NaN
+        constexpr T inf = std::numeric_limits<T>::infinity();
+        V special{ 0 };
+        special[1] = inf;
+        special[2] = -T(0);
+        special[3] = std::numeric_limits<T>::quiet_NaN();
+        r = special.rcp();
+        rs = special.rsqrt();
+        REQUIRE(r[0] == inf);
+        REQUIRE(r[1] == 0);
+        REQUIRE(r[2] == -inf);
+        REQUIRE(std::isnan(r[3]));
+        REQUIRE(rs[0] == inf);
+        REQUIRE(rs[1] == 0);
+        REQUIRE(std::isnan(rs[3]));
+    }
+}
+
+TEST_CASE("AVX-512 Mat4f", "[avx512]") {
+    static_assert(sizeof(Mat4f) == sizeof(__m512));
+
+    const Mat4f a{
+        2, 1, 0.5, 0.3,
+        -1, 3, 0.2, 1,
+        0.3, -0.7, 1.5, 2,
+        4, -2, 1, 1
+    };
+    const Mat4f b{
+        1, -2, 0.25, 4,
+        0.5, 1, -1, 2,
+        3, 0, 2, -0.5,
+        -1, 1.5, 0.75, 1
+    };
+    const Vec4f v{ 1, -2, 0.5, 3 };
+
+    // Column major references
+    auto at = [](const Mat4f& m, const uint32_t c, const uint32_t r) {
+        return m.data()[c * 4 + r];
+    };
+
+    auto c = a * b;
+    auto av = a * v;
+    auto t = a.transpose();
+    for (uint32_t j = 0; j < 4; ++j) {
+        float ref_v = 0;
+        for (uint32_t i = 0; i < 4; ++i) {
+            float ref = 0;
+            for (uint32_t k = 0; k < 4; ++k)
+                ref += at(a, k, i) * at(b, j, k);
+            REQUIRE(at(c, j, i) == Approx(ref));
+            REQUIRE(at(t, j, i) == at(a, i, j));
+            ref_v += at(a, i, j) * v[i];
+        }
+        REQUIRE(av[j] == Approx(ref_v));
+    }
+
+    auto [invertible, inv] = a.inverse();
+    REQUIRE(invertible);
+    auto id = a * inv;
+    for (uint32_t j = 0; j < 4; ++j)
+        for (uint32_t i = 0; i < 4; ++i)
+            REQUIRE(at(id, j, i) == Approx(i == j ? 1 : 0).margin(1e-5));
+    REQUIRE(a.determinant() == Approx(10.368));
+}
+
+TEMPLATE_TEST_CASE("AVX-512 masked tails", "[avx512]", float, double) {
+    using T = TestType;
+
+    // Every tail length of one and two zmm packets, the lanes past the end
+    // must be left alone
+    for (std::size_t n = 1; n <= 33; ++n) {
+        std::vector<T> a(n + 16), b(n + 16), out(n + 16, T(-100));
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            a[i] = T(0.25) * i - 1;
+            b[i] = T(3) - T(0.5) * i;
+        }
+
+        assign(std::span<T>(out.data(), n), lazy(std::span<const T>(a.data(), n)) *
+            lazy(std::span<const T>(b.data(), n)) + 2);
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == Approx(a[i] * b[i] + 2));
+        for (std::size_t i = n; i < out.size(); ++i)
+            REQUIRE(out[i] == T(-100));
+    }
+}
+
+#endif
@@ -0,0 +1,124 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/dispatch.h>
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+using Catch::Approx;
+
+TEST_CASE("Runtime cpu features", "[dispatch]") {
+    // Whatever this file was compiled for must be runnable here
+    if constexpr (has_sse42)
+        REQUIRE(runtime_has_sse42());
+    if constexpr (has_avx)
+        REQUIRE(runtime_has_avx());
+    if constexpr (has_avx2)
+        REQUIRE(runtime_has_avx2());
+    if constexpr (has_avx512f)
+        REQUIRE(runtime_has_avx512f());
+
+    // Feature hierarchy
+    if (runtime_has_avx2())
+        REQUIRE(runtime_has_avx());
+    if (runtime_has_avx512vl())
+        REQUIRE(runtime_has_avx512f());
+
+    REQUIRE(isa_level_supported(isa_level::scalar));
+    REQUIRE(isa_level_supported(detect_isa_level()));
+    REQUIRE(!isa_level_supported(isa_level::count));
+    REQUIRE(std::string(isa_level_name(isa_level::avx2)) == "avx2");
+}
+
+TEST_CASE("Dispatched kernels", "[dispatch]") {
+    const std::size_t n = 1003;
+
+    std::vector<float> x(n), y(n), z(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<float>(i % 7) - 3.f;
+        y[i] = static_cast<float>(i % 5) + 0.5f;
+        z[i] = static_cast<float>(i % 11) - 5.f;
+    }
+
+    const float mat[16] = {
+        1.f, 2.f, 3.f, 0.f,
+        0.f, 1.f, 4.f, 0.f,
+        5.f, 6.f, 0.f, 0.f,
+        1.f, 2.f, 3.f, 1.f
+    };
+    std::vector<float> pts(n * 4);
+    for (std::size_t i = 0; i < n * 4; ++i)
+        pts[i] = static_cast<float>(i % 13) * 0.25f - 1.f;
+
+    uint64_t initstate[8], initseq[8];
+    for (int i = 0; i < 8; ++i) {
+        initstate[i] = 0x853c49e6748fea9bull + i * 977;
+        initseq[i] = i * 3 + 1;
+    }
+
+    for (uint32_t l = 0; l < static_cast<uint32_t>(isa_level::count); ++l) {
+        auto level = static_cast<isa_level>(l);
+        if (!isa_level_supported(level)) {
+            REQUIRE(!force_isa_level(level));
+            continue;
+        }
+
+        DYNAMIC_SECTION("Level " << isa_level_name(level)) {
+            REQUIRE(force_isa_level(level));
+            REQUIRE(active_isa_level() == level);
+            REQUIRE(kernels_for(level) == &kernels());
+
+            // Normalize
+            auto nx = x, ny = y, nz = z;
+            kernels().normalize3f(nx.data(), ny.data(), nz.data(), n);
+            for (std::size_t i = 0; i < n; ++i) {
+                auto len = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+                REQUIRE(nx[i] == Approx(x[i] / len).margin(1e-5));
+                REQUIRE(ny[i] == Approx(y[i] / len).margin(1e-5));
+                REQUIRE(nz[i] == Approx(z[i] / len).margin(1e-5));
+            }
+
+            // Transform
+            std::vector<float> out(n * 4);
+            kernels().transform4f(mat, pts.data(), out.data(), n);
+            for (std::size_t i = 0; i < n; ++i) {
+                for (int r = 0; r < 4; ++r) {
+                    float expected = 0.f;
+                    for (int c = 0; c < 4; ++c)
+                        expected += mat[c * 4 + r] * pts[i * 4 + c];
+                    REQUIRE(out[i * 4 + r] == Approx(expected));
+                }
+            }
+
+            // Random fills match 8 scalar generators, twice to check the
+            // state is written back
+            pcg32x8_state rng(initstate, initseq);
+            pcg32 ref[8];
+            for (int i = 0; i < 8; ++i)
+                ref[i].seed(initstate[i], initseq[i]);
+
+            std::vector<uint32_t> uints(n);
+            kernels().fill_uint32(rng, uints.data(), n);
+            for (std::size_t i = 0; i < (n + 7) / 8 * 8; ++i) {
+                auto expected = ref[i % 8].next_uint();
+                if (i < n)
+                    REQUIRE(uints[i] == expected);
+            }
+
+            std::vector<float> floats(n);
+            kernels().fill_uniform_float(rng, floats.data(), n);
+            for (std::size_t i = 0; i < n; ++i) {
+                REQUIRE(floats[i] == ref[i % 8].next_float());
+                REQUIRE(floats[i] >= 0.f);
+                REQUIRE(floats[i] < 1.f);
+            }
+        }
+    }
+
+    reset_isa_level();
+    REQUIRE(active_isa_level() == detect_isa_level());
+}
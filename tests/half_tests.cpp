@@ -0,0 +1,165 @@
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+static constexpr float inf = std::numeric_limits<float>::infinity();
+
+static_assert(half(1.f).bits == 0x3c00);
+static_assert(bfloat16(1.f).bits == 0x3f80);
+static_assert(static_cast<float>(half::from_bits(0x7bff)) == 65504.f);
+
+// The midpoint between every positive finite value k and k + 1 and its two
+// neighbours, which must round to the even one of k and k + 1, to k and to
+// k + 1. Both signs. The last midpoint, 65520 for half, is the overflow
+// threshold
+template <typename T>
+static void rounding_cases(const uint16_t last, std::vector<float>& in,
+    std::vector<uint16_t>& expected)
+{
+    for (uint32_t k = 0; k <= last; ++k) {
+        // One past the largest finite value is the infinity, halfway to it
+        // is another half ulp up. lo + hi would overflow for bfloat16
+        const float lo = T::from_bits(k);
+        const float ulp = k == last ? lo - static_cast<float>(T::from_bits(k - 1))
+            : static_cast<float>(T::from_bits(k + 1)) - lo;
+        const float mid = lo + ulp / 2.f;
+        const uint16_t down = k, up = k + 1;
+        const uint16_t cases[] = { down, (k & 1) ? up : down, up };
+        const float values[] = { std::nextafter(mid, 0.f), mid, std::nextafter(mid, inf) };
+        for (uint32_t c = 0; c < 3; ++c) {
+            for (const float s : { 1.f, -1.f }) {
+                in.push_back(s * values[c]);
+                expected.push_back(cases[c] | (s < 0.f ? 0x8000 : 0));
+            }
+        }
+    }
+}
+
+TEST_CASE("Half conversions", "[half]") {
+    SECTION("Widening is exact") {
+        for (uint32_t b = 0; b < 0x10000; ++b) {
+            const uint16_t e = b & 0x7c00, m = b & 0x3ff;
+            const float f = half::from_bits(b);
+            if (e == 0x7c00 && m) {
+                REQUIRE(std::isnan(f));
+                continue;
+            }
+            const float mag = e ? std::ldexp(1.f + m / 1024.f, (e >> 10) - 15)
+                : std::ldexp(m / 1024.f, -14);
+            REQUIRE(f == (e == 0x7c00 ? inf : mag) * (b & 0x8000 ? -1.f : 1.f));
+            REQUIRE(std::signbit(f) == static_cast<bool>(b & 0x8000));
+            // And narrows back to the same bits
+            REQUIRE(half(f).bits == b);
+        }
+    }
+
+    SECTION("Narrowing rounds to nearest even") {
+        std::vector<float> in;
+        std::vector<uint16_t> expected;
+        rounding_cases<half>(0x7bff, in, expected);
+        std::vector<half> out(in.size());
+        convert(in, out);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            REQUIRE(half(in[i]).bits == expected[i]);
+            REQUIRE(out[i].bits == expected[i]);
+        }
+
+        REQUIRE(half(1e6f).bits == 0x7c00);
+        REQUIRE(half(-inf).bits == 0xfc00);
+        REQUIRE(half(1e-10f).bits == 0);
+        REQUIRE(half(-0.f).bits == 0x8000);
+        REQUIRE(std::isnan(static_cast<float>(half(std::numeric_limits<float>::quiet_NaN()))));
+        REQUIRE(std::isnan(static_cast<float>(half(std::numeric_limits<float>::signaling_NaN()))));
+    }
+}
+
+TEST_CASE("Bfloat16 conversions", "[half]") {
+    SECTION("Widening is exact") {
+        for (uint32_t b = 0; b < 0x10000; ++b) {
+            const float f = bfloat16::from_bits(b);
+            uint32_t x;
+            std::memcpy(&x, &f, sizeof(x));
+            REQUIRE(x == b << 16);
+            if (!std::isnan(f))
+                REQUIRE(bfloat16(f).bits == b);
+        }
+    }
+
+    SECTION("Narrowing rounds to nearest even") {
+        std::vector<float> in;
+        std::vector<uint16_t> expected;
+        rounding_cases<bfloat16>(0x7f7f, in, expected);
+        std::vector<bfloat16> out(in.size());
+        convert(in, out);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            REQUIRE(bfloat16(in[i]).bits == expected[i]);
+            // AVX512-BF16 flushes denormals to zero
+            if (!has_avx512bf16 || std::abs(in[i]) >= std::numeric_limits<float>::min())
+                REQUIRE(out[i].bits == expected[i]);
+        }
+
+        const float nans[] = { std::numeric_limits<float>::quiet_NaN(),
+            -std::numeric_limits<float>::quiet_NaN(), std::bit_cast<float>(0x7f80ffffu) };
+        for (const float n : nans)
+            REQUIRE(std::isnan(static_cast<float>(bfloat16(n))));
+        std::vector<bfloat16> nan_out(64);
+        convert(std::vector<float>(64, nans[2]), nan_out);
+        for (const auto b : nan_out)
+            REQUIRE(std::isnan(static_cast<float>(b)));
+    }
+}
+
+TEMPLATE_TEST_CASE("Bulk conversions", "[half]", half, bfloat16) {
+    // Sizes around the packet widths of every backend
+    for (const std::size_t n : { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1000 }) {
+        std::vector<float> src(n), back(n);
+        for (std::size_t i = 0; i < n; ++i)
+            src[i] = std::sin(i * 0.37f) * 100.f;
+        std::vector<TestType> narrowed(n);
+        convert(src, narrowed);
+        convert(narrowed, back);
+        for (std::size_t i = 0; i < n; ++i) {
+            REQUIRE(narrowed[i].bits == TestType(src[i]).bits);
+            REQUIRE(back[i] == static_cast<float>(narrowed[i]));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Vec storage", "[half]", half, bfloat16) {
+    static_assert(sizeof(Vec<TestType, 3>) == 3 * sizeof(TestType));
+
+    const Vec<TestType, 3> v3(1.f, -2.5f, 0.1f);
+    const Vec<TestType, 4> v4(1.f, -2.5f, 0.1f, 65504.f);
+    REQUIRE(v3.x.bits == TestType(1.f).bits);
+    REQUIRE(v3.z.bits == TestType(0.1f).bits);
+
+    const Vec3f w3 = widen(v3);
+    const Vec4f w4 = widen(v4);
+    for (uint32_t i = 0; i < 3; ++i)
+        REQUIRE(w3[i] == static_cast<float>(v3[i]));
+    for (uint32_t i = 0; i < 4; ++i)
+        REQUIRE(w4[i] == static_cast<float>(v4[i]));
+
+    const Vec4f f4(0.1f, -1e-3f, 12345.678f, 1e5f);
+    const auto n4 = narrow<TestType>(f4);
+    const auto n3 = narrow<TestType>(Vec3f(0.1f, -1e-3f, 12345.678f));
+    for (uint32_t i = 0; i < 4; ++i)
+        REQUIRE(n4[i].bits == TestType(f4[i]).bits);
+    for (uint32_t i = 0; i < 3; ++i)
+        REQUIRE(n3[i].bits == TestType(f4[i]).bits);
+
+    // Arrays of Vecs are arrays of scalars
+    std::vector<Vec<TestType, 3>> verts(5, v3);
+    std::vector<float> flat(15);
+    convert(std::span<const TestType>(&verts[0].x, 15), flat);
+    for (std::size_t i = 0; i < 15; ++i)
+        REQUIRE(flat[i] == w3[i % 3]);
+}
@@ -0,0 +1,280 @@
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+static constexpr float inf = std::numeric_limits<float>::infinity();
+
+// Slab test in double with exact division, entry distance or -1 on a miss.
+// Zero directions are handled by the origin test
+static double ref_box(const Vec3f& o, const Vec3f& d, const float tmin,
+    const float tmax, const Vec3f& lo, const Vec3f& hi)
+{
+    double t0 = tmin, t1 = tmax;
+    for (uint32_t a = 0; a < 3; ++a) {
+        if (d[a] == 0.f) {
+            if (o[a] < lo[a] || o[a] > hi[a])
+                return -1.;
+            continue;
+        }
+        double n = (static_cast<double>(lo[a]) - o[a]) / d[a];
+        double f = (static_cast<double>(hi[a]) - o[a]) / d[a];
+        if (n > f)
+            std::swap(n, f);
+        t0 = std::max(t0, n);
+        t1 = std::min(t1, f);
+    }
+    return t0 <= t1 ? t0 : -1.;
+}
+
+// Moller-Trumbore in double, t or -1 on a miss
+static double ref_triangle(const Vec3f& o, const Vec3f& d, const float tmin,
+    const float tmax, const Vec3f& a, const Vec3f& b, const Vec3f& c)
+{
+    double e1[3], e2[3], s[3], p[3], q[3], dd[3];
+    for (uint32_t i = 0; i < 3; ++i) {
+        e1[i] = static_cast<double>(b[i]) - a[i];
+        e2[i] = static_cast<double>(c[i]) - a[i];
+        s[i] = static_cast<double>(o[i]) - a[i];
+        dd[i] = d[i];
+    }
+    auto cross = [](const double* x, const double* y, double* z) {
+        z[0] = x[1] * y[2] - x[2] * y[1];
+        z[1] = x[2] * y[0] - x[0] * y[2];
+        z[2] = x[0] * y[1] - x[1] * y[0];
+    };
+    auto dot = [](const double* x, const double* y) {
+        return x[0] * y[0] + x[1] * y[1] + x[2] * y[2];
+    };
+    cross(dd, e2, p);
+    const double det = dot(e1, p);
+    if (det == 0.)
+        return -1.;
+    cross(s, e1, q);
+    const double u = dot(s, p) / det, v = dot(dd, q) / det, t = dot(e2, q) / det;
+    return u >= 0. && v >= 0. && u + v <= 1. && t >= tmin && t <= tmax ? t : -1.;
+}
+
+static Vec3f random_vec(pcg32& rng, const float scale) {
+    return Vec3f(rng.next_float() * 2.f - 1.f, rng.next_float() * 2.f - 1.f,
+        rng.next_float() * 2.f - 1.f) * scale;
+}
+
+TEMPLATE_TEST_CASE("Ray box packets", "[intersect]", (std::integral_constant<uint32_t, 4>),
+    (std::integral_constant<uint32_t, 8>), (std::integral_constant<uint32_t, 16>))
+{
+    constexpr uint32_t W = TestType::value;
+    pcg32 rng;
+
+    SECTION("Random rays against a reference") {
+        for (int iter = 0; iter < 500; ++iter) {
+            RaySoA<W> rays;
+            BoxSoA<W> boxes;
+            std::vector<Ray> rs(W);
+            std::vector<std::pair<Vec3f, Vec3f>> bs(W);
+            for (uint32_t l = 0; l < W; ++l) {
+                rs[l] = Ray(random_vec(rng, 4.f), random_vec(rng, 1.f), 0.f,
+                    l % 5 == 0 ? 2.f : inf);
+                rays.set(l, rs[l]);
+                const Vec3f c = random_vec(rng, 3.f), e = random_vec(rng, 1.f).abs();
+                bs[l] = { c - e, c + e };
+                boxes.set(l, c - e, c + e);
+            }
+
+            // Ray l against the W boxes
+            std::vector<BoxHits<W>> singles(W);
+            for (uint32_t l = 0; l < W; ++l)
+                singles[l] = intersect_box(rs[l], boxes);
+
+            for (uint32_t k = 0; k < W; ++k) {
+                // The W rays against box k
+                const auto packet = intersect_box(rays, bs[k].first, bs[k].second);
+                for (uint32_t l = 0; l < W; ++l) {
+                    // Both shapes do the same arithmetic on a pair
+                    const bool hit = packet.mask >> l & 1;
+                    REQUIRE(hit == static_cast<bool>(singles[l].mask >> k & 1));
+                    REQUIRE(packet.tnear[l] == singles[l].tnear[k]);
+
+                    const auto& r = rs[l];
+                    const double t = ref_box(r.org, r.dir, r.tmin, r.tmax, bs[k].first, bs[k].second);
+                    // Grazing rays may go either way
+                    if (t < 0. && ref_box(r.org, r.dir, r.tmin, r.tmax * 1.001f,
+                        bs[k].first - Vec3f(1e-3f), bs[k].second + Vec3f(1e-3f)) >= 0.)
+                        continue;
+                    REQUIRE(hit == (t >= 0.));
+                    if (hit)
+                        REQUIRE(packet.tnear[l] == Catch::Approx(t).margin(1e-4));
+                    else
+                        REQUIRE(packet.tnear[l] == inf);
+                }
+            }
+        }
+    }
+
+    SECTION("Axis parallel rays") {
+        const Vec3f lo(-1.f, -1.f, -1.f), hi(1.f, 1.f, 1.f);
+        RaySoA<W> rays;
+        const Ray cases[] = {
+            Ray(Vec3f(-5.f, 0.f, 0.f), Vec3f(1.f, 0.f, 0.f)),      // Through the middle
+            Ray(Vec3f(-5.f, 1.f, 0.f), Vec3f(1.f, 0.f, 0.f)),      // Along a face
+            Ray(Vec3f(-5.f, -1.f, -1.f), Vec3f(1.f, -0.f, 0.f)),   // Along an edge, -0
+            Ray(Vec3f(-5.f, 1.5f, 0.f), Vec3f(1.f, 0.f, 0.f)),     // Beside it
+            Ray(Vec3f(5.f, 0.f, 0.f), Vec3f(1.f, 0.f, 0.f)),       // Going away
+            Ray(Vec3f(0.f, 5.f, 0.f), Vec3f(0.f, -1.f, 0.f)),      // Down y
+            Ray(Vec3f(0.f, 0.f, 0.f), Vec3f(0.f, 0.f, 0.f)),       // No direction, inside
+            Ray(Vec3f(0.f, 2.f, 0.f), Vec3f(0.f, 0.f, 0.f)),       // No direction, outside
+        };
+        const bool expected[] = { true, true, true, false, false, true, true, false };
+        const float tnear[] = { 4.f, 4.f, 4.f, inf, inf, 4.f, 0.f, inf };
+        constexpr uint32_t count = std::min<uint32_t>(W, 8);
+        for (uint32_t l = 0; l < count; ++l)
+            rays.set(l, cases[l]);
+
+        const auto packet = intersect_box(rays, lo, hi);
+        BoxSoA<W> boxes;
+        boxes.set(0, lo, hi);
+        for (uint32_t l = 0; l < count; ++l) {
+            REQUIRE((packet.mask >> l & 1) == expected[l]);
+            REQUIRE(packet.tnear[l] == Catch::Approx(tnear[l]));
+            REQUIRE((intersect_box(cases[l], boxes).mask & 1) == expected[l]);
+        }
+        // Inactive lanes of the default constructed packet
+        REQUIRE(packet.mask >> count == 0);
+    }
+
+    SECTION("Empty boxes, inactive lanes and short rays miss") {
+        const Ray r(Vec3f(0.f, 0.f, -5.f), Vec3f(0.f, 0.f, 1.f));
+        BoxSoA<W> boxes;
+        REQUIRE(intersect_box(r, boxes).mask == 0);
+        boxes.set(0, Vec3f(-1.f), Vec3f(1.f));
+        boxes.set(1, Vec3f(1.f), Vec3f(-1.f));
+        REQUIRE(intersect_box(r, boxes).mask == 1);
+        REQUIRE(intersect_box(Ray(r.org, r.dir, 0.f, 3.9f), boxes).mask == 0);
+
+        RaySoA<W> rays;
+        rays.set(0, r);
+        rays.set(1, Ray(r.org, r.dir, 2.f, 1.f));
+        rays.set(2, Ray(r.org, r.dir, 0.f, 3.9f));
+        rays.set(3, Ray(r.org, r.dir, 5.f, 6.f));
+        const auto hits = intersect_box(rays, Vec3f(-1.f), Vec3f(1.f));
+        REQUIRE(hits.mask == 0b1001);
+        REQUIRE(hits.tnear[0] == Catch::Approx(4.f));
+        REQUIRE(hits.tnear[3] == Catch::Approx(5.f));
+        REQUIRE(intersect_box(rays, Vec3f(1.f), Vec3f(-1.f)).mask == 0);
+    }
+}
+
+TEMPLATE_TEST_CASE("Ray triangle packets", "[intersect]", (std::integral_constant<uint32_t, 4>),
+    (std::integral_constant<uint32_t, 8>), (std::integral_constant<uint32_t, 16>))
+{
+    constexpr uint32_t W = TestType::value;
+    pcg32 rng;
+
+    SECTION("Random rays against a reference") {
+        for (int iter = 0; iter < 500; ++iter) {
+            RaySoA<W> rays;
+            TriangleSoA<W> tris;
+            std::vector<Ray> rs(W);
+            std::vector<std::array<Vec3f, 3>> ts(W);
+            for (uint32_t l = 0; l < W; ++l) {
+                // Aimed at the unit cube so about half of them hit
+                const Vec3f o = random_vec(rng, 4.f);
+                rs[l] = Ray(o, random_vec(rng, 0.5f) - o, 0.f, l % 3 == 0 ? 0.8f : inf);
+                rays.set(l, rs[l]);
+                ts[l] = { random_vec(rng, 1.f), random_vec(rng, 1.f), random_vec(rng, 1.f) };
+                tris.set(l, ts[l][0], ts[l][1], ts[l][2]);
+            }
+
+            std::vector<TriangleHits<W>> singles(W);
+            for (uint32_t l = 0; l < W; ++l)
+                singles[l] = intersect_triangle<precision::exact>(rs[l], tris);
+
+            for (uint32_t k = 0; k < W; ++k) {
+                const auto& t = ts[k];
+                const auto packet = intersect_triangle<precision::exact>(rays, t[0], t[1], t[2]);
+                for (uint32_t l = 0; l < W; ++l) {
+                    const bool hit = packet.mask >> l & 1;
+                    REQUIRE(hit == static_cast<bool>(singles[l].mask >> k & 1));
+                    REQUIRE(packet.t[l] == singles[l].t[k]);
+
+                    const auto& r = rs[l];
+                    const double ref = ref_triangle(r.org, r.dir, r.tmin, r.tmax, t[0], t[1], t[2]);
+                    // Rays close to an edge may go either way
+                    const Vec3f c = (t[0] + t[1] + t[2]) / 3.f;
+                    const double grown = ref_triangle(r.org, r.dir, r.tmin, r.tmax * 1.001f,
+                        t[0] + (t[0] - c) * 1e-3f, t[1] + (t[1] - c) * 1e-3f, t[2] + (t[2] - c) * 1e-3f);
+                    const double shrunk = ref_triangle(r.org, r.dir, r.tmin, r.tmax * 0.999f,
+                        t[0] - (t[0] - c) * 1e-3f, t[1] - (t[1] - c) * 1e-3f, t[2] - (t[2] - c) * 1e-3f);
+                    if ((grown >= 0.) != (shrunk >= 0.))
+                        continue;
+                    REQUIRE(hit == (ref >= 0.));
+                    if (hit) {
+                        REQUIRE(packet.t[l] == Catch::Approx(ref).margin(1e-4));
+                        // The barycentrics give back the hit point
+                        const Vec3f p = r.org + r.dir * packet.t[l];
+                        const Vec3f q = t[0] * (1.f - packet.u[l] - packet.v[l])
+                            + t[1] * packet.u[l] + t[2] * packet.v[l];
+                        for (uint32_t a = 0; a < 3; ++a)
+                            REQUIRE(p[a] == Catch::Approx(q[a]).margin(1e-3));
+                    }
+                    else {
+                        REQUIRE(packet.t[l] == r.tmax);
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("Parallel, degenerate and NaN") {
+        const Vec3f a(-1.f, -1.f, 0.f), b(1.f, -1.f, 0.f), c(0.f, 1.f, 0.f);
+        RaySoA<W> rays;
+        rays.set(0, Ray(Vec3f(0.f, 0.f, -1.f), Vec3f(0.f, 0.f, 1.f)));  // Hit at 1
+        rays.set(1, Ray(Vec3f(-5.f, 0.f, 0.f), Vec3f(1.f, 0.f, 0.f)));  // In the plane
+        rays.set(2, Ray(Vec3f(0.f, 0.f, 1.f), Vec3f(0.f, 0.f, 1.f)));   // Behind
+        rays.set(3, Ray(Vec3f(0.f, 0.f, -1.f), Vec3f(0.f, std::numeric_limits<float>::quiet_NaN(), 1.f)));
+        const auto hits = intersect_triangle(rays, a, b, c);
+        REQUIRE(hits.mask == 1);
+        REQUIRE(hits.t[0] == Catch::Approx(1.f));
+        REQUIRE(hits.u[0] == Catch::Approx(0.25f));
+        REQUIRE(hits.v[0] == Catch::Approx(0.5f));
+
+        // Default lanes are degenerate
+        TriangleSoA<W> tris;
+        const Ray r(Vec3f(0.f, 0.f, -1.f), Vec3f(0.f, 0.f, 1.f));
+        REQUIRE(intersect_triangle(r, tris).mask == 0);
+        tris.set(W - 1, a, b, c);
+        tris.set(1, a, b, a);
+        REQUIRE(intersect_triangle(r, tris).mask == 1u << (W - 1));
+    }
+
+    SECTION("Closest hits") {
+        // A stack of triangles along z, the ray meets the nearest first
+        TriangleSoA<W> tris;
+        for (uint32_t l = 0; l < W; ++l) {
+            const float z = 10.f - std::abs(static_cast<float>(l) - W / 2.f);
+            tris.set(l, Vec3f(-1.f, -1.f, z), Vec3f(1.f, -1.f, z), Vec3f(0.f, 1.f, z));
+        }
+        const auto hits = intersect_triangle(Ray(Vec3f(0.f), Vec3f(0.f, 0.f, 1.f)), tris);
+        REQUIRE(std::popcount(hits.mask) == W);
+        REQUIRE(hits.closest() == 0);
+        REQUIRE(hits.t[hits.closest()] == Catch::Approx(10.f - W / 2.f));
+        REQUIRE(TriangleHits<W>().closest() == W);
+
+        // Shrinking tmax to the hits keeps the nearest
+        RaySoA<W> rays;
+        for (uint32_t l = 0; l < W; ++l)
+            rays.set(l, Ray(Vec3f(0.f), Vec3f(0.f, 0.f, 1.f)));
+        for (uint32_t l = 0; l < W; ++l) {
+            rays.tmax = intersect_triangle(rays, tris.v0.get(l), tris.v0.get(l) + tris.e1.get(l),
+                tris.v0.get(l) + tris.e2.get(l)).t;
+        }
+        for (uint32_t l = 0; l < W; ++l)
+            REQUIRE(rays.tmax[l] == Catch::Approx(10.f - W / 2.f));
+    }
+}
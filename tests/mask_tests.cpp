@@ -0,0 +1,175 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Lane values with ties, signed zeros and a NaN so every compare has lanes
+// of both results
+template <typename V>
+static V lanes(const uint32_t seed) {
+    using T = typename V::Scalar;
+    V v;
+    for (uint32_t l = 0; l < V::Size; ++l) {
+        const uint32_t k = (l * 7 + seed * 3) % 5;
+        v[l] = static_cast<T>(static_cast<int>(k) - 2);
+        if constexpr (std::is_floating_point_v<T>) {
+            if (l == 5 && seed == 1)
+                v[l] = std::numeric_limits<T>::quiet_NaN();
+            if (k == 2 && seed == 0)
+                v[l] = static_cast<T>(-0.);
+        }
+    }
+    return v;
+}
+
+template <typename V, typename F>
+static uint32_t ref_bits(const V& a, const V& b, const F& f) {
+    uint32_t r = 0;
+    for (uint32_t l = 0; l < V::Size; ++l)
+        r |= static_cast<uint32_t>(f(a[l], b[l])) << l;
+    return r;
+}
+
+#define MASK_TYPES Vec2f, Vec3f, Vec4f, (Vec<float, 8>), (Vec<float, 16>), \
+    Vec2d, Vec3d, Vec4d, (Vec<double, 8>), Vec4i
+
+TEMPLATE_TEST_CASE("Lane compares", "[mask]", MASK_TYPES) {
+    using T = typename TestType::Scalar;
+    constexpr uint32_t N = TestType::Size;
+    using M = Mask<T, N>;
+    const auto a = lanes<TestType>(0), b = lanes<TestType>(1);
+
+    REQUIRE((a < b).bits() == ref_bits(a, b, [](T x, T y) { return x < y; }));
+    REQUIRE((a <= b).bits() == ref_bits(a, b, [](T x, T y) { return x <= y; }));
+    REQUIRE((a > b).bits() == ref_bits(a, b, [](T x, T y) { return x > y; }));
+    REQUIRE((a >= b).bits() == ref_bits(a, b, [](T x, T y) { return x >= y; }));
+    REQUIRE(eq(a, b).bits() == ref_bits(a, b, [](T x, T y) { return x == y; }));
+    REQUIRE(neq(a, b).bits() == ref_bits(a, b, [](T x, T y) { return x != y; }));
+    REQUIRE(lt(a, b) == (a < b));
+    REQUIRE(ge(b, a) == (a <= b));
+
+    // Equal Vecs, the padding lane of the 3 wide ones stays out
+    REQUIRE(eq(a, a).all());
+    REQUIRE(eq(a, a).bits() == M::lanes);
+    REQUIRE(lt(a, a).none());
+    REQUIRE(neq(a, a).none());
+}
+
+TEMPLATE_TEST_CASE("Mask bits", "[mask]", MASK_TYPES) {
+    using T = typename TestType::Scalar;
+    constexpr uint32_t N = TestType::Size;
+    using M = Mask<T, N>;
+
+    REQUIRE(M().none());
+    REQUIRE(M(true).all());
+    REQUIRE(M(true).count() == N);
+    REQUIRE(M().first() == N);
+
+    const uint32_t patterns[] = { 0u, 1u, 0b1010u, 0xffffu, 0x8000u, 0b0110u };
+    for (const uint32_t p : patterns) {
+        const M m = M::from_bits(p), k = M::from_bits(p * 3 + 1);
+        const uint32_t b = p & M::lanes, c = (p * 3 + 1) & M::lanes;
+        REQUIRE(m.bits() == b);
+        REQUIRE(m.count() == static_cast<uint32_t>(std::popcount(b)));
+        REQUIRE(m.first() == (b ? static_cast<uint32_t>(std::countr_zero(b)) : N));
+        REQUIRE(m.any() == (b != 0));
+        REQUIRE(m.all() == (b == M::lanes));
+        for (uint32_t l = 0; l < N; ++l)
+            REQUIRE(m[l] == static_cast<bool>((b >> l) & 1));
+
+        REQUIRE((m & k).bits() == (b & c));
+        REQUIRE((m | k).bits() == (b | c));
+        REQUIRE((m ^ k).bits() == (b ^ c));
+        REQUIRE((~m).bits() == (~b & M::lanes));
+        REQUIRE(M::andnot(m, k).bits() == (~b & c));
+    }
+
+    for (uint32_t n = 0; n <= N; ++n)
+        REQUIRE(M::first_n(n).count() == n);
+}
+
+TEMPLATE_TEST_CASE("Select and masked moves", "[mask]", MASK_TYPES) {
+    using T = typename TestType::Scalar;
+    constexpr uint32_t N = TestType::Size;
+    using M = Mask<T, N>;
+    const auto a = lanes<TestType>(0), b = lanes<TestType>(2);
+    const T sentinel = static_cast<T>(99);
+
+    for (const uint32_t p : { 0u, 1u, 0b1001u, 0xaaaau, 0xffffu }) {
+        const M m = M::from_bits(p);
+        const auto s = select(m, a, b);
+        for (uint32_t l = 0; l < N; ++l)
+            REQUIRE(s[l] == (m[l] ? a[l] : b[l]));
+
+        // One element past the lanes catches writes through padding lanes
+        std::vector<T> mem(N + 1, sentinel);
+        for (uint32_t l = 0; l < N; ++l)
+            mem[l] = static_cast<T>(l + 1);
+        const auto loaded = masked_load(mem.data(), m);
+        for (uint32_t l = 0; l < N; ++l)
+            REQUIRE(loaded[l] == (m[l] ? static_cast<T>(l + 1) : T(0)));
+
+        masked_store(mem.data(), a, ~m);
+        for (uint32_t l = 0; l < N; ++l)
+            REQUIRE(mem[l] == (m[l] ? static_cast<T>(l + 1) : a[l]));
+        REQUIRE(mem[N] == sentinel);
+
+        std::vector<T> packed(N + 1, sentinel);
+        std::vector<uint32_t> idx(N + 1, 1000);
+        const uint32_t n = compress_store(packed.data(), b, m);
+        REQUIRE(n == m.count());
+        REQUIRE(compress_indices(idx.data(), 40, m) == n);
+        uint32_t k = 0;
+        for (uint32_t l = 0; l < N; ++l) {
+            if (m[l]) {
+                REQUIRE(packed[k] == b[l]);
+                REQUIRE(idx[k] == 40 + l);
+                ++k;
+            }
+        }
+        for (; k <= N; ++k) {
+            REQUIRE(packed[k] == sentinel);
+            REQUIRE(idx[k] == 1000);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Branch free culling", "[mask]", Vec4f, (Vec<float, 8>), (Vec<float, 16>)) {
+    constexpr uint32_t W = TestType::Size;
+    using M = Mask<float, W>;
+
+    // Distances against a radius, survivors packed by index and value. The
+    // tail is a masked load of the last n < W elements
+    for (const std::size_t n : { 0, 1, 5, 64, 1000, 1003 }) {
+        std::vector<float> d(n);
+        for (std::size_t i = 0; i < n; ++i)
+            d[i] = std::sin(i * 0.37f) * 2.f;
+        std::vector<uint32_t> ref_idx;
+        for (std::size_t i = 0; i < n; ++i)
+            if (d[i] < 0.5f)
+                ref_idx.push_back(static_cast<uint32_t>(i));
+
+        std::vector<uint32_t> idx(n + W);
+        std::vector<float> vals(n + W);
+        uint32_t k = 0, kv = 0;
+        const TestType r(0.5f);
+        for (std::size_t i = 0; i < n; i += W) {
+            const auto tail = M::first_n(static_cast<uint32_t>(std::min<std::size_t>(W, n - i)));
+            const auto v = masked_load(d.data() + i, tail);
+            const auto keep = (v < r) & tail;
+            k += compress_indices(idx.data() + k, static_cast<uint32_t>(i), keep);
+            kv += compress_store(vals.data() + kv, v, keep);
+        }
+        REQUIRE(k == ref_idx.size());
+        REQUIRE(kv == k);
+        for (uint32_t j = 0; j < k; ++j) {
+            REQUIRE(idx[j] == ref_idx[j]);
+            REQUIRE(vals[j] == d[ref_idx[j]]);
+        }
+    }
+}
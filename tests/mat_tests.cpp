@@ -1,3 +1,6 @@
+#include <span>
+#include <vector>
+
 #include <catch2/catch_all.hpp>
 
 #include <yavl/yavl.h>
@@ -134,4 +137,584 @@ TEMPLATE_PRODUCT_TEST_CASE("Mat tests", "[mat]", (Mat2, Mat3, Mat4), (float, dou
         if constexpr (is_float_v<typename TestType::Scalar> && TestType::Size == 4)
             REQUIRE(TestType::vectorized == true);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Bulk transforms", "[mat]") {
+    const Mat4f m{
+        0.8f, 0.3f, -0.2f, 0.f,
+        -0.4f, 1.5f, 0.6f, 0.f,
+        0.1f, -0.7f, 2.f, 0.f,
+        3.f, -2.f, 1.f, 1.f
+    };
+    const store_policy policies[] = {
+        store_policy::cached, store_policy::streaming, store_policy::automatic
+    };
+
+    // Sizes around the batch widths, plus an offset start so the streaming
+    // path has an unaligned head to deal with
+    for (std::size_t n : { 0, 1, 7, 8, 15, 16, 17, 33, 1000 }) {
+        for (std::size_t offset : { 0, 1 }) {
+            for (auto policy : policies) {
+                std::vector<Vec3f> pts(n + offset), out3(n + offset);
+                std::vector<Vec4f> pts4(n + offset), out4(n + offset);
+                for (std::size_t i = 0; i < n + offset; ++i) {
+                    pts[i] = Vec3f{ i * 0.5f - 3.f, 1.f - i * 0.25f, i % 7 * 1.f };
+                    pts4[i] = Vec4f{ pts[i].x, pts[i].y, pts[i].z, i % 3 * 0.5f };
+                }
+                std::span<const Vec3f> in{ pts.data() + offset, n };
+                std::span<Vec3f> out{ out3.data() + offset, n };
+
+                transform_points(m, in, out, policy);
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto p = in[i];
+                    auto e = m * Vec4f{ p.x, p.y, p.z, 1.f };
+                    REQUIRE(out[i].x == Approx(e.x));
+                    REQUIRE(out[i].y == Approx(e.y));
+                    REQUIRE(out[i].z == Approx(e.z));
+                }
+
+                transform_directions(m, in, out, policy);
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto p = in[i];
+                    auto e = m * Vec4f{ p.x, p.y, p.z, 0.f };
+                    REQUIRE(out[i].x == Approx(e.x).margin(1e-5));
+                    REQUIRE(out[i].y == Approx(e.y).margin(1e-5));
+                    REQUIRE(out[i].z == Approx(e.z).margin(1e-5));
+                }
+
+                transform_points(m, std::span<const Vec4f>{ pts4.data() + offset, n },
+                    std::span<Vec4f>{ out4.data() + offset, n }, policy);
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto e = m * pts4[offset + i];
+                    for (uint32_t c = 0; c < 4; ++c)
+                        REQUIRE(out4[offset + i][c] == Approx(e[c]).margin(1e-5));
+                }
+
+                // Normals stay perpendicular to transformed tangents
+                transform_normals(m, in, out, policy);
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto p = in[i];
+                    Vec3f t{ p.y, -p.x, 0.f };
+                    auto tt = m * Vec4f{ t.x, t.y, t.z, 0.f };
+                    auto d = out[i].x * tt.x + out[i].y * tt.y + out[i].z * tt.z;
+                    auto scale = out[i].length() * Vec3f{ tt.x, tt.y, tt.z }.length();
+                    REQUIRE(d == Approx(0.f).margin(1e-5f * scale + 1e-6f));
+                }
+            }
+        }
+    }
+
+    // In place
+    std::vector<Vec3f> pts(37), ref(37);
+    for (std::size_t i = 0; i < pts.size(); ++i)
+        pts[i] = Vec3f{ i * 1.f, i * 2.f, i * 3.f };
+    transform_points(m, pts, ref);
+    transform_points(m, pts, pts);
+    for (std::size_t i = 0; i < pts.size(); ++i) {
+        REQUIRE(pts[i].x == ref[i].x);
+        REQUIRE(pts[i].y == ref[i].y);
+        REQUIRE(pts[i].z == ref[i].z);
+    }
+}
+
+TEMPLATE_TEST_CASE("Mat3 inverse", "[mat]", Mat3f, Mat3d) {
+    using T = typename TestType::Scalar;
+    const T eps = std::is_same_v<T, float> ? 1e-5 : 1e-12;
+
+    // Not symmetric, so transposed cofactors show up
+    const TestType a{
+        2, 1, 0.5,
+        -1, 3, 0.2,
+        0.3, -0.7, 1.5
+    };
+    auto [invertible, inv] = a.inverse();
+    REQUIRE(invertible);
+    const auto id = a * inv;
+    for (uint32_t i = 0; i < 3; ++i)
+        for (uint32_t j = 0; j < 3; ++j)
+            REQUIRE(id[i][j] == Approx(i == j ? 1 : 0).margin(eps));
+}
+
+TEST_CASE("View transforms", "[mat][view]") {
+    const Mat4f m{
+        0.8f, 0.3f, -0.2f, 0.f,
+        -0.4f, 1.5f, 0.6f, 0.f,
+        0.1f, -0.7f, 2.f, 0.f,
+        3.f, -2.f, 1.f, 1.f
+    };
+
+    // Packed xyz in, interleaved position and normal records out
+    for (std::size_t n : { 0, 1, 7, 8, 15, 16, 17, 33, 1000 }) {
+        std::vector<float> xyz(n * 3), vertices(n * 6, -1.f), xyzw(n * 4);
+        std::vector<Vec3f> pts(n), ref(n);
+        std::vector<Vec4f> pts4(n), ref4(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            pts[i] = Vec3f{ i * 0.5f - 3.f, 1.f - i * 0.25f, i % 7 * 1.f };
+            pts4[i] = Vec4f{ pts[i].x, pts[i].y, pts[i].z, i % 3 * 0.5f };
+            for (uint32_t c = 0; c < 3; ++c)
+                xyz[i * 3 + c] = pts[i][c];
+            for (uint32_t c = 0; c < 4; ++c)
+                xyzw[i * 4 + c] = pts4[i][c];
+        }
+        Vec3fView in(xyz.data(), n);
+        StridedView<float, 3> positions(vertices.data(), n, 6);
+        StridedView<float, 3> normals(vertices.data() + 3, n, 6);
+
+        auto require_near = [&](const auto& view, const std::vector<Vec3f>& expected) {
+            for (std::size_t i = 0; i < n; ++i)
+                for (uint32_t c = 0; c < 3; ++c)
+                    REQUIRE(view[i][c] == Approx(expected[i][c]).margin(1e-5));
+        };
+
+        transform_points(m, in, positions);
+        transform_points(m, pts, ref);
+        require_near(positions, ref);
+
+        transform_normals(m, in, normals);
+        transform_normals(m, pts, ref);
+        require_near(normals, ref);
+        transform_points(m, pts, ref);
+        require_near(positions, ref);
+
+        transform_directions(m, in, in);
+        transform_directions(m, pts, ref);
+        require_near(in, ref);
+
+        Vec4fView in4(xyzw.data(), n);
+        transform_points(m, in4, in4);
+        transform_points(m, pts4, ref4);
+        for (std::size_t i = 0; i < n; ++i)
+            for (uint32_t c = 0; c < 4; ++c)
+                REQUIRE(in4[i][c] == Approx(ref4[i][c]).margin(1e-5));
+    }
+}
+
+TEST_CASE("Mat views", "[mat][view]") {
+    // Matrices a record of 20 floats apart, tagged after the 16 elements
+    const std::size_t n = 19, stride = 20;
+    std::vector<float> a(n * stride, -1.f), b(n * 16);
+    std::vector<Mat4f> ma(n), mb(n), out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (uint32_t e = 0; e < 16; ++e) {
+            a[i * stride + e] = ma[i].data()[e] = std::sin(i * 0.7f + e * 0.31f) * 2.f;
+            // Diagonally dominant so the inverses exist
+            b[i * 16 + e] = mb[i].data()[e] = std::cos(i * 0.3f - e * 0.17f) +
+                (e % 5 ? 0.f : 4.f);
+        }
+    }
+    MatView<float, 4, view_layout::strided> va(a.data(), n, stride);
+    Mat4fView vb(b.data(), n);
+    MatView<float, 4, view_layout::aligned> vo{ std::span<const Mat4f>(out) };
+
+    auto require_near = [](const Mat4f& x, const Mat4f& y) {
+        for (uint32_t e = 0; e < 16; ++e)
+            REQUIRE(x.data()[e] == Approx(y.data()[e]).margin(1e-5));
+    };
+
+    SECTION("Element and packet access") {
+        for (std::size_t i = 0; i < n; ++i)
+            require_near(va[i], ma[i]);
+        auto p = va.load<8>(8);
+        for (uint32_t l = 0; l < 8; ++l)
+            require_near(p.get(l), ma[8 + l]);
+        vb.store(0, p);
+        for (uint32_t l = 0; l < 8; ++l)
+            require_near(vb[l], ma[8 + l]);
+        va.store(n - 8, p);
+        for (uint32_t l = 0; l < 8; ++l)
+            require_near(va[n - 8 + l], ma[8 + l]);
+        for (std::size_t i = 0; i < n; ++i)
+            for (std::size_t e = 16; e < stride; ++e)
+                REQUIRE(a[i * stride + e] == -1.f);
+    }
+
+    SECTION("Bulk ops") {
+        multiply(va, vb, vo);
+        for (std::size_t i = 0; i < n; ++i)
+            require_near(out[i], ma[i] * mb[i]);
+
+        REQUIRE(inverse(vb, vb));
+        for (std::size_t i = 0; i < n; ++i)
+            require_near(vb[i], mb[i].inverse().second);
+    }
+}
+
+TEMPLATE_TEST_CASE("Mat4 inverse", "[mat]", Mat4f, Mat4d) {
+    using T = typename TestType::Scalar;
+    const T eps = std::is_same_v<T, float> ? 1e-5 : 1e-12;
+
+    auto require_identity = [&](const TestType& m) {
+        for (uint32_t i = 0; i < 4; ++i)
+            for (uint32_t j = 0; j < 4; ++j)
+                REQUIRE(m.data()[i * 4 + j] == Approx(i == j ? 1 : 0).margin(eps));
+    };
+
+    // Rotation, scale and translation
+    const TestType affine{
+        2, 1, 0.5, 0,
+        -1, 3, 0.2, 0,
+        0.3, -0.7, 1.5, 0,
+        4, -2, 1, 1
+    };
+    const TestType general{
+        2, 1, 0.5, 0.3,
+        -1, 3, 0.2, 1,
+        0.3, -0.7, 1.5, 2,
+        4, -2, 1, 1
+    };
+
+    SECTION("Determinant") {
+        REQUIRE(general.determinant() == Approx(10.368));
+        REQUIRE(affine.determinant() == Approx(10.74));
+        REQUIRE(TestType{ 1 }.determinant() == Approx(0).margin(eps));
+        const TestType triangular{
+            2, 0, 0, 0,
+            5, 3, 0, 0,
+            -1, 7, 0.5, 0,
+            4, 2, 9, -4
+        };
+        REQUIRE(triangular.determinant() == Approx(-12));
+    }
+
+    SECTION("General inverse") {
+        auto [invertible, inv] = general.inverse();
+        REQUIRE(invertible);
+        require_identity(general * inv);
+        require_identity(inv * general);
+
+        auto [singular_invertible, zero] = TestType{ 1 }.inverse();
+        REQUIRE(!singular_invertible);
+        for (uint32_t i = 0; i < 16; ++i)
+            REQUIRE(zero.data()[i] == 0);
+    }
+
+    SECTION("Affine inverse") {
+        auto [invertible, inv] = affine.affine_inverse();
+        REQUIRE(invertible);
+        require_identity(affine * inv);
+
+        auto [general_invertible, ref] = affine.inverse();
+        REQUIRE(general_invertible);
+        for (uint32_t i = 0; i < 16; ++i)
+            REQUIRE(inv.data()[i] == Approx(ref.data()[i]).margin(eps));
+
+        const TestType singular{
+            2, 1, 0.5, 0,
+            0, 0, 0, 0,
+            0.3, -0.7, 1.5, 0,
+            4, -2, 1, 1
+        };
+        REQUIRE(!singular.affine_inverse().first);
+    }
+
+    SECTION("Inverse precision") {
+        // Only 1 / det changes, the estimate's error scales every entry
+        auto [fast_invertible, fast] = general.template inverse<precision::fast>();
+        auto [standard_invertible, standard] = general.template inverse<precision::standard>();
+        auto ref = general.inverse().second;
+        REQUIRE(fast_invertible);
+        REQUIRE(standard_invertible);
+        for (uint32_t i = 0; i < 16; ++i) {
+            REQUIRE(fast.data()[i] == Approx(ref.data()[i]).epsilon(4e-4));
+            REQUIRE(standard.data()[i] == Approx(ref.data()[i]).epsilon(1e-5));
+        }
+        REQUIRE(!TestType{ 1 }.template inverse<precision::fast>().first);
+
+        auto affine_fast = affine.template affine_inverse<precision::fast>().second;
+        auto affine_ref = affine.affine_inverse().second;
+        for (uint32_t i = 0; i < 16; ++i)
+            REQUIRE(affine_fast.data()[i] == Approx(affine_ref.data()[i]).epsilon(4e-4).margin(eps));
+    }
+
+    SECTION("Batched inverse") {
+        std::vector<TestType> in, out(9);
+        for (uint32_t i = 0; i < 9; ++i) {
+            TestType m = general;
+            m[3][0] = static_cast<T>(i);
+            m[1][1] = static_cast<T>(3 + i * 0.5);
+            in.push_back(m);
+        }
+        REQUIRE(inverse(std::span<const TestType>{ in }, std::span<TestType>{ out }));
+        for (uint32_t i = 0; i < in.size(); ++i)
+            require_identity(in[i] * out[i]);
+
+        // In place, with a singular matrix in the middle
+        auto orig = in;
+        in[4] = TestType{ 1 };
+        REQUIRE(!inverse(std::span<const TestType>{ in }, std::span<TestType>{ in }));
+        REQUIRE(in[4].data()[0] == 0);
+        require_identity(orig[0] * in[0]);
+        require_identity(orig[8] * in[8]);
+    }
+}
+
+TEMPLATE_TEST_CASE("Mat3 kernels", "[mat]", Mat3f, Mat3d) {
+    using T = typename TestType::Scalar;
+    const T eps = std::is_same_v<T, float> ? 1e-5 : 1e-12;
+
+    const TestType a{
+        2, 1, 0.5,
+        -1, 3, 0.2,
+        0.3, -0.7, 1.5
+    };
+    const TestType b{
+        1, -2, 4,
+        0.5, 0, 3,
+        -1, 2, 0.25
+    };
+    auto element = [](const TestType& m, const uint32_t c, const uint32_t r) {
+        return m.data()[c * (sizeof(TestType) / sizeof(T) / 3) + r];
+    };
+
+    SECTION("Multiplication") {
+        Vec<T, 3> v{ 1.5, -2, 0.5 };
+        auto av = a * v;
+        auto ab = a * b;
+        for (uint32_t r = 0; r < 3; ++r) {
+            T ev = 0;
+            for (uint32_t k = 0; k < 3; ++k)
+                ev += element(a, k, r) * v[k];
+            REQUIRE(av[r] == Approx(ev));
+
+            for (uint32_t c = 0; c < 3; ++c) {
+                T e = 0;
+                for (uint32_t k = 0; k < 3; ++k)
+                    e += element(a, k, r) * element(b, c, k);
+                REQUIRE(element(ab, c, r) == Approx(e));
+            }
+        }
+    }
+
+    SECTION("Transpose") {
+        auto t = a.transpose();
+        for (uint32_t r = 0; r < 3; ++r)
+            for (uint32_t c = 0; c < 3; ++c)
+                REQUIRE(element(t, c, r) == element(a, r, c));
+    }
+
+    SECTION("Inverse") {
+        REQUIRE(a.determinant() == Approx(10.74));
+        auto [invertible, inv] = a.inverse();
+        REQUIRE(invertible);
+        auto id = a * inv;
+        for (uint32_t r = 0; r < 3; ++r)
+            for (uint32_t c = 0; c < 3; ++c)
+                REQUIRE(element(id, c, r) == Approx(r == c ? 1 : 0).margin(eps));
+
+        auto [singular_invertible, zero] = TestType{ 1 }.inverse();
+        REQUIRE(!singular_invertible);
+        REQUIRE(zero.data()[0] == 0);
+    }
+}
+
+// Odd sizes leave scalar rows and columns next to the packet tiles
+TEMPLATE_TEST_CASE("Dense Mat", "[mat]", (Mat<float, 5>), (Mat<double, 6>), (Mat<float, 8>),
+    (Mat<double, 13>), (Mat<float, 17>), (Mat<float, 32>), (Mat<double, 32>))
+{
+    using M = TestType;
+    using T = typename M::Scalar;
+    constexpr uint32_t N = M::Size;
+    const double eps = std::is_same_v<T, float> ? 1e-4 : 1e-10;
+
+    auto fill = [](M& m, const double offset) {
+        for (uint32_t i = 0; i < M::Size2; ++i)
+            m.arr[i] = static_cast<T>(std::sin(i * 0.37 + offset));
+    };
+    auto require_near = [&](const M& a, const M& b) {
+        for (uint32_t i = 0; i < M::Size2; ++i)
+            REQUIRE(a.arr[i] == Approx(b.arr[i]).margin(eps));
+    };
+    M id;
+    for (uint32_t i = 0; i < N; ++i)
+        id[i][i] = 1;
+
+    M a, b;
+    fill(a, 0);
+    fill(b, 1);
+    // Diagonally dominant, well conditioned
+    M well = a;
+    for (uint32_t i = 0; i < N; ++i)
+        well[i][i] += N;
+
+    SECTION("Multiplication and transpose") {
+        auto ab = a * b;
+        for (uint32_t c = 0; c < N; ++c) {
+            for (uint32_t r = 0; r < N; ++r) {
+                double e = 0;
+                for (uint32_t k = 0; k < N; ++k)
+                    e += static_cast<double>(a[k][r]) * b[c][k];
+                REQUIRE(ab[c][r] == Approx(e).margin(eps));
+            }
+        }
+        M c = a;
+        c *= b;
+        require_near(c, ab);
+
+        Vec<T, N> v;
+        for (uint32_t i = 0; i < N; ++i)
+            v[i] = static_cast<T>(i % 5) - 2;
+        auto av = a * v;
+        for (uint32_t r = 0; r < N; ++r) {
+            double e = 0;
+            for (uint32_t k = 0; k < N; ++k)
+                e += static_cast<double>(a[k][r]) * v[k];
+            REQUIRE(av[r] == Approx(e).margin(eps));
+        }
+
+        auto t = a.transpose();
+        for (uint32_t c = 0; c < N; ++c)
+            for (uint32_t r = 0; r < N; ++r)
+                REQUIRE(t[c][r] == a[r][c]);
+        require_near((a * b).transpose(), b.transpose() * a.transpose());
+
+        auto s = a * T(2);
+        for (uint32_t i = 0; i < M::Size2; ++i)
+            REQUIRE(s.arr[i] == a.arr[i] * 2);
+    }
+
+    SECTION("LU") {
+        LU<T, N> lu(well);
+        REQUIRE(!lu.singular());
+
+        Vec<T, N> x;
+        for (uint32_t i = 0; i < N; ++i)
+            x[i] = static_cast<T>(i) * T(0.5) - 1;
+        auto solved = lu.solve(well * x);
+        for (uint32_t i = 0; i < N; ++i)
+            REQUIRE(solved[i] == Approx(x[i]).margin(eps));
+
+        auto [invertible, inv] = well.inverse();
+        REQUIRE(invertible);
+        require_near(well * inv, id);
+        REQUIRE(well.determinant() == Approx(lu.determinant()));
+
+        // Every pivot is a row swap, the reversal permutation
+        M rev;
+        for (uint32_t i = 0; i < N; ++i)
+            rev[i][N - 1 - i] = 2;
+        LU<T, N> rlu(rev);
+        const T sign = (N / 2) % 2 ? -1 : 1;
+        REQUIRE(rlu.determinant() == Approx(sign * std::pow(T(2), T(N))));
+        REQUIRE(rev.determinant() == Approx(rlu.determinant()));
+        require_near(rev * rev.inverse().second, id);
+
+        // Rounding keeps dependent columns from giving an exact zero pivot,
+        // a zero column does
+        M singular = a;
+        singular[3] = Vec<T, N>();
+        REQUIRE(LU<T, N>(singular).singular());
+        REQUIRE(singular.determinant() == 0);
+        REQUIRE(!singular.inverse().first);
+    }
+
+    SECTION("Cholesky") {
+        // B B^T + N I is symmetric positive definite
+        M spd = a * a.transpose();
+        for (uint32_t i = 0; i < N; ++i)
+            spd[i][i] += N;
+        Cholesky<T, N> ch(spd);
+        REQUIRE(ch.ok);
+        auto l = ch.lower();
+        for (uint32_t c = 1; c < N; ++c)
+            REQUIRE(l[c][0] == 0);
+        require_near(l * l.transpose(), spd);
+
+        Vec<T, N> x;
+        for (uint32_t i = 0; i < N; ++i)
+            x[i] = static_cast<T>(i % 3) - 1;
+        auto solved = ch.solve(spd * x);
+        for (uint32_t i = 0; i < N; ++i)
+            REQUIRE(solved[i] == Approx(x[i]).margin(eps));
+
+        REQUIRE(!Cholesky<T, N>(a).ok);
+        spd[N - 1][N - 1] = -1;
+        REQUIRE(!Cholesky<T, N>(spd).ok);
+    }
+}
+
+TEST_CASE("Batched Mat4 multiply", "[mat]") {
+    // Whole and partial packs of every width
+    const std::size_t n = 37;
+    std::vector<Mat4f> a(n), b(n), out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (uint32_t e = 0; e < 16; ++e) {
+            a[i].data()[e] = std::sin(i * 0.7f + e * 0.31f) * 2.f;
+            b[i].data()[e] = std::cos(i * 0.3f - e * 0.17f) * 3.f;
+        }
+    }
+    auto require_near = [](const Mat4f& x, const Mat4f& y) {
+        for (uint32_t e = 0; e < 16; ++e)
+            REQUIRE(x.data()[e] == Approx(y.data()[e]).margin(1e-5));
+    };
+
+    multiply(a, b, out);
+    for (std::size_t i = 0; i < n; ++i)
+        require_near(out[i], a[i] * b[i]);
+
+    // In place on either side
+    auto c = a;
+    multiply(c, b, c);
+    for (std::size_t i = 0; i < n; ++i)
+        require_near(c[i], out[i]);
+    c = b;
+    multiply(a, c, c);
+    for (std::size_t i = 0; i < n; ++i)
+        require_near(c[i], out[i]);
+}
+
+TEMPLATE_TEST_CASE("Mat SoA", "[mat]", Mat4x8f, (MatSoA<float, 4, 4>), (MatSoA<double, 4, 4>),
+    (MatSoA<float, 3, 8>))
+{
+    using P = TestType;
+    using M = typename P::Element;
+    using T = typename P::Scalar;
+    constexpr uint32_t N = P::Size, W = P::Width;
+
+    std::vector<M> a(W), b(W), out(W);
+    for (uint32_t l = 0; l < W; ++l) {
+        for (uint32_t c = 0; c < N; ++c) {
+            for (uint32_t r = 0; r < N; ++r) {
+                a[l][c][r] = static_cast<T>(std::sin(l * 0.7 + c * 1.3 + r * 0.31));
+                b[l][c][r] = static_cast<T>(std::cos(l * 0.3 - c * 0.5 + r * 0.17));
+            }
+        }
+    }
+    auto require_near = [](const M& x, const M& y) {
+        for (uint32_t c = 0; c < N; ++c)
+            for (uint32_t r = 0; r < N; ++r)
+                REQUIRE(x[c][r] == Approx(y[c][r]).margin(1e-5));
+    };
+
+    auto pa = P::load(a.data());
+    auto pb = P::load(b.data());
+    for (uint32_t l = 0; l < W; ++l) {
+        REQUIRE(pa.get(l)[1][2] == a[l][1][2]);
+        require_near(pa.get(l), a[l]);
+    }
+    pa.store(out.data());
+    for (uint32_t l = 0; l < W; ++l)
+        require_near(out[l], a[l]);
+
+    (pa * pb).store(out.data());
+    for (uint32_t l = 0; l < W; ++l)
+        require_near(out[l], a[l] * b[l]);
+    pa *= pb;
+    pa.transpose().store(out.data());
+    for (uint32_t l = 0; l < W; ++l)
+        require_near(out[l], (a[l] * b[l]).transpose());
+
+    // Broadcast and Vec packs
+    P pm{ b[1] };
+    typename P::VecPack v;
+    for (uint32_t l = 0; l < W; ++l) {
+        Vec<T, N> e;
+        for (uint32_t i = 0; i < N; ++i)
+            e[i] = static_cast<T>(l) - i * T(0.5);
+        v.set(l, e);
+    }
+    auto pv = pm * v;
+    for (uint32_t l = 0; l < W; ++l) {
+        auto expected = b[1] * v.get(l);
+        for (uint32_t i = 0; i < N; ++i)
+            REQUIRE(pv.get(l)[i] == Approx(expected[i]).margin(1e-5));
+    }
+}
@@ -0,0 +1,170 @@
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+static const Mat4f test_matrix{
+    2.f, 0.5f, 0.f, 0.f,
+    -0.5f, 1.5f, 0.25f, 0.f,
+    0.f, 0.3f, 3.f, 0.f,
+    1.f, -2.f, 0.5f, 1.f
+};
+
+TEST_CASE("Thread pool", "[parallel]") {
+    thread_pool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    SECTION("Every chunk runs once") {
+        for (const std::size_t chunks : { 0u, 1u, 3u, 4u, 97u, 1000u }) {
+            std::vector<std::atomic<int>> hits(chunks);
+            pool.run(chunks, [&](const std::size_t c) { hits[c]++; });
+            for (const auto& h : hits)
+                REQUIRE(h == 1);
+        }
+    }
+
+    SECTION("Nested runs") {
+        std::vector<std::atomic<int>> hits(64);
+        pool.run(8, [&](const std::size_t c) {
+            pool.run(8, [&](const std::size_t d) { hits[c * 8 + d]++; });
+        });
+        for (const auto& h : hits)
+            REQUIRE(h == 1);
+    }
+
+    SECTION("Exceptions") {
+        REQUIRE_THROWS_AS(pool.run(100, [](const std::size_t c) {
+            if (c == 42)
+                throw std::runtime_error("chunk");
+        }), std::runtime_error);
+
+        // The pool is still usable
+        std::atomic<int> count = 0;
+        pool.run(100, [&](const std::size_t) { count++; });
+        REQUIRE(count == 100);
+    }
+}
+
+TEST_CASE("Parallel for and reduce", "[parallel]") {
+    thread_pool pool(3);
+
+    SECTION("Ranges") {
+        std::vector<int> v(1001, 0);
+        parallel_for(v.size(), 64, [&](const std::size_t b, const std::size_t e) {
+            REQUIRE(b % 64 == 0);
+            for (std::size_t i = b; i < e; ++i)
+                v[i] += 1;
+        }, pool);
+        for (const int x : v)
+            REQUIRE(x == 1);
+    }
+
+    SECTION("Reduce is deterministic") {
+        std::vector<float> v(100000);
+        for (std::size_t i = 0; i < v.size(); ++i)
+            v[i] = std::sin(static_cast<float>(i));
+        auto sum = [&](thread_pool& p) {
+            return parallel_reduce(v.size(), 1000, 0.f,
+                [&](const std::size_t b, const std::size_t e) {
+                    float s = 0.f;
+                    for (std::size_t i = b; i < e; ++i)
+                        s += v[i];
+                    return s;
+                },
+                [](const float a, const float b) { return a + b; }, p);
+        };
+        thread_pool single(1);
+        REQUIRE(sum(pool) == sum(single));
+        REQUIRE(parallel_reduce(0, 16, 5, [](auto, auto) { return 1; },
+            [](int a, int b) { return a + b; }, pool) == 5);
+    }
+}
+
+TEST_CASE("Parallel bulk functions", "[parallel]") {
+    thread_pool pool(4);
+    constexpr std::size_t n = 50000 + 13;
+
+    SECTION("Transforms") {
+        std::vector<Vec3f, aligned_allocator<Vec3f>> in(n), out(n), ref(n);
+        for (std::size_t i = 0; i < n; ++i)
+            in[i] = Vec3f(std::sin(i * 0.1f), std::cos(i * 0.3f), i * 0.001f);
+
+        transform_points(test_matrix, in, ref);
+        parallel_transform_points(test_matrix, in, out, store_policy::streaming, pool);
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == ref[i]);
+
+        transform_normals(test_matrix, in, ref);
+        parallel_transform_normals(test_matrix, in, out, store_policy::automatic, pool);
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == ref[i]);
+
+        // Views
+        std::vector<float> buf(n * 3), vout(n * 3), vref(n * 3);
+        for (std::size_t i = 0; i < buf.size(); ++i)
+            buf[i] = std::sin(i * 0.7f);
+        Vec3fView vin(buf.data(), n);
+        transform_points(test_matrix, vin, Vec3fView(vref.data(), n));
+        parallel_transform_points(test_matrix, vin, Vec3fView(vout.data(), n), pool);
+        REQUIRE(vout == vref);
+    }
+
+    SECTION("Normalize") {
+        VecArray<float, 3> a(n), b(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            a.set(i, Vec3f(i + 1.f, std::sin(i * 0.1f), 2.f));
+            b.set(i, a.get(i));
+        }
+        a.normalize();
+        parallel_normalize(b, pool);
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(a.get(i) == b.get(i));
+        // Padding is still zero
+        for (uint32_t c = 0; c < 3; ++c)
+            for (std::size_t i = n; i < b.streams[c].size(); ++i)
+                REQUIRE(b.stream(c)[i] == 0.f);
+
+        std::vector<float> buf(n * 3), ref;
+        for (std::size_t i = 0; i < buf.size(); ++i)
+            buf[i] = std::cos(i * 0.3f) + 1.5f;
+        ref = buf;
+        Vec3fView(ref.data(), n).normalize();
+        parallel_normalize(Vec3fView(buf.data(), n), pool);
+        REQUIRE(buf == ref);
+    }
+
+    SECTION("RNG fills match the serial ones") {
+        for (const unsigned threads : { 1u, 2u, 5u }) {
+            thread_pool p(threads);
+            pcg32x<8> rng;
+            rng.advance(12345);
+            pcg32x<8> ref = rng;
+
+            std::vector<float> f(n), fref(n);
+            parallel_fill_uniform_float(rng, std::span(f), store_policy::automatic, p);
+            ref.fill_uniform_float(fref);
+            REQUIRE(f == fref);
+
+            std::vector<uint32_t> u(n + 5), uref(n + 5);
+            parallel_fill_uint32(rng, std::span(u), store_policy::streaming, p);
+            ref.fill_uint32(uref);
+            REQUIRE(u == uref);
+
+            std::vector<double> d(n), dref(n);
+            parallel_fill_uniform_double(rng, std::span(d), store_policy::automatic, p);
+            ref.fill_uniform_double(dref);
+            REQUIRE(d == dref);
+
+            for (uint32_t i = 0; i < 8; ++i) {
+                REQUIRE(rng.lane(i).state == ref.lane(i).state);
+                REQUIRE(rng.lane(i).inc == ref.lane(i).inc);
+            }
+        }
+    }
+}
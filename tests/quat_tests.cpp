@@ -0,0 +1,159 @@
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+using Catch::Approx;
+
+// q1 * q2 written out component by component
+template <typename T>
+static Quat<T> hamilton_reference(const Quat<T>& a, const Quat<T>& b) {
+    const auto& p = a.v;
+    const auto& q = b.v;
+    return Quat<T>(
+        p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y,
+        p.w * q.y - p.x * q.z + p.y * q.w + p.z * q.x,
+        p.w * q.z + p.x * q.y - p.y * q.x + p.z * q.w,
+        p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z);
+}
+
+template <typename V>
+static void require_vec_near(const V& a, const V& b, const double eps) {
+    for (uint32_t i = 0; i < V::Size; ++i)
+        REQUIRE(a[i] == Approx(b[i]).margin(eps));
+}
+
+TEMPLATE_TEST_CASE("Quat tests", "[quat]", float, double) {
+    using Q = Quat<TestType>;
+    using V3 = Vec3<TestType>;
+    const TestType pi = std::numbers::pi_v<TestType>;
+    const double eps = std::is_same_v<TestType, float> ? 1e-5 : 1e-6;
+
+    const Q a = Q::axis_angle(V3(1, 2, 3).normalized(), TestType(0.7));
+    const Q b = Q::axis_angle(V3(-2, 0.5, 1).normalized(), TestType(-2.1));
+
+    SECTION("Hamilton product") {
+        require_vec_near((a * b).v, hamilton_reference(a, b).v, eps);
+        require_vec_near((b * a).v, hamilton_reference(b, a).v, eps);
+
+        Q c{ 1, 2, 3, 4 }, d{ -0.5, 0.25, 2, -1 };
+        require_vec_near((c * d).v, hamilton_reference(c, d).v, eps);
+        c *= d;
+        require_vec_near(c.v, hamilton_reference(Q{ 1, 2, 3, 4 }, d).v, eps);
+
+        // i * j = k, j * i = -k
+        REQUIRE(Q(1, 0, 0, 0) * Q(0, 1, 0, 0) == Q(0, 0, 1, 0));
+        REQUIRE(Q(0, 1, 0, 0) * Q(1, 0, 0, 0) == Q(0, 0, -1, 0));
+        REQUIRE(Q() * a == a);
+    }
+
+    SECTION("Conjugate, inverse and normalize") {
+        REQUIRE(a.conjugate() == Q(-a.v.x, -a.v.y, -a.v.z, a.v.w));
+        REQUIRE(a * a.conjugate() == Q());
+
+        Q c{ 1, 2, 3, 4 };
+        REQUIRE(c * c.inverse() == Q());
+        REQUIRE(c.inverse() * c == Q());
+
+        auto n = c.normalized();
+        REQUIRE(n.length() == Approx(1.).margin(eps));
+        require_vec_near(n.v, c.v / c.length(), eps);
+        c.normalize();
+        REQUIRE(c == n);
+    }
+
+    SECTION("Rotation") {
+        // A quarter turn around z takes x to y
+        auto qz = Q::axis_angle(V3(0, 0, 1), pi / 2);
+        require_vec_near(qz.rotate(V3(1, 0, 0)), V3(0, 1, 0), eps);
+        require_vec_near(qz.rotate(V3(0, 0, 5)), V3(0, 0, 5), eps);
+
+        // Composition applies the right hand side first
+        const V3 p(0.3, -1.2, 2.5);
+        require_vec_near((a * b).rotate(p), a.rotate(b.rotate(p)), eps);
+        require_vec_near(a.conjugate().rotate(a.rotate(p)), p, eps);
+        REQUIRE(a.rotate(p).length() == Approx(p.length()).margin(eps));
+    }
+
+    SECTION("Matrix conversions") {
+        const V3 p(0.3, -1.2, 2.5);
+        auto m3 = a.to_mat3();
+        auto m4 = a.to_mat4();
+        require_vec_near(m3 * p, a.rotate(p), eps);
+        auto r4 = m4 * Vec4<TestType>(p.x, p.y, p.z, 1);
+        require_vec_near(V3(r4.x, r4.y, r4.z), a.rotate(p), eps);
+        REQUIRE(r4.w == Approx(1.).margin(eps));
+
+        // Round trips, q and -q are the same rotation. Every branch of
+        // Shepperd's method is taken by one of the quaternions
+        for (const Q& q : { a, b, Q::axis_angle(V3(1, 0, 0), pi * 0.9),
+            Q::axis_angle(V3(0, 1, 0), pi * 0.9), Q::axis_angle(V3(0, 0, 1), pi * 0.9) })
+        {
+            for (const Q& r : { Q::from_mat(q.to_mat3()), Q::from_mat(q.to_mat4()) }) {
+                const TestType s = r.dot(q) < 0 ? -1 : 1;
+                require_vec_near(r.v * s, q.v, eps);
+            }
+        }
+    }
+
+    SECTION("Interpolation") {
+        REQUIRE(slerp(a, b, TestType(0)) == a);
+        REQUIRE(slerp(a, b, TestType(1)) == b);
+
+        // Constant angular velocity, a third of the way is a third of the
+        // angle between them
+        auto angle = [](const Q& p, const Q& q) {
+            return 2 * std::acos(std::min<TestType>(std::abs(p.dot(q)), 1));
+        };
+        const TestType total = angle(a, b);
+        auto s = slerp(a, b, TestType(1) / 3);
+        REQUIRE(s.length() == Approx(1.).margin(eps));
+        REQUIRE(angle(a, s) == Approx(total / 3).margin(1e-3));
+
+        auto n = nlerp(a, b, TestType(0.5));
+        REQUIRE(n.length() == Approx(1.).margin(eps));
+        // Both are halfway at t = 0.5
+        require_vec_near(n.v, slerp(a, b, TestType(0.5)).v, 1e-4);
+
+        // -b is the same rotation, the shorter arc is taken either way
+        Q nb(b.v * TestType(-1));
+        require_vec_near(slerp(a, nb, TestType(0.25)).rotate(V3(1, 2, 3)),
+            slerp(a, b, TestType(0.25)).rotate(V3(1, 2, 3)), 1e-4);
+        // Nearly equal quaternions go through nlerp
+        REQUIRE(slerp(a, a, TestType(0.3)) == a);
+    }
+}
+
+TEST_CASE("Batched rotation", "[quat]") {
+    // Whole batches of every width and a scalar tail
+    const std::size_t n = 16 * 5 + 7;
+    std::vector<Vec3f> in(n), out(n);
+    std::vector<Quatf> q(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        in[i] = Vec3f{ i * 0.5f - 3.f, 1.f - i * 0.25f, i * 0.125f };
+        q[i] = Quatf::axis_angle(Vec3f{ 1.f, i * 0.1f, -0.5f }.normalized(), i * 0.37f);
+    }
+
+    SECTION("One rotation") {
+        rotate_vectors(q[3], in, out);
+        for (std::size_t i = 0; i < n; ++i)
+            require_vec_near(out[i], q[3].rotate(in[i]), 1e-4);
+    }
+
+    SECTION("One rotation each") {
+        rotate_vectors(q, in, out);
+        for (std::size_t i = 0; i < n; ++i)
+            require_vec_near(out[i], q[i].rotate(in[i]), 1e-4);
+
+        // In place
+        auto expected = out;
+        rotate_vectors(q, in, in);
+        for (std::size_t i = 0; i < n; ++i)
+            require_vec_near(in[i], expected[i], 1e-6);
+    }
+}
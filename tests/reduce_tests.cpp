@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Sizes around the packet, unroll and pairwise block boundaries of every
+// backend
+static const std::size_t sizes[] = { 0, 1, 3, 7, 15, 16, 17, 63, 64, 65, 100,
+    4095, 4096, 4097, 10000, 70001 };
+
+static float value(const std::size_t i, const uint32_t c = 0) {
+    return std::sin(i * 0.37f + c * 1.3f) * 10.f + std::cos(i * 0.011f);
+}
+
+TEST_CASE("Float array reductions", "[reduce]") {
+    for (const auto n : sizes) {
+        std::vector<float> a(n), b(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = value(i);
+            b[i] = value(i, 1);
+        }
+
+        double ref_sum = 0., ref_dot = 0.;
+        for (std::size_t i = 0; i < n; ++i) {
+            ref_sum += a[i];
+            ref_dot += static_cast<double>(a[i]) * b[i];
+        }
+        const double tol = 1e-5 * (std::abs(ref_sum) + n + 1);
+
+        REQUIRE(std::abs(sum(a) - ref_sum) <= tol);
+        REQUIRE(std::abs(sum<summation::plain>(a) - ref_sum) <= tol);
+        REQUIRE(std::abs(sum<summation::kahan>(a) - ref_sum) <= tol);
+        REQUIRE(std::abs(dot(a, b) - ref_dot) <= 1e-5 * (std::abs(ref_dot) + 10 * n + 1));
+
+        if (n == 0) {
+            REQUIRE(min(a) == std::numeric_limits<float>::infinity());
+            REQUIRE(max(a) == -std::numeric_limits<float>::infinity());
+            REQUIRE(argmin(a) == 0);
+            REQUIRE(std::isnan(mean(a)));
+            continue;
+        }
+
+        REQUIRE(std::abs(mean(a) - ref_sum / n) <= tol / n);
+        const auto mn = std::min_element(a.begin(), a.end());
+        const auto mx = std::max_element(a.begin(), a.end());
+        REQUIRE(min(a) == *mn);
+        REQUIRE(max(a) == *mx);
+        REQUIRE(argmin(a) == static_cast<std::size_t>(mn - a.begin()));
+        REQUIRE(argmax(a) == static_cast<std::size_t>(mx - a.begin()));
+    }
+}
+
+TEST_CASE("Reduction edge cases", "[reduce]") {
+    constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+
+    SECTION("NaNs are skipped by min and max") {
+        std::vector<float> a(1000, 1.f);
+        a[0] = nan;
+        a[500] = -2.f;
+        a[501] = -2.f;
+        a[999] = nan;
+        REQUIRE(min(a) == -2.f);
+        REQUIRE(argmin(a) == 500);
+        REQUIRE(max(a) == 1.f);
+        REQUIRE(argmax(a) == 1);
+
+        std::fill(a.begin(), a.end(), nan);
+        REQUIRE(argmin(a) == a.size());
+    }
+
+    SECTION("Ties across blocks give the first index") {
+        std::vector<float> a(20000, 0.f);
+        a[19000] = 5.f;
+        a[7] = 5.f;
+        REQUIRE(argmax(a) == 7);
+    }
+
+    SECTION("Compensated sums") {
+        // 1 followed by many values below half an ulp of it
+        std::vector<float> a(1 << 20, 1e-8f);
+        a[0] = 1.f;
+        const double ref = 1. + (a.size() - 1) * static_cast<double>(1e-8f);
+        REQUIRE(std::abs(sum<summation::kahan>(a) - ref) < 1e-6);
+        REQUIRE(std::abs(sum<summation::pairwise>(a) - ref) < 1e-6);
+    }
+}
+
+TEST_CASE("Vec array reductions", "[reduce]") {
+    for (const auto n : sizes) {
+        std::vector<Vec3f> p(n);
+        std::vector<Vec4f> q(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            p[i] = Vec3f(value(i), value(i, 1), value(i, 2));
+            q[i] = Vec4f(value(i), value(i, 1), value(i, 2), value(i, 3));
+        }
+
+        double s3[3] = {}, s4[4] = {}, d3 = 0., d4 = 0.;
+        Vec3f lo(std::numeric_limits<float>::infinity()), hi(-std::numeric_limits<float>::infinity());
+        Vec4f lo4 = Vec4f(std::numeric_limits<float>::infinity());
+        for (std::size_t i = 0; i < n; ++i) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                s3[c] += p[i][c];
+                d3 += static_cast<double>(p[i][c]) * q[i][c];
+                lo[c] = std::min(lo[c], p[i][c]);
+                hi[c] = std::max(hi[c], p[i][c]);
+            }
+            for (uint32_t c = 0; c < 4; ++c) {
+                s4[c] += q[i][c];
+                d4 += static_cast<double>(q[i][c]) * q[i][c];
+                lo4[c] = std::min(lo4[c], q[i][c]);
+            }
+        }
+        const double tol = 1e-5 * (n + 1);
+
+        const Vec3f ps = sum(p), pk = sum<summation::kahan>(p);
+        const Vec4f qs = sum(q);
+        for (uint32_t c = 0; c < 3; ++c) {
+            REQUIRE(std::abs(ps[c] - s3[c]) <= tol);
+            REQUIRE(std::abs(pk[c] - s3[c]) <= tol);
+        }
+        for (uint32_t c = 0; c < 4; ++c)
+            REQUIRE(std::abs(qs[c] - s4[c]) <= tol);
+
+        std::vector<Vec3f> q3(n);
+        for (std::size_t i = 0; i < n; ++i)
+            q3[i] = Vec3f(q[i][0], q[i][1], q[i][2]);
+        REQUIRE(std::abs(dot(p, q3) - d3) <= 1e-5 * (std::abs(d3) + 100 * n + 1));
+        REQUIRE(std::abs(dot(q, q) - d4) <= 1e-5 * (d4 + 1));
+
+        // Exact, and the Vec operator == doesn't take infinities
+        const auto [bmin, bmax] = bounds(p);
+        const Vec3f pmin = min(p), pmax = max(p);
+        const Vec4f qmin = min(q);
+        for (uint32_t c = 0; c < 3; ++c) {
+            REQUIRE(bmin[c] == lo[c]);
+            REQUIRE(bmax[c] == hi[c]);
+            REQUIRE(pmin[c] == lo[c]);
+            REQUIRE(pmax[c] == hi[c]);
+        }
+        for (uint32_t c = 0; c < 4; ++c)
+            REQUIRE(qmin[c] == lo4[c]);
+    }
+}
+
+TEST_CASE("Mean and covariance", "[reduce]") {
+    // An anisotropic cloud far from the origin
+    const std::size_t n = 5000;
+    const Vec3f offset(1000.f, -2000.f, 500.f);
+    std::vector<Vec3f> p(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const float t = value(i), u = value(i, 1);
+        p[i] = Vec3f(t, 0.5f * t + u, 0.1f * u) + offset;
+    }
+
+    double m[3] = {};
+    for (const auto& v : p)
+        for (uint32_t c = 0; c < 3; ++c)
+            m[c] += v[c];
+    for (auto& x : m)
+        x /= n;
+    double ref[3][3] = {};
+    for (const auto& v : p)
+        for (uint32_t r = 0; r < 3; ++r)
+            for (uint32_t c = 0; c < 3; ++c)
+                ref[r][c] += (v[r] - m[r]) * (v[c] - m[c]) / n;
+
+    const Vec3f mean3 = mean(p);
+    for (uint32_t c = 0; c < 3; ++c)
+        REQUIRE(mean3[c] == Catch::Approx(m[c]).epsilon(1e-6));
+
+    const Mat3f cov = covariance(p);
+    for (uint32_t r = 0; r < 3; ++r)
+        for (uint32_t c = 0; c < 3; ++c)
+            REQUIRE(cov[c][r] == Catch::Approx(ref[r][c]).epsilon(1e-3).margin(1e-3));
+}
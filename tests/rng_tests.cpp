@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+template <uint32_t N>
+static void require_lanes_equal(const pcg32x<N>& rng, const std::array<pcg32, N>& ref) {
+    for (uint32_t i = 0; i < N; ++i) {
+        REQUIRE(rng.lane(i).state == ref[i].state);
+        REQUIRE(rng.lane(i).inc == ref[i].inc);
+    }
+}
+
+// Same draws from the vectorized generator and N scalar ones
+template <uint32_t N>
+static void require_same_draws(pcg32x<N>& rng, std::array<pcg32, N>& ref, const uint32_t count) {
+    std::array<uint32_t, N> result;
+    for (uint32_t k = 0; k < count; ++k) {
+        rng.next_uints(result);
+        for (uint32_t i = 0; i < N; ++i)
+            REQUIRE(result[i] == ref[i].next_uint());
+    }
+}
+
+TEST_CASE("pcg32 jump-ahead", "[rng]") {
+    pcg32 a(42u, 54u), b = a;
+    for (int i = 0; i < 1000; ++i)
+        a.next_uint();
+    b.advance(1000);
+    REQUIRE(a == b);
+    REQUIRE(b - pcg32(42u, 54u) == 1000);
+
+    b.advance(-1000);
+    REQUIRE(b == pcg32(42u, 54u));
+}
+
+template <uint32_t N>
+static void pcg32x_tests() {
+    using R = pcg32x<N>;
+
+    std::array<uint64_t, N> initstate, initseq;
+    std::array<pcg32, N> ref;
+    for (uint32_t i = 0; i < N; ++i) {
+        initstate[i] = 0x9e3779b97f4a7c15ull * (i + 1);
+        initseq[i] = 1000 + i * 7;
+        ref[i].seed(initstate[i], initseq[i]);
+    }
+
+    SECTION("Default seed") {
+        R rng;
+        for (uint32_t i = 0; i < N; ++i)
+            REQUIRE(rng.lane(i) == pcg32(PCG32_DEFAULT_STATE, i + 1));
+    }
+
+    SECTION("Advance") {
+        R rng(initstate, initseq);
+        require_lanes_equal<N>(rng, ref);
+        require_same_draws<N>(rng, ref, 17);
+
+        for (int64_t delta : { 1ll, 3ll, 1000ll, 123456789ll, -1ll, -1017ll, 1ll << 62 }) {
+            rng.advance(delta);
+            for (auto& r : ref)
+                r.advance(delta);
+            require_lanes_equal<N>(rng, ref);
+            require_same_draws<N>(rng, ref, 3);
+        }
+    }
+
+    SECTION("Split") {
+        const R rng(initstate, initseq);
+        const uint64_t n = 128;
+        const uint64_t length = R::split_length(n);
+        REQUIRE(length == ~0ull / n);
+
+        for (uint64_t k : { 0ull, 1ull, 77ull, 127ull }) {
+            auto sub = rng.split(k, n);
+            auto expected = ref;
+            for (auto& r : expected)
+                r.advance(static_cast<int64_t>(k * length));
+            require_lanes_equal<N>(sub, expected);
+
+            auto d = sub.distance(rng);
+            for (uint32_t i = 0; i < N; ++i)
+                REQUIRE(static_cast<uint64_t>(d[i]) == k * length);
+        }
+    }
+
+    SECTION("Factory") {
+        pcg32x_factory<N> factory(128, R(initstate, initseq));
+        REQUIRE(factory.draws_per_thread() == R::split_length(128));
+
+        // Neighbouring workers start a block apart in every lane, so none of
+        // them can reach the next one's first draw
+        for (uint32_t t = 0; t + 1 < 128; t += 9) {
+            auto d = factory.make(t + 1).distance(factory.make(t));
+            for (uint32_t i = 0; i < N; ++i)
+                REQUIRE(static_cast<uint64_t>(d[i]) == factory.draws_per_thread());
+        }
+
+        // Reproducible regardless of the order workers are created in
+        auto last = factory.make(127);
+        auto first = factory.make(0);
+        REQUIRE(last.distance(factory.make(127)) == std::array<int64_t, N>{});
+        require_lanes_equal<N>(first, ref);
+    }
+}
+
+// 8 lanes are the simd specializations, 16 as well with avx512, the others
+// the generic pcg32x
+TEMPLATE_TEST_CASE_SIG("pcg32x jump-ahead matches scalar pcg32", "[rng]",
+    ((uint32_t N), N), 8, 4, 16)
+{
+    pcg32x_tests<N>();
+}
+
+// Lemire's multiply-shift with rejection, one lane at a time
+static uint32_t bounded_reference(pcg32& rng, const uint32_t bound) {
+    const uint32_t threshold = (~bound + 1u) % bound;
+    for (;;) {
+        uint64_t m = (uint64_t) rng.next_uint() * bound;
+        if ((uint32_t) m >= threshold)
+            return (uint32_t) (m >> 32);
+    }
+}
+
+template <uint32_t N>
+static void pcg32x_fill_tests() {
+    using R = pcg32x<N>;
+
+    std::array<uint64_t, N> initstate, initseq;
+    for (uint32_t i = 0; i < N; ++i) {
+        initstate[i] = 0x2545f4914f6cdd1dull * (i + 3);
+        initseq[i] = 77 + i * 13;
+    }
+
+    // Whole leapfrog groups, leftover blocks and partial blocks, with and
+    // without streaming stores
+    const auto for_each_size = [](const auto& func) {
+        for (std::size_t n : { 0, 5, 8 * 4 * 3, 8 * 4 * 3 + 8 + 3, 1000, 4099 })
+            for (auto policy : { store_policy::cached, store_policy::streaming })
+                func(n, (n + N - 1) / N, policy);
+    };
+
+    // The same numbers as the next_* calls and the generator ends up at the
+    // same place
+    const auto check_fill = [&]<typename T>(const auto& fill, const auto& next) {
+        for_each_size([&](std::size_t n, std::size_t draws, store_policy policy) {
+            R rng(initstate, initseq), expected = rng;
+            std::vector<T> out(n), ref(n);
+            std::array<T, N> tmp;
+            for (std::size_t k = 0; k < draws; ++k) {
+                next(expected, tmp);
+                for (uint32_t i = 0; i < N && k * N + i < n; ++i)
+                    ref[k * N + i] = tmp[i];
+            }
+
+            fill(rng, std::span<T>(out), policy);
+            REQUIRE(out == ref);
+            REQUIRE(rng.distance(expected) == std::array<int64_t, N>{});
+        });
+    };
+
+    SECTION("uint32") {
+        check_fill.template operator()<uint32_t>(
+            [](R& rng, auto out, store_policy p) { rng.fill_uint32(out, p); },
+            [](R& rng, auto& tmp) { rng.next_uints(tmp); });
+    }
+
+    SECTION("Float") {
+        check_fill.template operator()<float>(
+            [](R& rng, auto out, store_policy p) {
+                rng.fill_uniform_float(out, p);
+                for (float f : out) {
+                    REQUIRE(f >= 0.f);
+                    REQUIRE(f < 1.f);
+                }
+            },
+            [](R& rng, auto& tmp) { rng.next_floats(tmp); });
+    }
+
+    SECTION("Double") {
+        check_fill.template operator()<double>(
+            [](R& rng, auto out, store_policy p) { rng.fill_uniform_double(out, p); },
+            [](R& rng, auto& tmp) { rng.next_doubles(tmp); });
+    }
+
+    SECTION("Bounded") {
+        // Powers of two never reject, the last bound rejects almost half of
+        // the draws and goes through the masked retry
+        for (uint32_t bound : { 1u, 6u, 1000u, 1u << 20, 0x80000001u }) {
+            for_each_size([&](std::size_t n, std::size_t draws, store_policy policy) {
+                R rng(initstate, initseq);
+                std::array<pcg32, N> ref_rng;
+                for (uint32_t i = 0; i < N; ++i)
+                    ref_rng[i] = rng.lane(i);
+
+                std::vector<uint32_t> out(n), ref(n);
+                for (std::size_t k = 0; k < draws; ++k) {
+                    for (uint32_t i = 0; i < N; ++i) {
+                        uint32_t r = bounded_reference(ref_rng[i], bound);
+                        if (k * N + i < n)
+                            ref[k * N + i] = r;
+                    }
+                }
+
+                rng.fill_uint32_bounded(out, bound, policy);
+                REQUIRE(out == ref);
+                for (uint32_t i = 0; i < N; ++i)
+                    REQUIRE(rng.lane(i) == ref_rng[i]);
+                for (uint32_t r : out)
+                    REQUIRE(r < bound);
+            });
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("pcg32x bulk fills match next_*", "[rng]",
+    ((uint32_t N), N), 8, 4, 16)
+{
+    pcg32x_fill_tests<N>();
+}
+
+template <uint32_t N>
+static void pcg32x_bounded_tests() {
+    using R = pcg32x<N>;
+
+    std::array<uint64_t, N> initstate, initseq;
+    for (uint32_t i = 0; i < N; ++i) {
+        initstate[i] = 0x5851f42d4c957f2dull * (i + 5);
+        initseq[i] = 3 + i * 31;
+    }
+
+    SECTION("next_uints") {
+        for (uint32_t bound : { 1u, 7u, 1u << 31, 0x80000001u, ~0u }) {
+            R rng(initstate, initseq);
+            std::array<pcg32, N> ref;
+            for (uint32_t i = 0; i < N; ++i)
+                ref[i] = rng.lane(i);
+
+            std::array<uint32_t, N> result;
+            for (int k = 0; k < 50; ++k) {
+                rng.next_uints(result, bound);
+                for (uint32_t i = 0; i < N; ++i)
+                    REQUIRE(result[i] == bounded_reference(ref[i], bound));
+            }
+            for (uint32_t i = 0; i < N; ++i)
+                REQUIRE(rng.lane(i) == ref[i]);
+        }
+    }
+
+    SECTION("Shuffle") {
+        // Position p - 1 of a block takes its index from lane l with bound p
+        for (uint32_t n : { 0u, 1u, 2u, 9u, 100u, 1000u }) {
+            R rng(initstate, initseq);
+            std::array<pcg32, N> ref_rng;
+            for (uint32_t i = 0; i < N; ++i)
+                ref_rng[i] = rng.lane(i);
+
+            std::vector<uint32_t> values(n), ref(n);
+            for (uint32_t i = 0; i < n; ++i)
+                values[i] = ref[i] = i;
+
+            rng.shuffle(values.begin(), values.end());
+            for (uint32_t p = n; p > 1;) {
+                for (uint32_t l = 0; l < N; ++l) {
+                    uint32_t idx = bounded_reference(ref_rng[l], p > l + 1 ? p - l : 1u);
+                    if (p > l + 1)
+                        std::swap(ref[p - l - 1], ref[idx]);
+                }
+                p = p > N ? p - N : 1;
+            }
+            REQUIRE(values == ref);
+
+            std::sort(values.begin(), values.end());
+            for (uint32_t i = 0; i < n; ++i)
+                REQUIRE(values[i] == i);
+        }
+    }
+
+    SECTION("Shuffle is uniform") {
+        // All 24 orders of 4 elements, 1000 expected each with a standard
+        // deviation around 31
+        R rng(initstate, initseq);
+        std::array<int, 256> counts{};
+        for (int k = 0; k < 24000; ++k) {
+            std::array<uint32_t, 4> v{ 0, 1, 2, 3 };
+            rng.shuffle(v.begin(), v.end());
+            ++counts[v[0] | v[1] << 2 | v[2] << 4 | v[3] << 6];
+        }
+
+        int orders = 0;
+        for (int c : counts) {
+            if (c > 0) {
+                ++orders;
+                REQUIRE(c > 850);
+                REQUIRE(c < 1150);
+            }
+        }
+        REQUIRE(orders == 24);
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("pcg32x bounded draws and shuffle", "[rng]",
+    ((uint32_t N), N), 8, 4, 16)
+{
+    pcg32x_bounded_tests<N>();
+}
@@ -0,0 +1,155 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+using Catch::Matchers::WithinAbs;
+
+// Sample sizes are large enough that the tolerances below are 5 to 10
+// standard errors, the seeds are fixed so the tests are deterministic
+static constexpr std::size_t sample_count = 1 << 18;
+
+// Sample mean of f over the values
+template <typename T, typename F>
+static double mean_of(const std::vector<T>& v, const F& f) {
+    double sum = 0.;
+    for (const auto& x : v)
+        sum += f(x);
+    return sum / v.size();
+}
+
+TEST_CASE("Normal deviates", "[sampling]") {
+    pcg32x<8> rng;
+
+    SECTION("Moments") {
+        std::vector<float> v(sample_count);
+        fill_normal(rng, std::span<float>(v));
+
+        REQUIRE_THAT(mean_of(v, [](double x) { return x; }), WithinAbs(0., 0.01));
+        REQUIRE_THAT(mean_of(v, [](double x) { return x * x; }), WithinAbs(1., 0.015));
+        REQUIRE_THAT(mean_of(v, [](double x) { return x * x * x; }), WithinAbs(0., 0.04));
+        REQUIRE_THAT(mean_of(v, [](double x) { return x * x * x * x; }), WithinAbs(3., 0.1));
+
+        // Phi(1) and Phi(-2)
+        REQUIRE_THAT(mean_of(v, [](double x) { return x < 1.; }), WithinAbs(0.841345, 0.004));
+        REQUIRE_THAT(mean_of(v, [](double x) { return x < -2.; }), WithinAbs(0.02275, 0.002));
+    }
+
+    SECTION("Mean and standard deviation") {
+        std::vector<float> v(sample_count);
+        fill_normal(rng, std::span<float>(v), 5.f, 2.f);
+
+        REQUIRE_THAT(mean_of(v, [](double x) { return x; }), WithinAbs(5., 0.02));
+        REQUIRE_THAT(mean_of(v, [](double x) { return (x - 5.) * (x - 5.); }),
+            WithinAbs(4., 0.06));
+    }
+
+    SECTION("Sizes") {
+        // Odd sizes and partial chunks fill every element and nothing past it
+        for (std::size_t n : { 1, 2, 7, 255, 256, 257, 1001 }) {
+            std::vector<float> v(n + 1, NAN);
+            fill_normal(rng, std::span<float>(v.data(), n));
+            for (std::size_t i = 0; i < n; ++i) {
+                REQUIRE(std::isfinite(v[i]));
+                REQUIRE(std::abs(v[i]) < 10.f);
+            }
+            REQUIRE(std::isnan(v[n]));
+        }
+    }
+}
+
+TEST_CASE("Exponential deviates", "[sampling]") {
+    pcg32x<8> rng;
+    std::vector<float> v(sample_count);
+    fill_exponential(rng, std::span<float>(v), 2.f);
+
+    for (float x : v) {
+        REQUIRE(x >= 0.f);
+        REQUIRE(std::isfinite(x));
+    }
+    REQUIRE_THAT(mean_of(v, [](double x) { return x; }), WithinAbs(0.5, 0.005));
+    REQUIRE_THAT(mean_of(v, [](double x) { return x * x; }), WithinAbs(0.5, 0.01));
+    REQUIRE_THAT(mean_of(v, [](double x) { return x > 1.; }), WithinAbs(std::exp(-2.), 0.004));
+}
+
+TEST_CASE("Directions", "[sampling]") {
+    pcg32x<8> rng;
+    std::vector<Vec3f> v(sample_count);
+
+    const auto require_unit = [&]() {
+        for (const auto& d : v)
+            REQUIRE_THAT(d.length(), WithinAbs(1., 1e-5));
+    };
+
+    SECTION("Sphere") {
+        sample_sphere(rng, std::span<Vec3f>(v));
+        require_unit();
+
+        // E[x] = 0 and E[x^2] = 1/3 per axis
+        for (uint32_t k = 0; k < 3; ++k) {
+            REQUIRE_THAT(mean_of(v, [k](const Vec3f& d) { return d[k]; }), WithinAbs(0., 0.007));
+            REQUIRE_THAT(mean_of(v, [k](const Vec3f& d) { return d[k] * d[k]; }),
+                WithinAbs(1. / 3., 0.006));
+        }
+        REQUIRE_THAT(mean_of(v, [](const Vec3f& d) { return d.x * d.y; }), WithinAbs(0., 0.004));
+    }
+
+    SECTION("Hemisphere") {
+        sample_hemisphere(rng, std::span<Vec3f>(v));
+        require_unit();
+
+        for (const auto& d : v)
+            REQUIRE(d.z >= 0.f);
+        REQUIRE_THAT(mean_of(v, [](const Vec3f& d) { return d.z; }), WithinAbs(0.5, 0.006));
+        REQUIRE_THAT(mean_of(v, [](const Vec3f& d) { return d.x; }), WithinAbs(0., 0.007));
+        REQUIRE_THAT(mean_of(v, [](const Vec3f& d) { return d.y; }), WithinAbs(0., 0.007));
+    }
+
+    SECTION("Cosine weighted hemisphere") {
+        sample_cosine_hemisphere(rng, std::span<Vec3f>(v));
+        require_unit();
+
+        // E[cos] = 2/3 and E[cos^2] = 1/2 for the density cos / pi
+        for (const auto& d : v)
+            REQUIRE(d.z >= 0.f);
+        REQUIRE_THAT(mean_of(v, [](const Vec3f& d) { return d.z; }), WithinAbs(2. / 3., 0.005));
+        REQUIRE_THAT(mean_of(v, [](const Vec3f& d) { return d.z * d.z; }), WithinAbs(0.5, 0.005));
+        REQUIRE_THAT(mean_of(v, [](const Vec3f& d) { return d.x; }), WithinAbs(0., 0.007));
+    }
+
+    SECTION("SoA matches AoS") {
+        const pcg32x<8> seed = rng;
+        std::vector<float> x(1001), y(1001), z(1001);
+        v.resize(1001);
+
+        sample_cosine_hemisphere(rng, std::span<Vec3f>(v));
+        rng = seed;
+        sample_cosine_hemisphere(rng, { std::span<float>(x), std::span<float>(y),
+            std::span<float>(z) });
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            REQUIRE(v[i].x == x[i]);
+            REQUIRE(v[i].y == y[i]);
+            REQUIRE(v[i].z == z[i]);
+        }
+    }
+}
+
+TEST_CASE("Disk", "[sampling]") {
+    pcg32x<16> rng;
+    std::vector<Vec2f> v(sample_count);
+    sample_disk(rng, std::span<Vec2f>(v));
+
+    const auto r2 = [](const Vec2f& p) { return (double) p.x * p.x + (double) p.y * p.y; };
+    for (const auto& p : v)
+        REQUIRE(r2(p) <= 1. + 1e-6);
+
+    // Uniform in area, E[r^2] = 1/2 and a quarter of the points within r = 1/2
+    REQUIRE_THAT(mean_of(v, r2), WithinAbs(0.5, 0.005));
+    REQUIRE_THAT(mean_of(v, [&](const Vec2f& p) { return r2(p) < 0.25; }), WithinAbs(0.25, 0.007));
+    REQUIRE_THAT(mean_of(v, [](const Vec2f& p) { return p.x; }), WithinAbs(0., 0.005));
+    REQUIRE_THAT(mean_of(v, [](const Vec2f& p) { return p.x > 0. && p.y > 0.; }),
+        WithinAbs(0.25, 0.007));
+}
@@ -0,0 +1,99 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+using Catch::Approx;
+
+// Contracted and separate multiply-adds round differently, which shows up
+// as an absolute error where the result cancels to near zero
+template <typename T>
+static Approx near(const T v) {
+    return Approx(v).margin(1e-4);
+}
+
+template <typename T>
+static std::vector<T> make_array(const std::size_t n, const T offset) {
+    std::vector<T> a(n);
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] = std::sin(static_cast<T>(i) * static_cast<T>(0.7) + offset) * 3;
+    return a;
+}
+
+TEMPLATE_TEST_CASE("Array expressions", "[expr]", float, double) {
+    using T = TestType;
+
+    // Every packet width and a scalar tail
+    for (std::size_t n : { 0, 1, 3, 4, 15, 16, 17, 100, 1027 }) {
+        auto a = make_array<T>(n, 0), b = make_array<T>(n, 1), c = make_array<T>(n, 2),
+            d = make_array<T>(n, 3), e = make_array<T>(n, 4);
+        std::vector<T> out(n, T(-100));
+
+        assign(out, lazy(a) * lazy(b) + lazy(c) * lazy(d) - lazy(e));
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == near(a[i] * b[i] + c[i] * d[i] - e[i]));
+
+        // Products on either side of an add or a sub are contracted
+        assign(out, lazy(e) - lazy(a) * lazy(b));
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == near(e[i] - a[i] * b[i]));
+        assign(out, lazy(a) * lazy(b) - lazy(e));
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == near(a[i] * b[i] - e[i]));
+        assign(out, lazy(e) + lazy(a) * lazy(b));
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == near(e[i] + a[i] * b[i]));
+
+        // Scalars on both sides, division and unary ops
+        assign(out, 2 * lazy(a) / (lazy(b) * 0 + 4) - T(1.5));
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == near(2 * a[i] / 4 - T(1.5)));
+
+        assign(out, sqrt(abs(-lazy(a))) + max(lazy(b), 0) - min(lazy(c), lazy(d)));
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == near(std::sqrt(std::abs(a[i])) + std::max(b[i], T(0)) -
+                std::min(c[i], d[i])));
+
+        // In place
+        auto expected = a;
+        for (auto& x : expected)
+            x = x * 3 + 1;
+        assign(std::span<T>(a), lazy(a) * 3 + 1);
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(a[i] == near(expected[i]));
+    }
+}
+
+// Register backed Vecs with and without padding and a fallback Vec
+TEMPLATE_TEST_CASE("Vec expressions", "[expr]", Vec3f, Vec4f, Vec3d, Vec4d, (Vec<float, 7>))
+{
+    using V = TestType;
+    using T = typename V::Scalar;
+
+    V a, b, c, d, e;
+    for (uint32_t i = 0; i < V::Size; ++i) {
+        a[i] = T(0.5) + i;
+        b[i] = T(2) - i;
+        c[i] = T(-1.25) * i;
+        d[i] = T(3) + i * i;
+        e[i] = T(0.75);
+    }
+
+    V r = eval(lazy(a) * lazy(b) + lazy(c) * lazy(d) - lazy(e));
+    V expected = a * b + c * d - e;
+    for (uint32_t i = 0; i < V::Size; ++i)
+        REQUIRE(r[i] == near(expected[i]));
+
+    r = eval((lazy(a) - 1) * 2 + lazy(b) / lazy(d));
+    expected = (a - 1) * 2 + b / d;
+    for (uint32_t i = 0; i < V::Size; ++i)
+        REQUIRE(r[i] == near(expected[i]));
+
+    r = eval(max(lazy(a), lazy(b)) - abs(lazy(c)));
+    for (uint32_t i = 0; i < V::Size; ++i)
+        REQUIRE(r[i] == near(std::max(a[i], b[i]) - std::abs(c[i])));
+}
@@ -0,0 +1,219 @@
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <yavl/yavl.h>
+
+using namespace yavl;
+
+// Distance in representable values, float results are compared against the
+// double precision reference rounded to float
+template <typename T>
+static double ulp_diff(const T a, const double ref_d) {
+    const T ref = static_cast<T>(ref_d);
+    if (std::isnan(a) || std::isnan(ref))
+        return std::isnan(a) == std::isnan(ref) ? 0. : std::numeric_limits<double>::infinity();
+    if (a == ref)
+        return 0.;
+    if (std::isinf(a) || std::isinf(ref))
+        return std::numeric_limits<double>::infinity();
+
+    using I = std::conditional_t<sizeof(T) == 4, int32_t, int64_t>;
+    auto ordered = [](const T v) {
+        auto i = std::bit_cast<I>(v);
+        return i < 0 ? std::numeric_limits<I>::min() - i : i;
+    };
+    auto ia = ordered(a), ib = ordered(ref);
+    return static_cast<double>(ia > ib ? ia - ib : ib - ia);
+}
+
+// Uniform sweep plus a log spaced sweep over [lo, hi]
+template <typename T>
+static std::vector<T> sweep(const T lo, const T hi, const uint32_t n = 20000) {
+    std::vector<T> ret;
+    for (uint32_t i = 0; i <= n; ++i)
+        ret.push_back(lo + (hi - lo) * static_cast<T>(i) / static_cast<T>(n));
+    for (int s = -1; s <= 1; s += 2) {
+        for (T v = std::numeric_limits<T>::min(); v < std::numeric_limits<T>::max() / 2; v *= T(1.37)) {
+            if (s * v >= lo && s * v <= hi)
+                ret.push_back(s * v);
+        }
+    }
+    return ret;
+}
+
+struct ulp_result {
+    double ulp = 0.;
+    double x = 0.;
+};
+
+// Worst error of f against ref over xs, REQUIRE-ing per lane is too slow
+// for sweeps this size so the caller checks the result
+template <typename V, typename F, typename R>
+static ulp_result max_ulp(const std::vector<typename V::Scalar>& xs, const F& f,
+    const R& ref, ulp_result worst = {})
+{
+    using T = typename V::Scalar;
+    for (std::size_t i = 0; i < xs.size(); i += V::Size) {
+        V v;
+        for (uint32_t l = 0; l < V::Size; ++l)
+            v[l] = xs[std::min(i + l, xs.size() - 1)];
+        auto r = f(v);
+        for (uint32_t l = 0; l < V::Size; ++l) {
+            auto err = ulp_diff<T>(r[l], ref(static_cast<double>(v[l])));
+            if (err > worst.ulp)
+                worst = { err, static_cast<double>(v[l]) };
+        }
+    }
+    return worst;
+}
+
+#define CHECK_ULP(RESULT, BOUND)                                        \
+    {                                                                   \
+        auto res = RESULT;                                              \
+        INFO("max error " << res.ulp << " ulp at x = " << res.x);       \
+        REQUIRE(res.ulp <= BOUND);                                      \
+    }
+
+template <typename V>
+static void unary_tests() {
+    using T = typename V::Scalar;
+    constexpr bool is_f32 = std::is_same_v<T, float>;
+
+    SECTION("exp") {
+        auto xs = sweep<T>(is_f32 ? -103.f : -744., is_f32 ? 88.7f : 709.7);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return exp(v); },
+            [](double x) { return std::exp(x); }), 1.);
+    }
+
+    SECTION("exp2") {
+        auto xs = sweep<T>(is_f32 ? -149.f : -1074., is_f32 ? 127.9f : 1023.9);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return exp2(v); },
+            [](double x) { return std::exp2(x); }), 1.);
+    }
+
+    SECTION("log") {
+        auto xs = sweep<T>(0, is_f32 ? 1e30f : 1e300);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return log(v); },
+            [](double x) { return std::log(x); }), 1.);
+    }
+
+    SECTION("log2") {
+        auto xs = sweep<T>(0, is_f32 ? 1e30f : 1e300);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return log2(v); },
+            [](double x) { return std::log2(x); }), (is_f32 ? 2. : 1.));
+    }
+
+    const T trig_range = is_f32 ? 8192.f : 1048576.;
+
+    SECTION("sin") {
+        auto xs = sweep<T>(-trig_range, trig_range);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return sin(v); },
+            [](double x) { return std::sin(x); }), (is_f32 ? 1. : 2.));
+    }
+
+    SECTION("cos") {
+        auto xs = sweep<T>(-trig_range, trig_range);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return cos(v); },
+            [](double x) { return std::cos(x); }), (is_f32 ? 1. : 2.));
+    }
+
+    SECTION("sincos") {
+        auto xs = sweep<T>(-trig_range, trig_range);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return sincos(v).first; },
+            [](double x) { return std::sin(x); }), (is_f32 ? 1. : 2.));
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return sincos(v).second; },
+            [](double x) { return std::cos(x); }), (is_f32 ? 1. : 2.));
+    }
+
+    SECTION("tan") {
+        auto xs = sweep<T>(-trig_range, trig_range);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return tan(v); },
+            [](double x) { return std::tan(x); }), 3.);
+    }
+
+    SECTION("atan") {
+        auto xs = sweep<T>(-1e10, 1e10);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return atan(v); },
+            [](double x) { return std::atan(x); }), (is_f32 ? 2. : 1.));
+    }
+
+    SECTION("erf") {
+        auto xs = sweep<T>(-7, 7);
+        CHECK_ULP(max_ulp<V>(xs, [](auto& v) { return erf(v); },
+            [](double x) { return std::erf(x); }), (is_f32 ? 2. : 1.));
+    }
+
+    SECTION("atan2") {
+        auto xs = sweep<T>(-100, 100, 2000);
+        auto ys = sweep<T>(-100, 100, 200);
+        ulp_result worst;
+        for (auto y : ys) {
+            worst = max_ulp<V>(xs, [&](auto& v) { return atan2(V(y), v); },
+                [&](double x) { return std::atan2(static_cast<double>(y), x); }, worst);
+        }
+        CHECK_ULP(worst, (is_f32 ? 3. : 2.));
+    }
+
+    SECTION("pow") {
+        auto xs = sweep<T>(0, 1e4, 2000);
+        const T ys[] = { -30.5, -3, -1, -0.5, 0, 0.3, 1, 2.5, 7, 19.1 };
+        ulp_result worst;
+        for (auto y : ys) {
+            worst = max_ulp<V>(xs, [&](auto& v) { return pow(v, y); },
+                [&](double x) { return std::pow(x, static_cast<double>(y)); }, worst);
+        }
+        CHECK_ULP(worst, 1.);
+    }
+}
+
+TEMPLATE_TEST_CASE("Vec math accuracy", "[vec_math]", Vec4f, Vec3f, (Vec<float, 16>),
+    Vec4d, Vec3d, (Vec<double, 8>))
+{
+    unary_tests<TestType>();
+}
+
+TEMPLATE_TEST_CASE("Vec math special values", "[vec_math]", Vec4f, Vec4d) {
+    using T = typename TestType::Scalar;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    constexpr T nan = std::numeric_limits<T>::quiet_NaN();
+
+    const TestType v{ inf, -inf, 0, -0. };
+
+    auto e = exp(v);
+    REQUIRE(e[0] == inf);
+    REQUIRE(e[1] == 0);
+    REQUIRE(e[2] == 1);
+    REQUIRE(std::isnan(exp(TestType(nan))[0]));
+
+    auto l = log(TestType{ inf, -1, 0, 1 });
+    REQUIRE(l[0] == inf);
+    REQUIRE(std::isnan(l[1]));
+    REQUIRE(l[2] == -inf);
+    REQUIRE(l[3] == 0);
+
+    auto a = atan(v);
+    REQUIRE(a[0] == Catch::Approx(M_PI / 2));
+    REQUIRE(a[1] == Catch::Approx(-M_PI / 2));
+    REQUIRE(std::signbit(a[3]));
+
+    auto a2 = atan2(TestType{ 0, 0, -0., 1 }, TestType{ 1, -1, -1, 0 });
+    REQUIRE(a2[0] == 0);
+    REQUIRE(a2[1] == Catch::Approx(M_PI));
+    REQUIRE(a2[2] == Catch::Approx(-M_PI));
+    REQUIRE(a2[3] == Catch::Approx(M_PI / 2));
+
+    auto p = pow(TestType{ -2, -2, 1, -8 }, TestType{ 3, 0.5, nan, 2 });
+    REQUIRE(p[0] == -8);
+    REQUIRE(std::isnan(p[1]));
+    REQUIRE(p[2] == 1);
+    REQUIRE(p[3] == 64);
+
+    auto er = erf(v);
+    REQUIRE(er[0] == 1);
+    REQUIRE(er[1] == -1);
+    REQUIRE(er[2] == 0);
+}
@@ -188,8 +188,8 @@ TEMPLATE_PRODUCT_TEST_CASE("Vec tests", "[vec]", (Vec2, Vec3, Vec4), (float, dou
     }
 
     SECTION("Compare tests") {
-        REQUIRE(vec1 != vec2)
-        REQUIRE(vec1 == vec5)
+        REQUIRE(vec1 != vec2);
+        REQUIRE(vec1 == vec5);
     }
 
     SECTION("Vectorization tests") {
@@ -198,4 +198,227 @@ TEMPLATE_PRODUCT_TEST_CASE("Vec tests", "[vec]", (Vec2, Vec3, Vec4), (float, dou
 
         REQUIRE(Vec<int, 4>::vectorized == true);
     }
-}
\ No newline at end of file
+}
+
+TEMPLATE_TEST_CASE("Precision tests", "[vec][precision]", Vec3f, Vec4f, Vec3d, Vec4d,
+    (Vec<float, 8>))
+{
+    using Scalar = typename TestType::Scalar;
+    constexpr uint32_t N = TestType::Size;
+
+    // Relative errors, fast is the raw x86 estimate(1.5 * 2^-12) or one
+    // refinement step on NEON, length<fast> compounds two of them
+    const double fast_eps = 4e-4, standard_eps = 1e-5;
+
+    TestType a, b;
+    for (uint32_t i = 0; i < N; ++i) {
+        a[i] = static_cast<Scalar>(0.37 + 1.9 * i);
+        b[i] = static_cast<Scalar>(0.6 + 0.45 * i);
+    }
+
+    SECTION("rcp and rsqrt") {
+        auto rcp_fast = a.template rcp<precision::fast>();
+        auto rcp_standard = a.rcp();
+        auto rcp_exact = a.template rcp<precision::exact>();
+        auto rsqrt_fast = a.template rsqrt<precision::fast>();
+        auto rsqrt_standard = a.rsqrt();
+        auto rsqrt_exact = a.template rsqrt<precision::exact>();
+        for (uint32_t i = 0; i < N; ++i) {
+            double x = a[i];
+            REQUIRE(rcp_fast[i] == Approx(1. / x).epsilon(fast_eps));
+            REQUIRE(rcp_standard[i] == Approx(1. / x).epsilon(standard_eps));
+            REQUIRE(rcp_exact[i] == Scalar(1) / a[i]);
+            REQUIRE(rsqrt_fast[i] == Approx(1. / std::sqrt(x)).epsilon(fast_eps));
+            REQUIRE(rsqrt_standard[i] == Approx(1. / std::sqrt(x)).epsilon(standard_eps));
+            REQUIRE(rsqrt_exact[i] == Scalar(1) / std::sqrt(a[i]));
+        }
+    }
+
+    SECTION("Division, length and normalize") {
+        auto div_fast = a.template div<precision::fast>(b);
+        auto div_exact = a.div(b);
+        auto n_fast = a.template normalized<precision::fast>();
+        auto n_standard = a.template normalized<precision::standard>();
+        auto n = a.normalized();
+        auto c = a;
+        c.template normalize<precision::fast>();
+        for (uint32_t i = 0; i < N; ++i) {
+            REQUIRE(div_fast[i] == Approx(a[i] / b[i]).epsilon(fast_eps));
+            REQUIRE(div_exact[i] == a[i] / b[i]);
+            REQUIRE(n_fast[i] == Approx(n[i]).epsilon(fast_eps));
+            REQUIRE(n_standard[i] == Approx(n[i]).epsilon(standard_eps));
+            REQUIRE(c[i] == n_fast[i]);
+        }
+        REQUIRE(a.template length<precision::fast>() == Approx(a.length()).epsilon(2 * fast_eps));
+        REQUIRE(a.template length<precision::standard>() == Approx(a.length()).epsilon(standard_eps));
+
+        // rcp(rsqrt(0)) is rcp(inf)
+        REQUIRE(TestType{ 0 }.template length<precision::fast>() == 0);
+    }
+}
+
+TEMPLATE_TEST_CASE("VecSoA tests", "[vec][soa]", (VecSoA<float, 3, 4>),
+    (VecSoA<float, 3, 8>), (VecSoA<float, 3, 16>), (VecSoA<double, 3, 4>))
+{
+    using Scalar = typename TestType::Scalar;
+    using Element = typename TestType::Element;
+    constexpr uint32_t W = TestType::Width;
+
+    std::array<Element, W> as, bs;
+    for (int i = 0; i < W; ++i) {
+        as[i] = Element(i + 1, 2 * i + 1, 3 - i);
+        bs[i] = Element(1, i, 2);
+    }
+
+    auto a = TestType::load(as.data());
+    auto b = TestType::load(bs.data());
+
+    SECTION("Lane access") {
+        for (int i = 0; i < W; ++i)
+            check_vec_components(a.get(i), i + 1, 2 * i + 1, 3 - i);
+    }
+
+    SECTION("Geo tests") {
+        auto dot = a.dot(b);
+        auto cross = a.cross(b);
+        for (uint32_t i = 0; i < W; ++i) {
+            REQUIRE(dot[i] == Approx(as[i].dot(bs[i])));
+            auto c = as[i].cross(bs[i]);
+            check_vec_components(cross.get(i), c.x, c.y, c.z);
+        }
+    }
+
+    SECTION("Math tests") {
+        auto n = a.normalized();
+        auto l = a.lerp(b, 0.25);
+        auto len = a.length();
+        for (uint32_t i = 0; i < W; ++i) {
+            auto e = as[i].normalized();
+            // rsqrt is refined with one Newton-Raphson step only
+            REQUIRE(n[0][i] == Approx(e.x).epsilon(1e-5));
+            REQUIRE(n[1][i] == Approx(e.y).epsilon(1e-5));
+            REQUIRE(n[2][i] == Approx(e.z).epsilon(1e-5));
+            REQUIRE(len[i] == Approx(as[i].length()));
+            auto el = as[i].lerp(bs[i], 0.25);
+            check_vec_components(l.get(i), el.x, el.y, el.z);
+        }
+    }
+
+    SECTION("VecArray tests") {
+        VecArray<Scalar, 3> va;
+        for (uint32_t i = 0; i < 2 * W + 1; ++i)
+            va.push_back(as[i % W]);
+        REQUIRE(va.size() == 2 * W + 1);
+        check_vec_components(va[W + 1], 2, 3, 2);
+
+        va.template normalize<W>();
+        for (uint32_t i = 0; i < va.size(); ++i)
+            REQUIRE(va[i].length() == Approx(1).epsilon(1e-5));
+
+        // Padding stays zeroed
+        auto tail = va.template load<W>(2 * W);
+        for (uint32_t i = 1; i < W; ++i)
+            REQUIRE(tail[0][i] == 0);
+    }
+}
+
+TEMPLATE_TEST_CASE("VecView tests", "[vec][view]", (VecSoA<float, 3, 4>),
+    (VecSoA<float, 3, 8>), (VecSoA<float, 3, 16>), (VecSoA<float, 4, 8>),
+    (VecSoA<double, 3, 4>))
+{
+    using Scalar = typename TestType::Scalar;
+    constexpr uint32_t N = TestType::Size;
+    constexpr uint32_t W = TestType::Width;
+
+    // Whole packets plus a partial one, records of a strided view are
+    // followed by a marker that must survive every store
+    const std::size_t n = 2 * W + 3;
+    const std::size_t stride = N + 2;
+    auto value = [](const std::size_t i, const uint32_t c) {
+        return static_cast<Scalar>(i * 4 + c + 1);
+    };
+    auto check = [&](const auto& view, auto&& expected) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto v = view[i];
+            for (uint32_t c = 0; c < N; ++c)
+                REQUIRE(v[c] == expected(i, c));
+        }
+    };
+
+    std::vector<Scalar> packed(n * N), strided(n * stride, Scalar(-1));
+    std::vector<Vec<Scalar, N>> aligned(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (uint32_t c = 0; c < N; ++c) {
+            packed[i * N + c] = value(i, c);
+            strided[i * stride + c] = value(i, c);
+            aligned[i][c] = value(i, c);
+        }
+    }
+    PackedView<Scalar, N> pv(packed.data(), n);
+    StridedView<Scalar, N> sv(strided.data(), n, stride);
+    AlignedView<Scalar, N> av{ std::span<const Vec<Scalar, N>>(aligned) };
+
+    SECTION("Element access") {
+        check(pv, value);
+        check(sv, value);
+        check(av, value);
+        REQUIRE(av.span().data() == aligned.data());
+
+        pv.set(1, pv[0]);
+        sv.set(1, sv[0]);
+        for (uint32_t c = 0; c < N; ++c) {
+            REQUIRE(packed[N + c] == value(0, c));
+            REQUIRE(strided[stride + c] == value(0, c));
+        }
+        REQUIRE(strided[stride + N] == -1);
+    }
+
+    SECTION("Packet access") {
+        auto round_trip = [&](const auto& view) {
+            for (std::size_t i = 0; i + W <= n; i += W) {
+                auto p = view.template load<W>(i);
+                for (uint32_t l = 0; l < W; ++l)
+                    for (uint32_t c = 0; c < N; ++c)
+                        REQUIRE(p[c][l] == value(i + l, c));
+                view.store(i, p * Scalar(2));
+            }
+            // The last packet ends on the last record
+            auto p = view.template load<W>(n - W);
+            REQUIRE(p[0][W - 1] == value(n - 1, 0));
+
+            auto tail = view.template load_partial<W>(n - 3, 3);
+            for (uint32_t l = 3; l < W; ++l)
+                REQUIRE(tail[0][l] == 0);
+            view.store_partial(n - 3, tail * Scalar(2), 3);
+
+            check(view, [&](const std::size_t i, const uint32_t c) {
+                return value(i, c) * 2;
+            });
+        };
+        round_trip(pv);
+        round_trip(sv);
+        round_trip(av);
+        for (std::size_t i = 0; i < n; ++i)
+            for (uint32_t c = N; c < stride; ++c)
+                REQUIRE(strided[i * stride + c] == -1);
+    }
+
+    SECTION("Bulk ops") {
+        auto normalized = [&](const std::size_t i, const uint32_t c) {
+            Vec<Scalar, N> v;
+            for (uint32_t k = 0; k < N; ++k)
+                v[k] = value(i, k);
+            return v.normalized()[c];
+        };
+        auto check_normalized = [&](const auto& view) {
+            view.template normalize<W>();
+            for (std::size_t i = 0; i < n; ++i)
+                for (uint32_t c = 0; c < N; ++c)
+                    REQUIRE(view[i][c] == Approx(normalized(i, c)).epsilon(1e-5));
+        };
+        check_normalized(pv);
+        check_normalized(sv);
+        check_normalized(av);
+        REQUIRE(strided[n * stride - 1] == -1);
+    }
+}